@@ -35,7 +35,7 @@ PreprocessOnlySwitch   :=-E
 ObjectsFileList        :="UOC20212.txt"
 PCHCompileFlags        :=
 MakeDirCommand         :=mkdir -p
-LinkOptions            :=  
+LinkOptions            :=  -pthread
 IncludePath            :=  $(IncludeSwitch). $(IncludeSwitch). $(IncludeSwitch)test/include $(IncludeSwitch)UOCVaccine/include 
 IncludePCH             := 
 RcIncludePath          := 
@@ -60,7 +60,7 @@ AS       := as
 ## User defined environment variables
 ##
 CodeLiteDir:=/usr/share/codelite
-Objects0=$(IntermediateDirectory)/test_src_test_suite.c$(ObjectSuffix) $(IntermediateDirectory)/test_src_test.c$(ObjectSuffix) $(IntermediateDirectory)/test_src_test_pr2.c$(ObjectSuffix) $(IntermediateDirectory)/test_src_test_pr3.c$(ObjectSuffix) $(IntermediateDirectory)/test_src_test_pr1.c$(ObjectSuffix) $(IntermediateDirectory)/src_main.c$(ObjectSuffix) 
+Objects0=$(IntermediateDirectory)/test_src_test_suite.c$(ObjectSuffix) $(IntermediateDirectory)/test_src_test.c$(ObjectSuffix) $(IntermediateDirectory)/test_src_test_pr2.c$(ObjectSuffix) $(IntermediateDirectory)/test_src_test_pr3.c$(ObjectSuffix) $(IntermediateDirectory)/test_src_test_pr1.c$(ObjectSuffix) $(IntermediateDirectory)/src_main.c$(ObjectSuffix) $(IntermediateDirectory)/test_src_bench.c$(ObjectSuffix) $(IntermediateDirectory)/test_src_test_pr4.c$(ObjectSuffix) 
 
 
 
@@ -139,6 +139,22 @@ $(IntermediateDirectory)/src_main.c$(DependSuffix): src/main.c
 $(IntermediateDirectory)/src_main.c$(PreprocessSuffix): src/main.c
 	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_main.c$(PreprocessSuffix) src/main.c
 
+$(IntermediateDirectory)/test_src_bench.c$(ObjectSuffix): test/src/bench.c $(IntermediateDirectory)/test_src_bench.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "/media/sf_PrProg/UOC20212 4/test/src/bench.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/test_src_bench.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/test_src_bench.c$(DependSuffix): test/src/bench.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/test_src_bench.c$(ObjectSuffix) -MF$(IntermediateDirectory)/test_src_bench.c$(DependSuffix) -MM test/src/bench.c
+
+$(IntermediateDirectory)/test_src_bench.c$(PreprocessSuffix): test/src/bench.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/test_src_bench.c$(PreprocessSuffix) test/src/bench.c
+
+$(IntermediateDirectory)/test_src_test_pr4.c$(ObjectSuffix): test/src/test_pr4.c $(IntermediateDirectory)/test_src_test_pr4.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "/media/sf_PrProg/UOC20212 4/test/src/test_pr4.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/test_src_test_pr4.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/test_src_test_pr4.c$(DependSuffix): test/src/test_pr4.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/test_src_test_pr4.c$(ObjectSuffix) -MF$(IntermediateDirectory)/test_src_test_pr4.c$(DependSuffix) -MM test/src/test_pr4.c
+
+$(IntermediateDirectory)/test_src_test_pr4.c$(PreprocessSuffix): test/src/test_pr4.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/test_src_test_pr4.c$(PreprocessSuffix) test/src/test_pr4.c
+
 
 -include $(IntermediateDirectory)/*$(DependSuffix)
 ##
@@ -60,7 +60,7 @@ AS       := as
 ## User defined environment variables
 ##
 CodeLiteDir:=/usr/share/codelite
-Objects0=$(IntermediateDirectory)/src_stock.c$(ObjectSuffix) $(IntermediateDirectory)/src_date.c$(ObjectSuffix) $(IntermediateDirectory)/src_vaccine.c$(ObjectSuffix) $(IntermediateDirectory)/src_appointment.c$(ObjectSuffix) $(IntermediateDirectory)/src_csv.c$(ObjectSuffix) $(IntermediateDirectory)/src_api.c$(ObjectSuffix) $(IntermediateDirectory)/src_person.c$(ObjectSuffix) $(IntermediateDirectory)/src_center.c$(ObjectSuffix) 
+Objects0=$(IntermediateDirectory)/src_stock.c$(ObjectSuffix) $(IntermediateDirectory)/src_date.c$(ObjectSuffix) $(IntermediateDirectory)/src_vaccine.c$(ObjectSuffix) $(IntermediateDirectory)/src_appointment.c$(ObjectSuffix) $(IntermediateDirectory)/src_csv.c$(ObjectSuffix) $(IntermediateDirectory)/src_api.c$(ObjectSuffix) $(IntermediateDirectory)/src_person.c$(ObjectSuffix) $(IntermediateDirectory)/src_center.c$(ObjectSuffix) $(IntermediateDirectory)/src_hash.c$(ObjectSuffix) $(IntermediateDirectory)/src_array.c$(ObjectSuffix) $(IntermediateDirectory)/src_arena.c$(ObjectSuffix) $(IntermediateDirectory)/src_intern.c$(ObjectSuffix) $(IntermediateDirectory)/src_snapshot.c$(ObjectSuffix) $(IntermediateDirectory)/src_wal.c$(ObjectSuffix) $(IntermediateDirectory)/src_columns.c$(ObjectSuffix) $(IntermediateDirectory)/src_cohort.c$(ObjectSuffix) 
 
 
 
@@ -157,6 +157,70 @@ $(IntermediateDirectory)/src_center.c$(DependSuffix): src/center.c
 $(IntermediateDirectory)/src_center.c$(PreprocessSuffix): src/center.c
 	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_center.c$(PreprocessSuffix) src/center.c
 
+$(IntermediateDirectory)/src_hash.c$(ObjectSuffix): src/hash.c $(IntermediateDirectory)/src_hash.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "/media/sf_PrProg/UOC20212 4/UOCVaccine/src/hash.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/src_hash.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/src_hash.c$(DependSuffix): src/hash.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/src_hash.c$(ObjectSuffix) -MF$(IntermediateDirectory)/src_hash.c$(DependSuffix) -MM src/hash.c
+
+$(IntermediateDirectory)/src_hash.c$(PreprocessSuffix): src/hash.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_hash.c$(PreprocessSuffix) src/hash.c
+
+$(IntermediateDirectory)/src_array.c$(ObjectSuffix): src/array.c $(IntermediateDirectory)/src_array.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "/media/sf_PrProg/UOC20212 4/UOCVaccine/src/array.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/src_array.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/src_array.c$(DependSuffix): src/array.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/src_array.c$(ObjectSuffix) -MF$(IntermediateDirectory)/src_array.c$(DependSuffix) -MM src/array.c
+
+$(IntermediateDirectory)/src_array.c$(PreprocessSuffix): src/array.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_array.c$(PreprocessSuffix) src/array.c
+
+$(IntermediateDirectory)/src_arena.c$(ObjectSuffix): src/arena.c $(IntermediateDirectory)/src_arena.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "/media/sf_PrProg/UOC20212 4/UOCVaccine/src/arena.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/src_arena.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/src_arena.c$(DependSuffix): src/arena.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/src_arena.c$(ObjectSuffix) -MF$(IntermediateDirectory)/src_arena.c$(DependSuffix) -MM src/arena.c
+
+$(IntermediateDirectory)/src_arena.c$(PreprocessSuffix): src/arena.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_arena.c$(PreprocessSuffix) src/arena.c
+
+$(IntermediateDirectory)/src_intern.c$(ObjectSuffix): src/intern.c $(IntermediateDirectory)/src_intern.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "/media/sf_PrProg/UOC20212 4/UOCVaccine/src/intern.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/src_intern.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/src_intern.c$(DependSuffix): src/intern.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/src_intern.c$(ObjectSuffix) -MF$(IntermediateDirectory)/src_intern.c$(DependSuffix) -MM src/intern.c
+
+$(IntermediateDirectory)/src_intern.c$(PreprocessSuffix): src/intern.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_intern.c$(PreprocessSuffix) src/intern.c
+
+$(IntermediateDirectory)/src_snapshot.c$(ObjectSuffix): src/snapshot.c $(IntermediateDirectory)/src_snapshot.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "/media/sf_PrProg/UOC20212 4/UOCVaccine/src/snapshot.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/src_snapshot.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/src_snapshot.c$(DependSuffix): src/snapshot.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/src_snapshot.c$(ObjectSuffix) -MF$(IntermediateDirectory)/src_snapshot.c$(DependSuffix) -MM src/snapshot.c
+
+$(IntermediateDirectory)/src_snapshot.c$(PreprocessSuffix): src/snapshot.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_snapshot.c$(PreprocessSuffix) src/snapshot.c
+
+$(IntermediateDirectory)/src_wal.c$(ObjectSuffix): src/wal.c $(IntermediateDirectory)/src_wal.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "/media/sf_PrProg/UOC20212 4/UOCVaccine/src/wal.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/src_wal.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/src_wal.c$(DependSuffix): src/wal.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/src_wal.c$(ObjectSuffix) -MF$(IntermediateDirectory)/src_wal.c$(DependSuffix) -MM src/wal.c
+
+$(IntermediateDirectory)/src_wal.c$(PreprocessSuffix): src/wal.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_wal.c$(PreprocessSuffix) src/wal.c
+
+$(IntermediateDirectory)/src_columns.c$(ObjectSuffix): src/columns.c $(IntermediateDirectory)/src_columns.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "/media/sf_PrProg/UOC20212 4/UOCVaccine/src/columns.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/src_columns.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/src_columns.c$(DependSuffix): src/columns.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/src_columns.c$(ObjectSuffix) -MF$(IntermediateDirectory)/src_columns.c$(DependSuffix) -MM src/columns.c
+
+$(IntermediateDirectory)/src_columns.c$(PreprocessSuffix): src/columns.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_columns.c$(PreprocessSuffix) src/columns.c
+
+$(IntermediateDirectory)/src_cohort.c$(ObjectSuffix): src/cohort.c $(IntermediateDirectory)/src_cohort.c$(DependSuffix)
+	$(CC) $(SourceSwitch) "/media/sf_PrProg/UOC20212 4/UOCVaccine/src/cohort.c" $(CFLAGS) $(ObjectSwitch)$(IntermediateDirectory)/src_cohort.c$(ObjectSuffix) $(IncludePath)
+$(IntermediateDirectory)/src_cohort.c$(DependSuffix): src/cohort.c
+	@$(CC) $(CFLAGS) $(IncludePath) -MG -MP -MT$(IntermediateDirectory)/src_cohort.c$(ObjectSuffix) -MF$(IntermediateDirectory)/src_cohort.c$(DependSuffix) -MM src/cohort.c
+
+$(IntermediateDirectory)/src_cohort.c$(PreprocessSuffix): src/cohort.c
+	$(CC) $(CFLAGS) $(IncludePath) $(PreprocessOnlySwitch) $(OutputSwitch) $(IntermediateDirectory)/src_cohort.c$(PreprocessSuffix) src/cohort.c
+
 
 -include $(IntermediateDirectory)/*$(DependSuffix)
 ##
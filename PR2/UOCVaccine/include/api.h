@@ -1,14 +1,20 @@
 #ifndef __UOCVACCINE_API__H
 #define __UOCVACCINE_API__H
 #include <stdbool.h>
+#include <pthread.h>
 #include "error.h"
 #include "csv.h"
+#include "arena.h"
+#include "intern.h"
 
 #include "person.h"
 #include "vaccine.h"
 #include "center.h"
 #include "stock.h"
 #include "appointment.h"
+#include "wal.h"
+#include "columns.h"
+#include "cohort.h"
 
 
 // Type that stores all the application data
@@ -27,17 +33,102 @@ typedef struct _ApiData {
     // PR2 EX1a
     tHealthCenterList centers;
     ////////////////////////////////    
+    
+    // Memory for the strings of the persons, vaccines and lots
+    tArena arena;
+    
+    // Unique cp and vaccine names, shared by all the entities
+    tInternTable strings;
+    
+    // Appointments of each person in any center
+    tAppointmentIndex personAppointments;
+    
+    // Log where the changes of the data are appended. If NULL, changes are not logged. Resetting the data keeps it, and the reset is logged so recovery replays it
+    tWal* log;
+    // Sequence number of the last change of the data written on the log
+    long long lsn;
+    
+    // Population also stored by columns, updated with each change of the persons. If NULL, it is not stored by columns. Resetting the data keeps it, removing all its rows
+    tPopulationColumns* columns;
 } tApiData;
 
+// Application data shared between threads. Many threads can read it at the same time, while a single one modifies it
+typedef struct _tApiSharedData {
+    tApiData data;
+    // Shared by the readers and exclusive for the writer
+    pthread_rwlock_t lock;
+} tApiSharedData;
+
+// Number of rows of a feed applied by api_syncData
+typedef struct _tApiSyncStats {
+    int inserted;
+    int changed;
+    int removed;
+    // Rows equal to the current data, which are not applied
+    int unchanged;
+} tApiSyncStats;
+
+// Cursor returning the records of the application data one at a time, without copying them. It is valid while the data is not modified
+typedef struct _tApiCursor {
+    // Position of the next record and position after the last one
+    int pos;
+    int end;
+    // Positions of the lots on the lots data. If NULL, the records are all the lots
+    int* lots;
+    // Appointments of a person
+    tPersonAppointment* appointments;
+} tApiCursor;
+
 // Get the API version information
 const char* api_version();
 
 // Load data from a CSV file. If reset is true, remove previous data
 tApiError api_loadData(tApiData* data, const char* filename, bool reset);
 
+// Load data from a CSV file, parsing it with the given number of threads. If reset is true, remove previous data
+tApiError api_loadDataParallel(tApiData* data, const char* filename, bool reset, int numThreads);
+
+// Synchronize the persons and vaccine lots with a new version of a CSV feed, applying only the rows inserted, changed or removed.
+// Appointments of removed persons are cancelled. If the feed has invalid rows, no row is removed. If stats is not NULL, the number of rows applied is stored on it.
+// Removing a person or a lot moves the last one to its position, so positions on the population and the lots are not kept across a sync
+tApiError api_syncData(tApiData* data, const char* filename, tApiSyncStats* stats);
+
+// Save all the data on a binary snapshot file
+tApiError api_saveSnapshot(const tApiData* data, const char* filename);
+
+// Load all the data from a binary snapshot file, removing previous data. Returns E_INVALID_LOG if the data has a log, as the log could not replay the load
+tApiError api_loadSnapshot(tApiData* data, const char* filename);
+
+// Recover the data from a snapshot and the changes of the log written after it, and append the next changes to the log.
+// Missing files are taken as empty. Changes are synced in groups of groupSize changes
+tApiError api_recoverData(tApiData* data, tWal* log, const char* snapshot, const char* logFile, int groupSize);
+
+// Save the data on a new snapshot and empty its log, so it only has the changes after the snapshot
+tApiError api_compactLog(tApiData* data, const char* snapshot, const char* logFile);
+
+// Write the pending changes of the log to the disk. Returns E_FILE_NOT_FOUND if any change could not be written
+tApiError api_syncLog(tApiData* data);
+
+// Sync and close the log of the data. Next changes are not logged
+tApiError api_closeLog(tApiData* data);
+
+// Store the population also by columns, building them with the current persons. Next changes of the persons are applied to them.
+// The columns are initialized by this call, and released with populationColumns_free
+tApiError api_enableColumns(tApiData* data, tPopulationColumns* columns);
+
+// Stop storing the population by columns. The columns are not released, and they keep the persons they had
+tApiError api_disableColumns(tApiData* data);
+
+// Select the persons matching a cohort query, on their positions of the population. If the population is not stored by columns, they are built for the query.
+// The selection is initialized by this call
+tApiError api_selectCohort(tApiData* data, const tCohortQuery* query, tCohortSelection* selection);
+
 // Add a new entry
 tApiError api_addDataEntry(tApiData* data, tCSVEntry entry);
 
+// Add a new entry from a CSV view
+tApiError api_addDataView(tApiData* data, const tCSVView* view);
+
 // Free all used memory
 tApiError api_freeData(tApiData* data);
 
@@ -47,46 +138,113 @@ tApiError api_initData(tApiData* data);
 // Add a new vaccines lot
 tApiError api_addVaccineLot(tApiData* data, tCSVEntry entry);
 
+// Add a new vaccines lot from a CSV view
+tApiError api_addVaccineLotView(tApiData* data, const tCSVView* view);
+
 // Get the number of persons registered on the application
-int api_populationCount(tApiData data);
+int api_populationCount(const tApiData* data);
 
 // Get the number of vaccines registered on the application
-int api_vaccineCount(tApiData data);
+int api_vaccineCount(const tApiData* data);
 
 // Get the number of vaccine lots registered on the application
-int api_vaccineLotsCount(tApiData data);
+int api_vaccineLotsCount(const tApiData* data);
 
 // Get vaccine data
-tApiError api_getVaccine(tApiData data, const char *name, tCSVEntry *entry);
+tApiError api_getVaccine(const tApiData* data, const char *name, tCSVEntry *entry);
 
 // Get vaccine lot data
-tApiError api_getVaccineLot(tApiData data, const char* cp, const char* vaccine, tDateTime timestamp, tCSVEntry *entry);
+tApiError api_getVaccineLot(const tApiData* data, const char* cp, const char* vaccine, tDateTime timestamp, tCSVEntry *entry);
 
 // Get registered vaccines
-tApiError api_getVaccines(tApiData data, tCSVData *vaccines);
+tApiError api_getVaccines(const tApiData* data, tCSVData *vaccines);
 
 // Get vaccine lots
-tApiError api_getVaccineLots(tApiData data, tCSVData *lots);
+tApiError api_getVaccineLots(const tApiData* data, tCSVData *lots);
+
+// Get the vaccine lots of a health center with a date between from and to, both included. If vaccine is NULL, lots of any vaccine are returned
+tApiError api_getCenterVaccineLots(const tApiData* data, const char* cp, const char* vaccine, tDate from, tDate to, tCSVData *lots);
+
+// Start a cursor over the registered vaccines, sorted by name
+void api_vaccinesCursor(const tApiData* data, tApiCursor* cursor);
+
+// Get the next vaccine of a cursor. NULL if there are no more vaccines
+tVaccine* api_nextVaccine(const tApiData* data, tApiCursor* cursor);
+
+// Start a cursor over all the vaccine lots
+void api_vaccineLotsCursor(const tApiData* data, tApiCursor* cursor);
+
+// Start a cursor over the vaccine lots of a health center with a date between from and to, both included
+void api_centerVaccineLotsCursor(const tApiData* data, tApiCursor* cursor, const char* cp, tDate from, tDate to);
+
+// Get the next vaccine lot of a cursor. NULL if there are no more lots
+tVaccineLot* api_nextVaccineLot(const tApiData* data, tApiCursor* cursor);
+
+// Start a cursor over the appointments of a person in any center, sorted by timestamp
+tApiError api_personAppointmentsCursor(const tApiData* data, tApiCursor* cursor, const char* document);
+
+// Get the next appointment of a cursor. NULL if there are no more appointments
+tPersonAppointment* api_nextPersonAppointment(const tApiData* data, tApiCursor* cursor);
 
 // Get the number of health centers registered on the application
-int api_centersCount(tApiData data);
+int api_centersCount(const tApiData* data);
 
 // Print center stock
-void api_printCenterStock(tApiData data, const char* cp);
+void api_printCenterStock(const tApiData* data, const char* cp);
 
 // Add a new vaccination appointment
 tApiError api_addAppointment(tApiData* data, const char* cp, const char* document, const char* vaccine, tDateTime timestamp);
 
+// Remove a vaccination appointment
+tApiError api_removeAppointment(tApiData* data, const char* cp, const char* document, tDateTime timestamp);
+
 // Get person appointments
-tApiError api_getPersonAppointments(tApiData data, const char* document, tCSVData *appointments);
+tApiError api_getPersonAppointments(const tApiData* data, const char* document, tCSVData *appointments);
 
 
 // Check availability of a vaccine in a given health center
-bool api_checkAvailability(tApiData data, const char* cp, const char* vaccine, tDate date);
+bool api_checkAvailability(const tApiData* data, const char* cp, const char* vaccine, tDate date);
 
-tVaccineStockNode* api_checkAvailabilityanyVaccine(tApiData *data, const char* cp, tDate date);
+// Check availability of a vaccine in a given health center
+tVaccine* api_checkAvailabilityanyVaccine(const tApiData* data, const char* cp, tDate date);
 
 // Find available vaccination appointment
 tApiError api_findAppointmentAvailability(tApiData* data, const char* cp, const char* document, tDateTime timestamp);
 
-#endif // __UOCVACCINE_API__H
\ No newline at end of file
+// Find available vaccination appointments for a list of persons in a health center, booked in order. The result of each person is stored on results
+tApiError api_findAppointmentAvailabilityBatch(tApiData* data, const char* cp, const char** documents, int count, tDateTime timestamp, tApiError* results);
+
+// Find available vaccination appointments for a list of requests of any health center, booked in order. Centers are processed in parallel with the given number of threads
+tApiError api_findAppointmentAvailabilityParallel(tApiData* data, const char** cps, const char** documents, int count, tDateTime timestamp, tApiError* results, int numThreads);
+
+// Initialize the data shared between threads
+tApiError api_initSharedData(tApiSharedData* shared);
+
+// Free all the memory of the data shared between threads
+tApiError api_freeSharedData(tApiSharedData* shared);
+
+// Start reading the shared data. Other threads can also read it, and it is not modified until api_endRead
+const tApiData* api_beginRead(tApiSharedData* shared);
+
+// Stop reading the shared data
+void api_endRead(tApiSharedData* shared);
+
+// Start modifying the shared data. No other thread can access it until api_endWrite
+tApiData* api_beginWrite(tApiSharedData* shared);
+
+// Stop modifying the shared data
+void api_endWrite(tApiSharedData* shared);
+
+// Add a new entry to the shared data
+tApiError api_sharedAddDataEntry(tApiSharedData* shared, tCSVEntry entry);
+
+// Get vaccine lot data from the shared data
+tApiError api_sharedGetVaccineLot(tApiSharedData* shared, const char* cp, const char* vaccine, tDateTime timestamp, tCSVEntry *entry);
+
+// Get person appointments from the shared data
+tApiError api_sharedGetPersonAppointments(tApiSharedData* shared, const char* document, tCSVData *appointments);
+
+// Check availability of a vaccine in a given health center of the shared data
+bool api_sharedCheckAvailability(tApiSharedData* shared, const char* cp, const char* vaccine, tDate date);
+
+#endif // __UOCVACCINE_API__H
@@ -3,6 +3,8 @@
 #include "date.h"
 #include "person.h"
 #include "vaccine.h"
+#include "intern.h"
+#include "snapshot.h"
 
 // Type that stores a vaccination appointment data
 typedef struct _tAppointment {    
@@ -15,25 +17,79 @@ typedef struct _tAppointment {
 } tAppointment;
 
 
+// Vaccination appointment of a person in a health center
+typedef struct _tPersonAppointment {
+    // Postal code of the health center
+    const char* cp;
+    // Timestamp of the vaccination appointment
+    tDateTime timestamp;
+    // Vaccine
+    tVaccine* vaccine;
+} tPersonAppointment;
+
+// Vaccination appointments of a person, sorted by timestamp
+typedef struct _tPersonAppointments {
+    // Document of the person
+    const char* document;
+    // Vaccination appointments
+    tPersonAppointment* elems;
+    // Number of elements
+    int count;
+    // Number of allocated elements
+    int capacity;
+} tPersonAppointments;
+
+// Index with the vaccination appointments of each person, in any health center
+typedef struct _tAppointmentIndex {
+    // Appointments of each person
+    tPersonAppointments* elems;
+    // Number of persons
+    int count;
+    // Number of allocated persons
+    int capacity;
+    // Open addressing hash index with the position of each person, by document
+    int* index;
+    // Number of slots of the index
+    int indexSize;
+} tAppointmentIndex;
+
 // Type that stores a list of vaccination appointments
 typedef struct _tAppointmentData {    
     // Vaccination appointments
     tAppointment* elems;
     // Number of elements
     int count;    
+    // Number of allocated elements
+    int capacity;
+    // Index where the appointments are also added, by person. If NULL, appointments are only stored on the list
+    tAppointmentIndex* index;
+    // Postal code of the health center of the list, stored on the index
+    const char* cp;
 } tAppointmentData;
 
 // Initializes a vaccination appointment data list
 void appointmentData_init(tAppointmentData* list);
 
+// Reserve memory to store at least the given number of appointments
+void appointmentData_reserve(tAppointmentData* list, int size);
+
 // Insert a new vaccination appointment
 void appointmentData_insert(tAppointmentData* list, tDateTime timestamp, tVaccine* vaccine, tPerson* person);
 
+// Insert a list of vaccination appointments at once. The list of appointments is sorted
+void appointmentData_insertBatch(tAppointmentData* list, tAppointment* appointments, int count);
+
+// Insert a list of vaccination appointments at once, without adding them to the index. The list of appointments is sorted
+void appointmentData_merge(tAppointmentData* list, tAppointment* appointments, int count);
+
+// Add a list of vaccination appointments of the list to its index, in the given order
+void appointmentData_indexBatch(tAppointmentData* list, const tAppointment* appointments, int count);
+
 // Remove a vaccination appointment
 void appointmentData_remove(tAppointmentData* list, tDateTime timestamp, tPerson* person);
 
 // Find the first instance of a vaccination appointment for given person
-int appointmentData_find(tAppointmentData list, tPerson* person, int start_pos);
+int appointmentData_find(const tAppointmentData* list, tPerson* person, int start_pos);
 
 // Release a vaccination appointment data list
 void appointmentData_free(tAppointmentData* list);
@@ -43,8 +99,35 @@ void appointment_init(tAppointment* appointment, tPerson* person, tVaccine* vacc
 void appointment_free(tAppointment* data);
 
 // Find the first instance of a vaccination appointment with bigger or equal timestamp
-int appointmentData_findTimestamp(tAppointmentData *list, tDateTime timestamp, int start_pos);
+int appointmentData_findTimestamp(const tAppointmentData *list, tDateTime timestamp, int start_pos);
 
 // Find the first instance of a vaccination appointment with bigger or equal timestamp by document
-int appointmentData_findDocument(tAppointmentData *list, tDateTime timestamp, const char* document, int start_pos);
+int appointmentData_findDocument(const tAppointmentData *list, tDateTime timestamp, const char* document, int start_pos);
+
+// Initialize an index of appointments by person
+void appointmentIndex_init(tAppointmentIndex* index);
+
+// Release an index of appointments by person
+void appointmentIndex_free(tAppointmentIndex* index);
+
+// Add a vaccination appointment of a person in a health center
+void appointmentIndex_add(tAppointmentIndex* index, const char* document, const char* cp, tDateTime timestamp, tVaccine* vaccine);
+
+// Remove a vaccination appointment of a person in a health center
+void appointmentIndex_remove(tAppointmentIndex* index, const char* document, const char* cp, tDateTime timestamp);
+
+// Find the vaccination appointments of a person. Returns NULL if the person never had appointments
+tPersonAppointments* appointmentIndex_find(const tAppointmentIndex* index, const char* document);
+
+// Write a vaccination appointment data list on a snapshot. Persons are written by position on the population and vaccines by id
+void appointmentData_save(const tAppointmentData* list, tSnapshotWriter* writer, const tPopulation* population);
+
+// Read an empty vaccination appointment data list from a snapshot, with the persons and vaccines of the application. Returns false if the snapshot is not valid
+bool appointmentData_load(tAppointmentData* list, tSnapshotReader* reader, const tPopulation* population, const tVaccineList* vaccines);
+
+// Write an index of appointments by person on a snapshot. The cp are written as positions on the table of strings
+void appointmentIndex_save(const tAppointmentIndex* index, tSnapshotWriter* writer, const tInternTable* strings);
+
+// Read an empty index of appointments by person from a snapshot. Returns false if the snapshot is not valid
+bool appointmentIndex_load(tAppointmentIndex* index, tSnapshotReader* reader, const tInternTable* strings, const tVaccineList* vaccines);
 #endif // __APPOINTMENT__H
\ No newline at end of file
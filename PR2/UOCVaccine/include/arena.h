@@ -0,0 +1,46 @@
+#ifndef __ARENA__H
+#define __ARENA__H
+#include <stddef.h>
+
+// Size of each block of memory of an arena
+#define ARENA_BLOCK_SIZE (1024 * 1024)
+
+// Alignment of the memory returned by an arena
+#define ARENA_ALIGNMENT 8
+
+// Block of memory of an arena. The data follows the header
+typedef struct _tArenaBlock {
+    struct _tArenaBlock* next;
+    size_t size;
+    size_t used;
+} tArenaBlock;
+
+// Bump allocator. All the memory is released at once
+typedef struct _tArena {
+    // Block used for new allocations, followed by the previous ones
+    tArenaBlock* first;
+    // Last block of the list, so other arenas can be merged in constant time
+    tArenaBlock* last;
+    // Number of bytes allocated to the blocks
+    size_t size;
+} tArena;
+
+// Initialize an arena
+void arena_init(tArena* arena);
+
+// Release all the memory of an arena
+void arena_free(tArena* arena);
+
+// Allocate size bytes on an arena, aligned to ARENA_ALIGNMENT
+void* arena_alloc(tArena* arena, size_t size);
+
+// Copy the first len characters of a string on an arena
+char* arena_strndup(tArena* arena, const char* str, int len);
+
+// Copy a string on an arena
+char* arena_strdup(tArena* arena, const char* str);
+
+// Move all the memory of the source arena to the destination. The source is left empty
+void arena_merge(tArena* destination, tArena* source);
+
+#endif // __ARENA__H
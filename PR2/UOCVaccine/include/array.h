@@ -0,0 +1,14 @@
+#ifndef __ARRAY__H
+#define __ARRAY__H
+#include <stddef.h>
+
+// Initial capacity of a dynamic array
+#define ARRAY_MIN_CAPACITY 8
+
+// Ensure an array can store at least size elements, doubling its capacity when it is full. Returns the (possibly moved) array
+void* array_grow(void* elems, int* capacity, int size, size_t elemSize);
+
+// Ensure an array can store at least size elements, allocating exactly the requested size. Returns the (possibly moved) array
+void* array_reserve(void* elems, int* capacity, int size, size_t elemSize);
+
+#endif // __ARRAY__H
@@ -3,6 +3,7 @@
 
 #include "stock.h"
 #include "appointment.h"
+#include "intern.h"
 
 // Health center
 typedef struct _tHealthCenter {    
@@ -11,16 +12,23 @@ typedef struct _tHealthCenter {
 	tAppointmentData appointments;
 } tHealthCenter;
 
-// Health center list node
-typedef struct _tHealthCenterNode {    
-    tHealthCenter elem;
-    struct _tHealthCenterNode *next;
-} tHealthCenterNode;
+// Number of centers stored on each block of a list of centers
+#define CENTER_BLOCK_SIZE 64
 
-// Health center list node
+// Health center list
 typedef struct _tHealthCenterList {    
-    tHealthCenterNode* first;
+    // Blocks of CENTER_BLOCK_SIZE centers, in insertion order. Blocks are never moved, so pointers to centers remain valid
+    tHealthCenter** blocks;
+    int numBlocks;
+    int blocksCapacity;
+    // Centers sorted by cp
+    tHealthCenter** sorted;
+    int capacity;
     int count;
+    // Table of unique strings storing the cp of the centers. If NULL, each center owns its cp
+    tInternTable* strings;
+    // Index of the appointments of each person, shared by all the centers. If NULL, appointments are only stored on each center
+    tAppointmentIndex* appointments;
 } tHealthCenterList;
 
 
@@ -40,7 +48,19 @@ void centerList_free(tHealthCenterList* list);
 void centerList_insert(tHealthCenterList* list, const char* cp);
 
 // Find a center
-tHealthCenter* centerList_find(tHealthCenterList* list, const char* cp);
+tHealthCenter* centerList_find(const tHealthCenterList* list, const char* cp);
+
+// Find the position of a center, sorted by cp. -1 if it does not exist
+int centerList_findPosition(const tHealthCenterList* list, const char* cp);
+
+// Get the center at a given position, sorted by cp
+tHealthCenter* centerList_get(const tHealthCenterList* list, int index);
+
+// Write a list of centers on a snapshot, with their stock and appointments. The cp are written as positions on the table of strings
+void centerList_save(const tHealthCenterList* list, tSnapshotWriter* writer, const tPopulation* population);
+
+// Read an empty list of centers from a snapshot, with the persons and vaccines of the application. Returns false if the snapshot is not valid
+bool centerList_load(tHealthCenterList* list, tSnapshotReader* reader, const tPopulation* population, const tVaccineList* vaccines);
 
 
 #endif // __CENTER_H__
\ No newline at end of file
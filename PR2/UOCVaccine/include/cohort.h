@@ -0,0 +1,71 @@
+#ifndef __COHORT__H
+#define __COHORT__H
+#include <stdbool.h>
+#include "date.h"
+#include "columns.h"
+
+// Number of rows of each word of a selection
+#define COHORT_WORD_BITS 64
+
+// Set of rows of a population, with a bit for each row
+typedef struct _tCohortSelection {
+    // Bits of the rows, the row i is the bit i % COHORT_WORD_BITS of the word i / COHORT_WORD_BITS
+    unsigned long long* words;
+    // Number of rows
+    int count;
+} tCohortSelection;
+
+// Conditions of the persons of a cohort. A person is selected if all the conditions hold
+typedef struct _tCohortQuery {
+    // Range of birthdays, as days since the epoch (date_toDays). The first day is included and the last one excluded
+    int bornFrom;
+    int bornBefore;
+    // Positions on the table of strings of the selected cp, with a bit for each position. If NULL, any cp is selected
+    unsigned long long* cps;
+    // Number of positions of the cp bitmap
+    int numCps;
+    // If true, only the persons without appointments are selected
+    bool withoutAppointment;
+} tCohortQuery;
+
+// Initialize an empty selection of count rows
+void cohortSelection_init(tCohortSelection* selection, int count);
+
+// Release a selection
+void cohortSelection_free(tCohortSelection* selection);
+
+// Add a row to a selection
+void cohortSelection_add(tCohortSelection* selection, int row);
+
+// Check if a row is on a selection
+bool cohortSelection_contains(const tCohortSelection* selection, int row);
+
+// Get the number of rows of a selection
+int cohortSelection_len(const tCohortSelection* selection);
+
+// Store the rows of a selection on an array with space for all of them, in increasing order. Returns the number of rows
+int cohortSelection_rows(const tCohortSelection* selection, int* rows);
+
+// Initialize a query selecting all the persons
+void cohortQuery_init(tCohortQuery* query);
+
+// Release a query
+void cohortQuery_free(tCohortQuery* query);
+
+// Select only the persons born on a date or later
+void cohortQuery_bornFrom(tCohortQuery* query, tDate date);
+
+// Select only the persons born before a date
+void cohortQuery_bornBefore(tCohortQuery* query, tDate date);
+
+// Select the persons of a cp. The first call restricts the query to the cp added
+void cohortQuery_addCp(tCohortQuery* query, const tInternTable* strings, const char* cp);
+
+// Select the persons of all the cp between first and last, both included, with their same number of digits
+void cohortQuery_addCpRange(tCohortQuery* query, const tInternTable* strings, const char* first, const char* last);
+
+// Select the persons of the columns matching the query. Booked has the rows of the persons with appointments. If NULL, no person has appointments.
+// The selection is initialized by this call
+void cohortQuery_select(const tCohortQuery* query, const tPopulationColumns* columns, const tCohortSelection* booked, tCohortSelection* selection);
+
+#endif // __COHORT__H
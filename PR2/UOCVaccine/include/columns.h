@@ -0,0 +1,77 @@
+#ifndef __COLUMNS__H
+#define __COLUMNS__H
+#include <stdbool.h>
+#include "person.h"
+#include "intern.h"
+
+// Minimum number of characters of each row of the document column, including the ending '\0'
+#define COLUMNS_DOCUMENT_WIDTH 16
+
+// Column of strings, stored one after another on a heap
+typedef struct _tStringColumn {
+    // Characters of the strings, each one ended by '\0'
+    char* heap;
+    int size;
+    // Number of allocated characters
+    int heapCapacity;
+    // Number of characters of the heap not used by any row
+    int dead;
+    // Position of the string of each row on the heap
+    int* offsets;
+} tStringColumn;
+
+// Population stored by columns. Each person is a row, on the same position as on the population
+typedef struct _tPopulationColumns {
+    int count;
+    // Number of allocated rows
+    int capacity;
+    // Documents, packed on rows of documentWidth characters padded with '\0'
+    char* documents;
+    int documentWidth;
+    // Position of the cp of each person on the table of strings
+    int* cps;
+    // Birthday of each person, as days since the epoch (date_toDays)
+    int* birthdays;
+    // Text fields. Changed strings are overwritten when they fit, and a heap is compacted when most of it is not used by any row
+    tStringColumn names;
+    tStringColumn surnames;
+    tStringColumn emails;
+    tStringColumn addresses;
+    // Table of unique strings storing the cp of the persons
+    tInternTable* strings;
+} tPopulationColumns;
+
+// Initialize empty columns, with the cp stored on a table of unique strings
+void populationColumns_init(tPopulationColumns* columns, tInternTable* strings);
+
+// Release the columns
+void populationColumns_free(tPopulationColumns* columns);
+
+// Get the number of rows
+int populationColumns_len(const tPopulationColumns* columns);
+
+// Reserve memory to store at least the given number of rows
+void populationColumns_reserve(tPopulationColumns* columns, int size);
+
+// Remove all the rows and add all the persons of a population, in the same order
+void populationColumns_build(tPopulationColumns* columns, const tPopulation* population);
+
+// Add a person as the last row
+void populationColumns_add(tPopulationColumns* columns, const tPerson* person);
+
+// Replace the data of the row at a given position by a person
+void populationColumns_set(tPopulationColumns* columns, int row, const tPerson* person);
+
+// Remove the row at a given position, moving the last row to it, as population_removeAt
+void populationColumns_removeAt(tPopulationColumns* columns, int row);
+
+// Get the document of a row. It points to the document column
+const char* populationColumns_document(const tPopulationColumns* columns, int row);
+
+// Get the person of a row. Its strings point to the columns, and are valid while they are not modified
+void populationColumns_get(const tPopulationColumns* columns, int row, tPerson* person);
+
+// Return the row of a person with the given document, scanning the document column. -1 if it does not exist
+int populationColumns_find(const tPopulationColumns* columns, const char* document);
+
+#endif // __COLUMNS__H
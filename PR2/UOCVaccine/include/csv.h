@@ -4,6 +4,9 @@
 #include <stdbool.h>
 #define CSV_SEPARATOR_CHAR ;
 
+// Maximum number of fields stored on a CSV view. Extra fields are only counted
+#define CSV_MAX_FIELDS 16
+
 // Store one entry from a CSV file
 typedef struct _tCSVEntry {
     int numFields;
@@ -15,9 +18,31 @@ typedef struct _tCSVEntry {
 typedef struct _tCSVData {
     tCSVEntry *entries;
     int count;
+    // Number of allocated entries
+    int capacity;
     bool isValid;
 } tCSVData;
 
+// A field of a CSV line. It points to the original text, which is not null terminated
+typedef struct _tCSVField {
+    const char* str;
+    int len;
+} tCSVField;
+
+// Store one entry from a CSV file as views over the original text, without copying it
+typedef struct _tCSVView {
+    tCSVField type;
+    int numFields;
+    tCSVField fields[CSV_MAX_FIELDS];
+} tCSVView;
+
+// Content of a CSV file mapped in memory
+typedef struct _tCSVFile {
+    const char* data;
+    long size;
+    bool mapped;
+} tCSVFile;
+
 // Initialize the tCSVData structure
 void csv_init(tCSVData* data);
 
@@ -27,6 +52,9 @@ void csv_initEntry(tCSVEntry* entry);
 // Parse the contents of a CSV file
 void csv_parse(tCSVData* data, const char* input, const char* type);
 
+// Reserve memory to store at least the given number of entries
+void csv_reserve(tCSVData* data, int size);
+
 // Add a new entry to the CSV Data
 void csv_addStrEntry(tCSVData* data, const char* entry, const char* type);
 
@@ -75,4 +103,28 @@ bool csv_equalsEntry(tCSVEntry entry1, tCSVEntry entry2);
 // Compare if two data objects are the same
 bool csv_equals(tCSVData data1, tCSVData data2);
 
+// Map the contents of a file in memory. Returns false if the file cannot be read
+bool csv_openFile(tCSVFile* file, const char* filename);
+
+// Release a file mapped in memory
+void csv_closeFile(tCSVFile* file);
+
+// Get the length of the line starting at pos, without end of line characters, and return the start of the next line
+const char* csv_nextLine(const char* pos, const char* end, int* len);
+
+// Parse the contents of a CSV line of len characters as views over the line
+void csv_parseView(tCSVView* view, const char* input, int len, const char* type);
+
+// Get a view over the contents of a CSV entry
+void csv_viewFromEntry(tCSVView* view, tCSVEntry* entry);
+
+// Compare a field with a string
+bool csv_fieldEquals(tCSVField field, const char* str);
+
+// Get a field as integer
+int csv_fieldAsInteger(tCSVField field);
+
+// Get a field as string. The value is copied to the provided buffer with provided maximum length
+void csv_fieldAsString(tCSVField field, char* buffer, int length);
+
 #endif
@@ -38,6 +38,12 @@ void dateTime_initTime(struct tm *std_time, tDateTime timestamp);
 // Add days to a given datetime
 void dateTime_addDay(tDateTime* dateTime, int days);
 
+// Get the number of minutes from 01/01/1970 00:00 to a given datetime
+int dateTime_toMinutes(tDateTime dateTime);
+
+// Get the datetime a given number of minutes after 01/01/1970 00:00
+void dateTime_fromMinutes(tDateTime* dateTime, int minutes);
+
 // Parse a tDate from string information
 void date_parse(tDate* date, const char* str);
 
@@ -47,4 +53,10 @@ int date_cmp(tDate date1, tDate date2);
 // Add days to a given date
 void date_addDay(tDate* date, int days);
 
+// Get the number of days from 01/01/1970 to a given date
+int date_toDays(tDate date);
+
+// Get the date a given number of days after 01/01/1970
+void date_fromDays(tDate* date, int days);
+
 #endif // __DATE_H__
\ No newline at end of file
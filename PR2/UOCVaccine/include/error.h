@@ -16,6 +16,8 @@ enum _tApiError
     E_HEALTH_CENTER_NOT_FOUND = -9, // Health Center not found
     E_LOT_NOT_FOUND = -10, // Vaccine lot not found
     E_NO_VACCINES = -11, // No vaccines to allocate appointments.
+    E_INVALID_SNAPSHOT = -12, // Invalid snapshot file
+    E_INVALID_LOG = -13, // Invalid log file
 };
 
 // Define an error type
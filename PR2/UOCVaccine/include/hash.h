@@ -0,0 +1,32 @@
+#ifndef __HASH__H
+#define __HASH__H
+#include <stdbool.h>
+
+// Value used to mark an empty slot on open addressing hash tables
+#define HASH_EMPTY_SLOT -1
+
+// Minimum number of slots of a hash table
+#define HASH_MIN_SIZE 16
+
+// Hash a string (FNV-1a)
+unsigned int hash_str(const char* str);
+
+// Hash the first len characters of a string (FNV-1a)
+unsigned int hash_strn(const char* str, int len);
+
+// Get the number of slots needed to store count elements with a load factor below 0.5
+int hash_tableSize(int count);
+
+// Find the slot of a key on an open addressing hash table with linear probing, starting on the slot given by its hash. Returns the slot of the element matching the key or the empty slot where it would be added.
+// equals checks if the element at a given position of data matches the key
+int hash_probe(const int* index, int size, unsigned int hash, bool (*equals)(const void* data, int pos, const void* key), const void* data, const void* key);
+
+// Release an open addressing hash table and allocate a new one able to store capacity elements, adding the count elements of data. Returns the new table and stores its number of slots on size.
+// The elements are the positions given by positions, or the first count positions if it is NULL. hash returns the hash of the element at a given position of data
+int* hash_rebuild(int* index, int* size, int capacity, const int* positions, int count, unsigned int (*hash)(const void* data, int pos), const void* data);
+
+// Remove the element of a slot of an open addressing hash table with linear probing. The next elements of its cluster are moved back, so they are still found.
+// hash returns the hash of the element at a given position of data
+void hash_removeSlot(int* index, int size, int slot, unsigned int (*hash)(const void* data, int pos), const void* data);
+
+#endif // __HASH__H
@@ -0,0 +1,56 @@
+#ifndef __INTERN__H
+#define __INTERN__H
+#include <stdbool.h>
+#include "arena.h"
+#include "snapshot.h"
+
+// Table of unique strings. Each distinct string is stored once, so interned strings can be compared by pointer
+typedef struct _tInternTable {
+    // Canonical strings, in insertion order
+    const char** strings;
+    int count;
+    // Number of allocated elements
+    int capacity;
+    // Open addressing hash index with the position of each string
+    int* index;
+    // Number of slots of the index
+    int indexSize;
+    // Memory of the strings added to the table. Strings read from a snapshot remain on the memory of the snapshot
+    tArena arena;
+} tInternTable;
+
+// Initialize the table
+void internTable_init(tInternTable* table);
+
+// Release the table and all its strings
+void internTable_free(tInternTable* table);
+
+// Get the number of strings of the table
+int internTable_len(const tInternTable* table);
+
+// Get the canonical copy of a string, adding it to the table if it is not found
+const char* internTable_add(tInternTable* table, const char* str);
+
+// Get the canonical copy of the first len characters of a string, adding it to the table if it is not found
+const char* internTable_addn(tInternTable* table, const char* str, int len);
+
+// Get the canonical copy of a string. NULL if it is not in the table
+const char* internTable_find(const tInternTable* table, const char* str);
+
+// Check if a string is the canonical copy of the table
+bool internTable_isCanonical(const tInternTable* table, const char* str);
+
+// Get the position of a string on the table, in insertion order. -1 if it is not in the table
+int internTable_findId(const tInternTable* table, const char* str);
+
+// Get the string at a given position of the table, in insertion order. NULL if the position is not valid
+const char* internTable_get(const tInternTable* table, int id);
+
+// Write the table on a snapshot
+void internTable_save(const tInternTable* table, tSnapshotWriter* writer);
+
+// Read an empty table from a snapshot. The strings are not copied, so they must remain valid while the table is used, as after snapshot_copyStrings.
+// Returns false if the snapshot is not valid
+bool internTable_load(tInternTable* table, tSnapshotReader* reader);
+
+#endif // __INTERN__H
@@ -2,6 +2,9 @@
 #define __PERSON_H__
 #include "csv.h"
 #include "date.h"
+#include "arena.h"
+#include "intern.h"
+#include "snapshot.h"
 
 typedef struct _tPerson {
     char* document;
@@ -16,6 +19,16 @@ typedef struct _tPerson {
 typedef struct _tPopulation {
     tPerson* elems;
     int count;
+    // Number of allocated elements
+    int capacity;
+    // Open addressing hash index with the position of each person, by document
+    int* index;
+    // Number of slots of the index
+    int indexSize;
+    // Arena storing the strings of the persons. If NULL, each person owns its strings
+    tArena* arena;
+    // Table of unique strings storing the cp of the persons. If NULL, each person stores its own cp
+    tInternTable* strings;
 } tPopulation;
 
 // Initialize the population data
@@ -33,22 +46,52 @@ void population_free(tPopulation* data);
 // Parse input from CSVEntry
 void person_parse(tPerson* data, tCSVEntry entry);
 
+// Parse input from a CSV view, copying the fields directly from the viewed text. If arena is not NULL, the strings are allocated on it
+void person_parseView(tPerson* data, const tCSVView* view, tArena* arena);
+
+// Reserve memory to store at least the given number of persons
+void population_reserve(tPopulation* data, int size);
+
 // Add a new person
 void population_add(tPopulation* data, tPerson person);
 
+// Add a new person from a CSV view. Returns false if a person with the same document already exists
+bool population_addView(tPopulation* data, const tCSVView* view);
+
+// Add a new person taking the ownership of its data, which must be allocated on the population arena if it has one. Returns false, leaving the person untouched, if a person with the same document already exists
+bool population_take(tPopulation* data, tPerson* person);
+
 // Remove a person
 void population_del(tPopulation* data, const char *document);
 
+// Check if a person has the same data as a CSV view of a person
+bool person_equalsView(const tPerson* data, const tCSVView* view);
+
+// Replace the data of the person at a given position by a CSV view of a person with the same document. The document string is kept
+void population_updateView(tPopulation* data, int pos, const tCSVView* view);
+
+// Remove the person at a given position, moving the last person to it. Other persons keep their position, so the index is updated in place
+void population_removeAt(tPopulation* data, int pos);
+
 // Return the position of a person with provided document. -1 if it does not exist
-int population_find(tPopulation data, const char* document);
+int population_find(const tPopulation* data, const char* document);
+
+// Return the position of a person with the document given by its first len characters. -1 if it does not exist
+int population_findn(const tPopulation* data, const char* document, int len);
 
 // Print the person data
-void population_print(tPopulation data);
+void population_print(const tPopulation* data);
 
 // Copy the data from the source to destination
 void person_cpy(tPerson* destination, tPerson source);
 
 // Return population lenght
-int population_len(tPopulation data);
+int population_len(const tPopulation* data);
+
+// Write the population on a snapshot. The cp of the persons are written as positions on the table of strings
+void population_save(const tPopulation* data, tSnapshotWriter* writer);
+
+// Read an empty population from a snapshot, with the strings copied on the snapshot arena. Returns false if the snapshot is not valid
+bool population_load(tPopulation* data, tSnapshotReader* reader);
 
 #endif
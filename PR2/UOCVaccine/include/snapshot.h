@@ -0,0 +1,96 @@
+#ifndef __SNAPSHOT__H
+#define __SNAPSHOT__H
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "csv.h"
+#include "arena.h"
+
+// Identifier at the start of a snapshot file
+#define SNAPSHOT_MAGIC "UOCVSNAP"
+
+// Version of the snapshot format. Any change on the records or on the hash functions of the indexes needs a new version
+#define SNAPSHOT_VERSION 2
+
+// Alignment of the arrays of a snapshot, so they can be read directly from the mapped file
+#define SNAPSHOT_ALIGNMENT 8
+
+// Header of a snapshot file
+typedef struct _tSnapshotHeader {
+    char magic[8];
+    int version;
+    // Snapshots are written with the byte order of the machine. It is checked when they are read
+    int byteOrder;
+    // Position and size of the strings, stored after all the records
+    long long stringsOffset;
+    long long stringsSize;
+} tSnapshotHeader;
+
+// Writer of a snapshot file. Records are written in order, and the strings they reference are kept until the end
+typedef struct _tSnapshotWriter {
+    FILE* fout;
+    // Number of bytes written
+    long long pos;
+    // Strings referenced by the records, by offset
+    char* strings;
+    int stringsSize;
+    int stringsCapacity;
+    // True if any write failed
+    bool failed;
+} tSnapshotWriter;
+
+// Reader of a snapshot file mapped in memory. Records are read in the order they were written
+typedef struct _tSnapshotReader {
+    tCSVFile file;
+    // Position of the next record
+    long long pos;
+    // Strings referenced by the records, by offset
+    const char* strings;
+    int stringsSize;
+    // True if the file is not a valid snapshot or any read went out of the file
+    bool failed;
+} tSnapshotReader;
+
+// Create a snapshot file. Returns false if the file cannot be created
+bool snapshot_openWriter(tSnapshotWriter* writer, const char* filename);
+
+// Write the strings and the header and close a snapshot file. Returns false if any write failed
+bool snapshot_closeWriter(tSnapshotWriter* writer);
+
+// Write an integer
+void snapshot_writeInt(tSnapshotWriter* writer, int value);
+
+// Write an array of size bytes, aligned to SNAPSHOT_ALIGNMENT
+void snapshot_write(tSnapshotWriter* writer, const void* data, size_t size);
+
+// Store a string and get its offset, used to reference it from the records
+int snapshot_addString(tSnapshotWriter* writer, const char* str);
+
+// Map a snapshot file and check its header. Returns false if the file cannot be read or, marking the reader as failed, if it is not a valid snapshot
+bool snapshot_openReader(tSnapshotReader* reader, const char* filename);
+
+// Release a snapshot file mapped in memory
+void snapshot_closeReader(tSnapshotReader* reader);
+
+// Read an integer. Returns 0 if the file has no more data
+int snapshot_readInt(tSnapshotReader* reader);
+
+// Read an array of size bytes written with snapshot_write. Returns NULL if the file has not enough data
+const void* snapshot_read(tSnapshotReader* reader, size_t size);
+
+// Read an array of count elements of elemSize bytes. Returns NULL if the count is not valid or the file has not enough data
+const void* snapshot_readArray(tSnapshotReader* reader, int count, size_t elemSize);
+
+// Get the string with a given offset. Returns NULL, marking the reader as failed, if the offset is not valid
+const char* snapshot_getString(tSnapshotReader* reader, int offset);
+
+// Write a hash index of positions
+void snapshot_writeIndex(tSnapshotWriter* writer, const int* index, int indexSize);
+
+// Read a hash index written with snapshot_writeIndex, with positions below limit. Returns a copy of the index, or NULL if it is empty or not valid
+int* snapshot_readIndex(tSnapshotReader* reader, int limit, int* indexSize);
+
+// Copy the strings of the snapshot on an arena, so they remain valid once the reader is closed
+void snapshot_copyStrings(tSnapshotReader* reader, tArena* arena);
+
+#endif // __SNAPSHOT__H
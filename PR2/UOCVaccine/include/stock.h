@@ -3,6 +3,10 @@
 
 #include "vaccine.h"
 #include "date.h"
+#include "snapshot.h"
+
+// Minimum number of days allocated for a stock
+#define STOCK_MIN_DAYS 32
 
 // Vaccine stock
 typedef struct _tVaccineStock {
@@ -10,24 +14,24 @@ typedef struct _tVaccineStock {
     int doses;    
 } tVaccineStock;
 
-// Node of a list of vaccine stocks
-typedef struct _tVaccineStockNode {    
-    tVaccineStock elem;
-    struct _tVaccineStockNode* next;
-} tVaccineStockNode;
-
-// Daily vaccine stock
-typedef struct _tVaccineDailyStock {    
-    tDate day;
-    tVaccineStockNode* first;
-    int count;
-    struct _tVaccineDailyStock* next;
-} tVaccineDailyStock;
+// Daily doses of a vaccine
+typedef struct _tVaccineStockColumn {
+    tVaccine* vaccine;
+    // Fenwick tree with the change of doses of each day, indexed by day number. The doses of a day are the sum of the changes up to it
+    int* deltas;
+} tVaccineStockColumn;
 
 // Stock data
 typedef struct _tVaccineStockData {        
-    tVaccineDailyStock* first;
-    tVaccineDailyStock* last;
+    // Doses of each vaccine, sorted by vaccine name
+    tVaccineStockColumn* columns;
+    int numColumns;
+    int columnCapacity;
+    // Day number (see date_toDays) of the first allocated day, and number of allocated days
+    int base;
+    int capacity;
+    // Day number of the first day in the stock, and number of days
+    int firstDay;
     int count;
 } tVaccineStockData;
 
@@ -45,7 +49,13 @@ int stockList_getDoses(tVaccineStockData* list, tDate date, tVaccine* vaccine);
 void stockList_free(tVaccineStockData* list);
 
 // Print stock list
-void stockList_print(tVaccineStockData list);
+void stockList_print(const tVaccineStockData* list);
+
+// Write a stock on a snapshot. The vaccines are written by id
+void stockList_save(const tVaccineStockData* list, tSnapshotWriter* writer);
+
+// Read an empty stock from a snapshot, with the vaccines of the given list. Returns false if the snapshot is not valid
+bool stockList_load(tVaccineStockData* list, tSnapshotReader* reader, const tVaccineList* vaccines);
 
 
 ///// AUX Methods: Top-down design //////
@@ -53,32 +63,20 @@ void stockList_print(tVaccineStockData list);
 // Initialize a stock element
 void stock_init(tVaccineStock* stock, tVaccine* vaccine, int doses);
 
-// Get the number of doses for a given vaccine
-int stockNode_getDoses(tVaccineStockNode* stock, tVaccine* vaccine);
-
-// Initialize a stock node element
-void stockNode_init(tVaccineStockNode* node, tVaccine* vaccine, int doses);
-
-// Initialize a daily stock element
-void dailyStock_init(tVaccineDailyStock* stock, tDate date);
-
-// Remove a daily stock element data
-void dailyStock_free(tVaccineDailyStock* stock);
-
-// Find a vaccine node for a given daily stock
-tVaccineStockNode* dailyStock_find(tVaccineDailyStock* stock, tVaccine* vaccine);
+// Find the position of the stock for a given date. Returns -1 if the date is not in the stock
+int stockList_find(tVaccineStockData* list, tDate date);
 
-// Remove all vaccine entries with no doses
-void dailyStock_purge(tVaccineDailyStock* stock);
+// Get the date of the stock at a given position
+tDate stockList_getDate(const tVaccineStockData* list, int pos);
 
-// Update the number of doses for a given vaccine
-void dailyStock_update(tVaccineDailyStock* stock, tVaccine* vaccine, int doses);
+// Get the number of vaccines with doses on the stock at a given position
+int stockList_dayCount(tVaccineStockData* list, int pos);
 
-// Copy the contents from source to destination
-void dailyStock_copy(tVaccineDailyStock* src, tVaccineDailyStock* dst);
+// Get the n-th vaccine with doses on the stock at a given position, sorted by vaccine name
+tVaccineStock stockList_dayStock(tVaccineStockData* list, int pos, int n);
 
-// Find the stock for a given date
-tVaccineDailyStock* stockList_find(tVaccineStockData* list, tDate date);
+// Update the number of doses for a given vaccine on the stock at a given position
+void stockList_addDoses(tVaccineStockData* list, int pos, tVaccine* vaccine, int doses);
 
 // Extend the list adding empty day cells on left
 void stockList_expandLeft(tVaccineStockData* list, tDate date);
@@ -89,4 +87,4 @@ void stockList_expandRight(tVaccineStockData* list, tDate date);
 // Remove entries with no data on the start and end of the list
 void stockList_purge(tVaccineStockData* list);
 
-#endif // __STOCK__H
\ No newline at end of file
+#endif // __STOCK__H
@@ -3,24 +3,41 @@
 
 #include "csv.h"
 #include "date.h"
+#include "arena.h"
+#include "intern.h"
+#include "snapshot.h"
 
 // Vaccine data
 typedef struct _tVaccine {
     char *name;
     int required;
     int days;
+    // Identifier of the vaccine on its list of vaccines. -1 if it is not on a list
+    int id;
 } tVaccine;
 
-// Node of a list of vaccines
-typedef struct _tVaccineNode {    
-    tVaccine vaccine;
-    struct _tVaccineNode *next;
-} tVaccineNode;
+// Number of vaccines stored on each block of a list of vaccines
+#define VACCINE_BLOCK_SIZE 16
 
 // List of vaccines
 typedef struct _tVaccineList {    
-    tVaccineNode* first;
+    // Blocks of VACCINE_BLOCK_SIZE vaccines, indexed by id. Blocks are never moved, so pointers to vaccines remain valid
+    tVaccine** blocks;
+    int numBlocks;
+    int blocksCapacity;
+    // Number of assigned ids. The ids of removed vaccines are not reused
+    int numIds;
+    // Ids of the vaccines sorted by name
+    int* sorted;
+    int capacity;
     int count;
+    // Hash index from the name of a vaccine to its id, with open addressing
+    int* index;
+    int indexSize;
+    // Arena storing the names of the vaccines. If NULL, each vaccine owns its name
+    tArena* arena;
+    // Table of unique strings storing the names of the vaccines. If NULL, each vaccine stores its own name
+    tInternTable* strings;
 } tVaccineList;
 
 // Vaccine lot data
@@ -31,10 +48,31 @@ typedef struct _tVaccineLot {
     int doses;
 } tVaccineLot;
 
+// Lots of a center
+typedef struct _tVaccineLotCenter {
+    // Position of the lots on the lots data, sorted by timestamp
+    int* lots;
+    int count;
+    int capacity;
+} tVaccineLotCenter;
+
 // Table of lots
 typedef struct _tVaccineLotData {    
     tVaccineLot* elems;
     int count;
+    // Number of allocated elements
+    int capacity;
+    // Hash index from the cp, vaccine and timestamp of a lot to its position, with open addressing
+    int* index;
+    int indexSize;
+    // Lots of each center, with the centers sorted by cp
+    tVaccineLotCenter* centers;
+    int numCenters;
+    int centersCapacity;
+    // Arena storing the cp of the lots. If NULL, each lot owns its cp
+    tArena* arena;
+    // Table of unique strings storing the cp of the lots. If NULL, each lot stores its own cp
+    tInternTable* strings;
 } tVaccineLotData;
 
 
@@ -60,6 +98,9 @@ void vaccineLot_cpy(tVaccineLot* destination, tVaccineLot source);
 // Parse input from CSVEntry
 void vaccineLot_parse(tVaccine* vaccine, tVaccineLot* lot, tCSVEntry entry);
 
+// Parse input from a CSV view without allocating memory. The cp and vaccine name are copied to the provided buffers with provided maximum length
+void vaccineLot_parseView(tVaccine* vaccine, tVaccineLot* lot, const tCSVView* view, char* cp, char* name, int length);
+
 // Initialize the vaccine's list
 void vaccineList_init(tVaccineList* list);
 
@@ -67,10 +108,19 @@ void vaccineList_init(tVaccineList* list);
 void vaccineList_free(tVaccineList* list);
 
 // Get the number of vaccines
-int vaccineList_len(tVaccineList list);
+int vaccineList_len(const tVaccineList* list);
 
 // Find a vaccine in the list of vaccines
-tVaccine* vaccineList_find(tVaccineList list, const char* name);
+tVaccine* vaccineList_find(const tVaccineList* list, const char* name);
+
+// Find the id of a vaccine in the list of vaccines. -1 if it does not exist
+int vaccineList_findId(const tVaccineList* list, const char* name);
+
+// Get the vaccine with a given id. NULL if it does not exist or it was removed
+tVaccine* vaccineList_getById(const tVaccineList* list, int id);
+
+// Get the vaccine at a given position, sorted by name
+tVaccine* vaccineList_get(const tVaccineList* list, int index);
 
 // Add a new vaccine
 void vaccineList_insert(tVaccineList* list, tVaccine vaccine);
@@ -78,6 +128,12 @@ void vaccineList_insert(tVaccineList* list, tVaccine vaccine);
 // Remove a vaccine
 void vaccineList_del(tVaccineList* list, const char* vaccine);
 
+// Write the list of vaccines on a snapshot. The names are written as positions on the table of strings
+void vaccineList_save(const tVaccineList* list, tSnapshotWriter* writer);
+
+// Read an empty list of vaccines from a snapshot. Returns false if the snapshot is not valid
+bool vaccineList_load(tVaccineList* list, tSnapshotReader* reader);
+
 // Initialize the vaccine lots data
 void vaccineLotData_init(tVaccineLotData* data);
 
@@ -85,15 +141,30 @@ void vaccineLotData_init(tVaccineLotData* data);
 void vaccineLotData_free(tVaccineLotData* data);
 
 // Get the number of lots
-int vaccineLotData_len(tVaccineLotData data);
+int vaccineLotData_len(const tVaccineLotData* data);
+
+// Reserve memory to store at least the given number of lots
+void vaccineLotData_reserve(tVaccineLotData* data, int size);
 
 // Add a new vaccine lot
 void vaccineLotData_add(tVaccineLotData* data, tVaccineLot lot);
 
-// Remove vaccines from a lot
+// Remove vaccines from a lot. A lot without doses is removed as vaccineLotData_removeAt, moving the last lot to its position
 void vaccineLotData_del(tVaccineLotData* data, const char* cp, const char* vaccine, tDateTime timestamp, int doses);
 
+// Remove the lot at a given position, moving the last lot to it. Other lots keep their position, so the indexes are updated in place
+void vaccineLotData_removeAt(tVaccineLotData* data, int idx);
+
 // Return the position of a vaccine lot entry with provided information. -1 if it does not exist
-int vaccineLotData_find(tVaccineLotData data, const char* cp, const char* vaccine, tDateTime timestamp);
+int vaccineLotData_find(const tVaccineLotData* data, const char* cp, const char* vaccine, tDateTime timestamp);
+
+// Find the lots of a center with a date between from and to, both included. Returns the lots of the center and the range [first, last) of them in the window. NULL if the center has no lots
+tVaccineLotCenter* vaccineLotData_findRange(const tVaccineLotData* data, const char* cp, tDate from, tDate to, int* first, int* last);
+
+// Write the vaccine lots on a snapshot. The cp are written as positions on the table of strings and the vaccines by id
+void vaccineLotData_save(const tVaccineLotData* data, tSnapshotWriter* writer);
+
+// Read empty vaccine lots from a snapshot, with the vaccines of the given list. Returns false if the snapshot is not valid
+bool vaccineLotData_load(tVaccineLotData* data, tSnapshotReader* reader, const tVaccineList* vaccines);
 
 #endif // __VACCINE__H
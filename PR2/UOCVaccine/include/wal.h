@@ -0,0 +1,98 @@
+#ifndef __WAL__H
+#define __WAL__H
+#include <stdio.h>
+#include <stdbool.h>
+#include "csv.h"
+
+// Identifier at the start of a log file
+#define WAL_MAGIC "UOCVWLOG"
+
+// Version of the log format
+#define WAL_VERSION 1
+
+// Default number of records written to the disk with a single sync
+#define WAL_GROUP_SIZE 64
+
+// Header of a log file
+typedef struct _tWalHeader {
+    char magic[8];
+    int version;
+    // Logs are written with the byte order of the machine. It is checked when they are read
+    int byteOrder;
+} tWalHeader;
+
+// Header of each record of a log file, followed by size bytes of data
+typedef struct _tWalRecordHeader {
+    // Checksum of the rest of the header and the data, to detect records not completely written
+    unsigned int checksum;
+    int size;
+    // Sequence number of the record
+    long long lsn;
+    int type;
+    int reserved;
+} tWalRecordHeader;
+
+// A record read from a log file. The data points to the mapped file
+typedef struct _tWalRecord {
+    long long lsn;
+    int type;
+    const char* data;
+    int size;
+} tWalRecord;
+
+// Append-only log file. Records are kept in memory and written to the disk in groups, with a single sync for all of them
+typedef struct _tWal {
+    FILE* fout;
+    // Records not yet written to the file
+    char* buffer;
+    int size;
+    int capacity;
+    // Position of the record being appended on the buffer. -1 if there is none
+    int record;
+    // Number of records not yet synced, and number of records synced at once
+    int pending;
+    int groupSize;
+    // Number of syncs of the file
+    long long syncs;
+    // True if any write failed
+    bool failed;
+} tWal;
+
+// Reader of a log file mapped in memory
+typedef struct _tWalReader {
+    tCSVFile file;
+    // Position of the next record. Once all the valid records are read, it is the size of the valid part of the log
+    long long pos;
+    // True if the file is not a valid log
+    bool failed;
+} tWalReader;
+
+// Open a log to append records after its first size bytes, removing the rest. If size is not positive, a new empty log is created.
+// Records are synced in groups of groupSize records. Returns false if the file cannot be opened
+bool wal_open(tWal* wal, const char* filename, long long size, int groupSize);
+
+// Sync the pending records and close a log. Returns false if any write failed
+bool wal_close(tWal* wal);
+
+// Start a new record
+void wal_begin(tWal* wal, long long lsn, int type);
+
+// Add data to the current record
+void wal_write(tWal* wal, const void* data, int size);
+
+// End the current record. The log is synced when groupSize records are pending. Returns false if any write failed
+bool wal_end(tWal* wal);
+
+// Write the pending records to the file and wait until they are on the disk. Returns false if any write failed
+bool wal_sync(tWal* wal);
+
+// Map a log file and check its header. Returns false if the file cannot be read or, marking the reader as failed, if it is not a valid log. A log without a complete header has no records
+bool wal_openReader(tWalReader* reader, const char* filename);
+
+// Release a log file mapped in memory
+void wal_closeReader(tWalReader* reader);
+
+// Read the next record. Returns false at the end of the log or on the first record not completely written
+bool wal_next(tWalReader* reader, tWalRecord* record);
+
+#endif // __WAL__H
@@ -1,69 +1,602 @@
+// Writer preference of the shared data lock is a GNU extension
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
 #include <stdio.h>
 #include <assert.h>
 #include "csv.h"
 #include "api.h"
 
 #include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
 #include "person.h"
 #include "vaccine.h"
 #include "appointment.h"
+#include "array.h"
 
 
 #define FILE_READ_BUFFER_SIZE 2048
 
+// Maximum number of bytes of a file parsed by each thread on every round of a parallel load
+#define PARALLEL_BLOCK_SIZE (4 * 1024 * 1024)
+
+// Number of days, starting on the requested one, searched for an available vaccination appointment
+#define API_BOOKING_DAYS 12
+
+// Types of the records of the log of changes
+#define API_LOG_ENTRY 1
+#define API_LOG_APPOINTMENT 2
+#define API_LOG_BOOKING 3
+#define API_LOG_REMOVE 4
+#define API_LOG_UPDATE 5
+#define API_LOG_DELETE 6
+#define API_LOG_RESET 7
+
+// Entries of a file parsed by a worker thread
+#define API_PARSED_NONE 0
+#define API_PARSED_PERSON 1
+#define API_PARSED_LOT 2
+
+// Line of a file prepared by a worker thread
+typedef struct _tApiParsedLine {
+    const char* line;
+    int len;
+    // Fields of the line, split by the worker
+    tCSVView view;
+    // Entry already parsed by the worker, if the line is a well formed person or lot
+    int parsed;
+    tPerson person;
+    // Lot and its vaccine, with their strings on the block arena
+    tVaccine vaccine;
+    tVaccineLot lot;
+} tApiParsedLine;
+
+// Block of a file parsed by a worker thread
+typedef struct _tApiParseBlock {
+    const char* start;
+    const char* end;
+    tApiParsedLine* lines;
+    int count;
+    int capacity;
+    // Arena storing the strings of the parsed persons
+    tArena arena;
+    // True if the block is being parsed by its own thread
+    bool threaded;
+} tApiParseBlock;
+
+// Bookings of a list of persons in a health center
+typedef struct _tApiBooking {
+    tHealthCenter* center;
+    // Day of the search, from the requested one, and its timestamp
+    int day;
+    tDateTime timestamp;
+    // Appointments booked, in booking order, not yet stored on the center
+    tAppointmentData pending;
+    // Persons already booked, by position on the population
+    bool* booked;
+} tApiBooking;
+
+// Booking requests of a health center, processed by a single worker thread
+typedef struct _tApiCenterRequests {
+    tApiBooking booking;
+    // Positions of the requests of the center, in request order
+    int* requests;
+    int count;
+    int capacity;
+    // Number of pending appointments already added to the index of persons
+    int indexed;
+} tApiCenterRequests;
+
+// Health centers booked by a worker thread
+typedef struct _tApiScheduleWorker {
+    tApiData* data;
+    const char** documents;
+    tApiError* results;
+    // Requests of all the centers. The worker books the centers first, first + step, ...
+    tApiCenterRequests* centers;
+    int numCenters;
+    int first;
+    int step;
+    // Persons booked on the current center, by position on the population
+    bool* booked;
+    // True if the worker runs on its own thread
+    bool threaded;
+} tApiScheduleWorker;
+
+// Synchronization of the data with a new version of a feed
+typedef struct _tApiSync {
+    // Number of persons and lots before the synchronization. Rows added by it are never removed
+    int numPersons;
+    int numLots;
+    // Persons and lots found on the feed, by position
+    bool* persons;
+    bool* lots;
+    // Doses of the lots on the feed, by position
+    int* doses;
+    // Positions expected for the next person and lot. New versions usually keep the order of the rows, so they are checked before the indexes
+    int nextPerson;
+    int nextLot;
+    tApiSyncStats stats;
+} tApiSync;
+
 // Get the API version information
 const char* api_version() {
     return "UOC PP 20212";
 }
 
+// Count the PERSON and VACCINE_LOT lines of a mapped file
+static void api_countEntries(tCSVFile* file, int* numPersons, int* numLots) {
+    const char *pos, *end;
+    int len;
+    
+    *numPersons = 0;
+    *numLots = 0;
+    
+    // Check the first character of each line
+    pos = file->data;
+    end = file->data + file->size;
+    while (pos < end) {
+        if (*pos == 'P') {
+            (*numPersons)++;
+        } else if (*pos == 'V') {
+            (*numLots)++;
+        }
+        pos = csv_nextLine(pos, end, &len);
+    }
+}
+
+// Update the persons of the appointments after the population has been moved to another memory block
+static void api_rebasePersons(tApiData* data, const tPerson* elems) {
+    tAppointmentData* appointments;
+    int i, j;
+    
+    if (elems == NULL || elems == data->population.elems) {
+        return;
+    }
+    
+    for (i = 0; i < data->centers.count; i++) {
+        appointments = &(centerList_get(&(data->centers), i)->appointments);
+        for (j = 0; j < appointments->count; j++) {
+            appointments->elems[j].person = data->population.elems + (appointments->elems[j].person - elems);
+        }
+    }
+}
+
+// Add the persons added to the population to the end of its columns
+static void api_appendColumns(tApiData* data) {
+    if (data->columns == NULL) {
+        return;
+    }
+    
+    while (data->columns->count < data->population.count) {
+        populationColumns_add(data->columns, &(data->population.elems[data->columns->count]));
+    }
+}
+
+// Start a record of a change on the log of the data. Returns false if the data has no log
+static bool api_beginLog(tApiData* data, int type) {
+    if (data->log == NULL) {
+        return false;
+    }
+    
+    data->lsn++;
+    wal_begin(data->log, data->lsn, type);
+    return true;
+}
+
+// Remove all the data. The log of the data is kept, and the reset is logged so it is also replayed on recovery.
+// The columns of the population are also kept, without rows, so they get the persons added after the reset
+static tApiError api_resetData(tApiData* data) {
+    tApiError error;
+    tPopulationColumns* columns;
+    tWal* log;
+    long long lsn;
+    
+    log = data->log;
+    lsn = data->lsn;
+    columns = data->columns;
+    error = api_freeData(data);
+    if (error == E_SUCCESS) {
+        error = api_initData(data);
+    }
+    // Without a log, the sequence numbers start again as on new data
+    data->log = log;
+    if (log != NULL) {
+        data->lsn = lsn;
+    }
+    
+    // The ids of the cp on the columns are from the released table of strings, so no row is kept
+    data->columns = columns;
+    if (columns != NULL) {
+        populationColumns_free(columns);
+    }
+    
+    if (error == E_SUCCESS && api_beginLog(data, API_LOG_RESET)) {
+        wal_end(data->log);
+    }
+    
+    return error;
+}
+
+// Reset the data if requested, map the file and reserve the memory for all its entries
+static tApiError api_openFile(tApiData* data, const char* filename, bool reset, tCSVFile* file) {
+    tApiError error;
+    int numPersons;
+    int numLots;
+    tPerson* elems;
+    
+    // Reset current data    
+    if (reset) {
+        // Remove previous information, keeping the log
+        error = api_resetData(data);
+        if (error != E_SUCCESS) {
+            return error;
+        }
+    }
+
+    // Map the input file in memory
+    if (!csv_openFile(file, filename)) {
+        return E_FILE_NOT_FOUND;
+    }
+    
+    // Reserve the memory for all the entries at once
+    api_countEntries(file, &numPersons, &numLots);
+    elems = data->population.elems;
+    population_reserve(&(data->population), data->population.count + numPersons);
+    api_rebasePersons(data, elems);
+    vaccineLotData_reserve(&(data->vaccineLots), data->vaccineLots.count + numLots);
+    
+    return E_SUCCESS;
+}
+
 // Load data from a CSV file. If reset is true, remove previous data
 tApiError api_loadData(tApiData* data, const char* filename, bool reset) {
     tApiError error;
-    FILE *fin;    
-    char buffer[FILE_READ_BUFFER_SIZE];
-    tCSVEntry entry;
+    tCSVFile file;
+    tCSVView view;
+    const char *pos, *next, *end;
+    int len;
     
     // Check input data
     assert( data != NULL );
     assert(filename != NULL);
     
-    // Reset current data    
-    if (reset) {
-        // Remove previous information
-        error = api_freeData(data);
-        if (error != E_SUCCESS) {
-            return error;
+    error = api_openFile(data, filename, reset, &file);
+    if (error != E_SUCCESS) {
+        return error;
+    }
+    
+    // Read file line by line, parsing the fields in place
+    pos = file.data;
+    end = file.data + file.size;
+    while (pos < end && error == E_SUCCESS) {
+        next = csv_nextLine(pos, end, &len);
+        
+        // Skip empty lines
+        if (len > 0) {
+            csv_parseView(&view, pos, len, NULL);
+            // Add this new entry to the api Data
+            error = api_addDataView(data, &view);
         }
+        pos = next;
+    }
+    
+    csv_closeFile(&file);
+    
+    return error;
+}
+
+// Split the lines of a block and parse the persons and lots. Runs on a worker thread, without accessing the shared data
+static void* api_parseBlock(void* arg) {
+    tApiParseBlock* block;
+    tApiParsedLine* line;
+    const char *pos, *next;
+    char cp[512];
+    char name[512];
+    int len;
+    
+    block = (tApiParseBlock*) arg;
+    block->count = 0;
+    
+    pos = block->start;
+    while (pos < block->end) {
+        next = csv_nextLine(pos, block->end, &len);
         
-        // Initialize the data
-        error = api_initData(data);
-        if (error != E_SUCCESS) {
-            return error;
+        // Skip empty lines
+        if (len > 0) {
+            block->lines = (tApiParsedLine*) array_grow(block->lines, &(block->capacity), block->count + 1, sizeof(tApiParsedLine));
+            line = &(block->lines[block->count]);
+            line->line = pos;
+            line->len = len;
+            line->parsed = API_PARSED_NONE;
+            
+            // Persons and lots are parsed here. Other lines are added from their view, and report their errors when committed
+            csv_parseView(&(line->view), pos, len, NULL);
+            if (csv_fieldEquals(line->view.type, "PERSON") && line->view.numFields == 7) {
+                person_init(&(line->person));
+                person_parseView(&(line->person), &(line->view), &(block->arena));
+                line->parsed = API_PARSED_PERSON;
+            } else if (csv_fieldEquals(line->view.type, "VACCINE_LOT") && line->view.numFields == 7) {
+                vaccineLot_parseView(&(line->vaccine), &(line->lot), &(line->view), cp, name, 512);
+                line->lot.cp = arena_strdup(&(block->arena), cp);
+                line->vaccine.name = arena_strdup(&(block->arena), name);
+                line->parsed = API_PARSED_LOT;
+            }
+            block->count ++;
         }
+        pos = next;
     }
+    
+    return NULL;
+}
 
-    // Open the input file
-    fin = fopen(filename, "r");
-    if (fin == NULL) {
-        return E_FILE_NOT_FOUND;
+// Log a change given by a CSV view, as a CSV line starting with its type
+static void api_logView(tApiData* data, int type, const tCSVView* view) {
+    int i;
+    
+    if (api_beginLog(data, type)) {
+        wal_write(data->log, view->type.str, view->type.len);
+        for (i = 0; i < view->numFields && i < CSV_MAX_FIELDS; i++) {
+            wal_write(data->log, ";", 1);
+            wal_write(data->log, view->fields[i].str, view->fields[i].len);
+        }
+        wal_end(data->log);
+    }
+}
+
+// Log a change of the appointments of a person in a health center. Write errors are reported when the log is synced
+static void api_logAppointment(tApiData* data, int type, const char* cp, const char* document, const char* vaccine, tDateTime timestamp) {
+    if (api_beginLog(data, type)) {
+        wal_write(data->log, &timestamp, sizeof(tDateTime));
+        wal_write(data->log, cp, strlen(cp) + 1);
+        wal_write(data->log, document, strlen(document) + 1);
+        wal_write(data->log, vaccine, strlen(vaccine) + 1);
+        wal_end(data->log);
+    }
+}
+
+// Add a parsed lot to the api data, with its vaccine and the stock of its center. The strings are copied
+static void api_addLot(tApiData* data, tVaccine vaccine, tVaccineLot lot) {
+    tVaccine *pVaccine;
+    
+    //////////////////////////////////
+    // Ex PR2 3c
+    /////////////////////////////////
+    tHealthCenter *pCenter;
+    /////////////////////////////////
+    
+    // Check if vaccine exists
+    pVaccine = vaccineList_find(&(data->vaccines), vaccine.name);
+    if (pVaccine == NULL) {
+        // Add the vaccine
+        vaccineList_insert(&(data->vaccines), vaccine);
+        pVaccine = vaccineList_find(&(data->vaccines), vaccine.name);
+    }
+    assert(pVaccine != NULL);
+    
+    // Assign this vaccine to the lot
+    lot.vaccine = pVaccine;
+    
+    // Add the lot to the data
+    vaccineLotData_add(&(data->vaccineLots), lot);
+    
+    
+    //////////////////////////////////
+    // Ex PR2 3c
+    /////////////////////////////////
+    pCenter = centerList_find(&(data->centers), lot.cp);
+    if (pCenter == NULL) {
+        centerList_insert(&(data->centers), lot.cp);
+        pCenter = centerList_find(&(data->centers), lot.cp);
+    }
+    stockList_update(&(pCenter->stock), lot.timestamp.date, lot.vaccine, lot.doses);
+    /////////////////////////////////
+}
+
+// Add a line prepared by a worker thread to the api data, without parsing it again
+static tApiError api_commitLine(tApiData* data, tApiParsedLine* line) {
+    tPerson* elems;
+    bool added;
+    
+    if (line->parsed == API_PARSED_LOT) {
+        api_addLot(data, line->vaccine, line->lot);
+        api_logView(data, API_LOG_ENTRY, &(line->view));
+        return E_SUCCESS;
+    }
+    
+    if (line->parsed == API_PARSED_PERSON) {
+        elems = data->population.elems;
+        // Persons are moved with the block arena, or copied if the population owns its strings
+        if (data->population.arena != NULL) {
+            added = population_take(&(data->population), &(line->person));
+        } else {
+            added = (population_find(&(data->population), line->person.document) < 0);
+            if (added) {
+                population_add(&(data->population), line->person);
+            }
+        }
+        api_rebasePersons(data, elems);
+        api_appendColumns(data);
+        if (added && api_beginLog(data, API_LOG_ENTRY)) {
+            wal_write(data->log, line->line, line->len);
+            wal_end(data->log);
+        }
+        return added ? E_SUCCESS : E_DUPLICATED_PERSON;
+    }
+    
+    return api_addDataView(data, &(line->view));
+}
+
+// Load data from a CSV file, parsing it with the given number of threads. If reset is true, remove previous data
+tApiError api_loadDataParallel(tApiData* data, const char* filename, bool reset, int numThreads) {
+    tApiError error;
+    tCSVFile file;
+    tApiParseBlock* blocks;
+    pthread_t* threads;
+    const char *pos, *end, *blockEnd;
+    long blockSize;
+    int numBlocks;
+    int i, j;
+    
+    // Check input data
+    assert( data != NULL );
+    assert(filename != NULL);
+    assert(numThreads > 0);
+    
+    error = api_openFile(data, filename, reset, &file);
+    if (error != E_SUCCESS) {
+        return error;
+    }
+    
+    // Split small files between all the threads
+    blockSize = file.size / numThreads + 1;
+    if (blockSize > PARALLEL_BLOCK_SIZE) {
+        blockSize = PARALLEL_BLOCK_SIZE;
+    }
+    
+    blocks = (tApiParseBlock*) calloc(numThreads, sizeof(tApiParseBlock));
+    threads = (pthread_t*) malloc(numThreads * sizeof(pthread_t));
+    if (blocks == NULL || threads == NULL) {
+        free(blocks);
+        free(threads);
+        csv_closeFile(&file);
+        return E_MEMORY_ERROR;
+    }
+    for (i = 0; i < numThreads; i++) {
+        arena_init(&(blocks[i].arena));
     }
     
-    // Read file line by line
-    while (fgets(buffer, FILE_READ_BUFFER_SIZE, fin)) {
-        // Remove new line character     
-        buffer[strcspn(buffer, "\n\r")] = '\0';
+    pos = file.data;
+    end = file.data + file.size;
+    while (pos < end && error == E_SUCCESS) {
+        // Split the next part of the file in blocks ending at a line boundary
+        numBlocks = 0;
+        while (numBlocks < numThreads && pos < end) {
+            blockEnd = pos + blockSize;
+            if (blockEnd >= end) {
+                blockEnd = end;
+            } else {
+                blockEnd = (const char*) memchr(blockEnd, '\n', end - blockEnd);
+                blockEnd = (blockEnd == NULL) ? end : blockEnd + 1;
+            }
+            blocks[numBlocks].start = pos;
+            blocks[numBlocks].end = blockEnd;
+            numBlocks ++;
+            pos = blockEnd;
+        }
         
-        csv_initEntry(&entry);
-        csv_parseEntry(&entry, buffer, NULL);
-        // Add this new entry to the api Data
-        error = api_addDataEntry(data, entry);
-        if (error != E_SUCCESS) {
-            return error;
+        // Parse the blocks in parallel. The current thread parses the first one
+        for (i = 1; i < numBlocks; i++) {
+            // If the thread cannot be created, the block is parsed later on the current thread
+            blocks[i].threaded = (pthread_create(&(threads[i]), NULL, api_parseBlock, &(blocks[i])) == 0);
         }
-        csv_freeEntry(&entry);
+        api_parseBlock(&(blocks[0]));
+        for (i = 1; i < numBlocks; i++) {
+            if (blocks[i].threaded) {
+                pthread_join(threads[i], NULL);
+            } else {
+                api_parseBlock(&(blocks[i]));
+            }
+        }
+        
+        // Commit the entries in file order, up to the first error
+        for (i = 0; i < numBlocks; i++) {
+            for (j = 0; j < blocks[i].count && error == E_SUCCESS; j++) {
+                error = api_commitLine(data, &(blocks[i].lines[j]));
+            }
+            
+            // The strings of the committed persons are now owned by the data
+            if (data->population.arena != NULL) {
+                arena_merge(data->population.arena, &(blocks[i].arena));
+            } else {
+                arena_free(&(blocks[i].arena));
+            }
+        }
+    }
+    
+    for (i = 0; i < numThreads; i++) {
+        free(blocks[i].lines);
+    }
+    free(blocks);
+    free(threads);
+    csv_closeFile(&file);
+    
+    return error;
+}
+
+// Save all the data on a binary snapshot file
+tApiError api_saveSnapshot(const tApiData* data, const char* filename) {
+    tSnapshotWriter writer;
+    
+    assert(data != NULL);
+    assert(filename != NULL);
+    
+    if (!snapshot_openWriter(&writer, filename)) {
+        return E_FILE_NOT_FOUND;
+    }
+    
+    // Sections are loaded in the same order, so each one can reference the previous ones
+    internTable_save(&(data->strings), &writer);
+    population_save(&(data->population), &writer);
+    vaccineList_save(&(data->vaccines), &writer);
+    vaccineLotData_save(&(data->vaccineLots), &writer);
+    centerList_save(&(data->centers), &writer, &(data->population));
+    appointmentIndex_save(&(data->personAppointments), &writer, &(data->strings));
+    
+    // Changes of the log up to this one are on the snapshot
+    snapshot_write(&writer, &(data->lsn), sizeof(long long));
+    
+    if (!snapshot_closeWriter(&writer)) {
+        return E_FILE_NOT_FOUND;
+    }
+    
+    return E_SUCCESS;
+}
+
+// Load all the data from a binary snapshot file, removing previous data. Returns E_INVALID_LOG if the data has a log, as the log could not replay the load
+tApiError api_loadSnapshot(tApiData* data, const char* filename) {
+    tSnapshotReader reader;
+    const long long* lsn;
+    bool valid;
+    
+    assert(data != NULL);
+    assert(filename != NULL);
+    
+    if (data->log != NULL) {
+        return E_INVALID_LOG;
     }
     
-    fclose(fin);
+    api_resetData(data);
+    
+    if (!snapshot_openReader(&reader, filename)) {
+        return reader.failed ? E_INVALID_SNAPSHOT : E_FILE_NOT_FOUND;
+    }
+    
+    // Strings are copied once, so the file can be closed. All the arrays are copied with a single pass replacing positions by pointers
+    snapshot_copyStrings(&reader, &(data->arena));
+    valid = internTable_load(&(data->strings), &reader)
+        && population_load(&(data->population), &reader)
+        && vaccineList_load(&(data->vaccines), &reader)
+        && vaccineLotData_load(&(data->vaccineLots), &reader, &(data->vaccines))
+        && centerList_load(&(data->centers), &reader, &(data->population), &(data->vaccines))
+        && appointmentIndex_load(&(data->personAppointments), &reader, &(data->strings), &(data->vaccines));
+    lsn = valid ? (const long long*) snapshot_read(&reader, sizeof(long long)) : NULL;
+    valid = lsn != NULL && reader.pos == reader.file.size - reader.stringsSize;
+    if (valid) {
+        data->lsn = *lsn;
+    }
+    snapshot_closeReader(&reader);
+    
+    // Partial data is never kept
+    if (!valid) {
+        api_resetData(data);
+        return E_INVALID_SNAPSHOT;
+    }
+    
+    if (data->columns != NULL) {
+        populationColumns_build(data->columns, &(data->population));
+    }
     
     return E_SUCCESS;
 }
@@ -81,6 +614,12 @@ tApiError api_initData(tApiData* data) {
     vaccineList_init(&(data->vaccines));
     vaccineLotData_init(&(data->vaccineLots));
     
+    // Store all the strings of the entities on the same arena
+    arena_init(&(data->arena));
+    data->population.arena = &(data->arena);
+    data->vaccines.arena = &(data->arena);
+    data->vaccineLots.arena = &(data->arena);
+    
     
     //////////////////////////////////
     // Ex PR1 2b
@@ -88,6 +627,24 @@ tApiError api_initData(tApiData* data) {
     centerList_init(&(data->centers));
     /////////////////////////////////
     
+    // Store each distinct cp and vaccine name only once
+    internTable_init(&(data->strings));
+    data->population.strings = &(data->strings);
+    data->vaccines.strings = &(data->strings);
+    data->vaccineLots.strings = &(data->strings);
+    data->centers.strings = &(data->strings);
+    
+    // Index the appointments of all the centers by person
+    appointmentIndex_init(&(data->personAppointments));
+    data->centers.appointments = &(data->personAppointments);
+    
+    // Changes are not logged until a log is opened
+    data->log = NULL;
+    data->lsn = 0;
+    
+    // The population is only stored by columns on request
+    data->columns = NULL;
+    
     return E_SUCCESS;
     
     /////////////////////////////////
@@ -96,100 +653,74 @@ tApiError api_initData(tApiData* data) {
 
 // Add a new vaccines lot
 tApiError api_addVaccineLot(tApiData* data, tCSVEntry entry) {
+    tCSVView view;
+    
+    // Check input data structure
+    assert(data != NULL);
+    
+    // Use the same path as the data loaded from files
+    csv_viewFromEntry(&view, &entry);
+    
+    return api_addVaccineLotView(data, &view);
+}
+
+// Add a new vaccines lot from a CSV view
+tApiError api_addVaccineLotView(tApiData* data, const tCSVView* view) {
     //////////////////////////////////
     // Ex PR1 2c
     /////////////////////////////////
     tVaccine vaccine;
     tVaccineLot lot;
-    tVaccine *pVaccine;
-    
-    //////////////////////////////////
-    // Ex PR2 3c
-    /////////////////////////////////
-    tHealthCenter *pCenter;
-    /////////////////////////////////
+    char cp[512];
+    char name[512];
     
     // Check input data structure
     assert(data != NULL);
+    assert(view != NULL);
     
     // Check the entry type
-    if (strcmp(csv_getType(&entry), "VACCINE_LOT") != 0) {
+    if (!csv_fieldEquals(view->type, "VACCINE_LOT")) {
         return E_INVALID_ENTRY_TYPE;
     }
     
     // Check the number of fields
-    if(csv_numFields(entry) != 7) {
+    if(view->numFields != 7) {
         return E_INVALID_ENTRY_FORMAT;
     }
     
-    // Parse the entry
-    vaccineLot_parse(&vaccine, &lot, entry);
-    
-    // Check if vaccine exists
-    pVaccine = vaccineList_find(data->vaccines, vaccine.name);
-    if (pVaccine == NULL) {
-        // Add the vaccine
-        vaccineList_insert(&(data->vaccines), vaccine);
-        pVaccine = vaccineList_find(data->vaccines, vaccine.name);
-    }
-    assert(pVaccine != NULL);
-    
-    // Assign this vaccine to the lot
-    lot.vaccine = pVaccine;
-    
-    // Add the lot to the data
-    vaccineLotData_add(&(data->vaccineLots), lot);
-    
-    
-    //////////////////////////////////
-    // Ex PR2 3c
-    /////////////////////////////////
-    pCenter = centerList_find(&(data->centers), lot.cp);
-    if (pCenter == NULL) {
-        centerList_insert(&(data->centers), lot.cp);
-        pCenter = centerList_find(&(data->centers), lot.cp);
-    }
-    stockList_update(&(pCenter->stock), lot.timestamp.date, lot.vaccine, lot.doses);
-    /////////////////////////////////
-    
-    
-    // Release temporal data
-    vaccine_free(&vaccine);
-    vaccineLot_free(&lot);
+    // Parse the entry. Strings are stored on local buffers, as they are copied when added
+    vaccineLot_parseView(&vaccine, &lot, view, cp, name, 512);
+    api_addLot(data, vaccine, lot);
     
     return E_SUCCESS;
-    
-    /////////////////////////////////
-    
-    //return E_NOT_IMPLEMENTED;
 }
 
 // Get the number of persons registered on the application
-int api_populationCount(tApiData data) {
+int api_populationCount(const tApiData* data) {
     //////////////////////////////////
     // Ex PR1 2d
     /////////////////////////////////
-    return population_len(data.population);
+    return population_len(&(data->population));
     /////////////////////////////////
     //return -1;
 }
 
 // Get the number of vaccines registered on the application
-int api_vaccineCount(tApiData data) {
+int api_vaccineCount(const tApiData* data) {
     //////////////////////////////////
     // Ex PR1 2d
     /////////////////////////////////
-    return vaccineList_len(data.vaccines);    
+    return vaccineList_len(&(data->vaccines));    
     /////////////////////////////////
     //return -1;
 }
 
 // Get the number of vaccine lots registered on the application
-int api_vaccineLotsCount(tApiData data) {
+int api_vaccineLotsCount(const tApiData* data) {
     //////////////////////////////////
     // Ex PR1 2d
     /////////////////////////////////
-    return vaccineLotData_len(data.vaccineLots);
+    return vaccineLotData_len(&(data->vaccineLots));
     /////////////////////////////////
     //return -1;
 }
@@ -210,6 +741,11 @@ tApiError api_freeData(tApiData* data) {
     centerList_free(&(data->centers));
     /////////////////////////////////
     
+    // Release all the strings at once
+    arena_free(&(data->arena));
+    internTable_free(&(data->strings));
+    appointmentIndex_free(&(data->personAppointments));
+    
     return E_SUCCESS;
     /////////////////////////////////
     //return E_NOT_IMPLEMENTED;
@@ -218,50 +754,59 @@ tApiError api_freeData(tApiData* data) {
 
 // Add a new entry
 tApiError api_addDataEntry(tApiData* data, tCSVEntry entry) { 
+    tCSVView view;
+    
+    assert(data != NULL);
+    
+    // Use the same path as the data loaded from files
+    csv_viewFromEntry(&view, &entry);
+    
+    return api_addDataView(data, &view);
+}
+
+// Add a new entry from a CSV view
+tApiError api_addDataView(tApiData* data, const tCSVView* view) {
     //////////////////////////////////
     // Ex PR1 2f
     /////////////////////////////////
-    int personIdx;
-    tPerson person;
-        
+    tApiError error;
+    tPerson* elems;
+    
     assert(data != NULL);
+    assert(view != NULL);
     
-    // Initialize the person object
-    person_init(&person);
-        
-    if (strcmp(csv_getType(&entry), "PERSON") == 0) {
+    if (csv_fieldEquals(view->type, "PERSON")) {
         // Check the number of fields
-        if(csv_numFields(entry) != 7) {
+        if(view->numFields != 7) {
             return E_INVALID_ENTRY_FORMAT;
         }
-        // Parse the data
-        person_parse(&person, entry);
         
-        // Check if this person already exists
-        if (population_find(data->population, person.document) >= 0) {
-            // Release person object
-            person_free(&person);
+        // Parse and add the new person, checking if this person already exists
+        elems = data->population.elems;
+        if (!population_addView(&(data->population), view)) {
             return E_DUPLICATED_PERSON;
         }
+        api_rebasePersons(data, elems);
+        api_appendColumns(data);
         
-        // Add the new person
-        population_add(&(data->population), person);
-        
-        // Release person object
-        person_free(&person);
-        
-    } else if (strcmp(csv_getType(&entry), "VACCINE_LOT") == 0) {
-        return api_addVaccineLot(data, entry);        
+    } else if (csv_fieldEquals(view->type, "VACCINE_LOT")) {
+        error = api_addVaccineLotView(data, view);
+        if (error != E_SUCCESS) {
+            return error;
+        }
     } else {
         return E_INVALID_ENTRY_TYPE;
     }
+    
+    // Only the entries that change the data are logged
+    api_logView(data, API_LOG_ENTRY, view);
     return E_SUCCESS;
     /////////////////////////////////
     //return E_NOT_IMPLEMENTED;
 }
 
 // Get vaccine data
-tApiError api_getVaccine(tApiData data, const char *name, tCSVEntry *entry) {
+tApiError api_getVaccine(const tApiData* data, const char *name, tCSVEntry *entry) {
     //////////////////////////////////
     // Ex PR1 3a
     /////////////////////////////////
@@ -272,7 +817,7 @@ tApiError api_getVaccine(tApiData data, const char *name, tCSVEntry *entry) {
     assert(entry != NULL);
     
     // Search vaccine
-    vaccine = vaccineList_find(data.vaccines, name);
+    vaccine = vaccineList_find(&(data->vaccines), name);
     
     if (vaccine == NULL) {
         return E_VACCINE_NOT_FOUND;
@@ -291,8 +836,19 @@ tApiError api_getVaccine(tApiData data, const char *name, tCSVEntry *entry) {
     //return E_NOT_IMPLEMENTED; 
 }
 
+// Print the data of a vaccine lot in a buffer
+static void api_printLot(char* buffer, tVaccineLot* lot) {
+    sprintf(buffer, "%02d/%02d/%04d;%02d:%02d;%s;%s;%d;%d;%d", 
+        lot->timestamp.date.day, lot->timestamp.date.month, lot->timestamp.date.year,
+        lot->timestamp.time.hour, lot->timestamp.time.minutes,
+        lot->cp,
+        lot->vaccine->name, lot->vaccine->required, lot->vaccine->days,
+        lot->doses
+    );
+}
+
 // Get vaccine lot data
-tApiError api_getVaccineLot(tApiData data, const char* cp, const char* vaccine, tDateTime timestamp, tCSVEntry *entry) {
+tApiError api_getVaccineLot(const tApiData* data, const char* cp, const char* vaccine, tDateTime timestamp, tCSVEntry *entry) {
     //////////////////////////////////
     // Ex PR1 3b
     /////////////////////////////////
@@ -304,20 +860,14 @@ tApiError api_getVaccineLot(tApiData data, const char* cp, const char* vaccine,
     assert(entry != NULL);
     
     // Search vaccine
-    idx = vaccineLotData_find(data.vaccineLots, cp, vaccine, timestamp);
+    idx = vaccineLotData_find(&(data->vaccineLots), cp, vaccine, timestamp);
         
     if (idx < 0) {
         return E_LOT_NOT_FOUND;
     }
     
     // Print data in the buffer
-    sprintf(buffer, "%02d/%02d/%04d;%02d:%02d;%s;%s;%d;%d;%d", 
-        data.vaccineLots.elems[idx].timestamp.date.day, data.vaccineLots.elems[idx].timestamp.date.month, data.vaccineLots.elems[idx].timestamp.date.year,
-        data.vaccineLots.elems[idx].timestamp.time.hour, data.vaccineLots.elems[idx].timestamp.time.minutes,
-        data.vaccineLots.elems[idx].cp,
-        data.vaccineLots.elems[idx].vaccine->name, data.vaccineLots.elems[idx].vaccine->required, data.vaccineLots.elems[idx].vaccine->days,
-        data.vaccineLots.elems[idx].doses
-    );
+    api_printLot(buffer, &(data->vaccineLots.elems[idx]));
     
     // Initialize the output structure
     csv_initEntry(entry);
@@ -331,20 +881,21 @@ tApiError api_getVaccineLot(tApiData data, const char* cp, const char* vaccine,
 }
 
 // Get registered vaccines
-tApiError api_getVaccines(tApiData data, tCSVData *vaccines) {
+tApiError api_getVaccines(const tApiData* data, tCSVData *vaccines) {
     //////////////////////////////////
     // Ex PR1 3c
     /////////////////////////////////
     char buffer[2048];
-    tVaccineNode *pNode = NULL;
+    tVaccine *pVaccine = NULL;
+    tApiCursor cursor;
     
     csv_init(vaccines);
+    csv_reserve(vaccines, data->vaccines.count);
         
-    pNode = data.vaccines.first;
-    while(pNode != NULL) {
-        sprintf(buffer, "%s;%d;%d", pNode->vaccine.name, pNode->vaccine.required, pNode->vaccine.days);
+    api_vaccinesCursor(data, &cursor);
+    while ((pVaccine = api_nextVaccine(data, &cursor)) != NULL) {
+        sprintf(buffer, "%s;%d;%d", pVaccine->name, pVaccine->required, pVaccine->days);
         csv_addStrEntry(vaccines, buffer, "VACCINE");
-        pNode = pNode->next;
     }    
     
     return E_SUCCESS;
@@ -353,22 +904,20 @@ tApiError api_getVaccines(tApiData data, tCSVData *vaccines) {
 }
 
 // Get vaccine lots
-tApiError api_getVaccineLots(tApiData data, tCSVData *lots) {
+tApiError api_getVaccineLots(const tApiData* data, tCSVData *lots) {
     //////////////////////////////////
     // Ex PR1 3d
     /////////////////////////////////
     char buffer[2048];
-    int idx;
+    tVaccineLot* lot;
+    tApiCursor cursor;
     
     csv_init(lots);
-    for(idx=0; idx<data.vaccineLots.count ; idx++) {
-        sprintf(buffer, "%02d/%02d/%04d;%02d:%02d;%s;%s;%d;%d;%d", 
-            data.vaccineLots.elems[idx].timestamp.date.day, data.vaccineLots.elems[idx].timestamp.date.month, data.vaccineLots.elems[idx].timestamp.date.year,
-            data.vaccineLots.elems[idx].timestamp.time.hour, data.vaccineLots.elems[idx].timestamp.time.minutes,
-            data.vaccineLots.elems[idx].cp,
-            data.vaccineLots.elems[idx].vaccine->name, data.vaccineLots.elems[idx].vaccine->required, data.vaccineLots.elems[idx].vaccine->days,
-            data.vaccineLots.elems[idx].doses
-        );
+    csv_reserve(lots, data->vaccineLots.count);
+    
+    api_vaccineLotsCursor(data, &cursor);
+    while ((lot = api_nextVaccineLot(data, &cursor)) != NULL) {
+        api_printLot(buffer, lot);
         csv_addStrEntry(lots, buffer, "VACCINE_LOT");
     }
     
@@ -378,46 +927,196 @@ tApiError api_getVaccineLots(tApiData data, tCSVData *lots) {
     //return E_NOT_IMPLEMENTED; 
 }
 
+// Get the vaccine lots of a health center with a date between from and to, both included. If vaccine is NULL, lots of any vaccine are returned
+tApiError api_getCenterVaccineLots(const tApiData* data, const char* cp, const char* vaccine, tDate from, tDate to, tCSVData *lots) {
+    char buffer[2048];
+    tVaccineLot* lot;
+    tApiCursor cursor;
+    
+    assert(cp != NULL);
+    assert(lots != NULL);
+    
+    csv_init(lots);
+    
+    api_centerVaccineLotsCursor(data, &cursor, cp, from, to);
+    while ((lot = api_nextVaccineLot(data, &cursor)) != NULL) {
+        if (vaccine == NULL || strcmp(lot->vaccine->name, vaccine) == 0) {
+            api_printLot(buffer, lot);
+            csv_addStrEntry(lots, buffer, "VACCINE_LOT");
+        }
+    }
+    
+    return E_SUCCESS;
+}
+
+// Start a cursor over the registered vaccines, sorted by name
+void api_vaccinesCursor(const tApiData* data, tApiCursor* cursor) {
+    assert(data != NULL);
+    assert(cursor != NULL);
+    
+    cursor->pos = 0;
+    cursor->end = data->vaccines.count;
+    cursor->lots = NULL;
+    cursor->appointments = NULL;
+}
+
+// Get the next vaccine of a cursor. NULL if there are no more vaccines
+tVaccine* api_nextVaccine(const tApiData* data, tApiCursor* cursor) {
+    assert(data != NULL);
+    assert(cursor != NULL);
+    
+    if (cursor->pos >= cursor->end) {
+        return NULL;
+    }
+    
+    return vaccineList_get(&(data->vaccines), cursor->pos++);
+}
+
+// Start a cursor over all the vaccine lots
+void api_vaccineLotsCursor(const tApiData* data, tApiCursor* cursor) {
+    assert(data != NULL);
+    assert(cursor != NULL);
+    
+    cursor->pos = 0;
+    cursor->end = data->vaccineLots.count;
+    cursor->lots = NULL;
+    cursor->appointments = NULL;
+}
+
+// Start a cursor over the vaccine lots of a health center with a date between from and to, both included
+void api_centerVaccineLotsCursor(const tApiData* data, tApiCursor* cursor, const char* cp, tDate from, tDate to) {
+    tVaccineLotCenter* center;
+    
+    assert(data != NULL);
+    assert(cursor != NULL);
+    assert(cp != NULL);
+    
+    cursor->appointments = NULL;
+    
+    // Lots of the center are sorted by timestamp, so the window is a range of them
+    center = vaccineLotData_findRange(&(data->vaccineLots), cp, from, to, &(cursor->pos), &(cursor->end));
+    cursor->lots = center != NULL ? center->lots : NULL;
+}
+
+// Get the next vaccine lot of a cursor. NULL if there are no more lots
+tVaccineLot* api_nextVaccineLot(const tApiData* data, tApiCursor* cursor) {
+    int idx;
+    
+    assert(data != NULL);
+    assert(cursor != NULL);
+    
+    if (cursor->pos >= cursor->end) {
+        return NULL;
+    }
+    
+    idx = cursor->lots != NULL ? cursor->lots[cursor->pos] : cursor->pos;
+    cursor->pos++;
+    
+    return &(data->vaccineLots.elems[idx]);
+}
+
+// Start a cursor over the appointments of a person in any center, sorted by timestamp
+tApiError api_personAppointmentsCursor(const tApiData* data, tApiCursor* cursor, const char* document) {
+    tPersonAppointments* personAppointments;
+    int idx;
+    
+    assert(data != NULL);
+    assert(cursor != NULL);
+    assert(document != NULL);
+    
+    cursor->pos = 0;
+    cursor->end = 0;
+    cursor->lots = NULL;
+    cursor->appointments = NULL;
+    
+    idx = population_find(&(data->population), document);
+    if (idx < 0) {
+        return E_PERSON_NOT_FOUND;
+    }
+    
+    personAppointments = appointmentIndex_find(&(data->personAppointments), data->population.elems[idx].document);
+    if (personAppointments != NULL) {
+        cursor->end = personAppointments->count;
+        cursor->appointments = personAppointments->elems;
+    }
+    
+    return E_SUCCESS;
+}
+
+// Get the next appointment of a cursor. NULL if there are no more appointments
+tPersonAppointment* api_nextPersonAppointment(const tApiData* data, tApiCursor* cursor) {
+    assert(data != NULL);
+    assert(cursor != NULL);
+    
+    if (cursor->pos >= cursor->end) {
+        return NULL;
+    }
+    
+    return &(cursor->appointments[cursor->pos++]);
+}
+
 // Get the number of health centers registered on the application
-int api_centersCount(tApiData data) {
+int api_centersCount(const tApiData* data) {
     //////////////////////////////////
     // Ex PR2 3e
     
-    return data.centers.count;
+    return data->centers.count;
     
     /////////////////////////////////
     // return -1;
 }
 
 // Print center stock
-void api_printCenterStock(tApiData data, const char* cp) {
+void api_printCenterStock(const tApiData* data, const char* cp) {
     tHealthCenter *pCenter;
     
     // Check input data    
     assert(cp != NULL);
     
     // Search the health center
-    pCenter = centerList_find(&(data.centers), cp);
+    pCenter = centerList_find(&(data->centers), cp);
     if (pCenter != NULL) {
         printf("==============================\n");
         printf("STOCK FOR CENTER %s\n", cp);
         printf("==============================\n");
-        stockList_print(pCenter->stock);
+        stockList_print(&(pCenter->stock));
         printf("==============================\n\n");
     }    
 }
 
+// Add an appointment to a center. If pending is not NULL, it is appended there to be inserted later
+static void api_insertAppointment(tHealthCenter* center, tAppointmentData* pending, tPerson* person, tVaccine* vaccine, tDateTime timestamp) {
+	if (pending == NULL){
+		appointmentData_insert(&(center->appointments), timestamp, vaccine, person);
+	} else {
+		pending->elems = (tAppointment*) array_grow(pending->elems, &(pending->capacity), pending->count + 1, sizeof(tAppointment));
+		appointment_init(&(pending->elems[pending->count]), person, vaccine, timestamp);
+		pending->count++;
+	}
+}
+
+// Add the appointments of all the doses of a vaccine for a person, starting on a given timestamp
+static void api_insertAppointments(tHealthCenter* center, tAppointmentData* pending, tPerson* person, tVaccine* vaccine, tDateTime timestamp) {
+	int i;
+	
+	api_insertAppointment(center, pending, person, vaccine, timestamp);
+	for (i=1; i<vaccine->required; i++){
+		dateTime_addDay(&timestamp, vaccine->days);
+		api_insertAppointment(center, pending, person, vaccine, timestamp);
+	}
+}
+
 // Add a new vaccination appointment
 tApiError api_addAppointment(tApiData* data, const char* cp, const char* document, const char* vaccine, tDateTime timestamp) {
     //////////////////////////////////
     // Ex PR3 2c
     /////////////////////////////////
-	int person_idx, i = 0;
+	int person_idx;
 	tVaccine* vaccineFound;
 	tHealthCenter* hcenterFound;
 	
-	person_idx = population_find(data->population, document);
-	vaccineFound = vaccineList_find(data->vaccines, vaccine);
+	person_idx = population_find(&(data->population), document);
+	vaccineFound = vaccineList_find(&(data->vaccines), vaccine);
 	hcenterFound = centerList_find(&(data->centers), cp);
 	if (person_idx == -1){
 		return E_PERSON_NOT_FOUND;
@@ -427,40 +1126,60 @@ tApiError api_addAppointment(tApiData* data, const char* cp, const char* documen
 		return E_HEALTH_CENTER_NOT_FOUND;
 	} 
 	
-	appointmentData_insert(&(hcenterFound->appointments), timestamp, vaccineFound, &(data->population.elems[person_idx]));
+	api_insertAppointments(hcenterFound, NULL, &(data->population.elems[person_idx]), vaccineFound, timestamp);
+	api_logAppointment(data, API_LOG_APPOINTMENT, hcenterFound->cp, document, vaccineFound->name, timestamp);
+	return E_SUCCESS;
+}
 
-	for (i=1; i<vaccineFound->required; i++){
-		dateTime_addDay(&timestamp, vaccineFound->days);
-		appointmentData_insert(&(hcenterFound->appointments), timestamp, vaccineFound, &(data->population.elems[person_idx]));
+// Remove a vaccination appointment
+tApiError api_removeAppointment(tApiData* data, const char* cp, const char* document, tDateTime timestamp) {
+	int person_idx;
+	int count;
+	tHealthCenter* hcenterFound;
+	
+	assert(data != NULL);
+	
+	person_idx = population_find(&(data->population), document);
+	hcenterFound = centerList_find(&(data->centers), cp);
+	if (person_idx == -1){
+		return E_PERSON_NOT_FOUND;
+	} else if (hcenterFound == NULL){
+		return E_HEALTH_CENTER_NOT_FOUND;
+	}
+	
+	// Removing an appointment that does not exist does not change the data
+	count = hcenterFound->appointments.count;
+	appointmentData_remove(&(hcenterFound->appointments), timestamp, &(data->population.elems[person_idx]));
+	if (hcenterFound->appointments.count < count){
+		api_logAppointment(data, API_LOG_REMOVE, hcenterFound->cp, document, "", timestamp);
 	}
 	return E_SUCCESS;
 }
 
 // Get person appointments
-tApiError api_getPersonAppointments(tApiData data, const char* document, tCSVData *appointments) {
+tApiError api_getPersonAppointments(const tApiData* data, const char* document, tCSVData *appointments) {
     //////////////////////////////////
     // Ex PR3 2d
     /////////////////////////////////
-	int idx=0, person_idx, start_pos=0;
-	tHealthCenter* hcenterFound;
+	tApiError error;
+	tApiCursor cursor;
+	tPersonAppointment* appointment;
 	char buffer[FILE_READ_BUFFER_SIZE];
 	
-	person_idx = population_find(data.population, document);
-	if (person_idx == -1){
-		return E_PERSON_NOT_FOUND;
+	// Appointments in all the centers, sorted by timestamp
+	error = api_personAppointmentsCursor(data, &cursor, document);
+	if (error != E_SUCCESS) {
+		return error;
 	}
 	
-	hcenterFound = centerList_find(&(data.centers),data.population.elems[person_idx].cp);
-	idx = appointmentData_find(hcenterFound->appointments, &(data.population.elems[person_idx]), start_pos);
-	while (idx >= 0){
-		start_pos = idx;
+	csv_reserve(appointments, appointments->count + cursor.end);
+	while ((appointment = api_nextPersonAppointment(data, &cursor)) != NULL) {
 		sprintf(buffer, "%02d/%02d/%04d;%02d:%02d;%s;%s", 
-            hcenterFound->appointments.elems[start_pos].timestamp.date.day, hcenterFound->appointments.elems[start_pos].timestamp.date.month, hcenterFound->appointments.elems[start_pos].timestamp.date.year,
-            hcenterFound->appointments.elems[start_pos].timestamp.time.hour, hcenterFound->appointments.elems[start_pos].timestamp.time.minutes,
-            hcenterFound->cp,
-            hcenterFound->appointments.elems[start_pos].vaccine->name);
+            appointment->timestamp.date.day, appointment->timestamp.date.month, appointment->timestamp.date.year,
+            appointment->timestamp.time.hour, appointment->timestamp.time.minutes,
+            appointment->cp,
+            appointment->vaccine->name);
 		csv_addStrEntry(appointments, buffer, "APPOINTMENT");
-		idx = appointmentData_find(hcenterFound->appointments, &(data.population.elems[person_idx]), start_pos+1);
 	}
     return E_SUCCESS; 
 }
@@ -499,52 +1218,46 @@ tApiError api_getPersonAppointments(tApiData data, const char* document, tCSVDat
 }*/
 
 
-bool api_checkAvailability(tApiData data, const char* cp, const char* vaccine, tDate date) {
+bool api_checkAvailability(const tApiData* data, const char* cp, const char* vaccine, tDate date) {
     //////////////////////////////////
     // Ex PR3 3a
     /////////////////////////////////
-	int vaccine_pos, i;
-	tDate mod_date;
+	int pos;
 	tHealthCenter* hcenterFound;
-	tVaccineDailyStock* dailyStock;
-	tVaccineStockNode* stock;
 	tVaccine* vaccineFound;
+	int doses;
 	
-	hcenterFound = centerList_find(&(data.centers), cp);
+	hcenterFound = centerList_find(&(data->centers), cp);
 	
-	if (hcenterFound->stock.count == 0 || hcenterFound == NULL){
+	if (hcenterFound == NULL || hcenterFound->stock.count == 0){
 		return false;
 	}
-	dailyStock = stockList_find(&(hcenterFound->stock), date);
-	if (dailyStock == NULL){
+	pos = stockList_find(&(hcenterFound->stock), date);
+	if (pos < 0){
 		return false;
 	} 
-	vaccineFound = vaccineList_find(data.vaccines, vaccine);
-	if (vaccine == NULL){
+	vaccineFound = vaccineList_find(&(data->vaccines), vaccine);
+	if (vaccineFound == NULL){
 		return false;
 	} 
-	stock = dailyStock_find(dailyStock, vaccineFound);
-	if (stock == NULL){
+	doses = stockList_getDoses(&(hcenterFound->stock), date, vaccineFound);
+	if (doses == 0){
 		return false;
 	}
-	if (stock->elem.vaccine->required == 1){
-		if (stock->elem.doses >= 1){
+	if (vaccineFound->required == 1){
+		if (doses >= 1){
 			return true;
 		} else {
 			return false;
 		}
 	} else {
+		// After the end of the stock the doses of the last day remain, so the stock is not extended and the check only reads the data
 		date_addDay(&date, vaccineFound->days);
-		stockList_expandRight(&(hcenterFound->stock), date);
-		dailyStock = stockList_find(&(hcenterFound->stock), date);
-		if (dailyStock == NULL){
-			return false;
-		} 
-		stock = dailyStock_find(dailyStock, vaccineFound);
-		if (stock == NULL){
+		doses = stockList_getDoses(&(hcenterFound->stock), date, vaccineFound);
+		if (doses == 0){
 			return false;
 		}
-		if (stock->elem.doses >= vaccineFound->required){
+		if (doses >= vaccineFound->required){
 			return true;
 		} else {
 			return false;
@@ -553,52 +1266,89 @@ bool api_checkAvailability(tApiData data, const char* cp, const char* vaccine, t
 	return false;
 }
 
+// Get the first vaccine, sorted by name, with enough doses on the stock of a center on a given date. NULL if there is none
+static tVaccine* api_availableVaccine(tHealthCenter* center, tDate date) {
+	int pos, i, count;
+	tVaccineStock stock;
+	
+	if (center->stock.count == 0){
+		return NULL;
+	}
+	pos = stockList_find(&(center->stock), date);
+	if (pos < 0){
+		return NULL;
+	} 
+	
+	count = stockList_dayCount(&(center->stock), pos);
+	for (i = 0; i < count; i++){
+		stock = stockList_dayStock(&(center->stock), pos, i);
+		if (stock.doses >= stock.vaccine->required){
+			return stock.vaccine;
+		}
+	}
+	return NULL;
+}
+
 // Check availability of a vaccine in a given health center
-tVaccineStockNode* api_checkAvailabilityanyVaccine(tApiData *data, const char* cp, tDate date) {
+tVaccine* api_checkAvailabilityanyVaccine(const tApiData* data, const char* cp, tDate date) {
     //////////////////////////////////
     // Ex PR3 3a
     /////////////////////////////////
-	int vaccine_pos, i;
-	tDate mod_date;
 	tHealthCenter* hcenterFound;
-	tVaccineDailyStock* dailyStock;
-	tVaccineStockNode* stock;
 	
 	hcenterFound = centerList_find(&(data->centers), cp);
 	
-	if (hcenterFound->stock.count == 0 || hcenterFound == NULL){
+	if (hcenterFound == NULL){
 		return NULL;
 	}
-	dailyStock = stockList_find(&(hcenterFound->stock), date);
-	if (dailyStock == NULL){
-		return NULL;
-	} 
+	return api_availableVaccine(hcenterFound, date);
+}
+
+// Check if a person has an appointment in a given health center
+static bool api_hasAppointment(tApiData* data, const char* document, tHealthCenter* center) {
+	tPersonAppointments* personAppointments;
+	int i;
 	
-	stock = dailyStock->first;
-	while (stock != NULL && (stock->elem.doses < stock->elem.vaccine->required)){
-		stock = stock->next;
-	} 
-	if (stock!=NULL){
-		return stock;
+	// Only the appointments of the person are checked
+	personAppointments = appointmentIndex_find(&(data->personAppointments), document);
+	for (i = 0; personAppointments != NULL && i < personAppointments->count; i++){
+		if (strcmp(personAppointments->elems[i].cp, center->cp) == 0){
+			return true;
+		}
 	}
-	return NULL;
+	return false;
 }
 
+// Book the doses of a vaccine on a given date. If pending is not NULL, the appointments are appended there to be inserted later
+static void api_bookDoses(tHealthCenter* center, tAppointmentData* pending, tPerson* person, tVaccine* vaccine, tDateTime timestamp) {
+	int pos;
 	
+	api_insertAppointments(center, pending, person, vaccine, timestamp);
+	pos = stockList_find(&(center->stock), timestamp.date);
+	if (pos >= 0){
+		stockList_addDoses(&(center->stock), pos, vaccine, 1);
+	}
+	if (vaccine->required > 1){
+		date_addDay(&(timestamp.date), vaccine->required);
+		api_insertAppointments(center, pending, person, vaccine, timestamp);
+		pos = stockList_find(&(center->stock), timestamp.date);
+		if (pos >= 0){
+			stockList_addDoses(&(center->stock), pos, vaccine, 1);
+		}
+	}
+}
 
 // Find available vaccination appointment
 tApiError api_findAppointmentAvailability(tApiData* data, const char* cp, const char* document, tDateTime timestamp) {
     //////////////////////////////////
     // Ex PR3 3b
     /////////////////////////////////
-	int person_idx, i = 0, vaccine_pos, appointment_idx, start_pos=0;
+	int person_idx, i = 0;
 	tHealthCenter* hcenterFound;
-	tVaccineStockNode* stock;
-	tVaccineDailyStock* dailyStock;
-	tVaccineStockData* stockData;
+	tVaccine* vaccine;
 
 	
-	person_idx = population_find(data->population, document);
+	person_idx = population_find(&(data->population), document);
 	hcenterFound = centerList_find(&(data->centers), cp);
 	if (person_idx == -1){
 		return E_PERSON_NOT_FOUND;
@@ -606,52 +1356,927 @@ tApiError api_findAppointmentAvailability(tApiData* data, const char* cp, const
 		return E_HEALTH_CENTER_NOT_FOUND;
 	} else if (hcenterFound->stock.count == 0){
 		return E_NO_VACCINES;
-	} else {
-		appointment_idx = appointmentData_find(hcenterFound->appointments, &(data->population.elems[person_idx]), start_pos);
-		if (appointment_idx >= 0 ){
-			return E_DUPLICATED_PERSON;
-		}
+	} else if (api_hasAppointment(data, document, hcenterFound)){
+		return E_DUPLICATED_PERSON;
 	}
 	
-	for (i=0; i<6; i++){
-		stock = api_checkAvailabilityanyVaccine(data, cp, timestamp.date);
-		if (stock != NULL) {
-			api_addAppointment(data, cp, document, stock->elem.vaccine->name, timestamp);
-			stockData = &(hcenterFound->stock);
-			dailyStock = stockList_find(stockData, timestamp.date);
-			dailyStock_update(dailyStock, stock->elem.vaccine, 1);
-			if (stock->elem.vaccine->required > 1){
-				date_addDay(&(timestamp.date), stock->elem.vaccine->required);
-				api_addAppointment(data, cp, document, stock->elem.vaccine->name, timestamp);
-				stockData = &(hcenterFound->stock);
-				dailyStock = stockList_find(stockData, timestamp.date);
-				dailyStock_update(dailyStock, stock->elem.vaccine, 1);
-			}
+	for (i=0; i<API_BOOKING_DAYS; i++){
+		vaccine = api_availableVaccine(hcenterFound, timestamp.date);
+		if (vaccine != NULL) {
+			api_bookDoses(hcenterFound, NULL, &(data->population.elems[person_idx]), vaccine, timestamp);
+			api_logAppointment(data, API_LOG_BOOKING, hcenterFound->cp, document, vaccine->name, timestamp);
 			return E_SUCCESS;
 		}
 		dateTime_addDay(&timestamp, 1);
 	}
 	
-	if (i==6){
-		for (i=0; i<6; i++){
-		stock = api_checkAvailabilityanyVaccine(data, cp, timestamp.date);
-		if (stock != NULL) {
-			api_addAppointment(data, cp, document, stock->elem.vaccine->name, timestamp);
-			stockData = &(hcenterFound->stock);
-			dailyStock = stockList_find(stockData, timestamp.date);
-			dailyStock_update(dailyStock, stock->elem.vaccine, 1);
-			if (stock->elem.vaccine->required > 1){
-				date_addDay(&(timestamp.date), stock->elem.vaccine->required);
-				api_addAppointment(data, cp, document, stock->elem.vaccine->name, timestamp);
-				stockData = &(hcenterFound->stock);
-				dailyStock = stockList_find(stockData, timestamp.date);
-				dailyStock_update(dailyStock, stock->elem.vaccine, 1);
+	return E_NO_VACCINES;
+}
+
+// Start the bookings of a list of persons in a health center
+static void api_initBooking(tApiBooking* booking, tHealthCenter* center, tDateTime timestamp, bool* booked) {
+	booking->center = center;
+	booking->day = 0;
+	booking->timestamp = timestamp;
+	appointmentData_init(&(booking->pending));
+	booking->booked = booked;
+}
+
+// Book the next person of a list in a health center. The appointments are appended to the pending ones of the booking
+static tApiError api_bookNext(tApiData* data, tApiBooking* booking, const char* document) {
+	int person_idx;
+	tVaccine* vaccine;
+	
+	person_idx = population_find(&(data->population), document);
+	if (person_idx == -1){
+		return E_PERSON_NOT_FOUND;
+	} else if (booking->center->stock.count == 0){
+		return E_NO_VACCINES;
+	} else if (booking->booked[person_idx] || api_hasAppointment(data, document, booking->center)){
+		return E_DUPLICATED_PERSON;
+	}
+	
+	// Booking only adds doses on the booked day and later days, so a day without doses for a person has no doses for the next ones.
+	// The calendar is walked once, starting each search on the day of the previous booking
+	vaccine = booking->day < API_BOOKING_DAYS ? api_availableVaccine(booking->center, booking->timestamp.date) : NULL;
+	while (vaccine == NULL && booking->day < API_BOOKING_DAYS - 1){
+		booking->day++;
+		dateTime_addDay(&(booking->timestamp), 1);
+		vaccine = api_availableVaccine(booking->center, booking->timestamp.date);
+	}
+	if (vaccine == NULL){
+		booking->day = API_BOOKING_DAYS;
+		return E_NO_VACCINES;
+	}
+	
+	api_bookDoses(booking->center, &(booking->pending), &(data->population.elems[person_idx]), vaccine, booking->timestamp);
+	booking->booked[person_idx] = true;
+	return E_SUCCESS;
+}
+
+// Find available vaccination appointments for a list of persons in a health center, booked in order. The result of each person is stored on results
+tApiError api_findAppointmentAvailabilityBatch(tApiData* data, const char* cp, const char** documents, int count, tDateTime timestamp, tApiError* results) {
+	int i;
+	int first;
+	tHealthCenter* hcenterFound;
+	tApiBooking booking;
+	bool* booked;
+	
+	assert(data != NULL);
+	assert(cp != NULL);
+	assert(documents != NULL || count == 0);
+	assert(results != NULL || count == 0);
+	
+	hcenterFound = centerList_find(&(data->centers), cp);
+	if (hcenterFound == NULL){
+		for (i = 0; i < count; i++){
+			results[i] = population_find(&(data->population), documents[i]) == -1 ? E_PERSON_NOT_FOUND : E_HEALTH_CENTER_NOT_FOUND;
+		}
+		return E_HEALTH_CENTER_NOT_FOUND;
+	}
+	
+	// The appointments are merged on the calendar of the center at the end, and the persons booked by the batch are marked
+	booked = (bool*) calloc(data->population.count > 0 ? data->population.count : 1, sizeof(bool));
+	assert(booked != NULL);
+	api_initBooking(&booking, hcenterFound, timestamp, booked);
+	
+	for (i = 0; i < count; i++){
+		first = booking.pending.count;
+		results[i] = api_bookNext(data, &booking, documents[i]);
+		if (results[i] == E_SUCCESS){
+			api_logAppointment(data, API_LOG_BOOKING, hcenterFound->cp, documents[i], booking.pending.elems[first].vaccine->name, booking.timestamp);
+		}
+	}
+	
+	appointmentData_insertBatch(&(hcenterFound->appointments), booking.pending.elems, booking.pending.count);
+	if (booking.pending.elems != NULL){
+		free(booking.pending.elems);
+	}
+	free(booked);
+	
+	return E_SUCCESS;
+}
+
+// Book the requests of the centers of a worker. Runs on a worker thread, only modifying the centers of the worker
+static void* api_scheduleCenters(void* arg) {
+	tApiScheduleWorker* worker;
+	tApiCenterRequests* center;
+	tAppointment* sorted;
+	int sortedCapacity;
+	int i, j;
+	
+	worker = (tApiScheduleWorker*) arg;
+	sorted = NULL;
+	sortedCapacity = 0;
+	
+	for (i = worker->first; i < worker->numCenters; i += worker->step){
+		center = &(worker->centers[i]);
+		center->booking.booked = worker->booked;
+		for (j = 0; j < center->count; j++){
+			worker->results[center->requests[j]] = api_bookNext(worker->data, &(center->booking), worker->documents[center->requests[j]]);
+		}
+		
+		// The calendar is merged with a sorted copy, as the booking order is needed to fill the index of persons
+		sorted = (tAppointment*) array_grow(sorted, &sortedCapacity, center->booking.pending.count, sizeof(tAppointment));
+		if (center->booking.pending.count > 0){
+			memcpy(sorted, center->booking.pending.elems, center->booking.pending.count * sizeof(tAppointment));
+		}
+		appointmentData_merge(&(center->booking.center->appointments), sorted, center->booking.pending.count);
+		
+		// Clear the marks of the booked persons for the next center
+		for (j = 0; j < center->booking.pending.count; j++){
+			worker->booked[center->booking.pending.elems[j].person - worker->data->population.elems] = false;
+		}
+	}
+	
+	if (sorted != NULL){
+		free(sorted);
+	}
+	return NULL;
+}
+
+// Find available vaccination appointments for a list of requests of any health center, booked in order. Centers are processed in parallel with the given number of threads
+tApiError api_findAppointmentAvailabilityParallel(tApiData* data, const char** cps, const char** documents, int count, tDateTime timestamp, tApiError* results, int numThreads) {
+	tApiCenterRequests* centers;
+	tApiCenterRequests* center;
+	tApiScheduleWorker* workers;
+	pthread_t* threads;
+	tAppointment* pending;
+	int* centerRequests;
+	int* requestCenter;
+	int numCenters;
+	int pos, first, last, i;
+	
+	assert(data != NULL);
+	assert(cps != NULL || count == 0);
+	assert(documents != NULL || count == 0);
+	assert(results != NULL || count == 0);
+	assert(numThreads > 0);
+	
+	centers = (tApiCenterRequests*) calloc(data->centers.count > 0 ? data->centers.count : 1, sizeof(tApiCenterRequests));
+	centerRequests = (int*) malloc((data->centers.count > 0 ? data->centers.count : 1) * sizeof(int));
+	requestCenter = (int*) malloc((count > 0 ? count : 1) * sizeof(int));
+	workers = (tApiScheduleWorker*) calloc(numThreads, sizeof(tApiScheduleWorker));
+	threads = (pthread_t*) malloc(numThreads * sizeof(pthread_t));
+	if (centers == NULL || centerRequests == NULL || requestCenter == NULL || workers == NULL || threads == NULL){
+		free(centers);
+		free(centerRequests);
+		free(requestCenter);
+		free(workers);
+		free(threads);
+		return E_MEMORY_ERROR;
+	}
+	
+	// Split the requests by center, keeping their order. Each center is owned by a single worker
+	numCenters = 0;
+	for (i = 0; i < data->centers.count; i++){
+		centerRequests[i] = -1;
+	}
+	for (i = 0; i < count; i++){
+		pos = centerList_findPosition(&(data->centers), cps[i]);
+		if (pos < 0){
+			results[i] = population_find(&(data->population), documents[i]) == -1 ? E_PERSON_NOT_FOUND : E_HEALTH_CENTER_NOT_FOUND;
+			requestCenter[i] = -1;
+			continue;
+		}
+		if (centerRequests[pos] < 0){
+			centerRequests[pos] = numCenters;
+			api_initBooking(&(centers[numCenters].booking), centerList_get(&(data->centers), pos), timestamp, NULL);
+			numCenters++;
+		}
+		requestCenter[i] = centerRequests[pos];
+		center = &(centers[requestCenter[i]]);
+		center->requests = (int*) array_grow(center->requests, &(center->capacity), center->count + 1, sizeof(int));
+		center->requests[center->count] = i;
+		center->count++;
+	}
+	
+	// Book the centers in parallel. The current thread runs the first worker
+	if (numThreads > numCenters){
+		numThreads = numCenters > 0 ? numCenters : 1;
+	}
+	for (i = 0; i < numThreads; i++){
+		workers[i].data = data;
+		workers[i].documents = documents;
+		workers[i].results = results;
+		workers[i].centers = centers;
+		workers[i].numCenters = numCenters;
+		workers[i].first = i;
+		workers[i].step = numThreads;
+		workers[i].booked = (bool*) calloc(data->population.count > 0 ? data->population.count : 1, sizeof(bool));
+		assert(workers[i].booked != NULL);
+	}
+	for (i = 1; i < numThreads; i++){
+		// If the thread cannot be created, the worker runs later on the current thread
+		workers[i].threaded = (pthread_create(&(threads[i]), NULL, api_scheduleCenters, &(workers[i])) == 0);
+	}
+	api_scheduleCenters(&(workers[0]));
+	for (i = 1; i < numThreads; i++){
+		if (workers[i].threaded){
+			pthread_join(threads[i], NULL);
+		} else {
+			api_scheduleCenters(&(workers[i]));
+		}
+	}
+	
+	// The index of persons is shared, so it is filled in request order once all the centers are booked
+	for (i = 0; i < count; i++){
+		if (results[i] == E_SUCCESS){
+			// The appointments of the request are the next ones of its center, all for the same person
+			center = &(centers[requestCenter[i]]);
+			pending = center->booking.pending.elems;
+			first = center->indexed;
+			last = first;
+			while (last < center->booking.pending.count && pending[last].person == pending[first].person){
+				last++;
 			}
-			return E_SUCCESS;
+			appointmentData_indexBatch(&(center->booking.center->appointments), &(pending[first]), last - first);
+			center->indexed = last;
+			
+			// The first appointment of a booking is on the booked day
+			api_logAppointment(data, API_LOG_BOOKING, center->booking.center->cp, documents[i], pending[first].vaccine->name, pending[first].timestamp);
 		}
-		dateTime_addDay(&timestamp, 1);
 	}
-		return E_NO_VACCINES;
+	
+	for (i = 0; i < numThreads; i++){
+		free(workers[i].booked);
 	}
-	return E_NO_VACCINES;
+	for (i = 0; i < numCenters; i++){
+		free(centers[i].requests);
+		free(centers[i].booking.pending.elems);
+	}
+	free(centers);
+	free(centerRequests);
+	free(requestCenter);
+	free(workers);
+	free(threads);
+	
+	return E_SUCCESS;
+}
+
+// Log a change of a vaccine lot, as a CSV line with its current data
+static void api_logLot(tApiData* data, int type, tVaccineLot* lot) {
+    char buffer[2048];
+    tCSVView view;
+    int len;
+    
+    if (data->log != NULL) {
+        len = sprintf(buffer, "VACCINE_LOT;");
+        api_printLot(buffer + len, lot);
+        csv_parseView(&view, buffer, strlen(buffer), NULL);
+        api_logView(data, type, &view);
+    }
+}
+
+// Replace the data of the person at a given position by a CSV view with the same document
+static void api_updatePerson(tApiData* data, int pos, const tCSVView* view) {
+    population_updateView(&(data->population), pos, view);
+    if (data->columns != NULL) {
+        populationColumns_set(data->columns, pos, &(data->population.elems[pos]));
+    }
+    api_logView(data, API_LOG_UPDATE, view);
+}
+
+// Set the doses of the lot at a given position, updating the stock of its center
+static void api_setLotDoses(tApiData* data, int idx, int doses) {
+    tVaccineLot* lot;
+    tHealthCenter* center;
+    
+    lot = &(data->vaccineLots.elems[idx]);
+    center = centerList_find(&(data->centers), lot->cp);
+    if (center != NULL) {
+        stockList_update(&(center->stock), lot->timestamp.date, lot->vaccine, doses - lot->doses);
+    }
+    lot->doses = doses;
+    api_logLot(data, API_LOG_UPDATE, lot);
+}
+
+// Remove the lot at a given position, removing its doses from the stock of its center
+static void api_removeLot(tApiData* data, int idx) {
+    tVaccineLot* lot;
+    tHealthCenter* center;
+    
+    lot = &(data->vaccineLots.elems[idx]);
+    center = centerList_find(&(data->centers), lot->cp);
+    if (center != NULL) {
+        stockList_update(&(center->stock), lot->timestamp.date, lot->vaccine, -lot->doses);
+    }
+    api_logLot(data, API_LOG_DELETE, lot);
+    vaccineLotData_removeAt(&(data->vaccineLots), idx);
+}
+
+// Remove the person at a given position, cancelling its appointments. The last person is moved to its position
+static void api_removePerson(tApiData* data, int pos) {
+    tPerson* person;
+    tPerson* last;
+    tPersonAppointments* appointments;
+    tPersonAppointment* appointment;
+    tHealthCenter* center;
+    tAppointmentData* list;
+    int count;
+    int i, j;
+    
+    person = &(data->population.elems[pos]);
+    if (api_beginLog(data, API_LOG_DELETE)) {
+        wal_write(data->log, "PERSON;", 7);
+        wal_write(data->log, person->document, strlen(person->document));
+        wal_end(data->log);
+    }
+    
+    // Cancel the appointments, from the last one, as each removal also updates the index
+    appointments = appointmentIndex_find(&(data->personAppointments), person->document);
+    while (appointments != NULL && appointments->count > 0) {
+        appointment = &(appointments->elems[appointments->count - 1]);
+        center = centerList_find(&(data->centers), appointment->cp);
+        count = appointments->count;
+        if (center != NULL) {
+            appointmentData_remove(&(center->appointments), appointment->timestamp, person);
+        }
+        if (appointments->count == count) {
+            appointments->count--;
+        }
+    }
+    
+    // The appointments of the last person will reference its new position
+    last = &(data->population.elems[data->population.count - 1]);
+    appointments = appointmentIndex_find(&(data->personAppointments), last->document);
+    if (last != person && appointments != NULL) {
+        for (i = 0; i < appointments->count; i++) {
+            center = centerList_find(&(data->centers), appointments->elems[i].cp);
+            if (center == NULL) {
+                continue;
+            }
+            list = &(center->appointments);
+            j = appointmentData_findTimestamp(list, appointments->elems[i].timestamp, 0);
+            while (j >= 0 && j < list->count && dateTime_cmp(list->elems[j].timestamp, appointments->elems[i].timestamp) == 0) {
+                if (list->elems[j].person == last) {
+                    list->elems[j].person = person;
+                }
+                j++;
+            }
+        }
+    }
+    
+    population_removeAt(&(data->population), pos);
+    if (data->columns != NULL) {
+        populationColumns_removeAt(data->columns, pos);
+    }
+}
+
+// Synchronize a person of a feed. Returns the error of the row
+static tApiError api_syncPerson(tApiData* data, tApiSync* sync, const tCSVView* view) {
+    tApiError error;
+    int pos;
+    
+    if (view->numFields != 7) {
+        return E_INVALID_ENTRY_FORMAT;
+    }
+    
+    pos = sync->nextPerson;
+    if (pos >= data->population.count || !csv_fieldEquals(view->fields[0], data->population.elems[pos].document)) {
+        pos = population_findn(&(data->population), view->fields[0].str, view->fields[0].len);
+    }
+    if (pos < 0) {
+        error = api_addDataView(data, view);
+        if (error == E_SUCCESS) {
+            sync->stats.inserted++;
+        }
+        return error;
+    }
+    
+    // Persons added by the feed, or already found on it, are repeated
+    if (pos >= sync->numPersons || sync->persons[pos]) {
+        return E_DUPLICATED_PERSON;
+    }
+    sync->persons[pos] = true;
+    sync->nextPerson = pos + 1;
+    
+    if (person_equalsView(&(data->population.elems[pos]), view)) {
+        sync->stats.unchanged++;
+    } else {
+        api_updatePerson(data, pos, view);
+        sync->stats.changed++;
+    }
+    
+    return E_SUCCESS;
+}
+
+// Synchronize a vaccine lot of a feed. Doses of existing lots are added up, and applied once the whole feed is read. Returns the error of the row
+static tApiError api_syncLot(tApiData* data, tApiSync* sync, const tCSVView* view) {
+    tApiError error;
+    tVaccine vaccine;
+    tVaccineLot lot;
+    char cp[512];
+    char name[512];
+    int idx;
+    
+    if (view->numFields != 7) {
+        return E_INVALID_ENTRY_FORMAT;
+    }
+    
+    vaccineLot_parseView(&vaccine, &lot, view, cp, name, 512);
+    idx = sync->nextLot;
+    if (idx >= data->vaccineLots.count || !dateTime_equals(data->vaccineLots.elems[idx].timestamp, lot.timestamp)
+        || strcmp(data->vaccineLots.elems[idx].cp, cp) != 0 || strcmp(data->vaccineLots.elems[idx].vaccine->name, name) != 0) {
+        idx = vaccineLotData_find(&(data->vaccineLots), cp, name, lot.timestamp);
+    }
+    
+    // New lots are added as on a load, so repeated rows also add their doses
+    if (idx < 0 || idx >= sync->numLots) {
+        error = api_addDataView(data, view);
+        if (error == E_SUCCESS && idx < 0) {
+            sync->stats.inserted++;
+        }
+        return error;
+    }
+    
+    sync->lots[idx] = true;
+    sync->doses[idx] += lot.doses;
+    sync->nextLot = idx + 1;
+    
+    return E_SUCCESS;
+}
+
+// Synchronize the persons and vaccine lots with a new version of a CSV feed, applying only the rows inserted, changed or removed.
+// Appointments of removed persons are cancelled. If the feed has invalid rows, no row is removed. If stats is not NULL, the number of rows applied is stored on it.
+// Removing a person or a lot moves the last one to its position, so positions on the population and the lots are not kept across a sync
+tApiError api_syncData(tApiData* data, const char* filename, tApiSyncStats* stats) {
+    tApiError error;
+    tApiError result;
+    tApiSync sync;
+    tCSVFile file;
+    tCSVView view;
+    const char *pos, *next, *end;
+    int len;
+    int i;
+    
+    assert(data != NULL);
+    assert(filename != NULL);
+    
+    if (!csv_openFile(&file, filename)) {
+        return E_FILE_NOT_FOUND;
+    }
+    
+    sync.numPersons = data->population.count;
+    sync.numLots = data->vaccineLots.count;
+    sync.persons = (bool*) calloc(sync.numPersons > 0 ? sync.numPersons : 1, sizeof(bool));
+    sync.lots = (bool*) calloc(sync.numLots > 0 ? sync.numLots : 1, sizeof(bool));
+    sync.doses = (int*) calloc(sync.numLots > 0 ? sync.numLots : 1, sizeof(int));
+    assert(sync.persons != NULL && sync.lots != NULL && sync.doses != NULL);
+    sync.nextPerson = 0;
+    sync.nextLot = 0;
+    memset(&(sync.stats), 0, sizeof(tApiSyncStats));
+    
+    // Apply the inserted and changed persons and the new lots, keeping the first error
+    result = E_SUCCESS;
+    pos = file.data;
+    end = file.data + file.size;
+    while (pos < end) {
+        next = csv_nextLine(pos, end, &len);
+        
+        // Skip empty lines
+        if (len > 0) {
+            csv_parseView(&view, pos, len, NULL);
+            if (csv_fieldEquals(view.type, "PERSON")) {
+                error = api_syncPerson(data, &sync, &view);
+            } else if (csv_fieldEquals(view.type, "VACCINE_LOT")) {
+                error = api_syncLot(data, &sync, &view);
+            } else {
+                error = E_INVALID_ENTRY_TYPE;
+            }
+            if (result == E_SUCCESS) {
+                result = error;
+            }
+        }
+        pos = next;
+    }
+    csv_closeFile(&file);
+    
+    // Apply the doses of the lots found on the feed
+    for (i = 0; i < sync.numLots; i++) {
+        if (sync.lots[i] && sync.doses[i] != data->vaccineLots.elems[i].doses) {
+            api_setLotDoses(data, i, sync.doses[i]);
+            sync.stats.changed++;
+        } else if (sync.lots[i]) {
+            sync.stats.unchanged++;
+        }
+    }
+    
+    // Remove the rows not found on the feed. Removing from the end, the row moved to each free position is already processed
+    if (result == E_SUCCESS) {
+        for (i = sync.numLots - 1; i >= 0; i--) {
+            if (!sync.lots[i]) {
+                api_removeLot(data, i);
+                sync.stats.removed++;
+            }
+        }
+        for (i = sync.numPersons - 1; i >= 0; i--) {
+            if (!sync.persons[i]) {
+                api_removePerson(data, i);
+                sync.stats.removed++;
+            }
+        }
+    }
+    
+    if (stats != NULL) {
+        *stats = sync.stats;
+    }
+    free(sync.persons);
+    free(sync.lots);
+    free(sync.doses);
+    
+    return result;
+}
+
+// Apply a change of a person or a vaccine lot logged by a synchronization
+static tApiError api_replayChange(tApiData* data, int type, const tCSVView* view) {
+    tVaccine vaccine;
+    tVaccineLot lot;
+    char cp[512];
+    char name[512];
+    int pos;
+    
+    if (csv_fieldEquals(view->type, "PERSON") && view->numFields >= 1) {
+        pos = population_findn(&(data->population), view->fields[0].str, view->fields[0].len);
+        if (pos < 0 || (type == API_LOG_UPDATE && view->numFields != 7)) {
+            return E_INVALID_LOG;
+        }
+        if (type == API_LOG_UPDATE) {
+            api_updatePerson(data, pos, view);
+        } else {
+            api_removePerson(data, pos);
+        }
+        return E_SUCCESS;
+    } else if (csv_fieldEquals(view->type, "VACCINE_LOT") && view->numFields == 7) {
+        vaccineLot_parseView(&vaccine, &lot, view, cp, name, 512);
+        pos = vaccineLotData_find(&(data->vaccineLots), cp, name, lot.timestamp);
+        if (pos < 0) {
+            return E_INVALID_LOG;
+        }
+        if (type == API_LOG_UPDATE) {
+            api_setLotDoses(data, pos, lot.doses);
+        } else {
+            api_removeLot(data, pos);
+        }
+        return E_SUCCESS;
+    }
+    
+    return E_INVALID_LOG;
+}
+
+// Read the timestamp and the cp, document and vaccine of an appointment record of the log. Returns false if the record is not valid
+static bool api_readLogAppointment(const tWalRecord* record, tDateTime* timestamp, const char** strings) {
+    const char* pos;
+    const char* end;
+    int i;
+    
+    if (record->size < (int) sizeof(tDateTime)) {
+        return false;
+    }
+    memcpy(timestamp, record->data, sizeof(tDateTime));
+    
+    // Each string must end inside the record
+    pos = record->data + sizeof(tDateTime);
+    end = record->data + record->size;
+    for (i = 0; i < 3; i++) {
+        strings[i] = pos;
+        pos = (const char*) memchr(pos, '\0', end - pos);
+        if (pos == NULL) {
+            return false;
+        }
+        pos++;
+    }
+    
+    return true;
+}
+
+// Apply a change of the log to the data, as it was applied when it was logged
+static tApiError api_replayRecord(tApiData* data, const tWalRecord* record) {
+    tCSVView view;
+    tDateTime timestamp;
+    const char* strings[3];
+    tHealthCenter* center;
+    tVaccine* vaccine;
+    int person_idx;
+    
+    if (record->type == API_LOG_ENTRY) {
+        csv_parseView(&view, record->data, record->size, NULL);
+        return api_addDataView(data, &view);
+    } else if (record->type == API_LOG_RESET) {
+        return api_resetData(data);
+    } else if (record->type == API_LOG_UPDATE || record->type == API_LOG_DELETE) {
+        csv_parseView(&view, record->data, record->size, NULL);
+        return api_replayChange(data, record->type, &view);
+    }
+    
+    if (!api_readLogAppointment(record, &timestamp, strings)) {
+        return E_INVALID_LOG;
+    }
+    if (record->type == API_LOG_APPOINTMENT) {
+        return api_addAppointment(data, strings[0], strings[1], strings[2], timestamp);
+    } else if (record->type == API_LOG_REMOVE) {
+        return api_removeAppointment(data, strings[0], strings[1], timestamp);
+    } else if (record->type == API_LOG_BOOKING) {
+        // The day of the booking is logged, so the availability is not searched again
+        center = centerList_find(&(data->centers), strings[0]);
+        person_idx = population_find(&(data->population), strings[1]);
+        vaccine = vaccineList_find(&(data->vaccines), strings[2]);
+        if (center == NULL || person_idx < 0 || vaccine == NULL) {
+            return E_INVALID_LOG;
+        }
+        api_bookDoses(center, NULL, &(data->population.elems[person_idx]), vaccine, timestamp);
+        return E_SUCCESS;
+    }
+    
+    return E_INVALID_LOG;
+}
+
+// Apply the changes of a log after the last change of the data. The size of the valid part of the log is stored on size
+static tApiError api_replayLog(tApiData* data, const char* filename, long long* size) {
+    tWalReader reader;
+    tWalRecord record;
+    tApiError error;
+    
+    *size = 0;
+    if (!wal_openReader(&reader, filename)) {
+        return reader.failed ? E_INVALID_LOG : E_SUCCESS;
+    }
+    
+    // Changes already on the snapshot are skipped. The last records may not be completely written, so they are ignored
+    error = E_SUCCESS;
+    while (error == E_SUCCESS && wal_next(&reader, &record)) {
+        if (record.lsn <= data->lsn) {
+            continue;
+        }
+        if (record.lsn != data->lsn + 1 || api_replayRecord(data, &record) != E_SUCCESS) {
+            error = E_INVALID_LOG;
+        }
+        data->lsn = record.lsn;
+    }
+    *size = reader.pos;
+    wal_closeReader(&reader);
+    
+    return error;
+}
+
+// Recover the data from a snapshot and the changes of the log written after it, and append the next changes to the log.
+// Missing files are taken as empty. Changes are synced in groups of groupSize changes
+tApiError api_recoverData(tApiData* data, tWal* log, const char* snapshot, const char* logFile, int groupSize) {
+    tApiError error;
+    long long size;
+    
+    assert(data != NULL);
+    assert(log != NULL);
+    assert(snapshot != NULL);
+    assert(logFile != NULL);
+    
+    error = api_loadSnapshot(data, snapshot);
+    if (error != E_SUCCESS && error != E_FILE_NOT_FOUND) {
+        return error;
+    }
+    
+    error = api_replayLog(data, logFile, &size);
+    if (error == E_SUCCESS && !wal_open(log, logFile, size, groupSize)) {
+        error = E_FILE_NOT_FOUND;
+    }
+    
+    // Partial data is never kept
+    if (error != E_SUCCESS) {
+        api_freeData(data);
+        api_initData(data);
+        return error;
+    }
+    
+    data->log = log;
+    return E_SUCCESS;
+}
+
+// Save the data on a new snapshot and empty its log, so it only has the changes after the snapshot
+tApiError api_compactLog(tApiData* data, const char* snapshot, const char* logFile) {
+    tApiError error;
+    char* filename;
+    
+    assert(data != NULL);
+    assert(data->log != NULL);
+    assert(snapshot != NULL);
+    assert(logFile != NULL);
+    
+    // The new snapshot replaces the previous one once it is completely written. Until the log is emptied, its changes are skipped by their sequence number
+    filename = (char*) malloc(strlen(snapshot) + 5);
+    assert(filename != NULL);
+    sprintf(filename, "%s.tmp", snapshot);
+    error = api_saveSnapshot(data, filename);
+    if (error == E_SUCCESS && rename(filename, snapshot) != 0) {
+        error = E_FILE_NOT_FOUND;
+    }
+    free(filename);
+    if (error != E_SUCCESS) {
+        return error;
+    }
+    
+    wal_close(data->log);
+    if (!wal_open(data->log, logFile, 0, data->log->groupSize)) {
+        data->log = NULL;
+        return E_FILE_NOT_FOUND;
+    }
+    
+    return E_SUCCESS;
+}
+
+// Write the pending changes of the log to the disk. Returns E_FILE_NOT_FOUND if any change could not be written
+tApiError api_syncLog(tApiData* data) {
+    assert(data != NULL);
+    assert(data->log != NULL);
+    
+    return wal_sync(data->log) ? E_SUCCESS : E_FILE_NOT_FOUND;
+}
+
+// Sync and close the log of the data. Next changes are not logged
+tApiError api_closeLog(tApiData* data) {
+    bool closed;
+    
+    assert(data != NULL);
+    assert(data->log != NULL);
+    
+    closed = wal_close(data->log);
+    data->log = NULL;
+    
+    return closed ? E_SUCCESS : E_FILE_NOT_FOUND;
+}
+
+// Store the population also by columns, building them with the current persons. Next changes of the persons are applied to them.
+// The columns are initialized by this call, and released with populationColumns_free
+tApiError api_enableColumns(tApiData* data, tPopulationColumns* columns) {
+    assert(data != NULL);
+    assert(columns != NULL);
+    
+    populationColumns_init(columns, &(data->strings));
+    populationColumns_build(columns, &(data->population));
+    data->columns = columns;
+    
+    return E_SUCCESS;
+}
+
+// Stop storing the population by columns. The columns are not released, and they keep the persons they had
+tApiError api_disableColumns(tApiData* data) {
+    assert(data != NULL);
+    
+    data->columns = NULL;
+    
+    return E_SUCCESS;
+}
+
+// Mark the persons with appointments on any center, on their positions of the population
+static void api_bookedPersons(tApiData* data, tCohortSelection* booked) {
+    tAppointmentData* appointments;
+    int i, j;
+    
+    cohortSelection_init(booked, data->population.count);
+    for (i = 0; i < data->centers.count; i++) {
+        appointments = &(centerList_get(&(data->centers), i)->appointments);
+        for (j = 0; j < appointments->count; j++) {
+            cohortSelection_add(booked, (int) (appointments->elems[j].person - data->population.elems));
+        }
+    }
+}
+
+// Select the persons matching a cohort query, on their positions of the population. If the population is not stored by columns, they are built for the query.
+// The selection is initialized by this call
+tApiError api_selectCohort(tApiData* data, const tCohortQuery* query, tCohortSelection* selection) {
+    tPopulationColumns columns;
+    tCohortSelection booked;
+    
+    assert(data != NULL);
+    assert(query != NULL);
+    assert(selection != NULL);
+    
+    if (data->columns == NULL) {
+        populationColumns_init(&columns, &(data->strings));
+        populationColumns_build(&columns, &(data->population));
+    }
+    
+    // Appointments are only checked once for all the persons, scanning the calendars of the centers
+    if (query->withoutAppointment) {
+        api_bookedPersons(data, &booked);
+    }
+    cohortQuery_select(query, data->columns != NULL ? data->columns : &columns, query->withoutAppointment ? &booked : NULL, selection);
+    
+    if (query->withoutAppointment) {
+        cohortSelection_free(&booked);
+    }
+    if (data->columns == NULL) {
+        populationColumns_free(&columns);
+    }
+    
+    return E_SUCCESS;
+}
+
+// Initialize the data shared between threads
+tApiError api_initSharedData(tApiSharedData* shared) {
+    pthread_rwlockattr_t attr;
+    tApiError error;
+    
+    assert(shared != NULL);
+    
+    error = api_initData(&(shared->data));
+    if (error != E_SUCCESS) {
+        return error;
+    }
+    
+    if (pthread_rwlockattr_init(&attr) != 0) {
+        api_freeData(&(shared->data));
+        return E_MEMORY_ERROR;
+    }
+#ifdef __GLIBC__
+    // Readers come continuously, so by default the writer could wait forever
+    pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+    if (pthread_rwlock_init(&(shared->lock), &attr) != 0) {
+        error = E_MEMORY_ERROR;
+        api_freeData(&(shared->data));
+    }
+    pthread_rwlockattr_destroy(&attr);
+    
+    return error;
+}
+
+// Free all the memory of the data shared between threads
+tApiError api_freeSharedData(tApiSharedData* shared) {
+    assert(shared != NULL);
+    
+    pthread_rwlock_destroy(&(shared->lock));
+    
+    return api_freeData(&(shared->data));
+}
+
+// Start reading the shared data. Other threads can also read it, and it is not modified until api_endRead
+const tApiData* api_beginRead(tApiSharedData* shared) {
+    assert(shared != NULL);
+    
+    pthread_rwlock_rdlock(&(shared->lock));
+    
+    return &(shared->data);
+}
+
+// Stop reading the shared data
+void api_endRead(tApiSharedData* shared) {
+    assert(shared != NULL);
+    
+    pthread_rwlock_unlock(&(shared->lock));
+}
+
+// Start modifying the shared data. No other thread can access it until api_endWrite
+tApiData* api_beginWrite(tApiSharedData* shared) {
+    assert(shared != NULL);
+    
+    pthread_rwlock_wrlock(&(shared->lock));
+    
+    return &(shared->data);
+}
+
+// Stop modifying the shared data
+void api_endWrite(tApiSharedData* shared) {
+    assert(shared != NULL);
+    
+    pthread_rwlock_unlock(&(shared->lock));
+}
+
+// Add a new entry to the shared data
+tApiError api_sharedAddDataEntry(tApiSharedData* shared, tCSVEntry entry) {
+    tApiError error;
+    
+    error = api_addDataEntry(api_beginWrite(shared), entry);
+    api_endWrite(shared);
+    
+    return error;
+}
+
+// Get vaccine lot data from the shared data
+tApiError api_sharedGetVaccineLot(tApiSharedData* shared, const char* cp, const char* vaccine, tDateTime timestamp, tCSVEntry *entry) {
+    tApiError error;
+    
+    error = api_getVaccineLot(api_beginRead(shared), cp, vaccine, timestamp, entry);
+    api_endRead(shared);
+    
+    return error;
+}
+
+// Get person appointments from the shared data
+tApiError api_sharedGetPersonAppointments(tApiSharedData* shared, const char* document, tCSVData *appointments) {
+    tApiError error;
+    
+    error = api_getPersonAppointments(api_beginRead(shared), document, appointments);
+    api_endRead(shared);
+    
+    return error;
+}
+
+// Check availability of a vaccine in a given health center of the shared data
+bool api_sharedCheckAvailability(tApiSharedData* shared, const char* cp, const char* vaccine, tDate date) {
+    bool available;
+    
+    available = api_checkAvailability(api_beginRead(shared), cp, vaccine, date);
+    api_endRead(shared);
+    
+    return available;
 }
@@ -2,6 +2,8 @@
 #include <assert.h>
 #include <stdlib.h>
 #include "appointment.h"
+#include "array.h"
+#include "hash.h"
 #include <malloc.h>
 
 // Initializes a vaccination appointment data list
@@ -11,6 +13,16 @@ void appointmentData_init(tAppointmentData* list) {
     /////////////////////////////////
 	list->elems=NULL;
 	list->count = 0;
+	list->capacity = 0;
+	list->index = NULL;
+	list->cp = NULL;
+}
+
+// Reserve memory to store at least the given number of appointments
+void appointmentData_reserve(tAppointmentData* list, int size) {
+	assert(list != NULL);
+	
+	list->elems = (tAppointment*) array_reserve(list->elems, &(list->capacity), size, sizeof(tAppointment));
 }
 
 
@@ -36,47 +48,104 @@ void appointmentData_insert(tAppointmentData* list, tDateTime timestamp, tVaccin
 	//////////////////////////////////
     // Ex PR3 1b
     /////////////////////////////////
-	int start_pos = 0, idx =0, i;
-	idx = appointmentData_findTimestamp(list, timestamp, start_pos);
-
-	// If timestamp is last
-    if (idx < 0) {   
-        // Allocate memory for new element
-		if (list->count == 0) {
-			// Request new memory space
-			list->elems = (tAppointment*) malloc(sizeof(tAppointment));            
-		} else {
-			// Modify currently allocated memory
-			list->elems = (tAppointment*) realloc(list->elems, (list->count + 1) * sizeof(tAppointment));            
-		}
-        appointment_init(&(list->elems[list->count]), person, vaccine, timestamp);
-        // Increase the number of elements
-        list->count ++;
-    } else {
-		start_pos = idx;
-		idx = appointmentData_findDocument(list, timestamp, person->document, start_pos);
-		
-		if (idx < 0){
-			if (list->count == 0) {
-				// Request new memory space
-				list->elems = (tAppointment*) malloc(sizeof(tAppointment));            
-			} else {
-				// Modify currently allocated memory
-				list->elems = (tAppointment*) realloc(list->elems, (list->count + 1) * sizeof(tAppointment));            
-			}
-			appointment_init(&(list->elems[list->count]), person, vaccine, timestamp);
-			// Increase the number of elements
-			list->count ++;
+	int idx;
+	
+	assert(list != NULL);
+	assert(person != NULL);
+	
+	// Appointments are sorted by timestamp and then by document
+	idx = appointmentData_findTimestamp(list, timestamp, 0);
+	if (idx >= 0) {
+		idx = appointmentData_findDocument(list, timestamp, person->document, idx);
+	}
+	if (idx < 0) {
+		idx = list->count;
+	}
+	
+	// Allocate memory for new element
+	list->elems = (tAppointment*) array_grow(list->elems, &(list->capacity), list->count + 1, sizeof(tAppointment));
+	
+	// Shift the following elements and store the new one
+	memmove(&(list->elems[idx + 1]), &(list->elems[idx]), (list->count - idx) * sizeof(tAppointment));
+	appointment_init(&(list->elems[idx]), person, vaccine, timestamp);
+	
+	// Increase the number of elements
+	list->count++;
+	
+	// Keep the appointments of the person
+	if (list->index != NULL) {
+		appointmentIndex_add(list->index, person->document, list->cp, timestamp, vaccine);
+	}
+}
+
+// Compare two appointments by timestamp and then by document
+static int appointment_cmp(const void* a, const void* b) {
+	const tAppointment* appointment1 = (const tAppointment*) a;
+	const tAppointment* appointment2 = (const tAppointment*) b;
+	int cmp;
+	
+	cmp = dateTime_cmp(appointment1->timestamp, appointment2->timestamp);
+	if (cmp == 0) {
+		cmp = strcmp(appointment1->person->document, appointment2->person->document);
+	}
+	return cmp;
+}
+
+// Insert a list of vaccination appointments at once. The list of appointments is sorted
+void appointmentData_insertBatch(tAppointmentData* list, tAppointment* appointments, int count) {
+	assert(list != NULL);
+	assert(appointments != NULL || count == 0);
+	
+	// Keep the appointments of the persons, in the given order
+	appointmentData_indexBatch(list, appointments, count);
+	appointmentData_merge(list, appointments, count);
+}
+
+// Insert a list of vaccination appointments at once, without adding them to the index. The list of appointments is sorted
+void appointmentData_merge(tAppointmentData* list, tAppointment* appointments, int count) {
+	int i, j, k;
+	
+	assert(list != NULL);
+	assert(appointments != NULL || count == 0);
+	
+	if (count == 0) {
+		return;
+	}
+	
+	qsort(appointments, count, sizeof(tAppointment), appointment_cmp);
+	
+	// Allocate memory for the new elements
+	list->elems = (tAppointment*) array_grow(list->elems, &(list->capacity), list->count + count, sizeof(tAppointment));
+	
+	// Merge from the end, so each element is moved only once. New appointments go before equal ones, as on appointmentData_insert
+	i = list->count - 1;
+	j = count - 1;
+	k = list->count + count - 1;
+	while (j >= 0) {
+		if (i >= 0 && appointment_cmp(&(list->elems[i]), &(appointments[j])) >= 0) {
+			list->elems[k--] = list->elems[i--];
 		} else {
-			list->elems = (tAppointment*) realloc(list->elems, (list->count + 1) * sizeof(tAppointment));
-			for (i=list->count; i>=idx; i--){
-				appointment_init(&(list->elems[i]), list->elems[i-1].person, list->elems[i-1].vaccine, list->elems[i-1].timestamp);
-			}
-			appointment_init(&(list->elems[idx]), person, vaccine, timestamp);
-			// Increase the number of elements
-			list->count ++;
+			list->elems[k--] = appointments[j--];
 		}
 	}
+	
+	// Increase the number of elements
+	list->count += count;
+}
+
+// Add a list of vaccination appointments of the list to its index, in the given order
+void appointmentData_indexBatch(tAppointmentData* list, const tAppointment* appointments, int count) {
+	int i;
+	
+	assert(list != NULL);
+	assert(appointments != NULL || count == 0);
+	
+	if (list->index == NULL) {
+		return;
+	}
+	for (i = 0; i < count; i++) {
+		appointmentIndex_add(list->index, appointments[i].person->document, list->cp, appointments[i].timestamp, appointments[i].vaccine);
+	}
 }
 
 // Remove a vaccination appointment
@@ -84,93 +153,113 @@ void appointmentData_remove(tAppointmentData* list, tDateTime timestamp, tPerson
     //////////////////////////////////
     // Ex PR3 1c
     /////////////////////////////////
-	int idx =0, start_pos=0, i=0, j=0;
-	bool found=false;
-
+	int i;
 	
-	while ((i < list->count) && (!found)){
-		if ((dateTime_cmp(list->elems[i].timestamp, timestamp) == 0) && 
-			(list->elems[i].person == person)){
-			found = true;
-		}
+	assert(list != NULL);
+	
+	// Search the person between the appointments with the same timestamp
+	i = appointmentData_findTimestamp(list, timestamp, 0);
+	while (i >= 0 && i < list->count && list->elems[i].person != person && dateTime_cmp(list->elems[i].timestamp, timestamp) == 0) {
 		i++;
 	}
 	
-	
-	if (found){
-		i = i-1;
-		if (i>=0 && i<=list->count){
-			for (j=i; j < list->count-1; j++){
-				/*appointment_free(&(list->elems[j]));*/
-				appointment_init(&(list->elems[j]), list->elems[j+1].person, list->elems[j+1].vaccine, list->elems[j+1].timestamp);
-				/*list->elems[j] = list->elems[j+1];*/
-			}
-			/*appointment_free(&(list->elems[list->count]));*/
-			list->count--;
-			if (list->count == 0){
-				free(list->elems);
-				list->elems = NULL;
-			} else {
-				list->elems = (tAppointment*)realloc(list->elems, list->count * sizeof(tAppointment));
-				if (list->elems == NULL) {
-					printf("Error, resize memory fail/n");
-				}
-			}
+	if (i >= 0 && i < list->count && list->elems[i].person == person && dateTime_cmp(list->elems[i].timestamp, timestamp) == 0) {
+		if (list->index != NULL) {
+			appointmentIndex_remove(list->index, person->document, list->cp, timestamp);
+		}
+		
+		// Shift the following elements
+		memmove(&(list->elems[i]), &(list->elems[i + 1]), (list->count - i - 1) * sizeof(tAppointment));
+		list->count--;
+		// Release the memory when no element is remaining. Otherwise the capacity is kept for new elements
+		if (list->count == 0){
+			free(list->elems);
+			list->elems = NULL;
+			list->capacity = 0;
 		}
 	}
 }
 
 
 // Find the first instance of a vaccination appointment for given person
-int appointmentData_find(tAppointmentData list, tPerson* person, int start_pos) {
+int appointmentData_find(const tAppointmentData* list, tPerson* person, int start_pos) {
     //////////////////////////////////
     // Ex PR3 1d
     /////////////////////////////////
-	if (start_pos >= list.count  || start_pos < 0){
+	int i;
+	
+	assert(list != NULL);
+	
+	if (start_pos < 0) {
 		return -1;
-	} else {
-		if (list.elems[start_pos].person == person){
-			return start_pos;
-		} else {
-			start_pos++;
-			appointmentData_find(list, person, start_pos);
+	}
+	
+	// Appointments are not sorted by person
+	for (i = start_pos; i < list->count; i++) {
+		if (list->elems[i].person == person) {
+			return i;
 		}
 	}
 	
+	return -1;
 }
 
 // Find the first instance of a vaccination appointment with bigger or equal timestamp
-int appointmentData_findTimestamp(tAppointmentData *list, tDateTime timestamp, int start_pos) {
+int appointmentData_findTimestamp(const tAppointmentData *list, tDateTime timestamp, int start_pos) {
     //////////////////////////////////
     // Ex PR3 1d
     /////////////////////////////////   
+	int first, last, middle;
+	
+	assert(list != NULL);
+	
 	if (start_pos >= list->count  || start_pos < 0){
 		return -1;
-	} else {
-		if (dateTime_cmp(list->elems[start_pos].timestamp, timestamp)>=0){
-			return start_pos;
+	}
+	
+	// Binary search of the lower bound, as appointments are sorted by timestamp
+	first = start_pos;
+	last = list->count;
+	while (first < last) {
+		middle = first + (last - first) / 2;
+		if (dateTime_cmp(list->elems[middle].timestamp, timestamp) < 0) {
+			first = middle + 1;
 		} else {
-			start_pos++;
-			appointmentData_findTimestamp(list, timestamp, start_pos);
+			last = middle;
 		}
 	}
+	
+	return first < list->count ? first : -1;
 }
 
 // Find the first instance of a vaccination appointment with bigger or equal timestamp by document
-int appointmentData_findDocument(tAppointmentData *list, tDateTime timestamp, const char* document, int start_pos) {
+int appointmentData_findDocument(const tAppointmentData *list, tDateTime timestamp, const char* document, int start_pos) {
     //////////////////////////////////
     // Ex PR3 1d
     /////////////////////////////////   
+	int first, last, middle, cmp;
+	
+	assert(list != NULL);
+	assert(document != NULL);
+	
 	if (start_pos >= list->count  || start_pos < 0){
 		return -1;
-	} else {
-		if (strcmp(list->elems[start_pos].person->document, document)>=0 || dateTime_cmp(list->elems[start_pos].timestamp, timestamp)!=0){
-			return start_pos;
+	}
+	
+	// Binary search of the lower bound of (timestamp, document), as appointments with the same timestamp are sorted by document
+	first = start_pos;
+	last = list->count;
+	while (first < last) {
+		middle = first + (last - first) / 2;
+		cmp = dateTime_cmp(list->elems[middle].timestamp, timestamp);
+		if (cmp < 0 || (cmp == 0 && strcmp(list->elems[middle].person->document, document) < 0)) {
+			first = middle + 1;
 		} else {
-			start_pos++;
-			appointmentData_findDocument(list, timestamp, document, start_pos);
+			last = middle;
 		}
 	}
+	
+	return first < list->count ? first : -1;
 }
 
 // Release a vaccination appointment data list
@@ -178,9 +267,315 @@ void appointmentData_free(tAppointmentData* list) {
     //////////////////////////////////
     // Ex PR3 1e
     /////////////////////////////////
+	// The index is released by its owner, so it is not updated
 	if (list->elems != NULL){
 		free(list->elems);
 		list->count=0;
+		list->capacity=0;
 		list->elems=NULL;
 	}
 }
+
+// Check if the person at a given position has the document given by key
+static bool appointmentIndex_equalsKey(const void* data, int pos, const void* key) {
+	return strcmp(((const tAppointmentIndex*) data)->elems[pos].document, (const char*) key) == 0;
+}
+
+// Get the hash of the document of the person at a given position, as stored on the index
+static unsigned int appointmentIndex_hashPerson(const void* data, int pos) {
+	return hash_str(((const tAppointmentIndex*) data)->elems[pos].document);
+}
+
+// Find the slot of the index for a given document. Returns the slot with the person or the empty slot where it should be placed
+static int appointmentIndex_slot(const tAppointmentIndex* index, const char* document) {
+	assert(index != NULL);
+	assert(index->index != NULL);
+	
+	return hash_probe(index->index, index->indexSize, hash_str(document), appointmentIndex_equalsKey, index, document);
+}
+
+// Rebuild the hash index with a size able to store count persons
+static void appointmentIndex_rebuild(tAppointmentIndex* index, int count) {
+	index->index = hash_rebuild(index->index, &(index->indexSize), count, NULL, index->count, appointmentIndex_hashPerson, index);
+}
+
+// Initialize an index of appointments by person
+void appointmentIndex_init(tAppointmentIndex* index) {
+	assert(index != NULL);
+	
+	index->elems = NULL;
+	index->count = 0;
+	index->capacity = 0;
+	index->index = NULL;
+	index->indexSize = 0;
+}
+
+// Release an index of appointments by person
+void appointmentIndex_free(tAppointmentIndex* index) {
+	int i;
+	
+	assert(index != NULL);
+	
+	for (i = 0; i < index->count; i++) {
+		if (index->elems[i].elems != NULL) {
+			free(index->elems[i].elems);
+		}
+	}
+	if (index->elems != NULL) {
+		free(index->elems);
+	}
+	if (index->index != NULL) {
+		free(index->index);
+	}
+	
+	appointmentIndex_init(index);
+}
+
+// Add a vaccination appointment of a person in a health center
+void appointmentIndex_add(tAppointmentIndex* index, const char* document, const char* cp, tDateTime timestamp, tVaccine* vaccine) {
+	tPersonAppointments* person;
+	int slot;
+	int i;
+	
+	assert(index != NULL);
+	assert(document != NULL);
+	assert(cp != NULL);
+	
+	// Grow the hash index when the load factor reaches 0.5
+	if (2 * (index->count + 1) > index->indexSize) {
+		appointmentIndex_rebuild(index, index->count + 1);
+	}
+	
+	slot = appointmentIndex_slot(index, document);
+	if (index->index[slot] == HASH_EMPTY_SLOT) {
+		// First appointment of the person
+		index->elems = (tPersonAppointments*) array_grow(index->elems, &(index->capacity), index->count + 1, sizeof(tPersonAppointments));
+		person = &(index->elems[index->count]);
+		person->document = document;
+		person->elems = NULL;
+		person->count = 0;
+		person->capacity = 0;
+		index->index[slot] = index->count;
+		index->count++;
+	} else {
+		person = &(index->elems[index->index[slot]]);
+	}
+	
+	// Persons have few appointments, so they are kept sorted by insertion
+	person->elems = (tPersonAppointment*) array_grow(person->elems, &(person->capacity), person->count + 1, sizeof(tPersonAppointment));
+	i = person->count;
+	while (i > 0 && dateTime_cmp(person->elems[i - 1].timestamp, timestamp) > 0) {
+		person->elems[i] = person->elems[i - 1];
+		i--;
+	}
+	person->elems[i].cp = cp;
+	person->elems[i].timestamp = timestamp;
+	person->elems[i].vaccine = vaccine;
+	person->count++;
+}
+
+// Remove a vaccination appointment of a person in a health center
+void appointmentIndex_remove(tAppointmentIndex* index, const char* document, const char* cp, tDateTime timestamp) {
+	tPersonAppointments* person;
+	int i;
+	
+	assert(index != NULL);
+	assert(cp != NULL);
+	
+	person = appointmentIndex_find(index, document);
+	if (person != NULL) {
+		for (i = 0; i < person->count; i++) {
+			if (dateTime_cmp(person->elems[i].timestamp, timestamp) == 0 && strcmp(person->elems[i].cp, cp) == 0) {
+				memmove(&(person->elems[i]), &(person->elems[i + 1]), (person->count - i - 1) * sizeof(tPersonAppointment));
+				person->count--;
+				break;
+			}
+		}
+	}
+}
+
+// Find the vaccination appointments of a person. Returns NULL if the person never had appointments
+tPersonAppointments* appointmentIndex_find(const tAppointmentIndex* index, const char* document) {
+	int slot;
+	
+	assert(index != NULL);
+	assert(document != NULL);
+	
+	if (index->count == 0) {
+		return NULL;
+	}
+	
+	slot = appointmentIndex_slot(index, document);
+	if (index->index[slot] == HASH_EMPTY_SLOT) {
+		return NULL;
+	}
+	
+	return &(index->elems[index->index[slot]]);
+}
+
+// Vaccination appointment as stored on a snapshot
+typedef struct _tAppointmentRecord {
+	tDateTime timestamp;
+	// Position of the person on the population and id of the vaccine
+	int person;
+	int vaccine;
+} tAppointmentRecord;
+
+// Vaccination appointment of a person as stored on a snapshot
+typedef struct _tPersonAppointmentRecord {
+	// Position of the cp on the table of strings and id of the vaccine
+	int cp;
+	int vaccine;
+	tDateTime timestamp;
+} tPersonAppointmentRecord;
+
+// Write a vaccination appointment data list on a snapshot. Persons are written by position on the population and vaccines by id
+void appointmentData_save(const tAppointmentData* list, tSnapshotWriter* writer, const tPopulation* population) {
+	tAppointmentRecord* records;
+	int i;
+	
+	assert(list != NULL);
+	assert(writer != NULL);
+	assert(population != NULL);
+	
+	records = (tAppointmentRecord*) malloc((list->count > 0 ? list->count : 1) * sizeof(tAppointmentRecord));
+	assert(records != NULL);
+	for (i = 0; i < list->count; i++) {
+		records[i].timestamp = list->elems[i].timestamp;
+		records[i].person = (int) (list->elems[i].person - population->elems);
+		records[i].vaccine = list->elems[i].vaccine->id;
+	}
+	
+	snapshot_writeInt(writer, list->count);
+	snapshot_write(writer, records, list->count * sizeof(tAppointmentRecord));
+	
+	free(records);
+}
+
+// Read an empty vaccination appointment data list from a snapshot, with the persons and vaccines of the application. Returns false if the snapshot is not valid
+bool appointmentData_load(tAppointmentData* list, tSnapshotReader* reader, const tPopulation* population, const tVaccineList* vaccines) {
+	const tAppointmentRecord* records;
+	tAppointment* appointment;
+	int count;
+	int i;
+	
+	assert(list != NULL);
+	assert(reader != NULL);
+	assert(population != NULL);
+	assert(vaccines != NULL);
+	assert(list->count == 0);
+	
+	count = snapshot_readInt(reader);
+	records = (const tAppointmentRecord*) snapshot_readArray(reader, count, sizeof(tAppointmentRecord));
+	if (records == NULL) {
+		return false;
+	}
+	
+	// Single pass replacing the positions and ids by pointers
+	appointmentData_reserve(list, count);
+	for (i = 0; i < count; i++) {
+		appointment = &(list->elems[i]);
+		if (records[i].person < 0 || records[i].person >= population->count) {
+			reader->failed = true;
+			return false;
+		}
+		appointment->timestamp = records[i].timestamp;
+		appointment->person = &(population->elems[records[i].person]);
+		appointment->vaccine = vaccineList_getById(vaccines, records[i].vaccine);
+		if (appointment->vaccine == NULL) {
+			reader->failed = true;
+			return false;
+		}
+		list->count++;
+	}
+	
+	return true;
+}
+
+// Write an index of appointments by person on a snapshot. The cp are written as positions on the table of strings
+void appointmentIndex_save(const tAppointmentIndex* index, tSnapshotWriter* writer, const tInternTable* strings) {
+	tPersonAppointmentRecord* records;
+	int capacity;
+	tPersonAppointments* person;
+	int i, j;
+	
+	assert(index != NULL);
+	assert(writer != NULL);
+	assert(strings != NULL);
+	
+	records = NULL;
+	capacity = 0;
+	
+	snapshot_writeInt(writer, index->count);
+	for (i = 0; i < index->count; i++) {
+		person = &(index->elems[i]);
+		records = (tPersonAppointmentRecord*) array_grow(records, &capacity, person->count, sizeof(tPersonAppointmentRecord));
+		for (j = 0; j < person->count; j++) {
+			records[j].cp = internTable_findId(strings, person->elems[j].cp);
+			records[j].vaccine = person->elems[j].vaccine->id;
+			records[j].timestamp = person->elems[j].timestamp;
+		}
+		snapshot_writeInt(writer, snapshot_addString(writer, person->document));
+		snapshot_writeInt(writer, person->count);
+		snapshot_write(writer, records, person->count * sizeof(tPersonAppointmentRecord));
+	}
+	snapshot_writeIndex(writer, index->index, index->indexSize);
+	
+	if (records != NULL) {
+		free(records);
+	}
+}
+
+// Read an empty index of appointments by person from a snapshot. Returns false if the snapshot is not valid
+bool appointmentIndex_load(tAppointmentIndex* index, tSnapshotReader* reader, const tInternTable* strings, const tVaccineList* vaccines) {
+	const tPersonAppointmentRecord* records;
+	tPersonAppointments* person;
+	int count;
+	int i, j;
+	
+	assert(index != NULL);
+	assert(reader != NULL);
+	assert(strings != NULL);
+	assert(vaccines != NULL);
+	assert(index->count == 0);
+	
+	// Each person needs at least its document and number of appointments
+	count = snapshot_readInt(reader);
+	if (reader->failed || count < 0 || (long long) count * (long long) (2 * sizeof(int)) > (long long) reader->file.size) {
+		reader->failed = true;
+		return false;
+	}
+	
+	index->elems = (tPersonAppointments*) array_reserve(index->elems, &(index->capacity), count, sizeof(tPersonAppointments));
+	for (i = 0; i < count; i++) {
+		person = &(index->elems[i]);
+		person->document = snapshot_getString(reader, snapshot_readInt(reader));
+		person->count = snapshot_readInt(reader);
+		records = (const tPersonAppointmentRecord*) snapshot_readArray(reader, person->count, sizeof(tPersonAppointmentRecord));
+		if (person->document == NULL || records == NULL) {
+			reader->failed = true;
+			return false;
+		}
+		
+		person->elems = (tPersonAppointment*) malloc((person->count > 0 ? person->count : 1) * sizeof(tPersonAppointment));
+		assert(person->elems != NULL);
+		person->capacity = person->count;
+		index->count++;
+		for (j = 0; j < person->count; j++) {
+			person->elems[j].cp = internTable_get(strings, records[j].cp);
+			person->elems[j].vaccine = vaccineList_getById(vaccines, records[j].vaccine);
+			person->elems[j].timestamp = records[j].timestamp;
+			if (person->elems[j].cp == NULL || person->elems[j].vaccine == NULL) {
+				reader->failed = true;
+				return false;
+			}
+		}
+	}
+	
+	index->index = snapshot_readIndex(reader, count, &(index->indexSize));
+	if (index->index == NULL && count > 0) {
+		reader->failed = true;
+	}
+	
+	return !reader->failed;
+}
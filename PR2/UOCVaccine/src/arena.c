@@ -0,0 +1,137 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "arena.h"
+
+// Get the data of a block
+#define ARENA_BLOCK_DATA(block) ((char*)(block) + sizeof(tArenaBlock))
+
+// Add a new block with at least size bytes. Blocks bigger than the default ones do not replace the current block
+static tArenaBlock* arena_addBlock(tArena* arena, size_t size) {
+    tArenaBlock* block;
+    
+    if (size < ARENA_BLOCK_SIZE) {
+        size = ARENA_BLOCK_SIZE;
+    }
+    
+    block = (tArenaBlock*) malloc(sizeof(tArenaBlock) + size);
+    assert(block != NULL);
+    block->size = size;
+    block->used = 0;
+    arena->size += size;
+    
+    if (arena->first == NULL || size == ARENA_BLOCK_SIZE) {
+        // Allocate from the new block from now on
+        block->next = arena->first;
+        arena->first = block;
+    } else {
+        // Keep allocating on the free space of the current block
+        block->next = arena->first->next;
+        arena->first->next = block;
+    }
+    if (block->next == NULL) {
+        arena->last = block;
+    }
+    
+    return block;
+}
+
+// Allocate size bytes with the given alignment
+static void* arena_allocAligned(tArena* arena, size_t size, size_t alignment) {
+    tArenaBlock* block;
+    size_t offset;
+    
+    assert(arena != NULL);
+    
+    block = arena->first;
+    if (block != NULL) {
+        offset = (block->used + alignment - 1) & ~(alignment - 1);
+        if (offset + size <= block->size) {
+            block->used = offset + size;
+            return ARENA_BLOCK_DATA(block) + offset;
+        }
+    }
+    
+    // Not enough space on the current block
+    block = arena_addBlock(arena, size);
+    block->used = size;
+    
+    return ARENA_BLOCK_DATA(block);
+}
+
+// Initialize an arena
+void arena_init(tArena* arena) {
+    assert(arena != NULL);
+    
+    arena->first = NULL;
+    arena->last = NULL;
+    arena->size = 0;
+}
+
+// Release all the memory of an arena
+void arena_free(tArena* arena) {
+    tArenaBlock* block;
+    tArenaBlock* next;
+    
+    assert(arena != NULL);
+    
+    block = arena->first;
+    while (block != NULL) {
+        next = block->next;
+        free(block);
+        block = next;
+    }
+    
+    arena_init(arena);
+}
+
+// Allocate size bytes on an arena, aligned to ARENA_ALIGNMENT
+void* arena_alloc(tArena* arena, size_t size) {
+    return arena_allocAligned(arena, size, ARENA_ALIGNMENT);
+}
+
+// Copy the first len characters of a string on an arena
+char* arena_strndup(tArena* arena, const char* str, int len) {
+    char* copy;
+    
+    assert(str != NULL);
+    assert(len >= 0);
+    
+    // Strings are packed without alignment
+    copy = (char*) arena_allocAligned(arena, len + 1, 1);
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+    
+    return copy;
+}
+
+// Copy a string on an arena
+char* arena_strdup(tArena* arena, const char* str) {
+    assert(str != NULL);
+    
+    return arena_strndup(arena, str, strlen(str));
+}
+
+// Move all the memory of the source arena to the destination. The source is left empty
+void arena_merge(tArena* destination, tArena* source) {
+    assert(destination != NULL);
+    assert(source != NULL);
+    
+    if (source->first == NULL) {
+        return;
+    }
+    
+    if (destination->first == NULL) {
+        *destination = *source;
+    } else {
+        // Append the source blocks after the current one, which is still used for new allocations
+        source->last->next = destination->first->next;
+        if (destination->first->next == NULL) {
+            destination->last = source->last;
+        }
+        destination->first->next = source->first;
+        destination->size += source->size;
+    }
+    
+    arena_init(source);
+}
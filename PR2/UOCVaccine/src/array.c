@@ -0,0 +1,43 @@
+#include <stdlib.h>
+#include <assert.h>
+#include "array.h"
+
+// Ensure an array can store at least size elements, doubling its capacity when it is full. Returns the (possibly moved) array
+void* array_grow(void* elems, int* capacity, int size, size_t elemSize) {
+    int newCapacity;
+    
+    assert(capacity != NULL);
+    assert(size >= 0);
+    
+    // Enough space is already available
+    if (size <= *capacity) {
+        return elems;
+    }
+    
+    // Double the capacity up to the requested size
+    newCapacity = *capacity > 0 ? *capacity : ARRAY_MIN_CAPACITY;
+    while (newCapacity < size) {
+        newCapacity *= 2;
+    }
+    
+    return array_reserve(elems, capacity, newCapacity, elemSize);
+}
+
+// Ensure an array can store at least size elements, allocating exactly the requested size. Returns the (possibly moved) array
+void* array_reserve(void* elems, int* capacity, int size, size_t elemSize) {
+    assert(capacity != NULL);
+    assert(size >= 0);
+    
+    if (size > *capacity) {
+        // Request new memory space or modify the currently allocated one
+        if (elems == NULL) {
+            elems = malloc(size * elemSize);
+        } else {
+            elems = realloc(elems, size * elemSize);
+        }
+        assert(elems != NULL);
+        *capacity = size;
+    }
+    
+    return elems;
+}
@@ -3,6 +3,16 @@
 #include <stdlib.h>
 #include "center.h"
 #include "appointment.h"
+#include "array.h"
+
+// Initialize the stock and appointments of a center
+static void center_initData(tHealthCenter* center) {
+    // Initialize the stock
+    stockList_init(&(center->stock));
+	
+	// Initialize the appointment data
+	appointmentData_init(&(center->appointments));
+}
 
 // Initialize a center
 void center_init(tHealthCenter* center, const char* cp) {
@@ -17,11 +27,21 @@ void center_init(tHealthCenter* center, const char* cp) {
     // Copy the cp
     strcpy(center->cp, cp);    
     
-    // Initialize the stock
-    stockList_init(&(center->stock));
-	
-	// Initialize the appointment data
-	appointmentData_init(&(center->appointments));
+    center_initData(center);
+}
+
+// Initialize a center of the list, using the canonical cp if the list has a table of strings
+static void centerList_initCenter(tHealthCenterList* list, tHealthCenter* center, const char* cp) {
+    if (list->strings != NULL) {
+        center->cp = (char*) internTable_add(list->strings, cp);
+        center_initData(center);
+    } else {
+        center_init(center, cp);
+    }
+    
+    // Appointments of the center are also indexed by person
+    center->appointments.index = list->appointments;
+    center->appointments.cp = center->cp;
 }
 
 // Release a center's data
@@ -43,92 +63,212 @@ void center_free(tHealthCenter* center) {
 	appointmentData_free(&(center->appointments));
 }
 
+// Find the position of a center in the sorted array, or the position where it should be inserted
+static int centerList_position(const tHealthCenterList* list, const char* cp) {
+    int first;
+    int last;
+    int middle;
+    
+    assert(list != NULL);
+    assert(cp != NULL);
+    
+    first = 0;
+    last = list->count;
+    while (first < last) {
+        middle = first + (last - first) / 2;
+        if (strcmp(list->sorted[middle]->cp, cp) < 0) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+    
+    return first;
+}
+
 // Initialize a list of centers
 void centerList_init(tHealthCenterList* list) {
     // PR2 Ex 2c
     
     assert(list != NULL);
     
+    list->blocks = NULL;
+    list->numBlocks = 0;
+    list->blocksCapacity = 0;
+    list->sorted = NULL;
+    list->capacity = 0;
     list->count = 0;
-    list->first = NULL;
+    list->strings = NULL;
+    list->appointments = NULL;
 }
 
 // Release a list of centers
 void centerList_free(tHealthCenterList* list) {
     // PR2 Ex 2d
-    tHealthCenterNode *pNode;
-    tHealthCenterNode *pAux;
+    int i;
     
     assert(list != NULL);
     
     // Remove all elements in the list
-    pNode = list->first;
-    while(pNode != NULL) {
-        center_free(&(pNode->elem));
-        pAux = pNode;
-        pNode = pNode->next;
-        free(pAux);
+    for (i = 0; i < list->count; i++) {
+        // Canonical cp are owned by the table of strings
+        if (list->strings != NULL) {
+            list->sorted[i]->cp = NULL;
+        }
+        center_free(list->sorted[i]);
+    }
+    for (i = 0; i < list->numBlocks; i++) {
+        free(list->blocks[i]);
+    }
+    if (list->blocks != NULL) {
+        free(list->blocks);
+    }
+    if (list->sorted != NULL) {
+        free(list->sorted);
     }
     
+    list->blocks = NULL;
+    list->numBlocks = 0;
+    list->blocksCapacity = 0;
+    list->sorted = NULL;
+    list->capacity = 0;
     list->count = 0;
-    list->first = NULL;
 }
 
 // Insert a new center
 void centerList_insert(tHealthCenterList* list, const char* cp) {
     // PR2 Ex 2e
-    tHealthCenterNode *pNode;
-    tHealthCenterNode *pAux;
+    tHealthCenter *pCenter;
+    int pos;
     
     assert(list != NULL);
+    assert(cp != NULL);
     
-    if (centerList_find(list, cp) == NULL) {    
+    pos = centerList_position(list, cp);
+    if (pos == list->count || strcmp(list->sorted[pos]->cp, cp) != 0) {
         
-        // Check if insertion point is the first position
-        if (list->first == NULL || strcmp(list->first->elem.cp, cp) > 0) {
-            // Insert as initial position
-            pAux = list->first;            
-            list->first = (tHealthCenterNode*) malloc(sizeof(tHealthCenterNode));
-            assert(list->first != NULL);
-            list->first->next = pAux;
-            center_init(&(list->first->elem), cp);
-        } else {        
-            // Search insertion point
-            pAux = list->first;
-            pNode = pAux->next;            
-            while(pNode != NULL && strcmp(pNode->elem.cp, cp) > 0) {                
-                pAux = pNode;
-                pNode = pNode->next;         
-            }
-            pAux->next = (tHealthCenterNode*) malloc(sizeof(tHealthCenterNode));
-            assert(pAux->next != NULL);
-            pAux->next->next = pNode;
-            center_init(&(pAux->next->elem), cp);
+        // Add a new block when the last one is full
+        if (list->count == list->numBlocks * CENTER_BLOCK_SIZE) {
+            list->blocks = (tHealthCenter**) array_grow(list->blocks, &(list->blocksCapacity), list->numBlocks + 1, sizeof(tHealthCenter*));
+            list->blocks[list->numBlocks] = (tHealthCenter*) malloc(CENTER_BLOCK_SIZE * sizeof(tHealthCenter));
+            assert(list->blocks[list->numBlocks] != NULL);
+            list->numBlocks++;
         }
+        pCenter = &(list->blocks[list->count / CENTER_BLOCK_SIZE][list->count % CENTER_BLOCK_SIZE]);
+        centerList_initCenter(list, pCenter, cp);
+        
+        // Keep the centers sorted by cp
+        list->sorted = (tHealthCenter**) array_grow(list->sorted, &(list->capacity), list->count + 1, sizeof(tHealthCenter*));
+        memmove(&(list->sorted[pos + 1]), &(list->sorted[pos]), (list->count - pos) * sizeof(tHealthCenter*));
+        list->sorted[pos] = pCenter;
+        
         // Increase the number of elements
         list->count++;
     }
 }
 
 // Find a center
-tHealthCenter* centerList_find(tHealthCenterList* list, const char* cp) {
+tHealthCenter* centerList_find(const tHealthCenterList* list, const char* cp) {
     // PR2 Ex 2f
+    int pos;
+    
+    assert(list != NULL);
+    
+    pos = centerList_findPosition(list, cp);
+    if (pos >= 0) {
+        return list->sorted[pos];
+    }
     
-    tHealthCenterNode *pNode;    
-    tHealthCenter *pCenter;    
+    return NULL;
+}
+
+// Find the position of a center, sorted by cp. -1 if it does not exist
+int centerList_findPosition(const tHealthCenterList* list, const char* cp) {
+    int pos;
     
     assert(list != NULL);
     
-    // Search center with provided cp
-    pNode = list->first;
-    pCenter = NULL;
-    while(pNode != NULL && pCenter == NULL) {
-        if(strcmp(cp, pNode->elem.cp) == 0) {
-            pCenter = &(pNode->elem);
-        }        
-        pNode = pNode->next;        
+    // The cp of the centers are canonical, so a cp that is not in the table cannot match
+    if (list->strings != NULL && internTable_find(list->strings, cp) == NULL) {
+        return -1;
+    }
+    
+    // Binary search of the center with provided cp
+    pos = centerList_position(list, cp);
+    if (pos < list->count && strcmp(list->sorted[pos]->cp, cp) == 0) {
+        return pos;
     }
     
-    return pCenter;
+    return -1;
+}
+
+// Get the center at a given position, sorted by cp
+tHealthCenter* centerList_get(const tHealthCenterList* list, int index) {
+    assert(list != NULL);
+    assert(index >= 0 && index < list->count);
+    
+    return list->sorted[index];
 }
 
+// Write a list of centers on a snapshot, with their stock and appointments. The cp are written as positions on the table of strings
+void centerList_save(const tHealthCenterList* list, tSnapshotWriter* writer, const tPopulation* population) {
+    int i;
+    
+    assert(list != NULL);
+    assert(list->strings != NULL);
+    assert(writer != NULL);
+    assert(population != NULL);
+    
+    // Centers are written sorted by cp, so they are loaded without sorting them again
+    snapshot_writeInt(writer, list->count);
+    for (i = 0; i < list->count; i++) {
+        snapshot_writeInt(writer, internTable_findId(list->strings, list->sorted[i]->cp));
+        stockList_save(&(list->sorted[i]->stock), writer);
+        appointmentData_save(&(list->sorted[i]->appointments), writer, population);
+    }
+}
+
+// Read an empty list of centers from a snapshot, with the persons and vaccines of the application. Returns false if the snapshot is not valid
+bool centerList_load(tHealthCenterList* list, tSnapshotReader* reader, const tPopulation* population, const tVaccineList* vaccines) {
+    tHealthCenter *pCenter;
+    const char* cp;
+    int count;
+    
+    assert(list != NULL);
+    assert(list->strings != NULL);
+    assert(reader != NULL);
+    assert(list->count == 0);
+    
+    count = snapshot_readInt(reader);
+    if (reader->failed || count < 0 || count > list->strings->count) {
+        reader->failed = true;
+        return false;
+    }
+    
+    list->sorted = (tHealthCenter**) array_reserve(list->sorted, &(list->capacity), count, sizeof(tHealthCenter*));
+    while (list->count < count) {
+        // The cp must be sorted and unique
+        cp = internTable_get(list->strings, snapshot_readInt(reader));
+        if (cp == NULL || (list->count > 0 && strcmp(list->sorted[list->count - 1]->cp, cp) >= 0)) {
+            reader->failed = true;
+            return false;
+        }
+        
+        if (list->count == list->numBlocks * CENTER_BLOCK_SIZE) {
+            list->blocks = (tHealthCenter**) array_grow(list->blocks, &(list->blocksCapacity), list->numBlocks + 1, sizeof(tHealthCenter*));
+            list->blocks[list->numBlocks] = (tHealthCenter*) malloc(CENTER_BLOCK_SIZE * sizeof(tHealthCenter));
+            assert(list->blocks[list->numBlocks] != NULL);
+            list->numBlocks++;
+        }
+        pCenter = &(list->blocks[list->count / CENTER_BLOCK_SIZE][list->count % CENTER_BLOCK_SIZE]);
+        centerList_initCenter(list, pCenter, cp);
+        list->sorted[list->count] = pCenter;
+        list->count++;
+        
+        if (!stockList_load(&(pCenter->stock), reader, vaccines) || !appointmentData_load(&(pCenter->appointments), reader, population, vaccines)) {
+            return false;
+        }
+    }
+    
+    return true;
+}
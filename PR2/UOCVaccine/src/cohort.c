@@ -0,0 +1,256 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <limits.h>
+#include "cohort.h"
+
+// Get the number of words needed to store count bits
+static int cohort_numWords(int count) {
+    return (count + COHORT_WORD_BITS - 1) / COHORT_WORD_BITS;
+}
+
+// Count the bits of a word
+static int cohort_popcount(unsigned long long word) {
+    word = word - ((word >> 1) & 0x5555555555555555ULL);
+    word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int) ((word * 0x0101010101010101ULL) >> 56);
+}
+
+// Initialize an empty selection of count rows
+void cohortSelection_init(tCohortSelection* selection, int count) {
+    assert(selection != NULL);
+    assert(count >= 0);
+    
+    selection->count = count;
+    selection->words = NULL;
+    if (count > 0) {
+        selection->words = (unsigned long long*) calloc(cohort_numWords(count), sizeof(unsigned long long));
+        assert(selection->words != NULL);
+    }
+}
+
+// Release a selection
+void cohortSelection_free(tCohortSelection* selection) {
+    assert(selection != NULL);
+    
+    if (selection->words != NULL) {
+        free(selection->words);
+    }
+    selection->words = NULL;
+    selection->count = 0;
+}
+
+// Add a row to a selection
+void cohortSelection_add(tCohortSelection* selection, int row) {
+    assert(selection != NULL);
+    assert(row >= 0 && row < selection->count);
+    
+    selection->words[row / COHORT_WORD_BITS] |= 1ULL << (row % COHORT_WORD_BITS);
+}
+
+// Check if a row is on a selection
+bool cohortSelection_contains(const tCohortSelection* selection, int row) {
+    assert(selection != NULL);
+    assert(row >= 0 && row < selection->count);
+    
+    return (selection->words[row / COHORT_WORD_BITS] >> (row % COHORT_WORD_BITS)) & 1;
+}
+
+// Get the number of rows of a selection
+int cohortSelection_len(const tCohortSelection* selection) {
+    int count;
+    int i;
+    
+    assert(selection != NULL);
+    
+    count = 0;
+    for (i = 0; i < cohort_numWords(selection->count); i++) {
+        count += cohort_popcount(selection->words[i]);
+    }
+    
+    return count;
+}
+
+// Store the rows of a selection on an array with space for all of them, in increasing order. Returns the number of rows
+int cohortSelection_rows(const tCohortSelection* selection, int* rows) {
+    unsigned long long word;
+    int count;
+    int bit;
+    int i;
+    
+    assert(selection != NULL);
+    assert(rows != NULL);
+    
+    count = 0;
+    for (i = 0; i < cohort_numWords(selection->count); i++) {
+        // Empty words are skipped at once
+        word = selection->words[i];
+        for (bit = 0; word != 0; bit++, word >>= 1) {
+            if (word & 1) {
+                rows[count++] = i * COHORT_WORD_BITS + bit;
+            }
+        }
+    }
+    
+    return count;
+}
+
+// Initialize a query selecting all the persons
+void cohortQuery_init(tCohortQuery* query) {
+    assert(query != NULL);
+    
+    query->bornFrom = INT_MIN;
+    query->bornBefore = INT_MAX;
+    query->cps = NULL;
+    query->numCps = 0;
+    query->withoutAppointment = false;
+}
+
+// Release a query
+void cohortQuery_free(tCohortQuery* query) {
+    assert(query != NULL);
+    
+    if (query->cps != NULL) {
+        free(query->cps);
+    }
+    cohortQuery_init(query);
+}
+
+// Select only the persons born on a date or later
+void cohortQuery_bornFrom(tCohortQuery* query, tDate date) {
+    assert(query != NULL);
+    
+    query->bornFrom = date_toDays(date);
+}
+
+// Select only the persons born before a date
+void cohortQuery_bornBefore(tCohortQuery* query, tDate date) {
+    assert(query != NULL);
+    
+    query->bornBefore = date_toDays(date);
+}
+
+// Grow the cp bitmap to store numCps positions, restricting the query to the cp on it
+static void cohortQuery_reserveCps(tCohortQuery* query, int numCps) {
+    int numWords;
+    int oldWords;
+    
+    oldWords = query->cps != NULL ? cohort_numWords(query->numCps) : 0;
+    numWords = cohort_numWords(numCps);
+    if (numWords < 1) {
+        numWords = 1;
+    }
+    if (numWords > oldWords) {
+        query->cps = (unsigned long long*) realloc(query->cps, numWords * sizeof(unsigned long long));
+        assert(query->cps != NULL);
+        memset(query->cps + oldWords, 0, (numWords - oldWords) * sizeof(unsigned long long));
+    }
+    if (numCps > query->numCps) {
+        query->numCps = numCps;
+    }
+}
+
+// Select the persons of a cp. The first call restricts the query to the cp added
+void cohortQuery_addCp(tCohortQuery* query, const tInternTable* strings, const char* cp) {
+    int id;
+    
+    assert(query != NULL);
+    assert(strings != NULL);
+    assert(cp != NULL);
+    
+    // A cp that is not on the table has no persons, but it still restricts the query
+    id = internTable_findId(strings, cp);
+    cohortQuery_reserveCps(query, id + 1);
+    if (id >= 0) {
+        query->cps[id / COHORT_WORD_BITS] |= 1ULL << (id % COHORT_WORD_BITS);
+    }
+}
+
+// Select the persons of all the cp between first and last, both included, with their same number of digits
+void cohortQuery_addCpRange(tCohortQuery* query, const tInternTable* strings, const char* first, const char* last) {
+    const char* str;
+    size_t len;
+    int id;
+    
+    assert(query != NULL);
+    assert(strings != NULL);
+    assert(first != NULL);
+    assert(last != NULL);
+    assert(strlen(first) == strlen(last));
+    
+    // The table also has other strings, as vaccine names, which are not on the range
+    len = strlen(first);
+    cohortQuery_reserveCps(query, internTable_len(strings));
+    for (id = 0; id < internTable_len(strings); id++) {
+        str = internTable_get(strings, id);
+        if (strlen(str) == len && strcmp(str, first) >= 0 && strcmp(str, last) <= 0) {
+            query->cps[id / COHORT_WORD_BITS] |= 1ULL << (id % COHORT_WORD_BITS);
+        }
+    }
+}
+
+// Set the bits of the rows with a birthday on a range. Each word is computed without branches, as the selected rows follow no pattern
+static void cohort_selectBirthdays(const int* birthdays, int count, int bornFrom, int bornBefore, unsigned long long* words) {
+    unsigned long long word;
+    unsigned int width;
+    int numRows;
+    int i, j;
+    
+    // A single unsigned compare checks both ends of the range
+    width = bornBefore > bornFrom ? (unsigned int) bornBefore - (unsigned int) bornFrom : 0;
+    for (i = 0; i < cohort_numWords(count); i++) {
+        numRows = count - i * COHORT_WORD_BITS < COHORT_WORD_BITS ? count - i * COHORT_WORD_BITS : COHORT_WORD_BITS;
+        word = 0;
+        for (j = 0; j < numRows; j++) {
+            word |= (unsigned long long) ((unsigned int) birthdays[i * COHORT_WORD_BITS + j] - (unsigned int) bornFrom < width) << j;
+        }
+        words[i] = word;
+    }
+}
+
+// Clear the bits of the rows with a cp not on the cp bitmap of the query. Empty words are skipped
+static void cohort_filterCps(const tCohortQuery* query, const int* cps, int count, unsigned long long* words) {
+    unsigned long long mask;
+    int numRows;
+    int id;
+    int i, j;
+    
+    for (i = 0; i < cohort_numWords(count); i++) {
+        if (words[i] == 0) {
+            continue;
+        }
+        numRows = count - i * COHORT_WORD_BITS < COHORT_WORD_BITS ? count - i * COHORT_WORD_BITS : COHORT_WORD_BITS;
+        mask = 0;
+        for (j = 0; j < numRows; j++) {
+            id = cps[i * COHORT_WORD_BITS + j];
+            if (id >= 0 && id < query->numCps) {
+                mask |= ((query->cps[id / COHORT_WORD_BITS] >> (id % COHORT_WORD_BITS)) & 1) << j;
+            }
+        }
+        words[i] &= mask;
+    }
+}
+
+// Select the persons of the columns matching the query. Booked has the rows of the persons with appointments. If NULL, no person has appointments.
+// The selection is initialized by this call
+void cohortQuery_select(const tCohortQuery* query, const tPopulationColumns* columns, const tCohortSelection* booked, tCohortSelection* selection) {
+    int i;
+    
+    assert(query != NULL);
+    assert(columns != NULL);
+    assert(booked == NULL || booked->count == columns->count);
+    assert(selection != NULL);
+    
+    // Each condition is applied to all the rows in a single pass over a single column
+    cohortSelection_init(selection, columns->count);
+    cohort_selectBirthdays(columns->birthdays, columns->count, query->bornFrom, query->bornBefore, selection->words);
+    if (query->cps != NULL) {
+        cohort_filterCps(query, columns->cps, columns->count, selection->words);
+    }
+    if (query->withoutAppointment && booked != NULL) {
+        for (i = 0; i < cohort_numWords(columns->count); i++) {
+            selection->words[i] &= ~booked->words[i];
+        }
+    }
+}
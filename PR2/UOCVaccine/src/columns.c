@@ -0,0 +1,319 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <limits.h>
+#include "columns.h"
+#include "array.h"
+
+// Initialize an empty column of strings
+static void stringColumn_init(tStringColumn* column) {
+    column->heap = NULL;
+    column->size = 0;
+    column->heapCapacity = 0;
+    column->dead = 0;
+    column->offsets = NULL;
+}
+
+// Release a column of strings
+static void stringColumn_free(tStringColumn* column) {
+    if (column->heap != NULL) {
+        free(column->heap);
+    }
+    if (column->offsets != NULL) {
+        free(column->offsets);
+    }
+    stringColumn_init(column);
+}
+
+// Mark the string of a row as not used. Rows without a string have a negative offset
+static void stringColumn_release(tStringColumn* column, int row) {
+    if (column->offsets[row] >= 0) {
+        column->dead += (int) strlen(column->heap + column->offsets[row]) + 1;
+        column->offsets[row] = -1;
+    }
+}
+
+// Copy the strings of the first count rows to a new heap when most of the heap is not used, so updates do not grow it without limit
+static void stringColumn_compact(tStringColumn* column, int count) {
+    char* heap;
+    int size;
+    int len;
+    int row;
+    
+    if (column->dead <= column->size / 2) {
+        return;
+    }
+    
+    heap = NULL;
+    if (column->size > column->dead) {
+        heap = (char*) malloc((column->size - column->dead) * sizeof(char));
+        assert(heap != NULL);
+    }
+    size = 0;
+    for (row = 0; row < count; row++) {
+        if (column->offsets[row] >= 0) {
+            len = (int) strlen(column->heap + column->offsets[row]);
+            memcpy(heap + size, column->heap + column->offsets[row], len + 1);
+            column->offsets[row] = size;
+            size += len + 1;
+        }
+    }
+    assert(size == column->size - column->dead);
+    
+    free(column->heap);
+    column->heap = heap;
+    column->heapCapacity = size;
+    column->size = size;
+    column->dead = 0;
+}
+
+// Store a string as the string of a row of a column with count rows. It replaces the previous string of the row if it fits, otherwise it is added at the end of the heap
+static void stringColumn_set(tStringColumn* column, int row, int count, const char* str) {
+    int oldLen;
+    int len;
+    
+    len = (int) strlen(str);
+    if (column->offsets[row] >= 0) {
+        oldLen = (int) strlen(column->heap + column->offsets[row]);
+        if (len <= oldLen) {
+            memcpy(column->heap + column->offsets[row], str, len + 1);
+            column->dead += oldLen - len;
+            return;
+        }
+        stringColumn_release(column, row);
+        stringColumn_compact(column, count);
+    }
+    
+    assert(column->size <= INT_MAX - len - 1);
+    column->heap = (char*) array_grow(column->heap, &(column->heapCapacity), column->size + len + 1, sizeof(char));
+    memcpy(column->heap + column->size, str, len + 1);
+    column->offsets[row] = column->size;
+    column->size += len + 1;
+}
+
+// Initialize empty columns, with the cp stored on a table of unique strings
+void populationColumns_init(tPopulationColumns* columns, tInternTable* strings) {
+    assert(columns != NULL);
+    assert(strings != NULL);
+    
+    columns->count = 0;
+    columns->capacity = 0;
+    columns->documents = NULL;
+    columns->documentWidth = COLUMNS_DOCUMENT_WIDTH;
+    columns->cps = NULL;
+    columns->birthdays = NULL;
+    stringColumn_init(&(columns->names));
+    stringColumn_init(&(columns->surnames));
+    stringColumn_init(&(columns->emails));
+    stringColumn_init(&(columns->addresses));
+    columns->strings = strings;
+}
+
+// Release the columns
+void populationColumns_free(tPopulationColumns* columns) {
+    assert(columns != NULL);
+    
+    if (columns->documents != NULL) {
+        free(columns->documents);
+    }
+    if (columns->cps != NULL) {
+        free(columns->cps);
+    }
+    if (columns->birthdays != NULL) {
+        free(columns->birthdays);
+    }
+    stringColumn_free(&(columns->names));
+    stringColumn_free(&(columns->surnames));
+    stringColumn_free(&(columns->emails));
+    stringColumn_free(&(columns->addresses));
+    populationColumns_init(columns, columns->strings);
+}
+
+// Get the number of rows
+int populationColumns_len(const tPopulationColumns* columns) {
+    assert(columns != NULL);
+    
+    return columns->count;
+}
+
+// Resize all the columns to store capacity rows
+static void populationColumns_resize(tPopulationColumns* columns, int capacity) {
+    columns->documents = (char*) realloc(columns->documents, (size_t) capacity * columns->documentWidth);
+    columns->cps = (int*) realloc(columns->cps, capacity * sizeof(int));
+    columns->birthdays = (int*) realloc(columns->birthdays, capacity * sizeof(int));
+    columns->names.offsets = (int*) realloc(columns->names.offsets, capacity * sizeof(int));
+    columns->surnames.offsets = (int*) realloc(columns->surnames.offsets, capacity * sizeof(int));
+    columns->emails.offsets = (int*) realloc(columns->emails.offsets, capacity * sizeof(int));
+    columns->addresses.offsets = (int*) realloc(columns->addresses.offsets, capacity * sizeof(int));
+    assert(columns->documents != NULL && columns->cps != NULL && columns->birthdays != NULL);
+    assert(columns->names.offsets != NULL && columns->surnames.offsets != NULL && columns->emails.offsets != NULL && columns->addresses.offsets != NULL);
+    columns->capacity = capacity;
+}
+
+// Reserve memory to store at least the given number of rows
+void populationColumns_reserve(tPopulationColumns* columns, int size) {
+    assert(columns != NULL);
+    
+    if (size > columns->capacity) {
+        populationColumns_resize(columns, size);
+    }
+}
+
+// Widen the rows of the document column to store documents of len characters
+static void populationColumns_widenDocuments(tPopulationColumns* columns, int len) {
+    int width;
+    int row;
+    
+    width = columns->documentWidth;
+    while (width < len + 1) {
+        width *= 2;
+    }
+    columns->documents = (char*) realloc(columns->documents, (size_t) (columns->capacity > 0 ? columns->capacity : 1) * width);
+    assert(columns->documents != NULL);
+    
+    // Move the rows from the last one, so no row is overwritten before it is moved
+    for (row = columns->count - 1; row >= 0; row--) {
+        memmove(columns->documents + (size_t) row * width, columns->documents + (size_t) row * columns->documentWidth, columns->documentWidth);
+        memset(columns->documents + (size_t) row * width + columns->documentWidth, 0, width - columns->documentWidth);
+    }
+    columns->documentWidth = width;
+}
+
+// Replace the data of the row at a given position by a person
+void populationColumns_set(tPopulationColumns* columns, int row, const tPerson* person) {
+    int len;
+    
+    assert(columns != NULL);
+    assert(row >= 0 && row < columns->count);
+    assert(person != NULL);
+    
+    len = (int) strlen(person->document);
+    if (len + 1 > columns->documentWidth) {
+        populationColumns_widenDocuments(columns, len);
+    }
+    memset(columns->documents + (size_t) row * columns->documentWidth, 0, columns->documentWidth);
+    memcpy(columns->documents + (size_t) row * columns->documentWidth, person->document, len);
+    
+    // The cp of the persons of a population are already on the table, but other ones are added
+    columns->cps[row] = internTable_findId(columns->strings, person->cp);
+    if (columns->cps[row] < 0) {
+        internTable_add(columns->strings, person->cp);
+        columns->cps[row] = internTable_findId(columns->strings, person->cp);
+    }
+    columns->birthdays[row] = date_toDays(person->birthday);
+    
+    stringColumn_set(&(columns->names), row, columns->count, person->name);
+    stringColumn_set(&(columns->surnames), row, columns->count, person->surname);
+    stringColumn_set(&(columns->emails), row, columns->count, person->email);
+    stringColumn_set(&(columns->addresses), row, columns->count, person->address);
+}
+
+// Add a person as the last row
+void populationColumns_add(tPopulationColumns* columns, const tPerson* person) {
+    assert(columns != NULL);
+    assert(person != NULL);
+    
+    if (columns->count == columns->capacity) {
+        populationColumns_resize(columns, columns->capacity > 0 ? 2 * columns->capacity : ARRAY_MIN_CAPACITY);
+    }
+    // The new row has no strings to replace
+    columns->count++;
+    columns->names.offsets[columns->count - 1] = -1;
+    columns->surnames.offsets[columns->count - 1] = -1;
+    columns->emails.offsets[columns->count - 1] = -1;
+    columns->addresses.offsets[columns->count - 1] = -1;
+    populationColumns_set(columns, columns->count - 1, person);
+}
+
+// Remove all the rows and add all the persons of a population, in the same order
+void populationColumns_build(tPopulationColumns* columns, const tPopulation* population) {
+    int i;
+    
+    assert(columns != NULL);
+    assert(population != NULL);
+    
+    populationColumns_free(columns);
+    populationColumns_reserve(columns, population->count);
+    for (i = 0; i < population->count; i++) {
+        populationColumns_add(columns, &(population->elems[i]));
+    }
+}
+
+// Remove the row at a given position, moving the last row to it, as population_removeAt
+void populationColumns_removeAt(tPopulationColumns* columns, int row) {
+    int last;
+    
+    assert(columns != NULL);
+    assert(row >= 0 && row < columns->count);
+    
+    stringColumn_release(&(columns->names), row);
+    stringColumn_release(&(columns->surnames), row);
+    stringColumn_release(&(columns->emails), row);
+    stringColumn_release(&(columns->addresses), row);
+    
+    last = columns->count - 1;
+    if (row != last) {
+        memcpy(columns->documents + (size_t) row * columns->documentWidth, columns->documents + (size_t) last * columns->documentWidth, columns->documentWidth);
+        columns->cps[row] = columns->cps[last];
+        columns->birthdays[row] = columns->birthdays[last];
+        columns->names.offsets[row] = columns->names.offsets[last];
+        columns->surnames.offsets[row] = columns->surnames.offsets[last];
+        columns->emails.offsets[row] = columns->emails.offsets[last];
+        columns->addresses.offsets[row] = columns->addresses.offsets[last];
+    }
+    columns->count--;
+    
+    stringColumn_compact(&(columns->names), columns->count);
+    stringColumn_compact(&(columns->surnames), columns->count);
+    stringColumn_compact(&(columns->emails), columns->count);
+    stringColumn_compact(&(columns->addresses), columns->count);
+}
+
+// Get the document of a row. It points to the document column
+const char* populationColumns_document(const tPopulationColumns* columns, int row) {
+    assert(columns != NULL);
+    assert(row >= 0 && row < columns->count);
+    
+    return columns->documents + (size_t) row * columns->documentWidth;
+}
+
+// Get the person of a row. Its strings point to the columns, and are valid while they are not modified
+void populationColumns_get(const tPopulationColumns* columns, int row, tPerson* person) {
+    assert(columns != NULL);
+    assert(row >= 0 && row < columns->count);
+    assert(person != NULL);
+    
+    person->document = columns->documents + (size_t) row * columns->documentWidth;
+    person->name = columns->names.heap + columns->names.offsets[row];
+    person->surname = columns->surnames.heap + columns->surnames.offsets[row];
+    person->email = columns->emails.heap + columns->emails.offsets[row];
+    person->address = columns->addresses.heap + columns->addresses.offsets[row];
+    person->cp = (char*) internTable_get(columns->strings, columns->cps[row]);
+    date_fromDays(&(person->birthday), columns->birthdays[row]);
+}
+
+// Return the row of a person with the given document, scanning the document column. -1 if it does not exist
+int populationColumns_find(const tPopulationColumns* columns, const char* document) {
+    const char* key;
+    int len;
+    int row;
+    
+    assert(columns != NULL);
+    assert(document != NULL);
+    
+    // Rows are padded with '\0', so the ending character is also compared
+    len = (int) strlen(document) + 1;
+    if (len > columns->documentWidth) {
+        return -1;
+    }
+    
+    key = columns->documents;
+    for (row = 0; row < columns->count; row++) {
+        if (memcmp(key, document, len) == 0) {
+            return row;
+        }
+        key += columns->documentWidth;
+    }
+    
+    return -1;
+}
@@ -1,12 +1,20 @@
 #include "csv.h"
+#include "array.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 // Initialize the tCSVData structure
 void csv_init(tCSVData* data) {
     data->count = 0;
+    data->capacity = 0;
     data->isValid = false;
     data->entries = NULL;
 }
@@ -18,16 +26,18 @@ void csv_initEntry(tCSVEntry* entry) {
     entry->type = NULL;
 }
 
+// Reserve memory to store at least the given number of entries
+void csv_reserve(tCSVData* data, int size) {
+    assert( data != NULL );
+    data->entries = (tCSVEntry*) array_reserve(data->entries, &(data->capacity), size, sizeof(tCSVEntry));
+}
+
 // Add a new entry to the CSV Data
 void csv_addStrEntry(tCSVData* data, const char* entry, const char* type) {
     assert( data != NULL );
     assert( entry != NULL );
+    data->entries = (tCSVEntry*) array_grow(data->entries, &(data->capacity), data->count + 1, sizeof(tCSVEntry));
     data->count++;
-    if (data->count == 1) {
-        data->entries = (tCSVEntry*) malloc(sizeof(tCSVEntry));
-    } else {
-        data->entries = (tCSVEntry*) realloc(data->entries, data->count * sizeof(tCSVEntry));
-    }
     csv_initEntry(&(data->entries[data->count-1]));
     csv_parseEntry(&(data->entries[data->count-1]), entry, type);
 }
@@ -61,14 +71,7 @@ void csv_parse(tCSVData* data, const char* input, const char* type) {
         line = (char*) malloc(len * sizeof(char));
         memset(line, 0, len * sizeof(char));
         strncpy(line, pStart, pEnd - pStart);
-        data->count++;
-        if (data->count == 1) {
-            data->entries = (tCSVEntry*) malloc(sizeof(tCSVEntry));
-        } else {
-            data->entries = (tCSVEntry*) realloc(data->entries, data->count * sizeof(tCSVEntry));
-        }
-        csv_initEntry(&(data->entries[data->count-1]));
-        csv_parseEntry(&(data->entries[data->count-1]), line, type);
+        csv_addStrEntry(data, line, type);
         free(line);
     }
     data->isValid = true;
@@ -263,3 +266,213 @@ bool csv_equals(tCSVData data1, tCSVData data2) {
     
     return true;
 }
+
+// Map the contents of a file in memory. Returns false if the file cannot be read
+bool csv_openFile(tCSVFile* file, const char* filename) {
+#ifdef _WIN32
+    FILE *fin;
+    char *buffer;
+#else
+    int fd;
+    struct stat info;
+    void *addr;
+#endif
+    
+    assert(file != NULL);
+    assert(filename != NULL);
+    
+    file->data = NULL;
+    file->size = 0;
+    file->mapped = false;
+    
+#ifdef _WIN32
+    // No mmap available: read the whole file in a single buffer
+    fin = fopen(filename, "rb");
+    if (fin == NULL) {
+        return false;
+    }
+    fseek(fin, 0, SEEK_END);
+    file->size = ftell(fin);
+    rewind(fin);
+    if (file->size > 0) {
+        buffer = (char*) malloc(file->size);
+        assert(buffer != NULL);
+        file->size = (long) fread(buffer, 1, file->size, fin);
+        file->data = buffer;
+    }
+    fclose(fin);
+#else
+    fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return false;
+    }
+    file->size = (long) info.st_size;
+    
+    // Empty files cannot be mapped
+    if (file->size > 0) {
+        addr = mmap(NULL, file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            close(fd);
+            return false;
+        }
+        // The file is read once from start to end
+        madvise(addr, file->size, MADV_SEQUENTIAL);
+        file->data = (const char*) addr;
+        file->mapped = true;
+    }
+    // The mapping remains valid after closing the descriptor
+    close(fd);
+#endif
+    
+    return true;
+}
+
+// Release a file mapped in memory
+void csv_closeFile(tCSVFile* file) {
+    assert(file != NULL);
+    
+    if (file->data != NULL) {
+#ifdef _WIN32
+        free((char*) file->data);
+#else
+        if (file->mapped) {
+            munmap((void*) file->data, file->size);
+        } else {
+            free((char*) file->data);
+        }
+#endif
+    }
+    file->data = NULL;
+    file->size = 0;
+    file->mapped = false;
+}
+
+// Get the length of the line starting at pos, without end of line characters, and return the start of the next line
+const char* csv_nextLine(const char* pos, const char* end, int* len) {
+    const char *pEnd;
+    
+    assert(pos != NULL);
+    assert(len != NULL);
+    
+    pEnd = (const char*) memchr(pos, '\n', end - pos);
+    if (pEnd == NULL) {
+        // Last line without new line character
+        pEnd = end;
+    }
+    *len = pEnd - pos;
+    
+    // Remove carriage return of Windows line ends
+    if (*len > 0 && pos[*len - 1] == '\r') {
+        (*len)--;
+    }
+    
+    return pEnd < end ? pEnd + 1 : end;
+}
+
+// Parse the contents of a CSV line of len characters as views over the line
+void csv_parseView(tCSVView* view, const char* input, int len, const char* type) {
+    const char *pStart, *pEnd, *pLast;
+    bool readType = true;
+    
+    assert(view != NULL);
+    assert(input != NULL);
+    
+    view->numFields = 0;
+    view->type.str = NULL;
+    view->type.len = 0;
+    
+    // If the type of the entry is not provided, use the first field
+    if (type != NULL) {
+        view->type.str = type;
+        view->type.len = strlen(type);
+        readType = false;
+    }
+    
+    pStart = input;
+    pLast = input + len;
+    while (pStart < pLast) {
+        pEnd = (const char*) memchr(pStart, ';', pLast - pStart);
+        if (pEnd == NULL) {
+            pEnd = pLast;
+        }
+        // As in csv_parseEntry, an empty field ends the entry
+        if (pEnd == pStart) {
+            break;
+        }
+        
+        if (readType) {
+            view->type.str = pStart;
+            view->type.len = pEnd - pStart;
+            readType = false;
+        } else {
+            if (view->numFields < CSV_MAX_FIELDS) {
+                view->fields[view->numFields].str = pStart;
+                view->fields[view->numFields].len = pEnd - pStart;
+            }
+            view->numFields++;
+        }
+        
+        pStart = pEnd + 1;
+    }
+}
+
+// Get a view over the contents of a CSV entry
+void csv_viewFromEntry(tCSVView* view, tCSVEntry* entry) {
+    int i;
+    
+    assert(view != NULL);
+    assert(entry != NULL);
+    
+    view->type.str = entry->type;
+    view->type.len = entry->type != NULL ? strlen(entry->type) : 0;
+    view->numFields = entry->numFields;
+    for (i = 0; i < entry->numFields && i < CSV_MAX_FIELDS; i++) {
+        view->fields[i].str = entry->fields[i];
+        view->fields[i].len = strlen(entry->fields[i]);
+    }
+}
+
+// Compare a field with a string
+bool csv_fieldEquals(tCSVField field, const char* str) {
+    assert(str != NULL);
+    
+    return field.str != NULL && strncmp(field.str, str, field.len) == 0 && str[field.len] == '\0';
+}
+
+// Get a field as integer
+int csv_fieldAsInteger(tCSVField field) {
+    int value = 0;
+    int i = 0;
+    bool negative = false;
+    
+    // Skip blank spaces as atoi does
+    while (i < field.len && field.str[i] == ' ') {
+        i++;
+    }
+    if (i < field.len && (field.str[i] == '-' || field.str[i] == '+')) {
+        negative = (field.str[i] == '-');
+        i++;
+    }
+    while (i < field.len && field.str[i] >= '0' && field.str[i] <= '9') {
+        value = value * 10 + (field.str[i] - '0');
+        i++;
+    }
+    
+    return negative ? -value : value;
+}
+
+// Get a field as string. The value is copied to the provided buffer with provided maximum length
+void csv_fieldAsString(tCSVField field, char* buffer, int length) {
+    int len;
+    
+    assert(buffer != NULL);
+    assert(length > 0);
+    
+    len = field.len < length - 1 ? field.len : length - 1;
+    memcpy(buffer, field.str, len);
+    buffer[len] = '\0';
+}
@@ -24,32 +24,29 @@ void dateTime_parse(tDateTime* dateTime, const char* date, const char* time) {
     sscanf(time, "%d:%d", &(dateTime->time.hour), &(dateTime->time.minutes));
 }
 
+// Get a number with the same order as the dates, packing the fields of a date
+static int date_key(tDate date) {
+    // Days fit in 5 bits and months in 4 bits
+    return date.year * 512 + date.month * 32 + date.day;
+}
+
 // Compare two tDateTime structures and return -1 if dateTime1<dateTime2, 0 if equals and 1 if dateTime1>dateTime2.
 int dateTime_cmp(tDateTime dateTime1, tDateTime dateTime2) {    
     int date_res;
+    int minutes1;
+    int minutes2;
     
     date_res = date_cmp(dateTime1.date, dateTime2.date);
     
     if (date_res != 0) {
         return date_res;
     }
-        
-    // Check hour
-    if (dateTime1.time.hour < dateTime2.time.hour) {
-        return -1;
-    }
-    if (dateTime1.time.hour > dateTime2.time.hour) {
-        return 1;
-    }
-    // Check minutes
-    if (dateTime1.time.minutes < dateTime2.time.minutes) {
-        return -1;
-    }
-    if (dateTime1.time.minutes > dateTime2.time.minutes) {
-        return 1;
-    }
     
-    return 0;
+    // Check the minutes of the day
+    minutes1 = dateTime1.time.hour * 60 + dateTime1.time.minutes;
+    minutes2 = dateTime2.time.hour * 60 + dateTime2.time.minutes;
+    
+    return (minutes1 > minutes2) - (minutes1 < minutes2);
 }
 
 // Compare two tDateTime structures and return true if they contain the same value or false otherwise.
@@ -85,22 +82,30 @@ void dateTime_fromTime(tDateTime *timestamp, struct tm std_time) {
 
 // Add a days to a given date
 void dateTime_addDay(tDateTime* dateTime, int days) {
-    
-    struct tm initTimestamp = { 0 };   
-    
     assert(dateTime != NULL);
     
-    // Get standard time representation
-    dateTime_initTime(&initTimestamp, *dateTime);
+    // The time of the day does not change
+    date_addDay(&(dateTime->date), days);
+}
+
+// Get the number of minutes from 01/01/1970 00:00 to a given datetime
+int dateTime_toMinutes(tDateTime dateTime) {
+    return date_toDays(dateTime.date) * 1440 + dateTime.time.hour * 60 + dateTime.time.minutes;
+}
+
+// Get the datetime a given number of minutes after 01/01/1970 00:00
+void dateTime_fromMinutes(tDateTime* dateTime, int minutes) {
+    int days;
     
-    // Add the number of days
-    initTimestamp.tm_mday += days;
+    assert(dateTime != NULL);
     
-    // Upate the date
-    mktime(&initTimestamp);
+    // Round the days down, so the minutes of the day are never negative
+    days = (minutes >= 0 ? minutes : minutes - 1439) / 1440;
+    minutes -= days * 1440;
     
-    // Update output structure
-    dateTime_fromTime(dateTime, initTimestamp);
+    date_fromDays(&(dateTime->date), days);
+    dateTime->time.hour = minutes / 60;
+    dateTime->time.minutes = minutes % 60;
 }
 
 // Parse a tDate from string information
@@ -111,42 +116,54 @@ void date_parse(tDate* date, const char* str) {
 
 // Compare two tDate structures and return -1 if date1<date2, 0 if equals and 1 if date1>date2.
 int date_cmp(tDate date1, tDate date2) {
-    // Check year
-    if (date1.year < date2.year) {
-        return -1;
-    }
-    if (date1.year > date2.year) {
-        return 1;
-    }
-    // Check month
-    if (date1.month < date2.month) {
-        return -1;
-    }
-    if (date1.month > date2.month) {
-        return 1;
-    }  
-    // Check day
-    if (date1.day < date2.day) {
-        return -1;
-    }
-    if (date1.day > date2.day) {
-        return 1;
-    }
+    int key1;
+    int key2;
+    
+    key1 = date_key(date1);
+    key2 = date_key(date2);
     
-    return 0;
+    return (key1 > key2) - (key1 < key2);
 }
 
 // Add days to a given date
 void date_addDay(tDate* date, int days) {
-    tDateTime timestamp;
-    
     assert(date != NULL);
+    
+    // Day numbers do not depend on the time zone, unlike mktime
+    date_fromDays(date, date_toDays(*date) + days);
+}
+
 
-    timestamp.date = *date;
-    timestamp.time.hour = 0;
-    timestamp.time.minutes = 0;
+// Get the number of days from 01/01/1970 to a given date
+int date_toDays(tDate date) {
+    int year, era, yearOfEra, dayOfYear, dayOfEra;
+    
+    // Count years from March, so the leap day is the last day of the year
+    year = date.year - (date.month <= 2 ? 1 : 0);
+    era = (year >= 0 ? year : year - 399) / 400;
+    yearOfEra = year - era * 400;
+    dayOfYear = (153 * (date.month + (date.month > 2 ? -3 : 9)) + 2) / 5 + date.day - 1;
+    dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    
+    // 719468 days from 01/03/0000 to 01/01/1970
+    return era * 146097 + dayOfEra - 719468;
+}
+
+// Get the date a given number of days after 01/01/1970
+void date_fromDays(tDate* date, int days) {
+    int era, dayOfEra, yearOfEra, dayOfYear, month;
     
-    dateTime_addDay(&timestamp, days);
+    assert(date != NULL);
     
-    *date = timestamp.date;
+    // Count days from 01/03/0000
+    days += 719468;
+    era = (days >= 0 ? days : days - 146096) / 146097;
+    dayOfEra = days - era * 146097;
+    yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    month = (5 * dayOfYear + 2) / 153;
+    
+    date->day = dayOfYear - (153 * month + 2) / 5 + 1;
+    date->month = month < 10 ? month + 3 : month - 9;
+    date->year = yearOfEra + era * 400 + (date->month <= 2 ? 1 : 0);
 }
@@ -0,0 +1,131 @@
+#include <stdlib.h>
+#include <assert.h>
+#include "hash.h"
+
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+// Hash a string (FNV-1a)
+unsigned int hash_str(const char* str) {
+    unsigned int hash = FNV_OFFSET_BASIS;
+    
+    assert(str != NULL);
+    
+    while (*str != '\0') {
+        hash ^= (unsigned char) *str;
+        hash *= FNV_PRIME;
+        str++;
+    }
+    
+    return hash;
+}
+
+// Hash the first len characters of a string (FNV-1a)
+unsigned int hash_strn(const char* str, int len) {
+    unsigned int hash = FNV_OFFSET_BASIS;
+    int i;
+    
+    assert(str != NULL);
+    
+    for (i = 0; i < len; i++) {
+        hash ^= (unsigned char) str[i];
+        hash *= FNV_PRIME;
+    }
+    
+    return hash;
+}
+
+// Get the number of slots needed to store count elements with a load factor below 0.5
+int hash_tableSize(int count) {
+    int size = HASH_MIN_SIZE;
+    
+    // Table sizes are powers of two, so positions can be computed with a mask
+    while (size < 2 * count) {
+        size *= 2;
+    }
+    
+    return size;
+}
+
+// Find the slot of a key on an open addressing hash table with linear probing, starting on the slot given by its hash. Returns the slot of the element matching the key or the empty slot where it would be added.
+// equals checks if the element at a given position of data matches the key
+int hash_probe(const int* index, int size, unsigned int hash, bool (*equals)(const void* data, int pos, const void* key), const void* data, const void* key) {
+    int mask;
+    int slot;
+    
+    assert(index != NULL);
+    assert(equals != NULL);
+    
+    mask = size - 1;
+    slot = hash & mask;
+    
+    // Linear probing up to an empty slot or the element matching the key
+    while (index[slot] != HASH_EMPTY_SLOT && !equals(data, index[slot], key)) {
+        slot = (slot + 1) & mask;
+    }
+    
+    return slot;
+}
+
+// Release an open addressing hash table and allocate a new one able to store capacity elements, adding the count elements of data. Returns the new table and stores its number of slots on size.
+// The elements are the positions given by positions, or the first count positions if it is NULL. hash returns the hash of the element at a given position of data
+int* hash_rebuild(int* index, int* size, int capacity, const int* positions, int count, unsigned int (*hash)(const void* data, int pos), const void* data) {
+    int mask;
+    int slot;
+    int pos;
+    int i;
+    
+    assert(size != NULL);
+    assert(hash != NULL);
+    
+    if (index != NULL) {
+        free(index);
+    }
+    
+    // Allocate the new table with all slots empty
+    *size = hash_tableSize(capacity > count ? capacity : count);
+    index = (int*) malloc(*size * sizeof(int));
+    assert(index != NULL);
+    for (i = 0; i < *size; i++) {
+        index[i] = HASH_EMPTY_SLOT;
+    }
+    
+    // The elements are all different, so each one is stored on the first empty slot from its hash
+    mask = *size - 1;
+    for (i = 0; i < count; i++) {
+        pos = positions != NULL ? positions[i] : i;
+        slot = hash(data, pos) & mask;
+        while (index[slot] != HASH_EMPTY_SLOT) {
+            slot = (slot + 1) & mask;
+        }
+        index[slot] = pos;
+    }
+    
+    return index;
+}
+
+// Remove the element of a slot of an open addressing hash table with linear probing. The next elements of its cluster are moved back, so they are still found.
+// hash returns the hash of the element at a given position of data
+void hash_removeSlot(int* index, int size, int slot, unsigned int (*hash)(const void* data, int pos), const void* data) {
+    int mask;
+    int next;
+    int home;
+    
+    assert(index != NULL);
+    assert(hash != NULL);
+    
+    mask = size - 1;
+    index[slot] = HASH_EMPTY_SLOT;
+    
+    // An element can fill the empty slot if its first slot is not between them
+    next = (slot + 1) & mask;
+    while (index[next] != HASH_EMPTY_SLOT) {
+        home = hash(data, index[next]) & mask;
+        if (((next - home) & mask) >= ((next - slot) & mask)) {
+            index[slot] = index[next];
+            index[next] = HASH_EMPTY_SLOT;
+            slot = next;
+        }
+        next = (next + 1) & mask;
+    }
+}
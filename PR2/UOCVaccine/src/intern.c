@@ -0,0 +1,215 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "intern.h"
+#include "hash.h"
+#include "array.h"
+
+// String searched on the index, given by its first len characters
+typedef struct _tInternKey {
+    const char* str;
+    int len;
+} tInternKey;
+
+// Check if the string at a given position is the string of a key
+static bool internTable_equalsKey(const void* data, int pos, const void* key) {
+    const tInternKey* strKey = (const tInternKey*) key;
+    const char* other;
+    
+    other = ((const tInternTable*) data)->strings[pos];
+    
+    return strncmp(other, strKey->str, strKey->len) == 0 && other[strKey->len] == '\0';
+}
+
+// Get the hash of the string at a given position, as stored on the index
+static unsigned int internTable_hashString(const void* data, int pos) {
+    return hash_str(((const tInternTable*) data)->strings[pos]);
+}
+
+// Find the slot of the index for a given string. Returns the slot with the string or the empty slot where it should be placed
+static int internTable_slot(const tInternTable* table, const char* str, int len) {
+    tInternKey key;
+    
+    assert(table->index != NULL);
+    
+    key.str = str;
+    key.len = len;
+    
+    return hash_probe(table->index, table->indexSize, hash_strn(str, len), internTable_equalsKey, table, &key);
+}
+
+// Rebuild the index with a size able to store count strings
+static void internTable_rebuild(tInternTable* table, int count) {
+    table->index = hash_rebuild(table->index, &(table->indexSize), count, NULL, table->count, internTable_hashString, table);
+}
+
+// Initialize the table
+void internTable_init(tInternTable* table) {
+    assert(table != NULL);
+    
+    table->strings = NULL;
+    table->count = 0;
+    table->capacity = 0;
+    table->index = NULL;
+    table->indexSize = 0;
+    arena_init(&(table->arena));
+}
+
+// Release the table and all its strings
+void internTable_free(tInternTable* table) {
+    assert(table != NULL);
+    
+    if (table->strings != NULL) {
+        free(table->strings);
+    }
+    if (table->index != NULL) {
+        free(table->index);
+    }
+    arena_free(&(table->arena));
+    
+    internTable_init(table);
+}
+
+// Get the number of strings of the table
+int internTable_len(const tInternTable* table) {
+    assert(table != NULL);
+    
+    return table->count;
+}
+
+// Get the canonical copy of a string, adding it to the table if it is not found
+const char* internTable_add(tInternTable* table, const char* str) {
+    assert(str != NULL);
+    
+    return internTable_addn(table, str, strlen(str));
+}
+
+// Get the canonical copy of the first len characters of a string, adding it to the table if it is not found
+const char* internTable_addn(tInternTable* table, const char* str, int len) {
+    int slot;
+    
+    assert(table != NULL);
+    assert(str != NULL);
+    
+    // Keep the load factor below 0.5
+    if (2 * (table->count + 1) > table->indexSize) {
+        internTable_rebuild(table, table->count + 1);
+    }
+    
+    slot = internTable_slot(table, str, len);
+    if (table->index[slot] == HASH_EMPTY_SLOT) {
+        // Store a new canonical copy
+        table->strings = (const char**) array_grow(table->strings, &(table->capacity), table->count + 1, sizeof(const char*));
+        table->strings[table->count] = arena_strndup(&(table->arena), str, len);
+        table->index[slot] = table->count;
+        table->count ++;
+    }
+    
+    return table->strings[table->index[slot]];
+}
+
+// Get the canonical copy of a string. NULL if it is not in the table
+const char* internTable_find(const tInternTable* table, const char* str) {
+    int slot;
+    
+    assert(table != NULL);
+    assert(str != NULL);
+    
+    // Empty table has no index
+    if (table->index == NULL) {
+        return NULL;
+    }
+    
+    slot = internTable_slot(table, str, strlen(str));
+    if (table->index[slot] == HASH_EMPTY_SLOT) {
+        return NULL;
+    }
+    
+    return table->strings[table->index[slot]];
+}
+
+// Check if a string is the canonical copy of the table
+bool internTable_isCanonical(const tInternTable* table, const char* str) {
+    return str != NULL && internTable_find(table, str) == str;
+}
+
+// Get the position of a string on the table, in insertion order. -1 if it is not in the table
+int internTable_findId(const tInternTable* table, const char* str) {
+    int slot;
+    
+    assert(table != NULL);
+    assert(str != NULL);
+    
+    if (table->index == NULL) {
+        return -1;
+    }
+    
+    slot = internTable_slot(table, str, strlen(str));
+    
+    return table->index[slot];
+}
+
+// Get the string at a given position of the table, in insertion order. NULL if the position is not valid
+const char* internTable_get(const tInternTable* table, int id) {
+    assert(table != NULL);
+    
+    if (id < 0 || id >= table->count) {
+        return NULL;
+    }
+    
+    return table->strings[id];
+}
+
+// Write the table on a snapshot
+void internTable_save(const tInternTable* table, tSnapshotWriter* writer) {
+    int* offsets;
+    int i;
+    
+    assert(table != NULL);
+    assert(writer != NULL);
+    
+    offsets = (int*) malloc((table->count > 0 ? table->count : 1) * sizeof(int));
+    assert(offsets != NULL);
+    for (i = 0; i < table->count; i++) {
+        offsets[i] = snapshot_addString(writer, table->strings[i]);
+    }
+    
+    snapshot_writeInt(writer, table->count);
+    snapshot_write(writer, offsets, table->count * sizeof(int));
+    snapshot_writeIndex(writer, table->index, table->indexSize);
+    
+    free(offsets);
+}
+
+// Read an empty table from a snapshot. The strings are not copied, so they must remain valid while the table is used, as after snapshot_copyStrings.
+// Returns false if the snapshot is not valid
+bool internTable_load(tInternTable* table, tSnapshotReader* reader) {
+    const int* offsets;
+    const char* str;
+    int count;
+    int i;
+    
+    assert(table != NULL);
+    assert(reader != NULL);
+    assert(table->count == 0);
+    
+    count = snapshot_readInt(reader);
+    offsets = (const int*) snapshot_readArray(reader, count, sizeof(int));
+    if (offsets == NULL) {
+        return false;
+    }
+    
+    table->strings = (const char**) array_reserve(table->strings, &(table->capacity), count, sizeof(const char*));
+    for (i = 0; i < count; i++) {
+        str = snapshot_getString(reader, offsets[i]);
+        table->strings[i] = str;
+    }
+    table->count = count;
+    
+    table->index = snapshot_readIndex(reader, count, &(table->indexSize));
+    if (table->index == NULL && count > 0) {
+        reader->failed = true;
+    }
+    
+    return !reader->failed;
+}
@@ -3,7 +3,60 @@
 #include <string.h>
 #include <stdio.h>
 #include "person.h"
+#include "hash.h"
+#include "array.h"
 
+// Check if a document is equal to the first len characters of a given one
+static bool person_documentEquals(const char* document, const char* other, int len) {
+    return strncmp(document, other, len) == 0 && document[len] == '\0';
+}
+
+// Document searched on the index, given by its first len characters
+typedef struct _tPopulationKey {
+    const char* document;
+    int len;
+} tPopulationKey;
+
+// Check if the person at a given position has the document of a key
+static bool population_equalsKey(const void* data, int pos, const void* key) {
+    const tPopulationKey* documentKey = (const tPopulationKey*) key;
+    
+    return person_documentEquals(((const tPopulation*) data)->elems[pos].document, documentKey->document, documentKey->len);
+}
+
+// Get the hash of the document of the person at a given position, as stored on the index
+static unsigned int population_hashPerson(const void* data, int pos) {
+    return hash_str(((const tPopulation*) data)->elems[pos].document);
+}
+
+// Find the slot of the index for a given document. Returns the slot with the person or the empty slot where it should be placed
+static int population_indexSlot(const tPopulation* data, const char* document, int len) {
+    tPopulationKey key;
+    
+    assert(data->index != NULL);
+    
+    key.document = document;
+    key.len = len;
+    
+    return hash_probe(data->index, data->indexSize, hash_strn(document, len), population_equalsKey, data, &key);
+}
+
+// Rebuild the index of the population with a size able to store count persons
+static void population_indexRebuild(tPopulation* data, int count) {
+    data->index = hash_rebuild(data->index, &(data->indexSize), count, NULL, data->count, population_hashPerson, data);
+}
+
+// Add the last person of the population to the index, growing it when the load factor reaches 0.5
+static void population_indexAdd(tPopulation* data) {
+    const char* document;
+    
+    if (2 * data->count > data->indexSize) {
+        population_indexRebuild(data, data->count);
+    } else {
+        document = data->elems[data->count - 1].document;
+        data->index[population_indexSlot(data, document, strlen(document))] = data->count - 1;
+    }
+}
 
 // Initialize the population data
 void population_init(tPopulation* data) {
@@ -12,6 +65,11 @@ void population_init(tPopulation* data) {
     
     data->elems = NULL;
     data->count = 0;
+    data->capacity = 0;
+    data->index = NULL;
+    data->indexSize = 0;
+    data->arena = NULL;
+    data->strings = NULL;
 }
 
 // Initialize a person structure
@@ -60,6 +118,30 @@ void person_free(tPerson* data) {
     data->cp = NULL;
 }
 
+// Remove the data of a person of the population. Strings on an arena are released with the arena
+static void population_freePerson(tPopulation* data, tPerson* person) {
+    if (data->arena == NULL) {
+        // Canonical cp are owned by the table of strings
+        if (data->strings != NULL) {
+            person->cp = NULL;
+        }
+        person_free(person);
+    }
+}
+
+// Replace the cp of a person of the population by its canonical copy
+static void population_internCp(tPopulation* data, tPerson* person) {
+    const char* cp;
+    
+    if (data->strings != NULL) {
+        cp = internTable_add(data->strings, person->cp);
+        if (data->arena == NULL) {
+            free(person->cp);
+        }
+        person->cp = (char*) cp;
+    }
+}
+
 // Remove the data from all persons
 void population_free(tPopulation* data) {
     int i;
@@ -69,14 +151,22 @@ void population_free(tPopulation* data) {
     
     // Remove contents
     for(i = 0; i < data->count; i++) {
-        person_free(&(data->elems[i]));
-    }    
+        population_freePerson(data, &(data->elems[i]));
+    }
     
     // Release memory
-    if (data->count > 0) {
+    if (data->elems != NULL) {
         free(data->elems);
         data->elems = NULL;
         data->count = 0;
+        data->capacity = 0;
+    }
+    
+    // Release the index
+    if (data->index != NULL) {
+        free(data->index);
+        data->index = NULL;
+        data->indexSize = 0;
     }
 }
 
@@ -134,32 +224,170 @@ void person_parse(tPerson* data, tCSVEntry entry) {
     sscanf(entry.fields[6], "%d/%d/%d", &(data->birthday.day), &(data->birthday.month), &(data->birthday.year));
 }
 
+// Reserve memory to store at least the given number of persons
+void population_reserve(tPopulation* data, int size) {
+    // Check input data
+    assert(data != NULL);
+    
+    data->elems = (tPerson*) array_reserve(data->elems, &(data->capacity), size, sizeof(tPerson));
+    
+    // Size the index for the reserved number of persons
+    if (hash_tableSize(size) > data->indexSize) {
+        population_indexRebuild(data, size);
+    }
+}
+
+// Copy a field of a CSV view into a new string, allocated on the arena if it is not NULL
+static char* person_fieldDup(tCSVField field, tArena* arena) {
+    char* str;
+    
+    if (arena != NULL) {
+        return arena_strndup(arena, field.str, field.len);
+    }
+    
+    str = (char*) malloc((field.len + 1) * sizeof(char));
+    assert(str != NULL);
+    memcpy(str, field.str, field.len);
+    str[field.len] = '\0';
+    
+    return str;
+}
+
+// Parse input from a CSV view. Strings are allocated on the arena if it is not NULL, and the cp is interned if strings is not NULL
+static void person_parseFields(tPerson* data, const tCSVView* view, tArena* arena, tInternTable* strings) {
+    char birthday[11];
+    
+    // Check input data
+    assert(data != NULL);
+    assert(view != NULL);
+    
+    // Check entry fields
+    assert(view->numFields == 7);
+    
+    // Remove old data
+    if (arena == NULL) {
+        person_free(data);
+    }
+    
+    // Copy the text fields
+    data->document = person_fieldDup(view->fields[0], arena);
+    data->name = person_fieldDup(view->fields[1], arena);
+    data->surname = person_fieldDup(view->fields[2], arena);
+    data->email = person_fieldDup(view->fields[3], arena);
+    data->address = person_fieldDup(view->fields[4], arena);
+    if (strings != NULL) {
+        data->cp = (char*) internTable_addn(strings, view->fields[5].str, view->fields[5].len);
+    } else {
+        data->cp = person_fieldDup(view->fields[5], arena);
+    }
+    
+    // Check birthday lenght
+    assert(view->fields[6].len == 10);
+    // Parse the birthday date
+    csv_fieldAsString(view->fields[6], birthday, 11);
+    date_parse(&(data->birthday), birthday);
+}
+
+// Parse input from a CSV view, copying the fields directly from the viewed text. If arena is not NULL, the strings are allocated on it
+void person_parseView(tPerson* data, const tCSVView* view, tArena* arena) {
+    person_parseFields(data, view, arena, NULL);
+}
+
+// Copy the data from the source to destination, allocating the strings on an arena
+static void person_cpyArena(tPerson* destination, tPerson source, tArena* arena) {
+    destination->document = arena_strdup(arena, source.document);
+    destination->name = arena_strdup(arena, source.name);
+    destination->surname = arena_strdup(arena, source.surname);
+    destination->email = arena_strdup(arena, source.email);
+    destination->address = arena_strdup(arena, source.address);
+    destination->cp = arena_strdup(arena, source.cp);
+    destination->birthday = source.birthday;
+}
+
 // Add a new person
 void population_add(tPopulation* data, tPerson person) {
     // Check input data
     assert(data != NULL);
     
     // If person does not exist add it
-    if(population_find(data[0], person.document) < 0) {   
+    if(population_find(data, person.document) < 0) {   
         // Allocate memory for new element
-        if (data->count == 0) {
-            // Request new memory space
-            data->elems = (tPerson*) malloc(sizeof(tPerson));            
-        } else {
-            // Modify currently allocated memory
-            data->elems = (tPerson*) realloc(data->elems, (data->count + 1) * sizeof(tPerson));            
-        }
-        assert(data->elems != NULL);
+        data->elems = (tPerson*) array_grow(data->elems, &(data->capacity), data->count + 1, sizeof(tPerson));
         
         // Initialize the new element
         person_init(&(data->elems[data->count]));
                 
         // Copy the data to the new position
-        person_cpy(&(data->elems[data->count]), person);
+        if (data->arena != NULL) {
+            person_cpyArena(&(data->elems[data->count]), person, data->arena);
+        } else {
+            person_cpy(&(data->elems[data->count]), person);
+        }
+        population_internCp(data, &(data->elems[data->count]));
         
         // Increase the number of elements
         data->count ++;
+        
+        // Add the new position to the index
+        population_indexAdd(data);
+    }
+}
+
+// Add a new person from a CSV view. Returns false if a person with the same document already exists
+bool population_addView(tPopulation* data, const tCSVView* view) {
+    // Check input data
+    assert(data != NULL);
+    assert(view != NULL);
+    assert(view->numFields == 7);
+    
+    // Check if this person already exists
+    if (population_findn(data, view->fields[0].str, view->fields[0].len) >= 0) {
+        return false;
+    }
+    
+    // Allocate memory for new element
+    data->elems = (tPerson*) array_grow(data->elems, &(data->capacity), data->count + 1, sizeof(tPerson));
+    
+    // Parse the data directly on the new position
+    person_init(&(data->elems[data->count]));
+    person_parseFields(&(data->elems[data->count]), view, data->arena, data->strings);
+    
+    // Increase the number of elements
+    data->count ++;
+    
+    // Add the new position to the index
+    population_indexAdd(data);
+    
+    return true;
+}
+
+// Add a new person taking the ownership of its data, which must be allocated on the population arena if it has one. Returns false, leaving the person untouched, if a person with the same document already exists
+bool population_take(tPopulation* data, tPerson* person) {
+    // Check input data
+    assert(data != NULL);
+    assert(person != NULL);
+    assert(person->document != NULL);
+    
+    // Check if this person already exists
+    if (population_find(data, person->document) >= 0) {
+        return false;
     }
+    
+    // Allocate memory for new element
+    data->elems = (tPerson*) array_grow(data->elems, &(data->capacity), data->count + 1, sizeof(tPerson));
+    
+    // Move the data to the new position. The source no longer owns it
+    data->elems[data->count] = *person;
+    population_internCp(data, &(data->elems[data->count]));
+    person_init(person);
+    
+    // Increase the number of elements
+    data->count ++;
+    
+    // Add the new position to the index
+    population_indexAdd(data);
+    
+    return true;
 }
 
 // Remove a person
@@ -171,11 +399,11 @@ void population_del(tPopulation* data, const char *document) {
     assert(data != NULL);
     
     // Find if it exists
-    pos = population_find(data[0], document);
+    pos = population_find(data, document);
     
     if (pos >= 0) {
         // Remove current position memory
-        person_free(&(data->elems[pos]));
+        population_freePerson(data, &(data->elems[pos]));
         // Shift elements 
         for(i = pos; i < data->count-1; i++) {
             // Copy address of element on position i+1 to position i
@@ -183,46 +411,136 @@ void population_del(tPopulation* data, const char *document) {
         }
         // Update the number of elements
         data->count--;
-        // Resize the used memory
+        // Release the memory when no element is remaining. Otherwise the capacity is kept for new elements
         if (data->count == 0) {
-            // No element remaining
             free(data->elems);
             data->elems = NULL;
-        } else {
-            // Still some elements are remaining
-            data->elems = (tPerson*)realloc(data->elems, data->count * sizeof(tPerson));
+            data->capacity = 0;
         }
+        // Positions after the removed one have changed
+        population_indexRebuild(data, data->count);
+    }
+}
+
+// Check if a string of a person is equal to a field of a CSV view
+static bool person_fieldEquals(const char* str, tCSVField field) {
+    return person_documentEquals(str, field.str, field.len);
+}
+
+// Check if a person has the same data as a CSV view of a person
+bool person_equalsView(const tPerson* data, const tCSVView* view) {
+    char birthday[11];
+    tDate date;
+    
+    assert(data != NULL);
+    assert(view != NULL);
+    assert(view->numFields == 7);
+    
+    // Compare the text fields first, as they are cheaper than parsing the birthday
+    if (!person_fieldEquals(data->document, view->fields[0])
+        || !person_fieldEquals(data->name, view->fields[1])
+        || !person_fieldEquals(data->surname, view->fields[2])
+        || !person_fieldEquals(data->email, view->fields[3])
+        || !person_fieldEquals(data->address, view->fields[4])
+        || !person_fieldEquals(data->cp, view->fields[5])
+        || view->fields[6].len != 10) {
+        return false;
+    }
+    
+    csv_fieldAsString(view->fields[6], birthday, 11);
+    date_parse(&date, birthday);
+    
+    return date_cmp(data->birthday, date) == 0;
+}
+
+// Replace the data of the person at a given position by a CSV view of a person with the same document. The document string is kept
+void population_updateView(tPopulation* data, int pos, const tCSVView* view) {
+    tPerson person;
+    
+    assert(data != NULL);
+    assert(pos >= 0 && pos < data->count);
+    assert(view != NULL);
+    assert(view->numFields == 7);
+    assert(person_documentEquals(data->elems[pos].document, view->fields[0].str, view->fields[0].len));
+    
+    person_init(&person);
+    person_parseFields(&person, view, data->arena, data->strings);
+    
+    // The document may be referenced by other structures, like the appointments of the person
+    if (data->arena == NULL) {
+        free(person.document);
+    }
+    person.document = data->elems[pos].document;
+    data->elems[pos].document = NULL;
+    
+    population_freePerson(data, &(data->elems[pos]));
+    data->elems[pos] = person;
+}
+
+// Remove the person at a given position, moving the last person to it. Other persons keep their position, so the index is updated in place
+void population_removeAt(tPopulation* data, int pos) {
+    const char* document;
+    int last;
+    
+    assert(data != NULL);
+    assert(pos >= 0 && pos < data->count);
+    
+    document = data->elems[pos].document;
+    hash_removeSlot(data->index, data->indexSize, population_indexSlot(data, document, strlen(document)), population_hashPerson, data);
+    population_freePerson(data, &(data->elems[pos]));
+    
+    // Move the last person to the free position
+    last = data->count - 1;
+    if (pos != last) {
+        document = data->elems[last].document;
+        data->index[population_indexSlot(data, document, strlen(document))] = pos;
+        data->elems[pos] = data->elems[last];
     }
+    data->count--;
 }
 
 // Return the position of a person with provided document. -1 if it does not exist
-int population_find(tPopulation data, const char* document) {
-    int i;
+int population_find(const tPopulation* data, const char* document) {
+    assert(data != NULL);
+    assert(document != NULL);
     
-    for(i = 0; i < data.count; i++) {
-        if(strcmp(data.elems[i].document, document) == 0 ) {
-            return i;
-        }
+    return population_findn(data, document, strlen(document));
+}
+
+// Return the position of a person with the document given by its first len characters. -1 if it does not exist
+int population_findn(const tPopulation* data, const char* document, int len) {
+    int slot;
+    
+    assert(data != NULL);
+    assert(document != NULL);
+    
+    // Empty population has no index
+    if (data->index == NULL) {
+        return -1;
     }
     
-    return -1;
+    slot = population_indexSlot(data, document, len);
+    
+    return data->index[slot];
 }
 
 // Print the person data
-void population_print(tPopulation data) {
+void population_print(const tPopulation* data) {
     int i;
     
-    for(i = 0; i < data.count; i++) {
+    assert(data != NULL);
+    
+    for(i = 0; i < data->count; i++) {
         // Print position and document
-        printf("%d;%s;", i, data.elems[i].document);
+        printf("%d;%s;", i, data->elems[i].document);
         // Print name and surname
-        printf("%s;%s;", data.elems[i].name, data.elems[i].surname);        
+        printf("%s;%s;", data->elems[i].name, data->elems[i].surname);        
         // Print email
-        printf("%s;", data.elems[i].email);
+        printf("%s;", data->elems[i].email);
         // Print address and CP
-        printf("%s;%s;", data.elems[i].address, data.elems[i].cp);
+        printf("%s;%s;", data->elems[i].address, data->elems[i].cp);
         // Print birthday date
-        printf("%02d/%02d/%04d\n", data.elems[i].birthday.day, data.elems[i].birthday.month, data.elems[i].birthday.year);
+        printf("%02d/%02d/%04d\n", data->elems[i].birthday.day, data->elems[i].birthday.month, data->elems[i].birthday.year);
     }
 }
 
@@ -267,6 +585,93 @@ void person_cpy(tPerson* destination, tPerson source) {
 }
 
 // Return population lenght
-int population_len(tPopulation data) {
-    return data.count;
-}
\ No newline at end of file
+int population_len(const tPopulation* data) {
+    assert(data != NULL);
+    
+    return data->count;
+}
+
+// Person as stored on a snapshot, with the strings as offsets
+typedef struct _tPersonRecord {
+    int document;
+    int name;
+    int surname;
+    int email;
+    int address;
+    // Position of the cp on the table of strings
+    int cp;
+    tDate birthday;
+} tPersonRecord;
+
+// Write the population on a snapshot. The cp of the persons are written as positions on the table of strings
+void population_save(const tPopulation* data, tSnapshotWriter* writer) {
+    tPersonRecord* records;
+    tPerson* person;
+    int i;
+    
+    assert(data != NULL);
+    assert(data->strings != NULL);
+    assert(writer != NULL);
+    
+    records = (tPersonRecord*) malloc((data->count > 0 ? data->count : 1) * sizeof(tPersonRecord));
+    assert(records != NULL);
+    for (i = 0; i < data->count; i++) {
+        person = &(data->elems[i]);
+        records[i].document = snapshot_addString(writer, person->document);
+        records[i].name = snapshot_addString(writer, person->name);
+        records[i].surname = snapshot_addString(writer, person->surname);
+        records[i].email = snapshot_addString(writer, person->email);
+        records[i].address = snapshot_addString(writer, person->address);
+        records[i].cp = internTable_findId(data->strings, person->cp);
+        records[i].birthday = person->birthday;
+    }
+    
+    snapshot_writeInt(writer, data->count);
+    snapshot_write(writer, records, data->count * sizeof(tPersonRecord));
+    snapshot_writeIndex(writer, data->index, data->indexSize);
+    
+    free(records);
+}
+
+// Read an empty population from a snapshot, with the strings copied on the snapshot arena. Returns false if the snapshot is not valid
+bool population_load(tPopulation* data, tSnapshotReader* reader) {
+    const tPersonRecord* records;
+    tPerson* person;
+    int count;
+    int i;
+    
+    assert(data != NULL);
+    assert(data->arena != NULL && data->strings != NULL);
+    assert(reader != NULL);
+    assert(data->count == 0);
+    
+    count = snapshot_readInt(reader);
+    records = (const tPersonRecord*) snapshot_readArray(reader, count, sizeof(tPersonRecord));
+    if (records == NULL) {
+        return false;
+    }
+    
+    // Single pass replacing the offsets and positions by pointers
+    data->elems = (tPerson*) array_reserve(data->elems, &(data->capacity), count, sizeof(tPerson));
+    for (i = 0; i < count; i++) {
+        person = &(data->elems[i]);
+        person->document = (char*) snapshot_getString(reader, records[i].document);
+        person->name = (char*) snapshot_getString(reader, records[i].name);
+        person->surname = (char*) snapshot_getString(reader, records[i].surname);
+        person->email = (char*) snapshot_getString(reader, records[i].email);
+        person->address = (char*) snapshot_getString(reader, records[i].address);
+        person->cp = (char*) internTable_get(data->strings, records[i].cp);
+        person->birthday = records[i].birthday;
+        if (person->cp == NULL) {
+            reader->failed = true;
+        }
+    }
+    data->count = count;
+    
+    data->index = snapshot_readIndex(reader, count, &(data->indexSize));
+    if (data->index == NULL && count > 0) {
+        reader->failed = true;
+    }
+    
+    return !reader->failed;
+}
@@ -0,0 +1,314 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <limits.h>
+#include "snapshot.h"
+#include "array.h"
+#include "hash.h"
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// Value of the byte order field of the header, as written by the current machine
+#define SNAPSHOT_BYTE_ORDER 0x01020304
+
+// Write bytes to a snapshot file
+static void snapshot_writeBytes(tSnapshotWriter* writer, const void* data, size_t size) {
+    if (size > 0 && !writer->failed && fwrite(data, 1, size, writer->fout) != size) {
+        writer->failed = true;
+    }
+    writer->pos += size;
+}
+
+// Write zeros up to the next aligned position
+static void snapshot_writeAlign(tSnapshotWriter* writer) {
+    static const char zeros[SNAPSHOT_ALIGNMENT] = {0};
+    
+    snapshot_writeBytes(writer, zeros, (SNAPSHOT_ALIGNMENT - writer->pos % SNAPSHOT_ALIGNMENT) % SNAPSHOT_ALIGNMENT);
+}
+
+// Create a snapshot file. Returns false if the file cannot be created
+bool snapshot_openWriter(tSnapshotWriter* writer, const char* filename) {
+    tSnapshotHeader header;
+    
+    assert(writer != NULL);
+    assert(filename != NULL);
+    
+    writer->pos = 0;
+    writer->strings = NULL;
+    writer->stringsSize = 0;
+    writer->stringsCapacity = 0;
+    writer->failed = false;
+    
+    writer->fout = fopen(filename, "wb");
+    if (writer->fout == NULL) {
+        return false;
+    }
+    
+    // The header is written again when the position of the strings is known
+    memset(&header, 0, sizeof(tSnapshotHeader));
+    snapshot_writeBytes(writer, &header, sizeof(tSnapshotHeader));
+    
+    return true;
+}
+
+// Write the strings and the header and close a snapshot file. Returns false if any write failed
+bool snapshot_closeWriter(tSnapshotWriter* writer) {
+    tSnapshotHeader header;
+    
+    assert(writer != NULL);
+    assert(writer->fout != NULL);
+    
+    memset(&header, 0, sizeof(tSnapshotHeader));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.byteOrder = SNAPSHOT_BYTE_ORDER;
+    
+    snapshot_writeAlign(writer);
+    header.stringsOffset = writer->pos;
+    header.stringsSize = writer->stringsSize;
+    snapshot_writeBytes(writer, writer->strings, writer->stringsSize);
+    
+    if (!writer->failed && (fseek(writer->fout, 0, SEEK_SET) != 0 || fwrite(&header, sizeof(tSnapshotHeader), 1, writer->fout) != 1)) {
+        writer->failed = true;
+    }
+    
+    // The snapshot must be on the disk before the log it replaces is removed
+    if (!writer->failed && fflush(writer->fout) != 0) {
+        writer->failed = true;
+    }
+#ifdef _WIN32
+    if (!writer->failed && _commit(_fileno(writer->fout)) != 0) {
+        writer->failed = true;
+    }
+#else
+    if (!writer->failed && fsync(fileno(writer->fout)) != 0) {
+        writer->failed = true;
+    }
+#endif
+    if (fclose(writer->fout) != 0) {
+        writer->failed = true;
+    }
+    writer->fout = NULL;
+    
+    if (writer->strings != NULL) {
+        free(writer->strings);
+        writer->strings = NULL;
+    }
+    
+    return !writer->failed;
+}
+
+// Write an integer
+void snapshot_writeInt(tSnapshotWriter* writer, int value) {
+    assert(writer != NULL);
+    
+    snapshot_writeBytes(writer, &value, sizeof(int));
+}
+
+// Write an array of size bytes, aligned to SNAPSHOT_ALIGNMENT
+void snapshot_write(tSnapshotWriter* writer, const void* data, size_t size) {
+    assert(writer != NULL);
+    assert(data != NULL || size == 0);
+    
+    snapshot_writeAlign(writer);
+    snapshot_writeBytes(writer, data, size);
+}
+
+// Store a string and get its offset, used to reference it from the records
+int snapshot_addString(tSnapshotWriter* writer, const char* str) {
+    int offset;
+    int len;
+    
+    assert(writer != NULL);
+    assert(str != NULL);
+    
+    len = strlen(str) + 1;
+    if (writer->stringsSize > INT_MAX - len) {
+        // Offsets are stored as integers
+        writer->failed = true;
+        return 0;
+    }
+    
+    offset = writer->stringsSize;
+    writer->strings = (char*) array_grow(writer->strings, &(writer->stringsCapacity), writer->stringsSize + len, sizeof(char));
+    memcpy(writer->strings + offset, str, len);
+    writer->stringsSize += len;
+    
+    return offset;
+}
+
+// Check the header of a mapped snapshot file and locate its strings
+static bool snapshot_readHeader(tSnapshotReader* reader) {
+    const tSnapshotHeader* header;
+    
+    // The mapped file is aligned to a page, so the records can be read in place
+    header = (const tSnapshotHeader*) snapshot_read(reader, sizeof(tSnapshotHeader));
+    if (header == NULL || memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0) {
+        return false;
+    }
+    if (header->version != SNAPSHOT_VERSION || header->byteOrder != SNAPSHOT_BYTE_ORDER) {
+        return false;
+    }
+    if (header->stringsOffset < reader->pos || header->stringsSize < 0 || header->stringsSize > INT_MAX || header->stringsOffset + header->stringsSize != reader->file.size) {
+        return false;
+    }
+    
+    // All the strings end inside the file
+    reader->strings = reader->file.data + header->stringsOffset;
+    reader->stringsSize = (int) header->stringsSize;
+    if (reader->stringsSize > 0 && reader->strings[reader->stringsSize - 1] != '\0') {
+        return false;
+    }
+    
+    return true;
+}
+
+// Map a snapshot file and check its header. Returns false if the file cannot be read or, marking the reader as failed, if it is not a valid snapshot
+bool snapshot_openReader(tSnapshotReader* reader, const char* filename) {
+    assert(reader != NULL);
+    assert(filename != NULL);
+    
+    reader->pos = 0;
+    reader->strings = NULL;
+    reader->stringsSize = 0;
+    reader->failed = false;
+    
+    if (!csv_openFile(&(reader->file), filename)) {
+        return false;
+    }
+    if (!snapshot_readHeader(reader)) {
+        reader->failed = true;
+        csv_closeFile(&(reader->file));
+        return false;
+    }
+    
+    return true;
+}
+
+// Release a snapshot file mapped in memory
+void snapshot_closeReader(tSnapshotReader* reader) {
+    assert(reader != NULL);
+    
+    csv_closeFile(&(reader->file));
+}
+
+// Read an integer. Returns 0 if the file has no more data
+int snapshot_readInt(tSnapshotReader* reader) {
+    int value;
+    
+    assert(reader != NULL);
+    
+    if (reader->pos + (long long) sizeof(int) > reader->file.size) {
+        reader->failed = true;
+        return 0;
+    }
+    memcpy(&value, reader->file.data + reader->pos, sizeof(int));
+    reader->pos += sizeof(int);
+    
+    return value;
+}
+
+// Read an array of size bytes written with snapshot_write. Returns NULL if the file has not enough data
+const void* snapshot_read(tSnapshotReader* reader, size_t size) {
+    const void* data;
+    
+    assert(reader != NULL);
+    
+    reader->pos = (reader->pos + SNAPSHOT_ALIGNMENT - 1) & ~((long long) SNAPSHOT_ALIGNMENT - 1);
+    if (reader->failed || reader->pos + (long long) size > reader->file.size) {
+        reader->failed = true;
+        return NULL;
+    }
+    data = reader->file.data + reader->pos;
+    reader->pos += size;
+    
+    return data;
+}
+
+// Read an array of count elements of elemSize bytes. Returns NULL if the count is not valid or the file has not enough data
+const void* snapshot_readArray(tSnapshotReader* reader, int count, size_t elemSize) {
+    assert(reader != NULL);
+    
+    if (count < 0 || (long long) count * (long long) elemSize > reader->file.size) {
+        reader->failed = true;
+        return NULL;
+    }
+    
+    return snapshot_read(reader, (size_t) count * elemSize);
+}
+
+// Get the string with a given offset. Returns NULL, marking the reader as failed, if the offset is not valid
+const char* snapshot_getString(tSnapshotReader* reader, int offset) {
+    assert(reader != NULL);
+    
+    if (offset < 0 || offset >= reader->stringsSize) {
+        reader->failed = true;
+        return NULL;
+    }
+    
+    return reader->strings + offset;
+}
+
+// Write a hash index of positions
+void snapshot_writeIndex(tSnapshotWriter* writer, const int* index, int indexSize) {
+    assert(writer != NULL);
+    
+    snapshot_writeInt(writer, indexSize);
+    snapshot_write(writer, index, indexSize * sizeof(int));
+}
+
+// Read a hash index written with snapshot_writeIndex, with positions below limit. Returns a copy of the index, or NULL if it is empty or not valid
+int* snapshot_readIndex(tSnapshotReader* reader, int limit, int* indexSize) {
+    const int* data;
+    int* index;
+    int empty;
+    int i;
+    
+    assert(reader != NULL);
+    assert(indexSize != NULL);
+    
+    *indexSize = snapshot_readInt(reader);
+    data = (const int*) snapshot_readArray(reader, *indexSize, sizeof(int));
+    if (data == NULL || *indexSize == 0) {
+        *indexSize = 0;
+        return NULL;
+    }
+    
+    // Slots are found with a mask, and probing stops on an empty slot
+    empty = 0;
+    for (i = 0; i < *indexSize; i++) {
+        if (data[i] == HASH_EMPTY_SLOT) {
+            empty++;
+        } else if (data[i] < 0 || data[i] >= limit) {
+            break;
+        }
+    }
+    if (i < *indexSize || empty == 0 || (*indexSize & (*indexSize - 1)) != 0) {
+        reader->failed = true;
+        *indexSize = 0;
+        return NULL;
+    }
+    
+    index = (int*) malloc(*indexSize * sizeof(int));
+    assert(index != NULL);
+    memcpy(index, data, *indexSize * sizeof(int));
+    
+    return index;
+}
+
+// Copy the strings of the snapshot on an arena, so they remain valid once the reader is closed
+void snapshot_copyStrings(tSnapshotReader* reader, tArena* arena) {
+    char* strings;
+    
+    assert(reader != NULL);
+    assert(arena != NULL);
+    
+    if (reader->stringsSize > 0) {
+        strings = (char*) arena_alloc(arena, reader->stringsSize);
+        memcpy(strings, reader->strings, reader->stringsSize);
+        reader->strings = strings;
+    }
+}
@@ -3,63 +3,249 @@
 #include <stdio.h>
 #include <string.h>
 #include "stock.h"
+#include "array.h"
+
+// Add a change of doses on the day at index i of a Fenwick tree with size days
+static void stock_treeAdd(int* tree, int size, int i, int doses) {
+    assert(tree != NULL);
+    assert(i >= 0 && i < size);
+    
+    // Tree nodes are stored from index 1
+    for (i++; i <= size; i += i & (-i)) {
+        tree[i - 1] += doses;
+    }
+}
+
+// Get the sum of the changes of doses of the days up to index i of a Fenwick tree
+static int stock_treeSum(const int* tree, int i) {
+    int doses = 0;
+    
+    assert(tree != NULL);
+    
+    for (i++; i > 0; i -= i & (-i)) {
+        doses += tree[i - 1];
+    }
+    
+    return doses;
+}
+
+// Turn an array with the change of doses of each day into a Fenwick tree, in linear time
+static void stock_treeBuild(int* tree, int size) {
+    int i;
+    int parent;
+    
+    assert(tree != NULL);
+    
+    for (i = 1; i <= size; i++) {
+        parent = i + (i & (-i));
+        if (parent <= size) {
+            tree[parent - 1] += tree[i - 1];
+        }
+    }
+}
+
+// Get the doses of a column on a given day number
+static int stockList_columnDoses(const tVaccineStockData* list, int column, int day) {
+    assert(list != NULL);
+    assert(column >= 0 && column < list->numColumns);
+    
+    if (day < list->base) {
+        return 0;
+    }
+    
+    return stock_treeSum(list->columns[column].deltas, day - list->base);
+}
+
+// Ensure the days between two day numbers can be stored, leaving the free space on the side that grows
+static void stockList_reserve(tVaccineStockData* list, int firstDay, int lastDay) {
+    bool growLeft;
+    bool growRight;
+    int base;
+    int capacity;
+    int slack;
+    int i;
+    int j;
+    int doses;
+    int previous;
+    int* deltas;
+    
+    assert(list != NULL);
+    assert(firstDay <= lastDay);
+    
+    growLeft = firstDay < list->base;
+    growRight = lastDay >= list->base + list->capacity;
+    
+    if (list->capacity > 0 && !growLeft && !growRight) {
+        return;
+    }
+    
+    // Current days must be kept
+    if (list->count > 0) {
+        if (list->firstDay < firstDay) {
+            firstDay = list->firstDay;
+        }
+        if (list->firstDay + list->count - 1 > lastDay) {
+            lastDay = list->firstDay + list->count - 1;
+        }
+    }
+    
+    // Allocate twice the days, so expanding day by day is amortized constant time
+    capacity = 2 * (lastDay - firstDay + 1);
+    if (capacity < STOCK_MIN_DAYS) {
+        capacity = STOCK_MIN_DAYS;
+    }
+    slack = capacity - (lastDay - firstDay + 1);
+    
+    // Most of the free days go to the growing side, but some are kept on the other one for alternating growth
+    if (list->capacity == 0 || (growLeft && growRight)) {
+        base = firstDay - slack / 2;
+    } else if (growLeft) {
+        base = firstDay - (slack - slack / 4);
+    } else {
+        base = firstDay - slack / 4;
+    }
+    
+    // Rebuild the tree of each vaccine on the new range of days. Days out of the stock have no changes
+    for (i = 0; i < list->numColumns; i++) {
+        deltas = (int*) calloc(capacity, sizeof(int));
+        assert(deltas != NULL);
+        previous = 0;
+        for (j = 0; j < list->count; j++) {
+            doses = stockList_columnDoses(list, i, list->firstDay + j);
+            deltas[list->firstDay + j - base] = doses - previous;
+            previous = doses;
+        }
+        stock_treeBuild(deltas, capacity);
+        free(list->columns[i].deltas);
+        list->columns[i].deltas = deltas;
+    }
+    
+    list->base = base;
+    list->capacity = capacity;
+}
+
+// Find the column of a vaccine with a given name, or the position where it should be inserted
+static int stockList_findName(tVaccineStockData* list, const char* name) {
+    int first;
+    int last;
+    int middle;
+    int cmp;
+    
+    assert(list != NULL);
+    assert(name != NULL);
+    
+    // Columns are sorted by name
+    first = 0;
+    last = list->numColumns;
+    while (first < last) {
+        middle = first + (last - first) / 2;
+        cmp = strcmp(list->columns[middle].vaccine->name, name);
+        if (cmp < 0) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+    
+    return first;
+}
+
+// Find the column of a vaccine. Vaccines with the same name share their column. Returns -1 if the vaccine has no column
+static int stockList_findColumn(tVaccineStockData* list, tVaccine* vaccine) {
+    int pos;
+    
+    assert(list != NULL);
+    assert(vaccine != NULL);
+    
+    pos = stockList_findName(list, vaccine->name);
+    if (pos < list->numColumns && strcmp(list->columns[pos].vaccine->name, vaccine->name) == 0) {
+        return pos;
+    }
+    
+    return -1;
+}
+
+// Get the column of a vaccine, adding it if it does not exist
+static int stockList_getColumn(tVaccineStockData* list, tVaccine* vaccine) {
+    int pos;
+    
+    assert(list != NULL);
+    assert(vaccine != NULL);
+    
+    pos = stockList_findColumn(list, vaccine);
+    if (pos < 0) {
+        list->columns = (tVaccineStockColumn*) array_grow(list->columns, &(list->columnCapacity), list->numColumns + 1, sizeof(tVaccineStockColumn));
+        
+        // Keep the columns sorted by vaccine name
+        pos = stockList_findName(list, vaccine->name);
+        memmove(&(list->columns[pos + 1]), &(list->columns[pos]), (list->numColumns - pos) * sizeof(tVaccineStockColumn));
+        list->numColumns++;
+        
+        list->columns[pos].vaccine = vaccine;
+        list->columns[pos].deltas = (int*) calloc(list->capacity, sizeof(int));
+        assert(list->capacity == 0 || list->columns[pos].deltas != NULL);
+    }
+    
+    return pos;
+}
+
+// Check if any vaccine has doses on a given day number
+static bool stockList_hasDoses(tVaccineStockData* list, int day) {
+    int i;
+    
+    assert(list != NULL);
+    
+    for (i = 0; i < list->numColumns; i++) {
+        if (stockList_columnDoses(list, i, day) != 0) {
+            return true;
+        }
+    }
+    
+    return false;
+}
 
 // Initialize a stock list
 void stockList_init(tVaccineStockData* list) {
     // PR2 Ex 1a
     assert(list != NULL);
     
+    list->columns = NULL;
+    list->numColumns = 0;
+    list->columnCapacity = 0;
+    list->base = 0;
+    list->capacity = 0;
+    list->firstDay = 0;
     list->count = 0;
-    list->first = NULL;
-    list->last = NULL;
     /////////////////
 }
 
 // Modify the doses of a certain vaccine
 void stockList_update(tVaccineStockData* list, tDate date, tVaccine* vaccine, int doses) {
     // PR2 Ex 1b
-    tDate today;
-    tDate startDate;
-    bool updateRange=false;
-    tVaccineDailyStock* pNode;
+    int day;
+    int column;
     
     assert(list != NULL);
     
+    day = date_toDays(date);
+    
     // If the list is empty, just add a new element
     if (list->count == 0) {
-        // Create the new element
-        list->first = (tVaccineDailyStock*) malloc(sizeof(tVaccineDailyStock));
-        assert(list->first != NULL);
-        list->last = list->first;
-        list->count = 1;        
-        // Initialize the new element
-        dailyStock_init(list->first, date);
-        // Update the number of doses
-        dailyStock_update(list->first, vaccine, doses);
-    } else {
-        // Search for the starting date
-        if (date_cmp(list->first->day, date) > 0) {
-            // Date is before other dates. Add missing elements at left
-            stockList_expandLeft(list, date);
-            // Set start position for update the first element
-            pNode = list->first;            
-        } else if (date_cmp(list->last->day, date) >= 0) {
-            // Date is in the range of dates we already have. We will start updating on provided date.
-            pNode = stockList_find(list, date);
-            assert (pNode != NULL);
-        } else {
-            // Date is after the end date. We will extend current stock up to the date and then update recursivelly
-            stockList_expandRight(list, date);
-            // Set start position for update the last element
-            pNode = list->last;
-        }
-        // Update all days from start position        
-        while(pNode != NULL) {
-            dailyStock_update(pNode, vaccine, doses);
-            pNode = pNode->next;
-        }
+        stockList_reserve(list, day, day);
+        list->firstDay = day;
+        list->count = 1;
+    } else if (day < list->firstDay) {
+        // Date is before other dates. Add missing elements at left
+        stockList_expandLeft(list, date);
+    } else if (day >= list->firstDay + list->count) {
+        // Date is after the end date. Extend current stock up to the date
+        stockList_expandRight(list, date);
     }
     
+    // A change on a day applies to all the following days
+    column = stockList_getColumn(list, vaccine);
+    stock_treeAdd(list->columns[column].deltas, list->capacity, day - list->base, doses);
+    
     // Once updated, remove empty elements
     stockList_purge(list);
     
@@ -69,17 +255,26 @@ void stockList_update(tVaccineStockData* list, tDate date, tVaccine* vaccine, in
 // Get the number of doses for a certain vaccine and date
 int stockList_getDoses(tVaccineStockData* list, tDate date, tVaccine* vaccine) {
     // PR2 Ex 1c
-    tVaccineDailyStock *pNode = NULL;
+    int day;
+    int column;
     int numDoses = 0;
-    assert(list != NULL);
     
-    pNode = stockList_find(list, date);
+    assert(list != NULL);
+    assert(vaccine != NULL);
     
-    if (pNode != NULL) {
-        numDoses = stockNode_getDoses(pNode->first, vaccine);
-    } else if(date_cmp(list->last->day, date) < 0) {
-        numDoses = stockNode_getDoses(list->last->first, vaccine);
-    }    
+    if (list->count > 0) {
+        day = date_toDays(date);
+        
+        // After the end of the stock, the doses of the last day remain
+        if (day >= list->firstDay + list->count) {
+            day = list->firstDay + list->count - 1;
+        }
+        
+        column = stockList_findColumn(list, vaccine);
+        if (day >= list->firstDay && column >= 0) {
+            numDoses = stockList_columnDoses(list, column, day);
+        }
+    }
     
     return numDoses;
     /////////////////
@@ -89,22 +284,18 @@ int stockList_getDoses(tVaccineStockData* list, tDate date, tVaccine* vaccine) {
 // Release a list of stocks
 void stockList_free(tVaccineStockData* list) {
     // PR2 Ex 2b
-    tVaccineDailyStock* pNode;
+    int i;
     
     assert(list != NULL);
     
-    pNode = list->first;
-    
-    while (pNode != NULL) {
-        list->first = pNode->next;
-        dailyStock_free(pNode);
-        free(pNode);
-        list->count--;
-        
-        pNode = list->first;
+    for (i = 0; i < list->numColumns; i++) {
+        free(list->columns[i].deltas);
+    }
+    if (list->columns != NULL) {
+        free(list->columns);
     }
-    list->first = NULL;
-    list->last = NULL;
+    
+    stockList_init(list);
     /////////////////
 }
 
@@ -119,309 +310,242 @@ void stock_init(tVaccineStock* stock, tVaccine* vaccine, int doses) {
     stock->vaccine = vaccine;
 }
 
-// Get the number of doses for a given vaccine
-int stockNode_getDoses(tVaccineStockNode* stock, tVaccine* vaccine) {
-    int numDoses = 0;
+// Find the position of the stock for a given date. Returns -1 if the date is not in the stock
+int stockList_find(tVaccineStockData* list, tDate date) {
+    int pos;
     
-    // Recursive trival cases: Empty list or current vaccine name is after target vaccine name (data is sorted by vaccine name)
-    if (stock == NULL || strcmp(stock->elem.vaccine->name, vaccine->name) > 0) {
-        numDoses = 0;
-    } else if (strcmp(stock->elem.vaccine->name, vaccine->name) == 0) {
-        // Recursion trivial case: We are on the vaccine node
-        numDoses = stock->elem.doses;
-    } else {
-        // Recursive call
-        numDoses = stockNode_getDoses(stock->next, vaccine);
+    assert(list != NULL);
+    
+    pos = date_toDays(date) - list->firstDay;
+    if (pos < 0 || pos >= list->count) {
+        pos = -1;
     }
     
-    return numDoses;
+    return pos;
 }
 
-// Initialize a stock node element
-void stockNode_init(tVaccineStockNode* node, tVaccine* vaccine, int doses) {
-    assert(node != NULL);
-    stock_init(&(node->elem), vaccine, doses);
-    node->next = NULL;
-}
-
-// Initialize a daily stock element
-void dailyStock_init(tVaccineDailyStock* stock, tDate date) {
-    assert(stock != NULL);
-    stock->count = 0;
-    stock->first = NULL;
-    stock->next = NULL;
-    stock->day = date;
-}
-
-// Remove a daily stock element data
-void dailyStock_free(tVaccineDailyStock* stock) {
-    tVaccineStockNode* pNode;    
-    
-    assert(stock != NULL);
+// Get the date of the stock at a given position
+tDate stockList_getDate(const tVaccineStockData* list, int pos) {
+    tDate date;
     
-    pNode = stock->first;
+    assert(list != NULL);
+    assert(pos >= 0 && pos < list->count);
     
-    while (pNode != NULL) {
-        stock->first = pNode->next;
-        free(pNode);
-        pNode = stock->first;
-    }
+    date_fromDays(&date, list->firstDay + pos);
     
-    stock->count = 0;
-    stock->first = NULL;
+    return date;
 }
 
-// Find a vaccine node for a given daily stock
-tVaccineStockNode* dailyStock_find(tVaccineDailyStock* stock, tVaccine* vaccine) {
-    tVaccineStockNode *pNode;
+// Get the number of vaccines with doses on the stock at a given position
+int stockList_dayCount(tVaccineStockData* list, int pos) {
+    int i;
+    int count = 0;
     
-    assert(stock != NULL);  
-    
-    pNode = stock->first;
+    assert(list != NULL);
+    assert(pos >= 0 && pos < list->count);
     
-    while (pNode != NULL && pNode->elem.vaccine != vaccine) {
-        pNode = pNode->next;
+    for (i = 0; i < list->numColumns; i++) {
+        if (stockList_columnDoses(list, i, list->firstDay + pos) != 0) {
+            count++;
+        }
     }
     
-    return pNode;
+    return count;
 }
 
-// Remove all vaccine entries with no doses
-void dailyStock_purge(tVaccineDailyStock* stock) {
-    tVaccineStockNode *pNode;
-    tVaccineStockNode *pAux;
-    bool is_first = true;
-    
-    assert(stock != NULL);
+// Get the n-th vaccine with doses on the stock at a given position, sorted by vaccine name
+tVaccineStock stockList_dayStock(tVaccineStockData* list, int pos, int n) {
+    tVaccineStock stock;
+    int doses;
+    int i;
     
-    pNode = stock->first;
-    pAux = NULL;
-    
-    while (pNode != NULL) {
-        if (pNode->elem.doses == 0) {
-            if (pAux != NULL) {
-                pAux->next = pNode->next;
-                free(pNode); 
-                pNode = pAux->next;
-            } else {
-                stock->first = pNode->next;
-                free(pNode);
-                pNode = stock->first;
-                pAux = NULL;                
+    assert(list != NULL);
+    assert(pos >= 0 && pos < list->count);
+    assert(n >= 0);
+    
+    stock_init(&stock, NULL, 0);
+    for (i = 0; i < list->numColumns && stock.vaccine == NULL; i++) {
+        doses = stockList_columnDoses(list, i, list->firstDay + pos);
+        if (doses != 0) {
+            if (n == 0) {
+                stock_init(&stock, list->columns[i].vaccine, doses);
             }
-            stock->count--;                        
-        } else {
-            pAux = pNode;
-            pNode = pNode->next;                    
+            n--;
         }
     }
-}
-
-// Update the number of doses for a given vaccine
-void dailyStock_update(tVaccineDailyStock* stock, tVaccine* vaccine, int doses) {
-    tVaccineStockNode* pNode;
-    tVaccineStockNode* pAux;
-    
-    assert(stock != NULL);
     
-    // Search for a node for given vaccine
-    pNode = dailyStock_find(stock, vaccine);
-    
-    if (pNode != NULL) {
-        // Just modify the number of doses
-        pNode->elem.doses += doses;        
-    } else if (stock->count == 0) {
-        // If the node is empty, just add a new element
-        stock->first = (tVaccineStockNode*) malloc(sizeof(tVaccineStockNode));
-        assert(stock->first != NULL);
-        stock_init(&(stock->first->elem), vaccine, doses);
-        stock->first->next = NULL;
-        stock->count++;
-    } else if (strcmp(stock->first->elem.vaccine->name, vaccine->name) > 0) {
-        // Insert as first element
-        pNode = stock->first;
-        stock->first = (tVaccineStockNode*) malloc(sizeof(tVaccineStockNode));
-        assert(stock->first != NULL);
-        stock_init(&(stock->first->elem), vaccine, doses);
-        stock->first->next = pNode;
-        stock->count++;
-    } else {
-        // Search for insertion point
-        pNode = stock->first;
-        while(pNode->next != NULL && strcmp(pNode->next->elem.vaccine->name, vaccine->name) < 0) {
-            pNode = pNode->next;
-        }
-        pAux = pNode->next;
-        pNode->next = (tVaccineStockNode*) malloc(sizeof(tVaccineStockNode));
-        assert(pNode->next != NULL);
-        stock_init(&(pNode->next->elem), vaccine, doses);
-        pNode->next->next = pAux;
-        stock->count++;
-    }
-}
-
-// Copy the contents from source to destination
-void dailyStock_copy(tVaccineDailyStock* src, tVaccineDailyStock* dst) {
-    tVaccineStockNode *pNode;
-    
-    // Ensure destination is initialized
-    dailyStock_init(dst, dst->day);
-    
-    // Add vaccines from soruce to destination
-    pNode = src->first;
-    while(pNode != NULL) {
-        dailyStock_update(dst, pNode->elem.vaccine, pNode->elem.doses);
-        pNode = pNode->next;
-    }
+    return stock;
 }
 
-// Find the stock for a given date
-tVaccineDailyStock* stockList_find(tVaccineStockData* list, tDate date) {
-    tVaccineDailyStock *pNode;
-    tVaccineDailyStock *pDate;
+// Update the number of doses for a given vaccine on the stock at a given position
+void stockList_addDoses(tVaccineStockData* list, int pos, tVaccine* vaccine, int doses) {
+    int column;
     
     assert(list != NULL);
+    assert(pos >= 0 && pos < list->count);
     
-    // Find the node
-    pDate = NULL;
-    if (list->count > 0 && date_cmp(list->first->day, date) <= 0 && date_cmp(list->last->day, date) >= 0) {
-        pNode = list->first;
-        while(pNode != NULL && pDate == NULL) {
-            if(date_cmp(pNode->day, date) == 0) {
-                // Point current node
-                pDate = pNode;
-            }
-            pNode = pNode->next;
-        }
-    }
+    column = stockList_getColumn(list, vaccine);
+    stock_treeAdd(list->columns[column].deltas, list->capacity, list->firstDay + pos - list->base, doses);
     
-    return pDate;    
+    // Undo the change on the next day. Days added after the last one copy its doses
+    if (pos < list->count - 1) {
+        stock_treeAdd(list->columns[column].deltas, list->capacity, list->firstDay + pos + 1 - list->base, -doses);
+    }
 }
 
 // Remove entries with no data on the start and end of the list
 void stockList_purge(tVaccineStockData* list) {
-    tVaccineDailyStock *pNode;
-    tVaccineDailyStock *pAux;
-    bool start;
+    int lastDay;
+    int doses;
+    int i;
     
     assert(list != NULL);
     
-    pNode = list->first;
-    pAux = NULL;
+    // Remove empty days at the start
+    while (list->count > 0 && !stockList_hasDoses(list, list->firstDay)) {
+        list->firstDay++;
+        list->count--;
+    }
     
-    start = true;
-    while (pNode != NULL) {
-        // Remove empty stocks
-        dailyStock_purge(pNode);
-        
-        // If node has no data...
-        if (pNode->count == 0) {            
-            if (start) {
-                // If we are on the first element, remove the element
-                list->first = pNode->next;
-                dailyStock_free(pNode);
-                free(pNode);
-                list->count--;
-                pNode = list->first;
-            } else {
-                // On other nodes just move to the next node
-                pNode = pNode->next;
-                start = false;
-            }
-            
-        } else {
-            // Store the last node with data
-            pAux = pNode;
-            pNode = pNode->next;
-            start = false;
-        }                
+    // Remove empty days at the end
+    lastDay = list->firstDay + list->count;
+    while (list->count > 0 && !stockList_hasDoses(list, list->firstDay + list->count - 1)) {
+        list->count--;
     }
     
-    // Remove empty nodes at the end
-    if (pAux != NULL) {
-        pNode = pAux->next;
-        while(pNode != NULL) {
-            pAux->next = pNode->next;
-            dailyStock_free(pNode);
-            free(pNode);
-            list->count--;
-            pNode = pAux->next;
+    // Days after the end have no changes, so they copy the doses of the last day when added again
+    if (list->count > 0 && lastDay > list->firstDay + list->count) {
+        for (i = 0; i < list->numColumns; i++) {
+            doses = stockList_columnDoses(list, i, list->firstDay + list->count) - stockList_columnDoses(list, i, list->firstDay + list->count - 1);
+            if (doses != 0) {
+                stock_treeAdd(list->columns[i].deltas, list->capacity, list->firstDay + list->count - list->base, -doses);
+            }
         }
-        list->last = pAux;
     }
 }
 
 
 // Extend the list adding empty day cells on left
 void stockList_expandLeft(tVaccineStockData* list, tDate date) {
-    tDate today;
-    tVaccineDailyStock* pAux;
-    
-    // Select the day previous to the first one
-    today = list->first->day;
-    date_addDay(&today, -1);
-    
-    // Iterate up to the top left date
-    while (date_cmp(today, date) >= 0) {
-        // Store current element
-        pAux = list->first;
-        // Add an element at first position
-        list->first = (tVaccineDailyStock*) malloc(sizeof(tVaccineDailyStock));
-        assert(list->first != NULL);        
-        list->count++;        
-        // Initialize the new element
-        dailyStock_init(list->first, today);        
-        // Set old first element as next element
-        list->first->next = pAux;
-        // Decrement the date
-        date_addDay(&today, -1);
+    int day;
+    
+    assert(list != NULL);
+    assert(list->count > 0);
+    
+    day = date_toDays(date);
+    if (day < list->firstDay) {
+        // New days have no changes, so they have no doses
+        stockList_reserve(list, day, list->firstDay);
+        list->count += list->firstDay - day;
+        list->firstDay = day;
     }
 }
 
 // Extend the list to the right with the data of the last position
 void stockList_expandRight(tVaccineStockData* list, tDate date) {
-    tDate today;
-        
-    // Select as today the day after the last day
-    today = list->last->day;
-    date_addDay(&today, 1);
-    // Iterate for all dates up to the top right date
-    while (date_cmp(today, date) <= 0) {        
-        // Add an element at first position
-        list->last->next = (tVaccineDailyStock*) malloc(sizeof(tVaccineDailyStock));
-        assert(list->last->next != NULL);        
-        list->count++;                
-        // Initialize the new element
-        dailyStock_init(list->last->next, today);        
-        // Copy the contents from old last element
-        dailyStock_copy(list->last, list->last->next);        
-        // Set the new last element
-        list->last = list->last->next;
-        // Increment the date
-        date_addDay(&today, 1);
+    int day;
+    int lastDay;
+    
+    assert(list != NULL);
+    assert(list->count > 0);
+    
+    day = date_toDays(date);
+    lastDay = list->firstDay + list->count - 1;
+    if (day > lastDay) {
+        // New days have no changes, so they keep the doses of the last day
+        stockList_reserve(list, lastDay, day);
+        list->count += day - lastDay;
     }
 }
 
 // Print stock list
-void stockList_print(tVaccineStockData list) {
-    tVaccineDailyStock* pDay;
-    tVaccineStockNode* pNode;
+void stockList_print(const tVaccineStockData* list) {
+    tDate date;
+    int pos;
+    int i;
+    int doses;
     bool first;
     
-    pDay = list.first;    
-    while(pDay != NULL) {        
-        printf("%02d/%02d/%04d => ", pDay->day.day, pDay->day.month, pDay->day.year);        
-        pNode = pDay->first; 
+    assert(list != NULL);
+    
+    for (pos = 0; pos < list->count; pos++) {
+        date = stockList_getDate(list, pos);
+        printf("%02d/%02d/%04d => ", date.day, date.month, date.year);        
         first = true;
-        while(pNode != NULL) {
-            if (!first) {
-                printf(" - ");
+        for (i = 0; i < list->numColumns; i++) {
+            doses = stockList_columnDoses(list, i, list->firstDay + pos);
+            if (doses != 0) {
+                if (!first) {
+                    printf(" - ");
+                }
+                printf("%s [%d]", list->columns[i].vaccine->name, doses);
+                first = false;
             }
-            printf("%s [%d]", pNode->elem.vaccine->name, pNode->elem.doses);
-            first = false;
-            pNode = pNode->next;
         }
         printf("\n");
-        pDay = pDay->next;
     }
 }
+
+// Write a stock on a snapshot. The vaccines are written by id
+void stockList_save(const tVaccineStockData* list, tSnapshotWriter* writer) {
+    int i;
+    
+    assert(list != NULL);
+    assert(writer != NULL);
+    
+    snapshot_writeInt(writer, list->numColumns);
+    snapshot_writeInt(writer, list->base);
+    snapshot_writeInt(writer, list->capacity);
+    snapshot_writeInt(writer, list->firstDay);
+    snapshot_writeInt(writer, list->count);
+    
+    // The trees are written as they are, so they are not rebuilt when loaded
+    for (i = 0; i < list->numColumns; i++) {
+        snapshot_writeInt(writer, list->columns[i].vaccine->id);
+        snapshot_write(writer, list->columns[i].deltas, list->capacity * sizeof(int));
+    }
+}
+
+// Read an empty stock from a snapshot, with the vaccines of the given list. Returns false if the snapshot is not valid
+bool stockList_load(tVaccineStockData* list, tSnapshotReader* reader, const tVaccineList* vaccines) {
+    const int* deltas;
+    tVaccine* vaccine;
+    int numColumns;
+    int i;
+    
+    assert(list != NULL);
+    assert(reader != NULL);
+    assert(vaccines != NULL);
+    assert(list->numColumns == 0);
+    
+    numColumns = snapshot_readInt(reader);
+    list->base = snapshot_readInt(reader);
+    list->capacity = snapshot_readInt(reader);
+    list->firstDay = snapshot_readInt(reader);
+    list->count = snapshot_readInt(reader);
+    
+    // The days of the stock are inside the allocated days
+    if (reader->failed || numColumns < 0 || numColumns > vaccines->numIds || list->capacity < 0 || list->count < 0 || list->count > list->capacity 
+        || (list->count > 0 && (list->firstDay < list->base || list->firstDay - list->base > list->capacity - list->count))) {
+        reader->failed = true;
+        stockList_init(list);
+        return false;
+    }
+    
+    list->columns = (tVaccineStockColumn*) array_reserve(list->columns, &(list->columnCapacity), numColumns, sizeof(tVaccineStockColumn));
+    for (i = 0; i < numColumns; i++) {
+        vaccine = vaccineList_getById(vaccines, snapshot_readInt(reader));
+        deltas = (const int*) snapshot_readArray(reader, list->capacity, sizeof(int));
+        if (vaccine == NULL || deltas == NULL) {
+            reader->failed = true;
+            return false;
+        }
+        list->columns[i].vaccine = vaccine;
+        list->columns[i].deltas = (int*) calloc(list->capacity, sizeof(int));
+        assert(list->capacity == 0 || list->columns[i].deltas != NULL);
+        memcpy(list->columns[i].deltas, deltas, list->capacity * sizeof(int));
+        list->numColumns++;
+    }
+    
+    return true;
+}
@@ -3,6 +3,13 @@
 #include <string.h>
 #include <stdio.h>
 #include "vaccine.h"
+#include "array.h"
+#include "hash.h"
+
+// Check if two vaccine names are equal. Canonical names are compared by pointer
+static bool vaccine_nameEquals(const char* name, const char* other) {
+    return name == other || strcmp(name, other) == 0;
+}
 
 // Initialize vaccine structure
 void vaccine_init(tVaccine* vaccine, const char* name, int required, int days) {
@@ -17,6 +24,7 @@ void vaccine_init(tVaccine* vaccine, const char* name, int required, int days) {
     strcpy(vaccine->name, name);
     vaccine->required = required;
     vaccine->days = days;
+    vaccine->id = -1;
 }
 
 // Release vaccine data
@@ -109,161 +117,492 @@ void vaccineLot_parse(tVaccine* vaccine, tVaccineLot* lot, tCSVEntry entry) {
 }
 
 
+// Parse input from a CSV view without allocating memory. The cp and vaccine name are copied to the provided buffers with provided maximum length
+void vaccineLot_parseView(tVaccine* vaccine, tVaccineLot* lot, const tCSVView* view, char* cp, char* name, int length) {
+    char date[11];
+    char time[6];
+    
+    // Check input data
+    assert(vaccine != NULL);
+    assert(lot != NULL);
+    assert(view != NULL);
+    assert(view->numFields == 7);
+    
+    // Get Lot data. The lot points to the cp buffer instead of owning a copy
+    csv_fieldAsString(view->fields[0], date, 11);
+    csv_fieldAsString(view->fields[1], time, 6);
+    dateTime_parse(&(lot->timestamp), date, time);
+    csv_fieldAsString(view->fields[2], cp, length);
+    lot->cp = cp;
+    lot->vaccine = NULL;
+    lot->doses = csv_fieldAsInteger(view->fields[6]);
+    
+    // Get vaccine data. The vaccine points to the name buffer instead of owning a copy
+    csv_fieldAsString(view->fields[3], name, length);
+    vaccine->name = name;
+    vaccine->required = csv_fieldAsInteger(view->fields[4]);
+    vaccine->days = csv_fieldAsInteger(view->fields[5]);
+    vaccine->id = -1;
+}
+
 // Initialize the vaccine's list
 void vaccineList_init(tVaccineList* list) {
     assert(list != NULL);
     
-    list->first = NULL;
+    list->blocks = NULL;
+    list->numBlocks = 0;
+    list->blocksCapacity = 0;
+    list->numIds = 0;
+    list->sorted = NULL;
+    list->capacity = 0;
     list->count = 0;
+    list->index = NULL;
+    list->indexSize = 0;
+    list->arena = NULL;
+    list->strings = NULL;
 }
 
 // Remove all elements
 void vaccineList_free(tVaccineList* list) {
-    tVaccineNode *pNode = NULL;
-    tVaccineNode *pAux = NULL;
+    tVaccine *pVaccine;
+    tArena* arena;
+    tInternTable* strings;
+    int i;
     
     assert(list != NULL);
     
-    pNode = list->first;
-    while(pNode != NULL) {
-        // Store the position of the current node
-        pAux = pNode;
-        
-        // Move to the next node in the list
-        pNode = pNode->next;
-        
-        // Remove previous node
-        vaccine_free(&(pAux->vaccine));
-        free(pAux);
+    arena = list->arena;
+    strings = list->strings;
+    
+    // Names on an arena or a table of strings are released with them
+    if (arena == NULL && strings == NULL) {
+        for (i = 0; i < list->numIds; i++) {
+            pVaccine = &(list->blocks[i / VACCINE_BLOCK_SIZE][i % VACCINE_BLOCK_SIZE]);
+            vaccine_free(pVaccine);
+        }
+    }
+    for (i = 0; i < list->numBlocks; i++) {
+        free(list->blocks[i]);
+    }
+    if (list->blocks != NULL) {
+        free(list->blocks);
+    }
+    if (list->sorted != NULL) {
+        free(list->sorted);
+    }
+    if (list->index != NULL) {
+        free(list->index);
     }
     
-    // Initialize to an empty list
+    // Initialize to an empty list, keeping the shared storage
     vaccineList_init(list);
+    list->arena = arena;
+    list->strings = strings;
 }
 
 // Get the number of vaccines
-int vaccineList_len(tVaccineList list) {
-    return list.count;
+int vaccineList_len(const tVaccineList* list) {
+    assert(list != NULL);
+    
+    return list->count;
 }
 
-// Find a vaccine in the list of vaccines
-tVaccine* vaccineList_find(tVaccineList list, const char* name) {
-    tVaccineNode *pNode = NULL;
-    tVaccineNode *pVaccine = NULL;
-        
-    // Point the first element
-    pNode = list.first;
+// Get the vaccine with a given id. NULL if it does not exist or it was removed
+tVaccine* vaccineList_getById(const tVaccineList* list, int id) {
+    tVaccine *pVaccine;
+    
+    assert(list != NULL);
+    
+    if (id < 0 || id >= list->numIds) {
+        return NULL;
+    }
+    pVaccine = &(list->blocks[id / VACCINE_BLOCK_SIZE][id % VACCINE_BLOCK_SIZE]);
+    
+    // Removed vaccines have no name
+    if (pVaccine->name == NULL) {
+        return NULL;
+    }
+    return pVaccine;
+}
+
+// Get the vaccine at a given position, sorted by name
+tVaccine* vaccineList_get(const tVaccineList* list, int index) {
+    assert(list != NULL);
+    assert(index >= 0 && index < list->count);
+    
+    return vaccineList_getById(list, list->sorted[index]);
+}
+
+// Check if the vaccine with a given id has the name given by key
+static bool vaccineList_equalsKey(const void* data, int id, const void* key) {
+    return vaccine_nameEquals(vaccineList_getById((const tVaccineList*) data, id)->name, (const char*) key);
+}
+
+// Get the hash of the name of the vaccine with a given id, as stored on the index
+static unsigned int vaccineList_hashVaccine(const void* data, int id) {
+    return hash_str(vaccineList_getById((const tVaccineList*) data, id)->name);
+}
+
+// Find the slot of the hash index for a given name. It is the slot of the vaccine or the empty slot where it would be added
+static int vaccineList_slot(const tVaccineList* list, const char* name) {
+    assert(list->index != NULL);
+    
+    return hash_probe(list->index, list->indexSize, hash_str(name), vaccineList_equalsKey, list, name);
+}
+
+// Rebuild the hash index with a size able to store count vaccines
+static void vaccineList_rebuild(tVaccineList* list, int count) {
+    list->index = hash_rebuild(list->index, &(list->indexSize), count, list->sorted, list->count, vaccineList_hashVaccine, list);
+}
+
+// Find the position of the first vaccine with a name not lower than the given one on the sorted ids
+static int vaccineList_position(const tVaccineList* list, const char* name) {
+    int first;
+    int last;
+    int middle;
+    
+    first = 0;
+    last = list->count;
+    while (first < last) {
+        middle = first + (last - first) / 2;
+        if (strcmp(vaccineList_getById(list, list->sorted[middle])->name, name) < 0) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+    
+    return first;
+}
+
+// Find the id of a vaccine in the list of vaccines. -1 if it does not exist
+int vaccineList_findId(const tVaccineList* list, const char* name) {
+    assert(list != NULL);
+    assert(name != NULL);
     
-    while(pNode != NULL && pVaccine == NULL) {
-        // Compare current node with given name
-        if (strcmp(pNode->vaccine.name, name) == 0) {
-            pVaccine = pNode;
+    // Names of the list are canonical, so only the canonical copy can match
+    if (list->strings != NULL) {
+        name = internTable_find(list->strings, name);
+        if (name == NULL) {
+            return -1;
         }
-        pNode = pNode->next;
     }
     
-    return &(pVaccine->vaccine);
+    if (list->count == 0) {
+        return -1;
+    }
+    
+    return list->index[vaccineList_slot(list, name)];
+}
+
+// Find a vaccine in the list of vaccines
+tVaccine* vaccineList_find(const tVaccineList* list, const char* name) {
+    return vaccineList_getById(list, vaccineList_findId(list, name));
+}
+
+// Copy a vaccine to the list, using the canonical name or the list arena if it has them
+static void vaccineList_cpy(tVaccineList* list, tVaccine* destination, tVaccine vaccine) {
+    if (list->strings != NULL) {
+        destination->name = (char*) internTable_add(list->strings, vaccine.name);
+        destination->required = vaccine.required;
+        destination->days = vaccine.days;
+    } else if (list->arena != NULL) {
+        destination->name = arena_strdup(list->arena, vaccine.name);
+        destination->required = vaccine.required;
+        destination->days = vaccine.days;
+    } else {
+        vaccine_cpy(destination, vaccine);
+    }
 }
 
 // Add a new vaccine
 void vaccineList_insert(tVaccineList* list, tVaccine vaccine) {
-    tVaccineNode *pNode = NULL;
-    tVaccineNode *pPrev = NULL;
+    tVaccine *pVaccine;
+    int pos;
+    int id;
     
     assert(list != NULL);
+    assert(vaccine.name != NULL);
     
-    // If the list is empty add the node as first position
-    if (list->count == 0) {
-        list->first = (tVaccineNode*) malloc(sizeof(tVaccineNode));
-        list->first->next = NULL;
-        vaccine_cpy(&(list->first->vaccine), vaccine);
-    } else {    
-        // Point the first element
-        pNode = list->first;
-        pPrev = pNode;
-                
-        // Advance in the list up to the insertion point or the end of the list
-        while(pNode != NULL && strcmp(pNode->vaccine.name, vaccine.name) < 0) {            
-            pPrev = pNode;
-            pNode = pNode->next;
-        }
-                
-        if (pNode == pPrev) {
-            // Insert as first element
-            list->first = (tVaccineNode*) malloc(sizeof(tVaccineNode));
-            list->first->next = pNode;
-            vaccine_cpy(&(list->first->vaccine), vaccine);            
-        } else {
-            // Insert after pPrev
-            pPrev->next = (tVaccineNode*) malloc(sizeof(tVaccineNode));        
-            vaccine_cpy(&(pPrev->next->vaccine), vaccine);
-            pPrev->next->next = pNode;            
-        }
+    // Vaccines are only added once
+    if (vaccineList_findId(list, vaccine.name) >= 0) {
+        return;
+    }
+    
+    // Add a new block when the last one is full
+    id = list->numIds;
+    if (id == list->numBlocks * VACCINE_BLOCK_SIZE) {
+        list->blocks = (tVaccine**) array_grow(list->blocks, &(list->blocksCapacity), list->numBlocks + 1, sizeof(tVaccine*));
+        list->blocks[list->numBlocks] = (tVaccine*) malloc(VACCINE_BLOCK_SIZE * sizeof(tVaccine));
+        assert(list->blocks[list->numBlocks] != NULL);
+        list->numBlocks++;
+    }
+    pVaccine = &(list->blocks[id / VACCINE_BLOCK_SIZE][id % VACCINE_BLOCK_SIZE]);
+    vaccineList_cpy(list, pVaccine, vaccine);
+    pVaccine->id = id;
+    list->numIds++;
+    
+    // Keep the ids sorted by name
+    pos = vaccineList_position(list, pVaccine->name);
+    list->sorted = (int*) array_grow(list->sorted, &(list->capacity), list->count + 1, sizeof(int));
+    memmove(&(list->sorted[pos + 1]), &(list->sorted[pos]), (list->count - pos) * sizeof(int));
+    list->sorted[pos] = id;
+    list->count++;
+    
+    // Grow the hash index when the load factor reaches 0.5
+    if (2 * list->count > list->indexSize) {
+        vaccineList_rebuild(list, list->count);
     }
-    list->count ++;
+    list->index[vaccineList_slot(list, pVaccine->name)] = id;
 }
 
 // Remove a vaccine
 void vaccineList_del(tVaccineList* list, const char* vaccine) {
-    tVaccineNode *pNode = NULL;
-    tVaccineNode *pPrev = NULL;
+    tVaccine *pVaccine;
+    int pos;
     
     assert(list != NULL);
+    assert(vaccine != NULL);
     
-    // Check if the list has elements
-    if (list->count > 0) {
-        pNode = list->first;
+    pVaccine = vaccineList_getById(list, vaccineList_findId(list, vaccine));
+    if (pVaccine != NULL) {
+        // Remove the id from the sorted ids
+        pos = vaccineList_position(list, pVaccine->name);
+        memmove(&(list->sorted[pos]), &(list->sorted[pos + 1]), (list->count - pos - 1) * sizeof(int));
+        list->count--;
+        
+        // The next vaccines of its cluster are moved back on the hash index, so they are still found
+        hash_removeSlot(list->index, list->indexSize, vaccineList_slot(list, pVaccine->name), vaccineList_hashVaccine, list);
         
-        // Check if we are removing the first position
-        if (strcmp(pNode->vaccine.name, vaccine) == 0) {
-            list->first = pNode->next;
-        } else {    
-            // Search in the list
-            pPrev = pNode;
-            while (pNode != NULL) {                
-                if (strcmp(pNode->vaccine.name, vaccine) == 0) {
-                    // Link previous and next nodes
-                    pPrev->next = pNode->next;
-                    // Remove node
-                    vaccine_free(&(pNode->vaccine));
-                    free(pNode);
-                    list->count --;                    
-                    pNode = NULL;
-                } else {
-                    pPrev = pNode;
-                    pNode = pNode->next;
-                }                
-            }            
-        }            
+        // The id is kept as a removed vaccine. Names on an arena or a table of strings are released with them
+        if (list->arena == NULL && list->strings == NULL) {
+            vaccine_free(pVaccine);
+        }
+        pVaccine->name = NULL;
+        pVaccine->id = -1;
     }
 }
 
 
+// Check if the cp of a lot is equal to a given one. Canonical cp are compared by pointer
+static bool vaccineLot_cpEquals(const tInternTable* strings, const char* cp, const char* other) {
+    if (strings != NULL) {
+        return cp == other;
+    }
+    return strcmp(cp, other) == 0;
+}
+
 // Initialize the vaccine lots data
 void vaccineLotData_init(tVaccineLotData* data) {
     assert(data != NULL);
     
     // Set the initial number of elements to zero.
     data->count = 0;    
+    data->capacity = 0;
     data->elems = NULL;
+    data->index = NULL;
+    data->indexSize = 0;
+    data->centers = NULL;
+    data->numCenters = 0;
+    data->centersCapacity = 0;
+    data->arena = NULL;
+    data->strings = NULL;
+}
+
+// Check if the lots own their cp
+static bool vaccineLotData_ownsCp(tVaccineLotData* data) {
+    return data->arena == NULL && data->strings == NULL;
+}
+
+// Get the cp of the lots of a center
+static const char* vaccineLotData_centerCp(const tVaccineLotData* data, const tVaccineLotCenter* center) {
+    return data->elems[center->lots[0]].cp;
+}
+
+// Find the position of the first center with a cp not lower than the given one
+static int vaccineLotData_centerPosition(const tVaccineLotData* data, const char* cp) {
+    int first;
+    int last;
+    int middle;
+    
+    first = 0;
+    last = data->numCenters;
+    while (first < last) {
+        middle = first + (last - first) / 2;
+        if (strcmp(vaccineLotData_centerCp(data, &(data->centers[middle])), cp) < 0) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+    
+    return first;
+}
+
+// Find the position of the first lot of a center with a timestamp not lower than the given one, or greater than it if after is true
+static int vaccineLotData_lotPosition(const tVaccineLotData* data, const tVaccineLotCenter* center, tDateTime timestamp, bool after) {
+    int first;
+    int last;
+    int middle;
+    int cmp;
+    
+    first = 0;
+    last = center->count;
+    while (first < last) {
+        middle = first + (last - first) / 2;
+        cmp = dateTime_cmp(data->elems[center->lots[middle]].timestamp, timestamp);
+        if (cmp < 0 || (after && cmp == 0)) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+    
+    return first;
+}
+
+// Add the lot at a given position to the lots of its center
+static void vaccineLotData_addToCenter(tVaccineLotData* data, int idx) {
+    tVaccineLotCenter* center;
+    tVaccineLot* lot;
+    int pos;
+    
+    lot = &(data->elems[idx]);
+    pos = vaccineLotData_centerPosition(data, lot->cp);
+    if (pos == data->numCenters || strcmp(vaccineLotData_centerCp(data, &(data->centers[pos])), lot->cp) != 0) {
+        // First lot of the center
+        data->centers = (tVaccineLotCenter*) array_grow(data->centers, &(data->centersCapacity), data->numCenters + 1, sizeof(tVaccineLotCenter));
+        memmove(&(data->centers[pos + 1]), &(data->centers[pos]), (data->numCenters - pos) * sizeof(tVaccineLotCenter));
+        data->centers[pos].lots = NULL;
+        data->centers[pos].count = 0;
+        data->centers[pos].capacity = 0;
+        data->numCenters++;
+    }
+    center = &(data->centers[pos]);
+    
+    // Lots with the same timestamp are kept in insertion order
+    pos = vaccineLotData_lotPosition(data, center, lot->timestamp, true);
+    center->lots = (int*) array_grow(center->lots, &(center->capacity), center->count + 1, sizeof(int));
+    memmove(&(center->lots[pos + 1]), &(center->lots[pos]), (center->count - pos) * sizeof(int));
+    center->lots[pos] = idx;
+    center->count++;
+}
+
+// Release the lots of the centers
+static void vaccineLotData_freeCenters(tVaccineLotData* data) {
+    int i;
+    
+    for (i = 0; i < data->numCenters; i++) {
+        free(data->centers[i].lots);
+    }
+    if (data->centers != NULL) {
+        free(data->centers);
+    }
+    data->centers = NULL;
+    data->numCenters = 0;
+    data->centersCapacity = 0;
 }
 
 // Remove all elements
 void vaccineLotData_free(tVaccineLotData* data) {
     int i;
+    tArena* arena;
+    tInternTable* strings;
+    
+    arena = data->arena;
+    strings = data->strings;
     if (data->elems != NULL) {
-        for(i=0; i < data->count; i++) {
-            vaccineLot_free(&(data->elems[i]));
+        // The cp on an arena or a table of strings are released with them
+        if (vaccineLotData_ownsCp(data)) {
+            for(i=0; i < data->count; i++) {
+                vaccineLot_free(&(data->elems[i]));
+            }
         }
         free(data->elems);
     }
-    vaccineLotData_init(data);    
+    if (data->index != NULL) {
+        free(data->index);
+    }
+    vaccineLotData_freeCenters(data);
+    vaccineLotData_init(data);
+    data->arena = arena;
+    data->strings = strings;
 }
 
 // Get the number of lots
-int vaccineLotData_len(tVaccineLotData data) {
+int vaccineLotData_len(const tVaccineLotData* data) {
+    assert(data != NULL);
+    
     // Return the number of lots
-    return data.count;
+    return data->count;
+}
+
+// Hash the cp, vaccine name and timestamp of a lot
+static unsigned int vaccineLot_hash(const char* cp, const char* vaccine, tDateTime timestamp) {
+    unsigned int hash;
+    
+    hash = hash_str(cp);
+    hash = hash * 31 + hash_str(vaccine);
+    hash = hash * 31 + (unsigned int) dateTime_toMinutes(timestamp);
+    
+    return hash;
+}
+
+// Lot searched on the hash index
+typedef struct _tVaccineLotKey {
+    const char* cp;
+    const char* vaccine;
+    tDateTime timestamp;
+} tVaccineLotKey;
+
+// Check if the lot at a given position has the cp, vaccine and timestamp of a key
+static bool vaccineLotData_equalsKey(const void* data, int idx, const void* key) {
+    const tVaccineLotData* lots = (const tVaccineLotData*) data;
+    const tVaccineLotKey* lotKey = (const tVaccineLotKey*) key;
+    tVaccineLot* lot;
+    
+    lot = &(lots->elems[idx]);
+    
+    return vaccineLot_cpEquals(lots->strings, lot->cp, lotKey->cp) && vaccine_nameEquals(lot->vaccine->name, lotKey->vaccine) && dateTime_equals(lot->timestamp, lotKey->timestamp);
+}
+
+// Get the hash of the lot at a given position, as stored on the index
+static unsigned int vaccineLotData_hashLot(const void* data, int idx) {
+    tVaccineLot* lot;
+    
+    lot = &(((const tVaccineLotData*) data)->elems[idx]);
+    
+    return vaccineLot_hash(lot->cp, lot->vaccine->name, lot->timestamp);
+}
+
+// Find the slot of the hash index for a given lot. It is the slot of the lot or the empty slot where it would be added
+static int vaccineLotData_slot(const tVaccineLotData* data, const char* cp, const char* vaccine, tDateTime timestamp) {
+    tVaccineLotKey key;
+    
+    assert(data->index != NULL);
+    
+    key.cp = cp;
+    key.vaccine = vaccine;
+    key.timestamp = timestamp;
+    
+    return hash_probe(data->index, data->indexSize, vaccineLot_hash(cp, vaccine, timestamp), vaccineLotData_equalsKey, data, &key);
+}
+
+// Rebuild the hash index with a size able to store count lots
+static void vaccineLotData_rebuild(tVaccineLotData* data, int count) {
+    data->index = hash_rebuild(data->index, &(data->indexSize), count, NULL, data->count, vaccineLotData_hashLot, data);
+}
+
+// Reserve memory to store at least the given number of lots
+void vaccineLotData_reserve(tVaccineLotData* data, int size) {
+    assert(data != NULL);
+    
+    data->elems = (tVaccineLot*) array_reserve(data->elems, &(data->capacity), size, sizeof(tVaccineLot));
+    
+    // Size the hash index too, so it is not rebuilt while the lots are added
+    if (2 * size > data->indexSize) {
+        vaccineLotData_rebuild(data, size);
+    }
 }
 
 // Add a new vaccine lot
@@ -273,87 +612,197 @@ void vaccineLotData_add(tVaccineLotData* data, tVaccineLot lot) {
     // Check input data (Pre-conditions)
     assert(data != NULL);    
     
+    // Use the canonical cp, so it is found and stored without copies
+    if (data->strings != NULL) {
+        lot.cp = (char*) internTable_add(data->strings, lot.cp);
+    }
+    
     // Check if an entry with this data already exists
-    idx = vaccineLotData_find(*data, lot.cp, lot.vaccine->name, lot.timestamp);
+    idx = vaccineLotData_find(data, lot.cp, lot.vaccine->name, lot.timestamp);
     
     // If it does not exist, create a new entry, otherwise add the number of doses
     if (idx < 0) {    
-        if (data->elems == NULL) {
-            data->elems = (tVaccineLot*) malloc(sizeof(tVaccineLot));
+        data->elems = (tVaccineLot*) array_grow(data->elems, &(data->capacity), data->count + 1, sizeof(tVaccineLot));
+        if (data->strings != NULL) {
+            data->elems[data->count] = lot;
+        } else if (data->arena != NULL) {
+            data->elems[data->count] = lot;
+            data->elems[data->count].cp = arena_strdup(data->arena, lot.cp);
         } else {
-            data->elems = (tVaccineLot*) realloc(data->elems, (data->count + 1) * sizeof(tVaccineLot));
+            vaccineLot_cpy(&(data->elems[data->count]), lot);
         }
-        assert(data->elems != NULL);        
-        vaccineLot_cpy(&(data->elems[data->count]), lot);
         data->count ++;        
+        
+        // Grow the hash index when the load factor reaches 0.5
+        if (2 * data->count > data->indexSize) {
+            vaccineLotData_rebuild(data, data->count);
+        } else {
+            data->index[vaccineLotData_slot(data, lot.cp, lot.vaccine->name, lot.timestamp)] = data->count - 1;
+        }
+        vaccineLotData_addToCenter(data, data->count - 1);
     } else {
         data->elems[idx].doses += lot.doses;
     }    
 }
 
-// Remove vaccines from a lot
+// Remove vaccines from a lot. A lot without doses is removed as vaccineLotData_removeAt, moving the last lot to its position
 void vaccineLotData_del(tVaccineLotData* data, const char* cp, const char* vaccine, tDateTime timestamp, int doses) {
     int idx;
-    int i;
     
     assert(cp != NULL);
     assert(vaccine != NULL);   
     
     // Check if an entry with this data already exists
-    idx = vaccineLotData_find(*data, cp, vaccine, timestamp);
+    idx = vaccineLotData_find(data, cp, vaccine, timestamp);
     
     if (idx >= 0) {
         // Reduce the number of doses
         data->elems[idx].doses -= doses;
-        // Shift elements to remove selected
+        // Remove the lot without doses, moving the last lot to its position, so the indexes are updated in place
         if (data->elems[idx].doses <= 0) {
-            for(i = idx; i < data->count-1; i++) {
-                // Remove the data from this position
-                vaccineLot_free(&(data->elems[i]));
-                // Copy element on position i+1 to position i
-                vaccineLot_cpy(&(data->elems[i]), data->elems[i+1]);
-            }            
-            // Update the number of elements
-            data->count--;     
-            // Free last position
-            vaccineLot_free(&(data->elems[data->count]));
+            vaccineLotData_removeAt(data, idx);
         }        
-        if (data->count > 0) {
-            data->elems = (tVaccineLot*) realloc(data->elems, data->count * sizeof(tVaccineLot));
-            assert(data->elems != NULL);
-        } else {
+        // Release the memory when no element is remaining. Otherwise the capacity is kept for new elements
+        if (data->count == 0) {
             free(data->elems);
             data->elems = NULL;
+            data->capacity = 0;
         }     
     }
 }
 
-// Return the position of a vaccine lot entry with provided information. -1 if it does not exist
-int vaccineLotData_find(tVaccineLotData data, const char* cp, const char* vaccine, tDateTime timestamp) {
-    int i;
+// Find the center of the lot at a given position. The position of the lot on the lots of the center is stored on pos
+static tVaccineLotCenter* vaccineLotData_findInCenter(const tVaccineLotData* data, int idx, int* pos) {
+    tVaccineLotCenter* center;
+    tVaccineLot* lot;
+    
+    lot = &(data->elems[idx]);
+    center = &(data->centers[vaccineLotData_centerPosition(data, lot->cp)]);
+    
+    // Lots with the same timestamp are sorted by insertion, not by position
+    *pos = vaccineLotData_lotPosition(data, center, lot->timestamp, false);
+    while (center->lots[*pos] != idx) {
+        (*pos)++;
+        assert(*pos < center->count);
+    }
+    
+    return center;
+}
+
+// Remove the lot at a given position, moving the last lot to it. Other lots keep their position, so the indexes are updated in place
+void vaccineLotData_removeAt(tVaccineLotData* data, int idx) {
+    tVaccineLotCenter* center;
+    tVaccineLot* lot;
+    int last;
+    int pos;
     
+    assert(data != NULL);
+    assert(idx >= 0 && idx < data->count);
+    
+    // Remove the lot from its center, and the center when it has no more lots
+    center = vaccineLotData_findInCenter(data, idx, &pos);
+    memmove(&(center->lots[pos]), &(center->lots[pos + 1]), (center->count - pos - 1) * sizeof(int));
+    center->count--;
+    if (center->count == 0) {
+        free(center->lots);
+        pos = center - data->centers;
+        memmove(&(data->centers[pos]), &(data->centers[pos + 1]), (data->numCenters - pos - 1) * sizeof(tVaccineLotCenter));
+        data->numCenters--;
+    }
+    
+    lot = &(data->elems[idx]);
+    hash_removeSlot(data->index, data->indexSize, vaccineLotData_slot(data, lot->cp, lot->vaccine->name, lot->timestamp), vaccineLotData_hashLot, data);
+    if (vaccineLotData_ownsCp(data)) {
+        vaccineLot_free(lot);
+    }
+    
+    // Move the last lot to the free position
+    last = data->count - 1;
+    if (idx != last) {
+        lot = &(data->elems[last]);
+        data->index[vaccineLotData_slot(data, lot->cp, lot->vaccine->name, lot->timestamp)] = idx;
+        center = vaccineLotData_findInCenter(data, last, &pos);
+        center->lots[pos] = idx;
+        data->elems[idx] = data->elems[last];
+    }
+    data->count--;
+}
+
+// Return the position of a vaccine lot entry with provided information. -1 if it does not exist
+int vaccineLotData_find(const tVaccineLotData* data, const char* cp, const char* vaccine, tDateTime timestamp) {
+    assert(data != NULL);
     assert(cp != NULL);
     assert(vaccine != NULL);    
     
-    for(i = 0; i < data.count; i++) {
-        if(strcmp(data.elems[i].cp, cp) == 0 && strcmp(data.elems[i].vaccine->name, vaccine) == 0 && dateTime_equals(data.elems[i].timestamp, timestamp)) {
-            return i;
+    // The cp of the lots are canonical, so only the canonical copy can match
+    if (data->strings != NULL) {
+        cp = internTable_find(data->strings, cp);
+        if (cp == NULL) {
+            return -1;
         }
     }
     
-    return -1;
+    if (data->count == 0) {
+        return -1;
+    }
+    
+    return data->index[vaccineLotData_slot(data, cp, vaccine, timestamp)];
+}
+
+// Find the lots of a center with a date between from and to, both included. Returns the lots of the center and the range [first, last) of them in the window. NULL if the center has no lots
+tVaccineLotCenter* vaccineLotData_findRange(const tVaccineLotData* data, const char* cp, tDate from, tDate to, int* first, int* last) {
+    tVaccineLotCenter* center;
+    tDateTime timestamp;
+    int pos;
+    
+    assert(data != NULL);
+    assert(cp != NULL);
+    assert(first != NULL);
+    assert(last != NULL);
+    
+    *first = 0;
+    *last = 0;
+    
+    pos = vaccineLotData_centerPosition(data, cp);
+    if (pos == data->numCenters || strcmp(vaccineLotData_centerCp(data, &(data->centers[pos])), cp) != 0) {
+        return NULL;
+    }
+    center = &(data->centers[pos]);
+    
+    // First lot from the start of the first day, up to the last lot of the last day
+    timestamp.date = from;
+    timestamp.time.hour = 0;
+    timestamp.time.minutes = 0;
+    *first = vaccineLotData_lotPosition(data, center, timestamp, false);
+    timestamp.date = to;
+    timestamp.time.hour = 23;
+    timestamp.time.minutes = 59;
+    *last = vaccineLotData_lotPosition(data, center, timestamp, true);
+    if (*last < *first) {
+        *last = *first;
+    }
+    
+    return center;
 }
 
 // Return the position of a vaccine lot entry with provided information. -1 if it does not exist
-int vaccineLotData_findbyTime(tVaccineLotData data, const char* cp, const char* vaccine, tDate date) {
+int vaccineLotData_findbyTime(const tVaccineLotData* data, const char* cp, const char* vaccine, tDate date) {
+    tVaccineLotCenter* center;
+    int first;
+    int last;
     int i;
     
     assert(cp != NULL);
     assert(vaccine != NULL);    
     
-    for(i = 0; i < data.count; i++) {
-        if(strcmp(data.elems[i].cp, cp) == 0 && strcmp(data.elems[i].vaccine->name, vaccine) == 0 && date_cmp(data.elems[i].timestamp.date, date)==0) {
-            return i;
+    center = vaccineLotData_findRange(data, cp, date, date, &first, &last);
+    if (center == NULL) {
+        return -1;
+    }
+    
+    for(i = first; i < last; i++) {
+        if(vaccine_nameEquals(data->elems[center->lots[i]].vaccine->name, vaccine)) {
+            return center->lots[i];
         }
     }
     
@@ -361,15 +810,238 @@ int vaccineLotData_findbyTime(tVaccineLotData data, const char* cp, const char*
 }
 
 // Return the position of a vaccine lot entry with provided information. -1 if it does not exist
-int vaccineLotData_anyVaccinefindbyTime(tVaccineLotData data, const char* cp, tDate date) {
-    int i;
+int vaccineLotData_anyVaccinefindbyTime(const tVaccineLotData* data, const char* cp, tDate date) {
+    tVaccineLotCenter* center;
+    int first;
+    int last;
     
     assert(cp != NULL);
-    for(i = 0; i < data.count; i++) {
-        if(strcmp(data.elems[i].cp, cp) == 0 && date_cmp(data.elems[i].timestamp.date, date)==0) {
-            return i;
+    
+    center = vaccineLotData_findRange(data, cp, date, date, &first, &last);
+    if (center == NULL || first == last) {
+        return -1;
+    }
+    
+    return center->lots[first];
+}
+
+// Vaccine as stored on a snapshot. Removed vaccines have no name
+typedef struct _tVaccineRecord {
+    // Position of the name on the table of strings. -1 for removed vaccines
+    int name;
+    int required;
+    int days;
+} tVaccineRecord;
+
+// Vaccine lot as stored on a snapshot
+typedef struct _tVaccineLotRecord {
+    // Id of the vaccine and position of the cp on the table of strings
+    int vaccine;
+    int cp;
+    tDateTime timestamp;
+    int doses;
+} tVaccineLotRecord;
+
+// Write the list of vaccines on a snapshot. The names are written as positions on the table of strings
+void vaccineList_save(const tVaccineList* list, tSnapshotWriter* writer) {
+    tVaccineRecord* records;
+    tVaccine* pVaccine;
+    int i;
+    
+    assert(list != NULL);
+    assert(list->strings != NULL);
+    assert(writer != NULL);
+    
+    // Vaccines are written by id, including the removed ones, so ids are kept
+    records = (tVaccineRecord*) malloc((list->numIds > 0 ? list->numIds : 1) * sizeof(tVaccineRecord));
+    assert(records != NULL);
+    for (i = 0; i < list->numIds; i++) {
+        pVaccine = &(list->blocks[i / VACCINE_BLOCK_SIZE][i % VACCINE_BLOCK_SIZE]);
+        records[i].name = (pVaccine->name != NULL) ? internTable_findId(list->strings, pVaccine->name) : -1;
+        records[i].required = pVaccine->required;
+        records[i].days = pVaccine->days;
+    }
+    
+    snapshot_writeInt(writer, list->numIds);
+    snapshot_write(writer, records, list->numIds * sizeof(tVaccineRecord));
+    snapshot_writeInt(writer, list->count);
+    snapshot_write(writer, list->sorted, list->count * sizeof(int));
+    snapshot_writeIndex(writer, list->index, list->indexSize);
+    
+    free(records);
+}
+
+// Read an empty list of vaccines from a snapshot. Returns false if the snapshot is not valid
+bool vaccineList_load(tVaccineList* list, tSnapshotReader* reader) {
+    const tVaccineRecord* records;
+    const int* sorted;
+    tVaccine* pVaccine;
+    int numIds;
+    int count;
+    int i;
+    
+    assert(list != NULL);
+    assert(list->strings != NULL);
+    assert(reader != NULL);
+    assert(list->numIds == 0);
+    
+    numIds = snapshot_readInt(reader);
+    records = (const tVaccineRecord*) snapshot_readArray(reader, numIds, sizeof(tVaccineRecord));
+    if (records == NULL) {
+        return false;
+    }
+    
+    list->numBlocks = (numIds + VACCINE_BLOCK_SIZE - 1) / VACCINE_BLOCK_SIZE;
+    list->blocks = (tVaccine**) array_reserve(list->blocks, &(list->blocksCapacity), list->numBlocks, sizeof(tVaccine*));
+    for (i = 0; i < list->numBlocks; i++) {
+        list->blocks[i] = (tVaccine*) malloc(VACCINE_BLOCK_SIZE * sizeof(tVaccine));
+        assert(list->blocks[i] != NULL);
+    }
+    for (i = 0; i < numIds; i++) {
+        pVaccine = &(list->blocks[i / VACCINE_BLOCK_SIZE][i % VACCINE_BLOCK_SIZE]);
+        pVaccine->name = (char*) internTable_get(list->strings, records[i].name);
+        pVaccine->required = records[i].required;
+        pVaccine->days = records[i].days;
+        pVaccine->id = (pVaccine->name != NULL) ? i : -1;
+        if (pVaccine->name == NULL && records[i].name != -1) {
+            reader->failed = true;
         }
     }
+    list->numIds = numIds;
     
-    return -1;
-}
\ No newline at end of file
+    // The sorted ids can only reference existing vaccines
+    count = snapshot_readInt(reader);
+    sorted = (const int*) snapshot_readArray(reader, count, sizeof(int));
+    if (sorted == NULL) {
+        return false;
+    }
+    list->sorted = (int*) array_reserve(list->sorted, &(list->capacity), count, sizeof(int));
+    for (i = 0; i < count; i++) {
+        list->sorted[i] = sorted[i];
+        if (vaccineList_getById(list, sorted[i]) == NULL) {
+            list->sorted[i] = 0;
+            reader->failed = true;
+        }
+    }
+    list->count = count;
+    
+    list->index = snapshot_readIndex(reader, numIds, &(list->indexSize));
+    if (list->index == NULL && count > 0) {
+        reader->failed = true;
+    }
+    
+    // The slots of the index can only reference existing vaccines, as their names are read on lookups
+    for (i = 0; list->index != NULL && i < list->indexSize; i++) {
+        if (list->index[i] != HASH_EMPTY_SLOT && vaccineList_getById(list, list->index[i]) == NULL) {
+            list->index[i] = HASH_EMPTY_SLOT;
+            reader->failed = true;
+        }
+    }
+    
+    return !reader->failed;
+}
+
+// Write the vaccine lots on a snapshot. The cp are written as positions on the table of strings and the vaccines by id
+void vaccineLotData_save(const tVaccineLotData* data, tSnapshotWriter* writer) {
+    tVaccineLotRecord* records;
+    tVaccineLot* lot;
+    int i;
+    
+    assert(data != NULL);
+    assert(data->strings != NULL);
+    assert(writer != NULL);
+    
+    records = (tVaccineLotRecord*) malloc((data->count > 0 ? data->count : 1) * sizeof(tVaccineLotRecord));
+    assert(records != NULL);
+    for (i = 0; i < data->count; i++) {
+        lot = &(data->elems[i]);
+        records[i].vaccine = lot->vaccine->id;
+        records[i].cp = internTable_findId(data->strings, lot->cp);
+        records[i].timestamp = lot->timestamp;
+        records[i].doses = lot->doses;
+    }
+    
+    snapshot_writeInt(writer, data->count);
+    snapshot_write(writer, records, data->count * sizeof(tVaccineLotRecord));
+    snapshot_writeIndex(writer, data->index, data->indexSize);
+    
+    // Lots of each center, with the centers sorted by cp
+    snapshot_writeInt(writer, data->numCenters);
+    for (i = 0; i < data->numCenters; i++) {
+        snapshot_writeInt(writer, data->centers[i].count);
+        snapshot_write(writer, data->centers[i].lots, data->centers[i].count * sizeof(int));
+    }
+    
+    free(records);
+}
+
+// Read empty vaccine lots from a snapshot, with the vaccines of the given list. Returns false if the snapshot is not valid
+bool vaccineLotData_load(tVaccineLotData* data, tSnapshotReader* reader, const tVaccineList* vaccines) {
+    const tVaccineLotRecord* records;
+    const int* lots;
+    tVaccineLotCenter* center;
+    tVaccineLot* lot;
+    int count;
+    int numCenters;
+    int i, j;
+    
+    assert(data != NULL);
+    assert(data->strings != NULL);
+    assert(reader != NULL);
+    assert(vaccines != NULL);
+    assert(data->count == 0);
+    
+    count = snapshot_readInt(reader);
+    records = (const tVaccineLotRecord*) snapshot_readArray(reader, count, sizeof(tVaccineLotRecord));
+    if (records == NULL) {
+        return false;
+    }
+    
+    // Single pass replacing the ids and positions by pointers
+    data->elems = (tVaccineLot*) array_reserve(data->elems, &(data->capacity), count, sizeof(tVaccineLot));
+    for (i = 0; i < count; i++) {
+        lot = &(data->elems[i]);
+        lot->vaccine = vaccineList_getById(vaccines, records[i].vaccine);
+        lot->cp = (char*) internTable_get(data->strings, records[i].cp);
+        lot->timestamp = records[i].timestamp;
+        lot->doses = records[i].doses;
+        if (lot->vaccine == NULL || lot->cp == NULL) {
+            reader->failed = true;
+        }
+    }
+    data->count = count;
+    
+    data->index = snapshot_readIndex(reader, count, &(data->indexSize));
+    if (data->index == NULL && count > 0) {
+        reader->failed = true;
+    }
+    
+    numCenters = snapshot_readInt(reader);
+    if (numCenters < 0 || numCenters > count) {
+        reader->failed = true;
+        return false;
+    }
+    data->centers = (tVaccineLotCenter*) array_reserve(data->centers, &(data->centersCapacity), numCenters, sizeof(tVaccineLotCenter));
+    for (i = 0; i < numCenters && !reader->failed; i++) {
+        center = &(data->centers[i]);
+        center->count = snapshot_readInt(reader);
+        lots = (const int*) snapshot_readArray(reader, center->count, sizeof(int));
+        if (lots == NULL || center->count == 0) {
+            reader->failed = true;
+            break;
+        }
+        center->lots = (int*) malloc(center->count * sizeof(int));
+        assert(center->lots != NULL);
+        center->capacity = center->count;
+        for (j = 0; j < center->count; j++) {
+            center->lots[j] = lots[j];
+            if (lots[j] < 0 || lots[j] >= count) {
+                center->lots[j] = 0;
+                reader->failed = true;
+            }
+        }
+        data->numCenters++;
+    }
+    
+    return !reader->failed;
+}
@@ -0,0 +1,240 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "wal.h"
+#include "array.h"
+#include "hash.h"
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// Value of the byte order field of the header, as written by the current machine
+#define WAL_BYTE_ORDER 0x01020304
+
+// Checksum of a record. It covers all the fields of the header after the checksum and the data, which are contiguous
+static unsigned int wal_checksum(const char* record, int size) {
+    return hash_strn(record + sizeof(unsigned int), sizeof(tWalRecordHeader) - sizeof(unsigned int) + size);
+}
+
+// Write the buffered data of a log to its file and wait until it is on the disk
+static void wal_flush(tWal* wal) {
+    if (!wal->failed && wal->size > 0 && fwrite(wal->buffer, 1, wal->size, wal->fout) != (size_t) wal->size) {
+        wal->failed = true;
+    }
+    wal->size = 0;
+    if (!wal->failed && fflush(wal->fout) != 0) {
+        wal->failed = true;
+    }
+#ifdef _WIN32
+    if (!wal->failed && _commit(_fileno(wal->fout)) != 0) {
+        wal->failed = true;
+    }
+#else
+    if (!wal->failed && fsync(fileno(wal->fout)) != 0) {
+        wal->failed = true;
+    }
+#endif
+    wal->syncs++;
+}
+
+// Open a log to append records after its first size bytes, removing the rest. If size is not positive, a new empty log is created.
+// Records are synced in groups of groupSize records. Returns false if the file cannot be opened
+bool wal_open(tWal* wal, const char* filename, long long size, int groupSize) {
+    tWalHeader header;
+    int result;
+    
+    assert(wal != NULL);
+    assert(filename != NULL);
+    assert(groupSize > 0);
+    
+    wal->buffer = NULL;
+    wal->size = 0;
+    wal->capacity = 0;
+    wal->record = -1;
+    wal->pending = 0;
+    wal->groupSize = groupSize;
+    wal->syncs = 0;
+    wal->failed = false;
+    
+    if (size < (long long) sizeof(tWalHeader)) {
+        wal->fout = fopen(filename, "wb");
+        if (wal->fout == NULL) {
+            return false;
+        }
+        memset(&header, 0, sizeof(tWalHeader));
+        memcpy(header.magic, WAL_MAGIC, sizeof(header.magic));
+        header.version = WAL_VERSION;
+        header.byteOrder = WAL_BYTE_ORDER;
+        wal_write(wal, &header, sizeof(tWalHeader));
+        wal_flush(wal);
+        return !wal->failed;
+    }
+    
+    // Records after the valid part of the log were not completely written, so they are removed
+    wal->fout = fopen(filename, "r+b");
+    if (wal->fout == NULL) {
+        return false;
+    }
+#ifdef _WIN32
+    result = _chsize_s(_fileno(wal->fout), size);
+#else
+    result = ftruncate(fileno(wal->fout), size);
+#endif
+    if (result != 0 || fseek(wal->fout, 0, SEEK_END) != 0) {
+        fclose(wal->fout);
+        wal->fout = NULL;
+        return false;
+    }
+    
+    return true;
+}
+
+// Sync the pending records and close a log. Returns false if any write failed
+bool wal_close(tWal* wal) {
+    assert(wal != NULL);
+    assert(wal->fout != NULL);
+    assert(wal->record < 0);
+    
+    if (wal->size > 0) {
+        wal_flush(wal);
+    }
+    if (fclose(wal->fout) != 0) {
+        wal->failed = true;
+    }
+    wal->fout = NULL;
+    
+    if (wal->buffer != NULL) {
+        free(wal->buffer);
+        wal->buffer = NULL;
+    }
+    wal->capacity = 0;
+    
+    return !wal->failed;
+}
+
+// Start a new record
+void wal_begin(tWal* wal, long long lsn, int type) {
+    tWalRecordHeader header;
+    
+    assert(wal != NULL);
+    assert(wal->record < 0);
+    
+    memset(&header, 0, sizeof(tWalRecordHeader));
+    header.lsn = lsn;
+    header.type = type;
+    wal->record = wal->size;
+    wal_write(wal, &header, sizeof(tWalRecordHeader));
+}
+
+// Add data to the current record
+void wal_write(tWal* wal, const void* data, int size) {
+    assert(wal != NULL);
+    assert(data != NULL || size == 0);
+    
+    wal->buffer = (char*) array_grow(wal->buffer, &(wal->capacity), wal->size + size, sizeof(char));
+    memcpy(wal->buffer + wal->size, data, size);
+    wal->size += size;
+}
+
+// End the current record. The log is synced when groupSize records are pending. Returns false if any write failed
+bool wal_end(tWal* wal) {
+    tWalRecordHeader header;
+    char* record;
+    
+    assert(wal != NULL);
+    assert(wal->record >= 0);
+    
+    // The header is completed once the size of the data is known
+    record = wal->buffer + wal->record;
+    memcpy(&header, record, sizeof(tWalRecordHeader));
+    header.size = wal->size - wal->record - sizeof(tWalRecordHeader);
+    memcpy(record, &header, sizeof(tWalRecordHeader));
+    header.checksum = wal_checksum(record, header.size);
+    memcpy(record, &header, sizeof(tWalRecordHeader));
+    wal->record = -1;
+    
+    wal->pending++;
+    if (wal->pending >= wal->groupSize) {
+        return wal_sync(wal);
+    }
+    
+    return !wal->failed;
+}
+
+// Write the pending records to the file and wait until they are on the disk. Returns false if any write failed
+bool wal_sync(tWal* wal) {
+    assert(wal != NULL);
+    assert(wal->record < 0);
+    
+    if (wal->pending > 0) {
+        wal_flush(wal);
+        wal->pending = 0;
+    }
+    
+    return !wal->failed;
+}
+
+// Map a log file and check its header. Returns false if the file cannot be read or, marking the reader as failed, if it is not a valid log. A log without a complete header has no records
+bool wal_openReader(tWalReader* reader, const char* filename) {
+    tWalHeader header;
+    
+    assert(reader != NULL);
+    assert(filename != NULL);
+    
+    reader->pos = 0;
+    reader->failed = false;
+    
+    if (!csv_openFile(&(reader->file), filename)) {
+        return false;
+    }
+    
+    // A log without a complete header was being created, so it has no records
+    if (reader->file.size < (long) sizeof(tWalHeader)) {
+        return true;
+    }
+    
+    memcpy(&header, reader->file.data, sizeof(tWalHeader));
+    if (memcmp(header.magic, WAL_MAGIC, sizeof(header.magic)) != 0 || header.version != WAL_VERSION || header.byteOrder != WAL_BYTE_ORDER) {
+        reader->failed = true;
+        csv_closeFile(&(reader->file));
+        return false;
+    }
+    reader->pos = sizeof(tWalHeader);
+    
+    return true;
+}
+
+// Release a log file mapped in memory
+void wal_closeReader(tWalReader* reader) {
+    assert(reader != NULL);
+    
+    csv_closeFile(&(reader->file));
+}
+
+// Read the next record. Returns false at the end of the log or on the first record not completely written
+bool wal_next(tWalReader* reader, tWalRecord* record) {
+    tWalRecordHeader header;
+    const char* data;
+    
+    assert(reader != NULL);
+    assert(record != NULL);
+    
+    if (reader->pos + (long long) sizeof(tWalRecordHeader) > reader->file.size) {
+        return false;
+    }
+    data = reader->file.data + reader->pos;
+    memcpy(&header, data, sizeof(tWalRecordHeader));
+    if (header.size < 0 || header.size > reader->file.size - reader->pos - (long long) sizeof(tWalRecordHeader) || header.checksum != wal_checksum(data, header.size)) {
+        return false;
+    }
+    
+    record->lsn = header.lsn;
+    record->type = header.type;
+    record->data = data + sizeof(tWalRecordHeader);
+    record->size = header.size;
+    reader->pos += sizeof(tWalRecordHeader) + header.size;
+    
+    return true;
+}
@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include "test_suite.h"
 #include "test.h"
+#include "bench.h"
 
 int main(int argc, char **argv)
 {
@@ -17,6 +18,13 @@ int main(int argc, char **argv)
         exit(EXIT_FAILURE);
     }
     
+    // Run the benchmarks instead of the tests
+    if (parameters.bench != NULL) {
+        bench_run(parameters.bench, parameters.bench_size);
+        waitKey(parameters);
+        exit(EXIT_SUCCESS);
+    }
+    
     // Initialize the test suite
     testSuite_init(&testSuite);
     
@@ -0,0 +1,143 @@
+#ifndef __BENCH__H
+#define __BENCH__H
+#include <stdbool.h>
+#include <time.h>
+
+// File used to store the synthetic data of the benchmarks
+#define BENCH_DATA_FILE "bench_data.csv"
+
+// Maximum number of threads used by the parallel benchmarks
+#define BENCH_MAX_THREADS 8
+
+// Number of days covered by the stock benchmark
+#define BENCH_STOCK_DAYS 3650
+
+// Number of health centers of the centers benchmark
+#define BENCH_NUM_CENTERS 5000
+
+// Number of vaccines of the vaccines benchmark
+#define BENCH_NUM_VACCINES 20
+
+// Number of lots and days of the window of the lot range benchmark
+#define BENCH_NUM_LOTS 100000
+#define BENCH_WINDOW_DAYS 30
+
+// Number of threads reading the shared data on the shared benchmark
+#define BENCH_NUM_READERS 4
+
+// File used to store the snapshot of the snapshot benchmark
+#define BENCH_SNAPSHOT_FILE "bench_data.snap"
+
+// File used to store the log of changes of the log benchmark
+#define BENCH_LOG_FILE "bench_data.wal"
+
+// File used to store the new version of the data of the sync benchmark
+#define BENCH_SYNC_FILE "bench_data_v2.csv"
+
+// Number of times the population is scanned on the columns benchmark
+#define BENCH_SCAN_ROUNDS 10
+
+// Maximum number of persons loaded on the cohort benchmark. Larger sizes only fill the columns scanned by the queries
+#define BENCH_COHORT_PERSONS 1000000
+
+// A benchmark
+typedef struct {
+    // Name of the benchmark
+    const char* name;
+    // Description of the benchmark
+    const char* description;
+    // Default number of elements
+    int size;
+    // Benchmark method
+    void (*run)(int size);
+} tBenchmark;
+
+// Run the benchmark with the given name, or all of them with "all". If size is not positive, default sizes are used
+void bench_run(const char* name, int size);
+
+// Get the current wall clock time in seconds
+double bench_now();
+
+// Get the seconds elapsed since the given time
+double bench_elapsed(double start);
+
+// Get the resident memory of the process in KB. Returns -1 if it is not available
+long bench_memoryUsage();
+
+// Get the peak resident memory of the process in KB. Returns -1 if it is not available
+long bench_memoryPeak();
+
+// Write a CSV file with n synthetic persons
+void bench_writePersons(const char* filename, int n);
+
+// Write a CSV file with n synthetic persons followed by a vaccine lot every 10 persons
+void bench_writeData(const char* filename, int n);
+
+// Get the document of the synthetic person i
+void bench_document(char* buffer, int i);
+
+
+// Load a population and compare linear and indexed lookups by document
+void bench_populationFind(int size);
+
+// Load the same file with an increasing number of threads and report the throughput
+void bench_loadParallel(int size);
+
+// Load a population with the strings on an arena and on the heap, comparing time and memory
+void bench_loadMemory(int size);
+
+// Add daily lots to a stock over BENCH_STOCK_DAYS days, then lots on random past dates, and look up the doses of random dates
+void bench_stock(int size);
+
+// Add days to dates and compare them using mktime and using day numbers
+void bench_date(int size);
+
+// Insert appointments in random order on a center calendar and look them up by timestamp and document
+void bench_appointments(int size);
+
+// Book two doses for each person in their center and get the appointments of each person, with the index and scanning the center
+void bench_personAppointments(int size);
+
+// Insert BENCH_NUM_CENTERS health centers and find them by cp
+void bench_centers(int size);
+
+// Find vaccines by name on a catalog of BENCH_NUM_VACCINES vaccines, half of the lookups for unknown names
+void bench_vaccines(int size);
+
+// Add lots to the vaccine lots data, each one on a different day, and find them
+void bench_lots(int size);
+
+// Get the lots of a center on a window of BENCH_WINDOW_DAYS days, with the index of each center and scanning all the lots
+void bench_lotRange(int size);
+
+// Export all the vaccine lots as CSV data and with a cursor
+void bench_export(int size);
+
+// Call overhead of the read functions of the API and of the population
+void bench_apiCalls(int size);
+
+// Book appointments for a list of persons in a center, one at a time and with a batch
+void bench_booking(int size);
+
+// Book appointments for a list of requests of several centers, one at a time and in parallel
+void bench_scheduler(int size);
+
+// Latency of the queries of several readers of the shared data, alone and while a writer adds entries
+void bench_shared(int size);
+
+// Load the same data from a CSV file and from a snapshot, with an appointment for every 10 persons
+void bench_snapshot(int size);
+
+// Book appointments for every 100 persons without a log, with group commit and syncing each change, and recover the data from the snapshot and the log
+void bench_log(int size);
+
+// Synchronize the data, with an appointment for every 100 persons, with a new version changing 2% of the rows, and compare it with a reset and reload
+void bench_sync(int size);
+
+// Count the persons of a cp born before a date and find documents, scanning the population and its columns
+void bench_columns(int size);
+
+// Select the persons born before 1960 of the cp 08001 to 08025 without appointments, scanning the persons and with cohort queries
+void bench_cohort(int size);
+
+#endif // __BENCH__H
@@ -16,6 +16,8 @@ typedef struct _AppArguments {
     char* in_file;
     char* readme_file;
     char* progress_file;
+    char* bench;
+    int bench_size;
     bool wait_on_exit;
 } tAppArguments;
 
@@ -0,0 +1,1657 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+#include <pthread.h>
+#include "bench.h"
+#include "api.h"
+
+// Available benchmarks
+static const tBenchmark benchmarks[] = {
+    {"population_find", "Lookups by document over a loaded population", 1000000, bench_populationFind},
+    {"load_parallel", "Throughput of the parallel loader from 1 to BENCH_MAX_THREADS threads", 1000000, bench_loadParallel},
+    {"load_memory", "Load time and memory of persons with strings on an arena or on the heap", 1000000, bench_loadMemory},
+    {"stock", "Daily stock updates and lookups of doses by date", 10000000, bench_stock},
+    {"date", "Date arithmetic with mktime and with day numbers", 10000000, bench_date},
+    {"appointments", "Sorted inserts and lookups on the calendar of a center", 100000, bench_appointments},
+    {"person_appointments", "Appointments of each person with the index by person and scanning the center", 100000, bench_personAppointments},
+    {"centers", "Inserts and lookups of health centers by cp", 1000000, bench_centers},
+    {"vaccines", "Lookups of vaccines by name on the catalog of vaccines", 10000000, bench_vaccines},
+    {"lots", "Adds and lookups of lots on the vaccine lots data", 100000, bench_lots},
+    {"lot_range", "Lots of a center on a date window with the index of each center and with a scan", 1000, bench_lotRange},
+    {"export", "Export of the vaccine lots as CSV data and with a cursor", 1000000, bench_export},
+    {"api_calls", "Call overhead of the read functions of the API", 10000000, bench_apiCalls},
+    {"booking", "Bookings of appointments in a center one at a time and with a batch", 100000, bench_booking},
+    {"scheduler", "Bookings of appointments in several centers one at a time and in parallel", 200000, bench_scheduler},
+    {"shared", "Query latency of the shared data, alone and while a writer adds entries", 200000, bench_shared},
+    {"snapshot", "Startup time loading the data from a CSV file and from a snapshot", 1000000, bench_snapshot},
+    {"log", "Commit throughput of the log of changes and recovery time from a snapshot and the log", 1000000, bench_log},
+    {"sync", "Refresh time of the data with a new version of the feed, synchronized and reloaded", 1000000, bench_sync},
+    {"columns", "Scans of the population by cp and birthday and by document, by persons and by columns", 1000000, bench_columns},
+    {"cohort", "Selection of a cohort by birthday, cp and appointments, scanning the persons and with cohort queries", 10000000, bench_cohort},
+};
+
+// Run the benchmark with the given name, or all of them with "all". If size is not positive, default sizes are used
+void bench_run(const char* name, int size) {
+    int i;
+    int numBenchmarks;
+    bool found = false;
+    
+    assert(name != NULL);
+    
+    numBenchmarks = sizeof(benchmarks) / sizeof(benchmarks[0]);
+    for (i = 0; i < numBenchmarks; i++) {
+        if (strcmp(name, "all") == 0 || strcmp(name, benchmarks[i].name) == 0) {
+            printf("=================================================================\n");
+            printf("BENCHMARK [%s] %s\n", benchmarks[i].name, benchmarks[i].description);
+            printf("=================================================================\n");
+            benchmarks[i].run(size > 0 ? size : benchmarks[i].size);
+            printf("\n");
+            found = true;
+        }
+    }
+    
+    if (!found) {
+        printf("ERROR: Unknown benchmark %s. Available benchmarks:\n", name);
+        for (i = 0; i < numBenchmarks; i++) {
+            printf("\t%s\n", benchmarks[i].name);
+        }
+    }
+}
+
+// Get the current wall clock time in seconds
+double bench_now() {
+    struct timespec ts;
+    
+    timespec_get(&ts, TIME_UTC);
+    
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Get the seconds elapsed since the given time
+double bench_elapsed(double start) {
+    return bench_now() - start;
+}
+
+// Get the resident memory of the process in KB. Returns -1 if it is not available
+long bench_memoryUsage() {
+    FILE* fin;
+    long size;
+    long resident;
+    
+    resident = -1;
+    fin = fopen("/proc/self/statm", "r");
+    if (fin != NULL) {
+        if (fscanf(fin, "%ld %ld", &size, &resident) == 2) {
+            resident = resident * 4;
+        }
+        fclose(fin);
+    }
+    
+    return resident;
+}
+
+// Get the peak resident memory of the process in KB. Returns -1 if it is not available
+long bench_memoryPeak() {
+#ifndef _WIN32
+    struct rusage usage;
+    
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        return usage.ru_maxrss;
+    }
+#endif
+    return -1;
+}
+
+// Get the document of the synthetic person i
+void bench_document(char* buffer, int i) {
+    sprintf(buffer, "%08d%c", i, 'A' + (i % 23));
+}
+
+// Write a CSV file with n synthetic persons
+void bench_writePersons(const char* filename, int n) {
+    FILE *fout;
+    char document[16];
+    int i;
+    
+    fout = fopen(filename, "w");
+    assert(fout != NULL);
+    
+    for (i = 0; i < n; i++) {
+        bench_document(document, i);
+        fprintf(fout, "PERSON;%s;Name%d;Surname%d;person%d@example.com;Street %d, %d;%05d;%02d/%02d/%04d\n",
+            document, i, i, i, i % 1000, i % 100, 8001 + (i % 50), 1 + (i % 28), 1 + (i % 12), 1930 + (i % 90));
+    }
+    
+    fclose(fout);
+}
+
+// Write a CSV file with n synthetic persons followed by a vaccine lot every 10 persons
+void bench_writeData(const char* filename, int n) {
+    FILE *fout;
+    int i;
+    
+    bench_writePersons(filename, n);
+    
+    fout = fopen(filename, "a");
+    assert(fout != NULL);
+    
+    for (i = 0; i < n / 10; i++) {
+        fprintf(fout, "VACCINE_LOT;%02d/%02d/2022;%02d:%02d;%05d;%s;2;21;%d\n",
+            1 + (i % 28), 1 + (i % 12), i % 24, i % 60, 8001 + (i % 50), (i % 2) ? "PFIZER" : "MODERNA", 100 + (i % 200));
+    }
+    
+    fclose(fout);
+}
+
+// Linear lookup by document, as it was done before the population index
+static int bench_populationFindLinear(tPopulation* data, const char* document) {
+    int i;
+    
+    for(i = 0; i < data->count; i++) {
+        if(strcmp(data->elems[i].document, document) == 0 ) {
+            return i;
+        }
+    }
+    
+    return -1;
+}
+
+// Load a population and compare linear and indexed lookups by document
+void bench_populationFind(int size) {
+    tApiData data;
+    tApiError error;
+    char document[16];
+    double start;
+    double seconds;
+    double linearSeconds;
+    int numLinear;
+    int found;
+    int i;
+    
+    bench_writePersons(BENCH_DATA_FILE, size);
+    
+    // Load the data
+    api_initData(&data);
+    start = bench_now();
+    error = api_loadData(&data, BENCH_DATA_FILE, true);
+    seconds = bench_elapsed(start);
+    assert(error == E_SUCCESS);
+    printf("Loaded %d persons in %.3f s\n", api_populationCount(&data), seconds);
+    
+    // Indexed lookups for all persons
+    found = 0;
+    start = bench_now();
+    for (i = 0; i < size; i++) {
+        bench_document(document, i);
+        if (population_find(&(data.population), document) == i) {
+            found++;
+        }
+    }
+    seconds = bench_elapsed(start);
+    assert(found == size);
+    printf("Indexed find: %d lookups in %.3f s (%.1f ns/lookup)\n", size, seconds, 1e9 * seconds / size);
+    
+    // Linear lookups are O(n), so only a sample is measured
+    numLinear = size < 1000 ? size : 1000;
+    found = 0;
+    start = bench_now();
+    for (i = 0; i < numLinear; i++) {
+        bench_document(document, (int)(((long long)i * size) / numLinear));
+        if (bench_populationFindLinear(&(data.population), document) >= 0) {
+            found++;
+        }
+    }
+    linearSeconds = bench_elapsed(start);
+    assert(found == numLinear);
+    printf("Linear find:  %d lookups in %.3f s (%.1f ns/lookup)\n", numLinear, linearSeconds, 1e9 * linearSeconds / numLinear);
+    if (seconds > 0) {
+        printf("Speedup: %.1fx\n", (linearSeconds / numLinear) / (seconds / size));
+    }
+    
+    api_freeData(&data);
+    remove(BENCH_DATA_FILE);
+}
+
+// Load the same file with an increasing number of threads and report the throughput
+void bench_loadParallel(int size) {
+    tApiData data;
+    tApiData reference;
+    tApiError error;
+    double start;
+    double seconds;
+    double baseSeconds;
+    int numRows;
+    int numThreads;
+    
+    bench_writeData(BENCH_DATA_FILE, size);
+    numRows = size + size / 10;
+    
+    // Serial load, used as reference
+    api_initData(&reference);
+    start = bench_now();
+    error = api_loadData(&reference, BENCH_DATA_FILE, true);
+    baseSeconds = bench_elapsed(start);
+    assert(error == E_SUCCESS);
+    printf("Serial:     %d rows in %.3f s (%.0f rows/s)\n", numRows, baseSeconds, numRows / baseSeconds);
+    
+    for (numThreads = 1; numThreads <= BENCH_MAX_THREADS; numThreads *= 2) {
+        api_initData(&data);
+        start = bench_now();
+        error = api_loadDataParallel(&data, BENCH_DATA_FILE, true, numThreads);
+        seconds = bench_elapsed(start);
+        assert(error == E_SUCCESS);
+        assert(api_populationCount(&data) == api_populationCount(&reference));
+        assert(api_vaccineLotsCount(&data) == api_vaccineLotsCount(&reference));
+        printf("%d threads: %d rows in %.3f s (%.0f rows/s, %.2fx)\n", numThreads, numRows, seconds, numRows / seconds, baseSeconds / seconds);
+        api_freeData(&data);
+    }
+    
+    api_freeData(&reference);
+    remove(BENCH_DATA_FILE);
+}
+
+// Load a population and report the time and memory used, with the strings on the arena or on the heap
+static void bench_loadMemoryMode(const char* mode, bool useArena) {
+    tApiData data;
+    tApiError error;
+    double start;
+    double loadSeconds;
+    double freeSeconds;
+    long memoryBefore;
+    long memoryAfter;
+    
+    api_initData(&data);
+    if (!useArena) {
+        // Each person owns its strings, as before the arena was added
+        data.population.arena = NULL;
+        data.vaccines.arena = NULL;
+        data.vaccineLots.arena = NULL;
+    }
+    
+    memoryBefore = bench_memoryUsage();
+    start = bench_now();
+    error = api_loadData(&data, BENCH_DATA_FILE, false);
+    loadSeconds = bench_elapsed(start);
+    assert(error == E_SUCCESS);
+    memoryAfter = bench_memoryUsage();
+    
+    start = bench_now();
+    api_freeData(&data);
+    freeSeconds = bench_elapsed(start);
+    
+    printf("%-6s load %.3f s, free %.3f s", mode, loadSeconds, freeSeconds);
+    if (memoryBefore >= 0) {
+        printf(", resident memory +%.1f MB", (memoryAfter - memoryBefore) / 1024.0);
+    }
+    if (bench_memoryPeak() >= 0) {
+        printf(", peak %.1f MB", bench_memoryPeak() / 1024.0);
+    }
+    printf("\n");
+}
+
+// Load a population with the strings on an arena and on the heap, comparing time and memory
+void bench_loadMemory(int size) {
+    bench_writePersons(BENCH_DATA_FILE, size);
+    printf("%d persons\n", size);
+    
+    // The peak memory never decreases, so the arena is measured first
+    bench_loadMemoryMode("Arena", true);
+    bench_loadMemoryMode("Heap", false);
+    
+    remove(BENCH_DATA_FILE);
+}
+
+// Add daily lots to a stock over BENCH_STOCK_DAYS days, then lots on random past dates, and look up the doses of random dates
+void bench_stock(int size) {
+    tVaccineStockData stock;
+    tVaccine vaccines[2];
+    tDate date;
+    tDate first;
+    double start;
+    double seconds;
+    long long total;
+    int i;
+    
+    vaccines[0].name = "MODERNA";
+    vaccines[0].days = 0;
+    vaccines[0].required = 1;
+    vaccines[1].name = "PFIZER";
+    vaccines[1].days = 21;
+    vaccines[1].required = 2;
+    
+    // A lot of each vaccine arrives every day
+    stockList_init(&stock);
+    date_parse(&first, "01/01/2022");
+    date = first;
+    start = bench_now();
+    for (i = 0; i < BENCH_STOCK_DAYS; i++) {
+        stockList_update(&stock, date, &(vaccines[i % 2]), 10);
+        date_addDay(&date, 1);
+    }
+    seconds = bench_elapsed(start);
+    printf("Update  %d days in %.3f s\n", BENCH_STOCK_DAYS, seconds);
+    
+    // Add lots on pseudo-random past dates, which change all the following days
+    srand(1);
+    start = bench_now();
+    for (i = 0; i < size / 10; i++) {
+        date_fromDays(&date, date_toDays(first) + rand() % BENCH_STOCK_DAYS);
+        stockList_update(&stock, date, &(vaccines[i % 2]), 1);
+    }
+    seconds = bench_elapsed(start);
+    printf("Backfill %d lots in %.3f s (%.0f lots/s)\n", size / 10, seconds, (size / 10) / seconds);
+    
+    // Look up the doses of pseudo-random dates of the stock
+    srand(1);
+    total = 0;
+    start = bench_now();
+    for (i = 0; i < size; i++) {
+        date_fromDays(&date, date_toDays(first) + rand() % BENCH_STOCK_DAYS);
+        total += stockList_getDoses(&stock, date, &(vaccines[i % 2]));
+    }
+    seconds = bench_elapsed(start);
+    printf("Lookup  %d dates in %.3f s (%.0f lookups/s, checksum %lld)\n", size, seconds, size / seconds, total);
+    
+    stockList_free(&stock);
+}
+
+// Add days to a date with mktime, as done before day numbers were used
+static void bench_mktimeAddDay(tDate* date, int days) {
+    struct tm tm = { 0 };
+    
+    tm.tm_mday = date->day + days;
+    tm.tm_mon = date->month - 1;
+    tm.tm_year = date->year - 1900;
+    mktime(&tm);
+    
+    date->day = tm.tm_mday;
+    date->month = tm.tm_mon + 1;
+    date->year = tm.tm_year + 1900;
+}
+
+// Compare two dates field by field, as done before day numbers were used
+static int bench_fieldCmp(tDate date1, tDate date2) {
+    if (date1.year != date2.year) {
+        return date1.year < date2.year ? -1 : 1;
+    }
+    if (date1.month != date2.month) {
+        return date1.month < date2.month ? -1 : 1;
+    }
+    if (date1.day != date2.day) {
+        return date1.day < date2.day ? -1 : 1;
+    }
+    return 0;
+}
+
+// Add days to dates and compare them using mktime and using day numbers
+void bench_date(int size) {
+    tDate date;
+    tDate previous;
+    double start;
+    double seconds;
+    long long total;
+    int i;
+    
+    // Move forward and backward, so the dates stay in a range of a few years
+    date_parse(&date, "01/01/2022");
+    total = 0;
+    start = bench_now();
+    for (i = 0; i < size; i++) {
+        previous = date;
+        bench_mktimeAddDay(&date, (i % 2 == 0) ? 3 : -2);
+        total += bench_fieldCmp(date, previous) + date.day;
+    }
+    seconds = bench_elapsed(start);
+    printf("mktime       %d operations in %.3f s (%.1f ns/op, checksum %lld)\n", size, seconds, seconds * 1e9 / size, total);
+    
+    date_parse(&date, "01/01/2022");
+    total = 0;
+    start = bench_now();
+    for (i = 0; i < size; i++) {
+        previous = date;
+        date_addDay(&date, (i % 2 == 0) ? 3 : -2);
+        total += date_cmp(date, previous) + date.day;
+    }
+    seconds = bench_elapsed(start);
+    printf("Day numbers  %d operations in %.3f s (%.1f ns/op, checksum %lld)\n", size, seconds, seconds * 1e9 / size, total);
+}
+
+// Find the first appointment with a bigger or equal timestamp with a linear search
+static int bench_findTimestampLinear(tAppointmentData* list, tDateTime timestamp) {
+    int i;
+    
+    for (i = 0; i < list->count; i++) {
+        if (dateTime_cmp(list->elems[i].timestamp, timestamp) >= 0) {
+            return i;
+        }
+    }
+    
+    return -1;
+}
+
+// Get the timestamp of the synthetic appointment i, in 15 minutes slots during a year
+static void bench_appointmentTimestamp(tDateTime* timestamp, int i) {
+    tDateTime first;
+    
+    dateTime_parse(&first, "01/01/2022", "00:00");
+    dateTime_fromMinutes(timestamp, dateTime_toMinutes(first) + (int)(((long long)i * 7919) % (365 * 96)) * 15);
+}
+
+// Insert appointments in random order on a center calendar and look them up by timestamp and document
+void bench_appointments(int size) {
+    tAppointmentData appointments;
+    tPerson* persons;
+    char* documents;
+    tVaccine vaccine;
+    tDateTime timestamp;
+    double start;
+    double seconds;
+    int numLinear;
+    int found;
+    int pos;
+    int i;
+    
+    vaccine.name = "PFIZER";
+    vaccine.days = 21;
+    vaccine.required = 2;
+    persons = (tPerson*) calloc(size, sizeof(tPerson));
+    documents = (char*) malloc(size * 16);
+    assert(persons != NULL && documents != NULL);
+    for (i = 0; i < size; i++) {
+        bench_document(documents + i * 16, i);
+        persons[i].document = documents + i * 16;
+    }
+    
+    appointmentData_init(&appointments);
+    start = bench_now();
+    for (i = 0; i < size; i++) {
+        bench_appointmentTimestamp(&timestamp, i);
+        appointmentData_insert(&appointments, timestamp, &vaccine, &(persons[i]));
+    }
+    seconds = bench_elapsed(start);
+    printf("Insert  %d appointments in %.3f s\n", size, seconds);
+    
+    // Binary search of each appointment
+    found = 0;
+    start = bench_now();
+    for (i = 0; i < size; i++) {
+        bench_appointmentTimestamp(&timestamp, i);
+        pos = appointmentData_findTimestamp(&appointments, timestamp, 0);
+        pos = appointmentData_findDocument(&appointments, timestamp, persons[i].document, pos);
+        if (pos >= 0 && appointments.elems[pos].person == &(persons[i])) {
+            found++;
+        }
+    }
+    seconds = bench_elapsed(start);
+    printf("Binary  %d lookups in %.3f s (%.0f lookups/s, %d found)\n", size, seconds, size / seconds, found);
+    
+    // Linear search of some appointments
+    numLinear = size < 1000 ? size : 1000;
+    found = 0;
+    start = bench_now();
+    for (i = 0; i < numLinear; i++) {
+        bench_appointmentTimestamp(&timestamp, (int)(((long long)i * size) / numLinear));
+        if (bench_findTimestampLinear(&appointments, timestamp) >= 0) {
+            found++;
+        }
+    }
+    seconds = bench_elapsed(start);
+    printf("Linear  %d lookups in %.3f s (%.0f lookups/s)\n", numLinear, seconds, numLinear / seconds);
+    
+    appointmentData_free(&appointments);
+    free(documents);
+    free(persons);
+}
+
+// Book two doses for each person in their center and get the appointments of each person, with the index and scanning the center
+void bench_personAppointments(int size) {
+    tApiData data;
+    tApiError error;
+    tCSVData report;
+    tHealthCenter* center;
+    tPerson* person;
+    tDateTime timestamp;
+    char document[16];
+    double start;
+    double seconds;
+    int found;
+    int pos;
+    int i;
+    
+    bench_writeData(BENCH_DATA_FILE, size);
+    api_initData(&data);
+    error = api_loadData(&data, BENCH_DATA_FILE, true);
+    assert(error == E_SUCCESS);
+    remove(BENCH_DATA_FILE);
+    
+    start = bench_now();
+    for (i = 0; i < size; i++) {
+        bench_document(document, i);
+        person = &(data.population.elems[population_find(&(data.population), document)]);
+        dateTime_parse(&timestamp, "01/03/2022", "08:00");
+        dateTime_fromMinutes(&timestamp, dateTime_toMinutes(timestamp) + (i % 5000) * 5);
+        error = api_addAppointment(&data, person->cp, document, "PFIZER", timestamp);
+        assert(error == E_SUCCESS);
+    }
+    seconds = bench_elapsed(start);
+    printf("Booked  %d persons in %.3f s\n", size, seconds);
+    
+    // Appointments of each person from the index
+    found = 0;
+    start = bench_now();
+    for (i = 0; i < size; i++) {
+        bench_document(document, i);
+        csv_init(&report);
+        api_getPersonAppointments(&data, document, &report);
+        found += csv_numEntries(report);
+        csv_free(&report);
+    }
+    seconds = bench_elapsed(start);
+    printf("Index   %d persons in %.3f s (%.0f persons/s, %d appointments)\n", size, seconds, size / seconds, found);
+    
+    // Appointments of each person scanning the calendar of their center
+    found = 0;
+    start = bench_now();
+    for (i = 0; i < size; i++) {
+        bench_document(document, i);
+        person = &(data.population.elems[population_find(&(data.population), document)]);
+        center = centerList_find(&(data.centers), person->cp);
+        pos = appointmentData_find(&(center->appointments), person, 0);
+        while (pos >= 0) {
+            found++;
+            pos = appointmentData_find(&(center->appointments), person, pos + 1);
+        }
+    }
+    seconds = bench_elapsed(start);
+    printf("Scan    %d persons in %.3f s (%.0f persons/s, %d appointments)\n", size, seconds, size / seconds, found);
+    
+    api_freeData(&data);
+}
+
+// Insert BENCH_NUM_CENTERS health centers and find them by cp
+void bench_centers(int size) {
+    tHealthCenterList list;
+    char cp[16];
+    double start;
+    double seconds;
+    int found;
+    int i;
+    
+    centerList_init(&list);
+    start = bench_now();
+    for (i = 0; i < BENCH_NUM_CENTERS; i++) {
+        sprintf(cp, "%05d", (int)(((long long)i * 7919) % BENCH_NUM_CENTERS));
+        centerList_insert(&list, cp);
+    }
+    seconds = bench_elapsed(start);
+    printf("Insert  %d centers in %.3f s\n", BENCH_NUM_CENTERS, seconds);
+    
+    found = 0;
+    start = bench_now();
+    for (i = 0; i < size; i++) {
+        sprintf(cp, "%05d", (int)(((long long)i * 104729) % BENCH_NUM_CENTERS));
+        if (centerList_find(&list, cp) != NULL) {
+            found++;
+        }
+    }
+    seconds = bench_elapsed(start);
+    printf("Find    %d centers in %.3f s (%.0f lookups/s, %d found)\n", size, seconds, size / seconds, found);
+    
+    centerList_free(&list);
+}
+
+// Find vaccines by name on a catalog of BENCH_NUM_VACCINES vaccines, half of the lookups for unknown names
+void bench_vaccines(int size) {
+    tVaccineList list;
+    tVaccine vaccine;
+    char names[2 * BENCH_NUM_VACCINES][32];
+    double start;
+    double seconds;
+    int found;
+    int i;
+    
+    vaccineList_init(&list);
+    for (i = 0; i < 2 * BENCH_NUM_VACCINES; i++) {
+        sprintf(names[i], "VACCINE-%02d", i);
+        if (i < BENCH_NUM_VACCINES) {
+            vaccine_init(&vaccine, names[i], 2, 21);
+            vaccineList_insert(&list, vaccine);
+            vaccine_free(&vaccine);
+        }
+    }
+    
+    found = 0;
+    start = bench_now();
+    for (i = 0; i < size; i++) {
+        if (vaccineList_find(&list, names[(i * 7) % (2 * BENCH_NUM_VACCINES)]) != NULL) {
+            found++;
+        }
+    }
+    seconds = bench_elapsed(start);
+    printf("Find    %d vaccines in %.3f s (%.0f lookups/s, %d found)\n", size, seconds, size / seconds, found);
+    
+    vaccineList_free(&list);
+}
+
+// Add lots to the vaccine lots data, each one on a different day, and find them
+void bench_lots(int size) {
+    tVaccineLotData data;
+    tVaccine vaccine;
+    tVaccineLot lot;
+    tDateTime start;
+    char cp[16];
+    double startTime;
+    double seconds;
+    int found;
+    int i;
+    
+    vaccineLotData_init(&data);
+    vaccine_init(&vaccine, "PFIZER", 2, 21);
+    dateTime_parse(&start, "01/01/2000", "10:00");
+    lot.vaccine = &vaccine;
+    lot.cp = cp;
+    lot.doses = 100;
+    
+    startTime = bench_now();
+    for (i = 0; i < size; i++) {
+        sprintf(cp, "%05d", 8001 + (i % 50));
+        lot.timestamp = start;
+        dateTime_addDay(&(lot.timestamp), i);
+        vaccineLotData_add(&data, lot);
+    }
+    seconds = bench_elapsed(startTime);
+    printf("Add     %d lots in %.3f s (%.0f lots/s)\n", size, seconds, size / seconds);
+    
+    found = 0;
+    startTime = bench_now();
+    for (i = 0; i < size; i++) {
+        sprintf(cp, "%05d", 8001 + (i % 50));
+        lot.timestamp = start;
+        dateTime_addDay(&(lot.timestamp), i);
+        if (vaccineLotData_find(&data, cp, "PFIZER", lot.timestamp) >= 0) {
+            found++;
+        }
+    }
+    seconds = bench_elapsed(startTime);
+    printf("Find    %d lots in %.3f s (%.0f lookups/s, %d found)\n", size, seconds, size / seconds, found);
+    
+    vaccineLotData_free(&data);
+    vaccine_free(&vaccine);
+}
+
+// Get the lots of a center on a window of BENCH_WINDOW_DAYS days, with the index of each center and scanning all the lots
+void bench_lotRange(int size) {
+    tVaccineLotData data;
+    tVaccine vaccine;
+    tVaccineLot lot;
+    tVaccineLotCenter* center;
+    tDateTime start;
+    tDate from;
+    tDate to;
+    char cp[16];
+    double startTime;
+    double seconds;
+    long found;
+    int first;
+    int last;
+    int i;
+    int j;
+    
+    vaccineLotData_init(&data);
+    vaccine_init(&vaccine, "PFIZER", 2, 21);
+    dateTime_parse(&start, "01/01/2000", "10:00");
+    lot.vaccine = &vaccine;
+    lot.cp = cp;
+    lot.doses = 100;
+    vaccineLotData_reserve(&data, BENCH_NUM_LOTS);
+    for (i = 0; i < BENCH_NUM_LOTS; i++) {
+        sprintf(cp, "%05d", 8001 + (i % 50));
+        lot.timestamp = start;
+        dateTime_addDay(&(lot.timestamp), i / 10);
+        vaccineLotData_add(&data, lot);
+    }
+    
+    found = 0;
+    startTime = bench_now();
+    for (i = 0; i < size; i++) {
+        sprintf(cp, "%05d", 8001 + (i % 50));
+        from = start.date;
+        date_addDay(&from, (int)(((long long)i * 7919) % (BENCH_NUM_LOTS / 10)));
+        to = from;
+        date_addDay(&to, BENCH_WINDOW_DAYS - 1);
+        center = vaccineLotData_findRange(&data, cp, from, to, &first, &last);
+        if (center != NULL) {
+            found += last - first;
+        }
+    }
+    seconds = bench_elapsed(startTime);
+    printf("Index   %d windows in %.3f s (%.0f queries/s, %ld lots)\n", size, seconds, size / seconds, found);
+    
+    found = 0;
+    startTime = bench_now();
+    for (i = 0; i < size; i++) {
+        sprintf(cp, "%05d", 8001 + (i % 50));
+        from = start.date;
+        date_addDay(&from, (int)(((long long)i * 7919) % (BENCH_NUM_LOTS / 10)));
+        to = from;
+        date_addDay(&to, BENCH_WINDOW_DAYS - 1);
+        for (j = 0; j < data.count; j++) {
+            if (strcmp(data.elems[j].cp, cp) == 0 && date_cmp(data.elems[j].timestamp.date, from) >= 0 && date_cmp(data.elems[j].timestamp.date, to) <= 0) {
+                found++;
+            }
+        }
+    }
+    seconds = bench_elapsed(startTime);
+    printf("Scan    %d windows in %.3f s (%.0f queries/s, %ld lots)\n", size, seconds, size / seconds, found);
+    
+    vaccineLotData_free(&data);
+    vaccine_free(&vaccine);
+}
+
+// Export all the vaccine lots as CSV data and with a cursor
+void bench_export(int size) {
+    tApiData data;
+    tVaccine vaccine;
+    tVaccineLot lot;
+    tVaccineLot* pLot;
+    tApiCursor cursor;
+    tCSVData lots;
+    tDateTime start;
+    char cp[16];
+    char buffer[256];
+    double startTime;
+    double seconds;
+    long memoryBefore;
+    long memoryAfter;
+    long length;
+    int i;
+    
+    api_initData(&data);
+    vaccine_init(&vaccine, "PFIZER", 2, 21);
+    dateTime_parse(&start, "01/01/2000", "10:00");
+    lot.vaccine = &vaccine;
+    lot.cp = cp;
+    lot.doses = 100;
+    vaccineLotData_reserve(&(data.vaccineLots), size);
+    for (i = 0; i < size; i++) {
+        sprintf(cp, "%05d", 8001 + (i % 50));
+        lot.timestamp = start;
+        dateTime_addDay(&(lot.timestamp), i / 50);
+        vaccineLotData_add(&(data.vaccineLots), lot);
+    }
+    
+    memoryBefore = bench_memoryUsage();
+    startTime = bench_now();
+    api_getVaccineLots(&data, &lots);
+    seconds = bench_elapsed(startTime);
+    memoryAfter = bench_memoryUsage();
+    printf("CSV     %d lots in %.3f s (%.0f lots/s)", csv_numEntries(lots), seconds, csv_numEntries(lots) / seconds);
+    if (memoryBefore >= 0) {
+        printf(", resident memory +%.1f MB", (memoryAfter - memoryBefore) / 1024.0);
+    }
+    printf("\n");
+    csv_free(&lots);
+    
+    // Each lot is formatted, as an exporter writing it to a file would do
+    length = 0;
+    memoryBefore = bench_memoryUsage();
+    startTime = bench_now();
+    api_vaccineLotsCursor(&data, &cursor);
+    while ((pLot = api_nextVaccineLot(&data, &cursor)) != NULL) {
+        length += sprintf(buffer, "%02d/%02d/%04d;%02d:%02d;%s;%s;%d;%d;%d",
+            pLot->timestamp.date.day, pLot->timestamp.date.month, pLot->timestamp.date.year,
+            pLot->timestamp.time.hour, pLot->timestamp.time.minutes, pLot->cp,
+            pLot->vaccine->name, pLot->vaccine->required, pLot->vaccine->days, pLot->doses);
+    }
+    seconds = bench_elapsed(startTime);
+    memoryAfter = bench_memoryUsage();
+    printf("Cursor  %d lots in %.3f s (%.0f lots/s, %ld bytes)", size, seconds, size / seconds, length);
+    if (memoryBefore >= 0) {
+        printf(", resident memory +%.1f MB", (memoryAfter - memoryBefore) / 1024.0);
+    }
+    printf("\n");
+    
+    api_freeData(&data);
+    vaccine_free(&vaccine);
+}
+
+// Call overhead of the read functions of the API and of the population
+void bench_apiCalls(int size) {
+    tApiData data;
+    tApiError error;
+    char document[16];
+    double start;
+    double seconds;
+    long total;
+    int i;
+    
+    bench_writeData(BENCH_DATA_FILE, 10000);
+    api_initData(&data);
+    error = api_loadData(&data, BENCH_DATA_FILE, false);
+    assert(error == E_SUCCESS);
+    printf("Size of tApiData: %d bytes\n", (int) sizeof(tApiData));
+    
+    total = 0;
+    start = bench_now();
+    for (i = 0; i < size; i++) {
+        total += api_vaccineCount(&data) + api_centersCount(&data);
+    }
+    seconds = bench_elapsed(start);
+    printf("Count   %d calls in %.3f s (%.1f ns/call, total %ld)\n", 2 * size, seconds, seconds * 1e9 / (2.0 * size), total);
+    
+    total = 0;
+    start = bench_now();
+    for (i = 0; i < size; i++) {
+        bench_document(document, i % 10000);
+        total += population_find(&(data.population), document);
+    }
+    seconds = bench_elapsed(start);
+    printf("Find    %d calls in %.3f s (%.1f ns/call, total %ld)\n", size, seconds, seconds * 1e9 / size, total);
+    
+    api_freeData(&data);
+    remove(BENCH_DATA_FILE);
+}
+
+// Book appointments for a list of persons in a center, one at a time and with a batch
+void bench_booking(int size) {
+    tApiData data;
+    tApiError error;
+    tApiError* results;
+    tDateTime timestamp;
+    char (*documents)[16];
+    const char** pDocuments;
+    FILE* fout;
+    double start;
+    double seconds;
+    int booked;
+    int i;
+    
+    // Persons and a lot with enough doses for all of them
+    bench_writePersons(BENCH_DATA_FILE, size);
+    fout = fopen(BENCH_DATA_FILE, "a");
+    assert(fout != NULL);
+    fprintf(fout, "VACCINE_LOT;01/04/2022;10:00;08001;PFIZER;2;21;%d\n", 2 * size);
+    fclose(fout);
+    
+    documents = malloc(size * sizeof(documents[0]));
+    pDocuments = (const char**) malloc(size * sizeof(const char*));
+    results = (tApiError*) malloc(size * sizeof(tApiError));
+    assert(documents != NULL && pDocuments != NULL && results != NULL);
+    for (i = 0; i < size; i++) {
+        bench_document(documents[i], i);
+        pDocuments[i] = documents[i];
+    }
+    dateTime_parse(&timestamp, "01/04/2022", "10:00");
+    
+    api_initData(&data);
+    error = api_loadData(&data, BENCH_DATA_FILE, false);
+    assert(error == E_SUCCESS);
+    booked = 0;
+    start = bench_now();
+    for (i = 0; i < size; i++) {
+        if (api_findAppointmentAvailability(&data, "08001", pDocuments[i], timestamp) == E_SUCCESS) {
+            booked++;
+        }
+    }
+    seconds = bench_elapsed(start);
+    printf("Single  %d persons in %.3f s (%.0f bookings/s, %d booked)\n", size, seconds, booked / seconds, booked);
+    api_freeData(&data);
+    
+    api_initData(&data);
+    error = api_loadData(&data, BENCH_DATA_FILE, false);
+    assert(error == E_SUCCESS);
+    booked = 0;
+    start = bench_now();
+    api_findAppointmentAvailabilityBatch(&data, "08001", pDocuments, size, timestamp, results);
+    seconds = bench_elapsed(start);
+    for (i = 0; i < size; i++) {
+        if (results[i] == E_SUCCESS) {
+            booked++;
+        }
+    }
+    printf("Batch   %d persons in %.3f s (%.0f bookings/s, %d booked)\n", size, seconds, booked / seconds, booked);
+    api_freeData(&data);
+    
+    free(documents);
+    free(pDocuments);
+    free(results);
+    remove(BENCH_DATA_FILE);
+}
+
+// Book appointments for a list of requests of several centers, one at a time and in parallel
+void bench_scheduler(int size) {
+    tApiData data;
+    tApiError error;
+    tApiError* results;
+    tDateTime timestamp;
+    char (*documents)[16];
+    char (*cps)[8];
+    const char** pDocuments;
+    const char** pCps;
+    FILE* fout;
+    double start;
+    double seconds;
+    int threads[] = {1, 2, 4, 8};
+    int booked;
+    int i, j;
+    
+    // Persons of 50 centers, each person requesting an appointment on its own center with enough doses for all
+    bench_writePersons(BENCH_DATA_FILE, size);
+    fout = fopen(BENCH_DATA_FILE, "a");
+    assert(fout != NULL);
+    for (i = 0; i < 50; i++) {
+        fprintf(fout, "VACCINE_LOT;01/04/2022;10:00;%05d;PFIZER;2;21;%d\n", 8001 + i, 2 * (size / 50 + 1));
+    }
+    fclose(fout);
+    
+    documents = malloc(size * sizeof(documents[0]));
+    cps = malloc(size * sizeof(cps[0]));
+    pDocuments = (const char**) malloc(size * sizeof(const char*));
+    pCps = (const char**) malloc(size * sizeof(const char*));
+    results = (tApiError*) malloc(size * sizeof(tApiError));
+    assert(documents != NULL && cps != NULL && pDocuments != NULL && pCps != NULL && results != NULL);
+    for (i = 0; i < size; i++) {
+        bench_document(documents[i], i);
+        sprintf(cps[i], "%05d", 8001 + (i % 50));
+        pDocuments[i] = documents[i];
+        pCps[i] = cps[i];
+    }
+    dateTime_parse(&timestamp, "01/04/2022", "10:00");
+    
+    api_initData(&data);
+    error = api_loadData(&data, BENCH_DATA_FILE, false);
+    assert(error == E_SUCCESS);
+    booked = 0;
+    start = bench_now();
+    for (i = 0; i < size; i++) {
+        if (api_findAppointmentAvailability(&data, pCps[i], pDocuments[i], timestamp) == E_SUCCESS) {
+            booked++;
+        }
+    }
+    seconds = bench_elapsed(start);
+    printf("Single      %d requests in %.3f s (%.0f bookings/s, %d booked)\n", size, seconds, booked / seconds, booked);
+    api_freeData(&data);
+    
+    for (j = 0; j < (int) (sizeof(threads) / sizeof(threads[0])); j++) {
+        api_initData(&data);
+        error = api_loadData(&data, BENCH_DATA_FILE, false);
+        assert(error == E_SUCCESS);
+        booked = 0;
+        start = bench_now();
+        api_findAppointmentAvailabilityParallel(&data, pCps, pDocuments, size, timestamp, results, threads[j]);
+        seconds = bench_elapsed(start);
+        for (i = 0; i < size; i++) {
+            if (results[i] == E_SUCCESS) {
+                booked++;
+            }
+        }
+        printf("Parallel %d  %d requests in %.3f s (%.0f bookings/s, %d booked)\n", threads[j], size, seconds, booked / seconds, booked);
+        api_freeData(&data);
+    }
+    
+    free(documents);
+    free(cps);
+    free(pDocuments);
+    free(pCps);
+    free(results);
+    remove(BENCH_DATA_FILE);
+}
+
+// Thread querying the shared data on the shared benchmark
+typedef struct {
+    tApiSharedData* shared;
+    // Set by the writer when it ends. If NULL, the reader does its maximum number of reads
+    bool* done;
+    // Documents of the persons of the data
+    char (*documents)[16];
+    int numDocuments;
+    // Latency of each query, in seconds
+    double* latencies;
+    int count;
+    int maxReads;
+    // Seed of the pseudo-random queries
+    unsigned int seed;
+} tBenchReader;
+
+// Run pseudo-random queries on the shared data, storing the latency of each one
+static void* bench_readShared(void* arg) {
+    tBenchReader* reader;
+    tCSVData appointments;
+    tCSVEntry entry;
+    tDateTime timestamp;
+    const char* document;
+    char cp[16];
+    double start;
+    bool done;
+    int n;
+    
+    reader = (tBenchReader*) arg;
+    done = false;
+    while (!done && reader->count < reader->maxReads) {
+        reader->seed = reader->seed * 1103515245 + 12345;
+        n = (reader->seed >> 8) % reader->numDocuments;
+        document = reader->documents[n];
+        sprintf(cp, "%05d", 8001 + (n % 50));
+        timestamp.date.day = 1 + (n % 28);
+        timestamp.date.month = 1 + (n % 12);
+        timestamp.date.year = 2022;
+        timestamp.time.hour = n % 24;
+        timestamp.time.minutes = n % 60;
+        
+        // Each query is one of the read functions of the shared data
+        start = bench_now();
+        switch (n % 3) {
+            case 0:
+                csv_init(&appointments);
+                api_sharedGetPersonAppointments(reader->shared, document, &appointments);
+                csv_free(&appointments);
+                break;
+            case 1:
+                api_sharedCheckAvailability(reader->shared, cp, "PFIZER", timestamp.date);
+                break;
+            default:
+                if (api_sharedGetVaccineLot(reader->shared, cp, "MODERNA", timestamp, &entry) == E_SUCCESS) {
+                    csv_freeEntry(&entry);
+                }
+                break;
+        }
+        reader->latencies[reader->count] = bench_elapsed(start);
+        reader->count++;
+        
+        // The end of the writer is checked from time to time, as it also takes the lock
+        if (reader->done != NULL && reader->count % 64 == 0) {
+            api_beginRead(reader->shared);
+            done = *(reader->done);
+            api_endRead(reader->shared);
+        }
+    }
+    
+    return NULL;
+}
+
+// Compare two latencies
+static int bench_latencyCmp(const void* a, const void* b) {
+    double latency1 = *(const double*) a;
+    double latency2 = *(const double*) b;
+    
+    return (latency1 > latency2) - (latency1 < latency2);
+}
+
+// Run the readers of the shared data, optionally with a writer adding the given entries, and print their latencies
+static void bench_sharedRound(const char* name, tApiSharedData* shared, tBenchReader* readers, tCSVEntry* entries, int numEntries) {
+    pthread_t threads[BENCH_NUM_READERS];
+    bool threaded[BENCH_NUM_READERS];
+    double* latencies;
+    double start;
+    double seconds;
+    double writerSeconds;
+    bool done;
+    int count;
+    int i;
+    
+    done = false;
+    start = bench_now();
+    for (i = 0; i < BENCH_NUM_READERS; i++) {
+        readers[i].done = (entries != NULL) ? &done : NULL;
+        readers[i].count = 0;
+        readers[i].seed = i + 1;
+        threaded[i] = (pthread_create(&(threads[i]), NULL, bench_readShared, &(readers[i])) == 0);
+    }
+    
+    // The writer applies one entry at a time, as a feed of updates
+    writerSeconds = 0;
+    if (entries != NULL) {
+        for (i = 0; i < numEntries; i++) {
+            api_sharedAddDataEntry(shared, entries[i]);
+        }
+        writerSeconds = bench_elapsed(start);
+        api_beginWrite(shared);
+        done = true;
+        api_endWrite(shared);
+    }
+    
+    count = 0;
+    for (i = 0; i < BENCH_NUM_READERS; i++) {
+        if (threaded[i]) {
+            pthread_join(threads[i], NULL);
+        } else {
+            bench_readShared(&(readers[i]));
+        }
+        count += readers[i].count;
+    }
+    seconds = bench_elapsed(start);
+    
+    latencies = (double*) malloc((count > 0 ? count : 1) * sizeof(double));
+    assert(latencies != NULL);
+    count = 0;
+    for (i = 0; i < BENCH_NUM_READERS; i++) {
+        memcpy(&(latencies[count]), readers[i].latencies, readers[i].count * sizeof(double));
+        count += readers[i].count;
+    }
+    qsort(latencies, count, sizeof(double), bench_latencyCmp);
+    
+    if (count > 0) {
+        printf("%-14s %d reads in %.3f s (%.0f reads/s), latency p50 %.2f us, p99 %.2f us, max %.2f us\n", name, count, seconds, count / seconds,
+            latencies[count / 2] * 1e6, latencies[(int) (count * 0.99)] * 1e6, latencies[count - 1] * 1e6);
+    }
+    if (entries != NULL) {
+        printf("%-14s %d entries in %.3f s (%.0f entries/s)\n", "Writer", numEntries, writerSeconds, numEntries / writerSeconds);
+    }
+    
+    free(latencies);
+}
+
+// Latency of the queries of several readers of the shared data, alone and while a writer adds entries
+void bench_shared(int size) {
+    tApiSharedData shared;
+    tApiError error;
+    tBenchReader readers[BENCH_NUM_READERS];
+    tCSVEntry* entries;
+    char (*documents)[16];
+    char buffer[1024];
+    int i;
+    
+    bench_writeData(BENCH_DATA_FILE, size);
+    
+    documents = malloc(size * sizeof(documents[0]));
+    entries = (tCSVEntry*) malloc(size * sizeof(tCSVEntry));
+    assert(documents != NULL && entries != NULL);
+    for (i = 0; i < size; i++) {
+        bench_document(documents[i], i);
+    }
+    
+    // Updates of the writer: new persons and lots of the existing centers
+    for (i = 0; i < size; i++) {
+        csv_initEntry(&(entries[i]));
+        if (i % 2 == 0) {
+            bench_document(buffer, size + i);
+            sprintf(buffer + strlen(buffer), ";Name;Surname;name@example.com;Street, 1;%05d;01/01/1990", 8001 + (i % 50));
+            csv_parseEntry(&(entries[i]), buffer, "PERSON");
+        } else {
+            sprintf(buffer, "%02d/%02d/2022;%02d:%02d;%05d;%s;2;21;%d", 1 + (i % 28), 1 + (i % 12), i % 24, i % 60, 8001 + (i % 50), (i % 4 == 1) ? "PFIZER" : "MODERNA", 10);
+            csv_parseEntry(&(entries[i]), buffer, "VACCINE_LOT");
+        }
+    }
+    
+    for (i = 0; i < BENCH_NUM_READERS; i++) {
+        readers[i].shared = &shared;
+        readers[i].documents = documents;
+        readers[i].numDocuments = size;
+        readers[i].maxReads = size;
+        readers[i].latencies = (double*) malloc(size * sizeof(double));
+        assert(readers[i].latencies != NULL);
+    }
+    
+    error = api_initSharedData(&shared);
+    assert(error == E_SUCCESS);
+    error = api_loadData(api_beginWrite(&shared), BENCH_DATA_FILE, false);
+    api_endWrite(&shared);
+    assert(error == E_SUCCESS);
+    
+    bench_sharedRound("Readers", &shared, readers, NULL, 0);
+    bench_sharedRound("Readers+writer", &shared, readers, entries, size);
+    
+    api_freeSharedData(&shared);
+    for (i = 0; i < BENCH_NUM_READERS; i++) {
+        free(readers[i].latencies);
+    }
+    for (i = 0; i < size; i++) {
+        csv_freeEntry(&(entries[i]));
+    }
+    free(entries);
+    free(documents);
+    remove(BENCH_DATA_FILE);
+}
+
+// Load the same data from a CSV file and from a snapshot, with an appointment for every 10 persons
+void bench_snapshot(int size) {
+    tApiData data;
+    tApiData loaded;
+    tApiError error;
+    tApiError* results;
+    tDateTime timestamp;
+    char (*documents)[16];
+    char (*cps)[8];
+    const char** pDocuments;
+    const char** pCps;
+    tCSVFile file;
+    double start;
+    double seconds;
+    double csvSeconds;
+    long snapshotSize;
+    int count;
+    int i;
+    
+    bench_writeData(BENCH_DATA_FILE, size);
+    
+    // Bookings are part of the data, but they are not on the CSV file
+    count = size / 10;
+    documents = malloc(count * sizeof(documents[0]));
+    cps = malloc(count * sizeof(cps[0]));
+    pDocuments = (const char**) malloc(count * sizeof(const char*));
+    pCps = (const char**) malloc(count * sizeof(const char*));
+    results = (tApiError*) malloc(count * sizeof(tApiError));
+    assert(documents != NULL && cps != NULL && pDocuments != NULL && pCps != NULL && results != NULL);
+    for (i = 0; i < count; i++) {
+        bench_document(documents[i], i);
+        sprintf(cps[i], "%05d", 8001 + (i % 50));
+        pDocuments[i] = documents[i];
+        pCps[i] = cps[i];
+    }
+    dateTime_parse(&timestamp, "01/01/2022", "10:00");
+    
+    api_initData(&data);
+    start = bench_now();
+    error = api_loadData(&data, BENCH_DATA_FILE, false);
+    csvSeconds = bench_elapsed(start);
+    assert(error == E_SUCCESS);
+    printf("CSV       %d persons in %.3f s\n", size, csvSeconds);
+    api_findAppointmentAvailabilityParallel(&data, pCps, pDocuments, count, timestamp, results, 1);
+    
+    start = bench_now();
+    error = api_saveSnapshot(&data, BENCH_SNAPSHOT_FILE);
+    seconds = bench_elapsed(start);
+    assert(error == E_SUCCESS);
+    snapshotSize = 0;
+    if (csv_openFile(&file, BENCH_SNAPSHOT_FILE)) {
+        snapshotSize = file.size;
+        csv_closeFile(&file);
+    }
+    printf("Save      %d persons in %.3f s (%.1f MB)\n", size, seconds, snapshotSize / 1048576.0);
+    
+    api_initData(&loaded);
+    start = bench_now();
+    error = api_loadSnapshot(&loaded, BENCH_SNAPSHOT_FILE);
+    seconds = bench_elapsed(start);
+    assert(error == E_SUCCESS);
+    printf("Snapshot  %d persons in %.3f s (%.1fx faster, %d persons, %d lots, %d centers)\n", size, seconds, csvSeconds / seconds, 
+        api_populationCount(&loaded), api_vaccineLotsCount(&loaded), api_centersCount(&loaded));
+    
+    api_freeData(&loaded);
+    api_freeData(&data);
+    free(documents);
+    free(cps);
+    free(pDocuments);
+    free(pCps);
+    free(results);
+    remove(BENCH_SNAPSHOT_FILE);
+    remove(BENCH_DATA_FILE);
+}
+
+// Book appointments for the persons from first to first + count - 1 in their center, syncing the log after each one if requested. Returns the number of booked persons
+static int bench_logBookings(tApiData* data, int first, int count, bool sync) {
+    tDateTime timestamp;
+    char document[16];
+    char cp[16];
+    int booked;
+    int i;
+    
+    dateTime_parse(&timestamp, "01/01/2022", "10:00");
+    booked = 0;
+    for (i = first; i < first + count; i++) {
+        bench_document(document, i);
+        sprintf(cp, "%05d", 8001 + (i % 50));
+        if (api_findAppointmentAvailability(data, cp, document, timestamp) == E_SUCCESS) {
+            booked++;
+        }
+        if (sync) {
+            api_syncLog(data);
+        }
+    }
+    
+    return booked;
+}
+
+// Book appointments for every 100 persons without a log, with group commit and syncing each change, and recover the data from the snapshot and the log
+void bench_log(int size) {
+    tApiData data;
+    tApiError error;
+    tWal log;
+    double start;
+    double seconds;
+    double csvSeconds;
+    long long syncs;
+    int count;
+    int booked;
+    
+    bench_writeData(BENCH_DATA_FILE, size);
+    remove(BENCH_SNAPSHOT_FILE);
+    remove(BENCH_LOG_FILE);
+    count = size / 100;
+    
+    // Current fallback: the whole CSV file is loaded again, and the changes are lost
+    api_initData(&data);
+    start = bench_now();
+    error = api_loadData(&data, BENCH_DATA_FILE, false);
+    csvSeconds = bench_elapsed(start);
+    assert(error == E_SUCCESS);
+    printf("CSV reload        %d persons in %.3f s\n", size, csvSeconds);
+    
+    start = bench_now();
+    booked = bench_logBookings(&data, 0, count, false);
+    seconds = bench_elapsed(start);
+    printf("No log            %d changes in %.3f s (%.0f changes/s)\n", booked, seconds, booked / seconds);
+    
+    // The data is saved once, and then every change is logged
+    error = api_saveSnapshot(&data, BENCH_SNAPSHOT_FILE);
+    assert(error == E_SUCCESS);
+    api_freeData(&data);
+    api_initData(&data);
+    error = api_recoverData(&data, &log, BENCH_SNAPSHOT_FILE, BENCH_LOG_FILE, WAL_GROUP_SIZE);
+    assert(error == E_SUCCESS);
+    
+    syncs = log.syncs;
+    start = bench_now();
+    booked = bench_logBookings(&data, count, count, false);
+    api_syncLog(&data);
+    seconds = bench_elapsed(start);
+    printf("Group commit      %d changes in %.3f s (%.0f changes/s, %lld syncs)\n", booked, seconds, booked / seconds, log.syncs - syncs);
+    
+    syncs = log.syncs;
+    start = bench_now();
+    booked = bench_logBookings(&data, 2 * count, count, true);
+    seconds = bench_elapsed(start);
+    printf("Sync each change  %d changes in %.3f s (%.0f changes/s, %lld syncs)\n", booked, seconds, booked / seconds, log.syncs - syncs);
+    
+    api_closeLog(&data);
+    api_freeData(&data);
+    
+    // Recovery replays the logged changes on the snapshot
+    api_initData(&data);
+    start = bench_now();
+    error = api_recoverData(&data, &log, BENCH_SNAPSHOT_FILE, BENCH_LOG_FILE, WAL_GROUP_SIZE);
+    seconds = bench_elapsed(start);
+    assert(error == E_SUCCESS);
+    printf("Recovery          %lld changes in %.3f s (%.1fx faster than the CSV reload)\n", data.lsn, seconds, csvSeconds / seconds);
+    
+    api_closeLog(&data);
+    api_freeData(&data);
+    remove(BENCH_SNAPSHOT_FILE);
+    remove(BENCH_LOG_FILE);
+    remove(BENCH_DATA_FILE);
+}
+
+// Write the next version of the file of bench_writeData. Of every 100 persons and lots, one is changed and another one is removed, and n / 100 new persons are added
+static void bench_writeDataVersion(const char* filename, int n) {
+    FILE *fout;
+    char document[16];
+    int i;
+    
+    fout = fopen(filename, "w");
+    assert(fout != NULL);
+    
+    for (i = 0; i < n + n / 100; i++) {
+        if (i < n && i % 100 == 51) {
+            continue;
+        }
+        bench_document(document, i);
+        fprintf(fout, "PERSON;%s;Name%d;Surname%d;person%d@%s;Street %d, %d;%05d;%02d/%02d/%04d\n",
+            document, i, i, i, (i % 100 == 50) ? "example.org" : "example.com", i % 1000, i % 100, 8001 + (i % 50), 1 + (i % 28), 1 + (i % 12), 1930 + (i % 90));
+    }
+    
+    for (i = 0; i < n / 10; i++) {
+        if (i % 100 == 51) {
+            continue;
+        }
+        fprintf(fout, "VACCINE_LOT;%02d/%02d/2022;%02d:%02d;%05d;%s;2;21;%d\n",
+            1 + (i % 28), 1 + (i % 12), i % 24, i % 60, 8001 + (i % 50), (i % 2) ? "PFIZER" : "MODERNA", 100 + (i % 200) + (i % 100 == 50));
+    }
+    
+    fclose(fout);
+}
+
+// Synchronize the data, with an appointment for every 100 persons, with a new version changing 2% of the rows, and compare it with a reset and reload
+void bench_sync(int size) {
+    tApiData data;
+    tApiError error;
+    tApiSyncStats stats;
+    double start;
+    double seconds;
+    double reloadSeconds;
+    int booked;
+    
+    bench_writeData(BENCH_DATA_FILE, size);
+    bench_writeDataVersion(BENCH_SYNC_FILE, size);
+    
+    api_initData(&data);
+    error = api_loadData(&data, BENCH_DATA_FILE, false);
+    assert(error == E_SUCCESS);
+    booked = bench_logBookings(&data, 0, size / 100, false);
+    
+    // Current refresh: all the data is loaded again, and the appointments are lost
+    start = bench_now();
+    error = api_loadData(&data, BENCH_SYNC_FILE, true);
+    reloadSeconds = bench_elapsed(start);
+    assert(error == E_SUCCESS);
+    printf("Reset and reload  %d persons in %.3f s (%d appointments lost)\n", api_populationCount(&data), reloadSeconds, booked);
+    
+    api_freeData(&data);
+    api_initData(&data);
+    error = api_loadData(&data, BENCH_DATA_FILE, false);
+    assert(error == E_SUCCESS);
+    bench_logBookings(&data, 0, size / 100, false);
+    
+    start = bench_now();
+    error = api_syncData(&data, BENCH_SYNC_FILE, &stats);
+    seconds = bench_elapsed(start);
+    assert(error == E_SUCCESS);
+    printf("Sync              %d inserted, %d changed, %d removed in %.3f s (%.1fx faster than the reload)\n",
+        stats.inserted, stats.changed, stats.removed, seconds, reloadSeconds / seconds);
+    
+    // Only the file is read when there are no changes
+    start = bench_now();
+    error = api_syncData(&data, BENCH_SYNC_FILE, &stats);
+    seconds = bench_elapsed(start);
+    assert(error == E_SUCCESS);
+    printf("Sync unchanged    %d rows in %.3f s (%.1fx faster than the reload)\n", stats.unchanged, seconds, reloadSeconds / seconds);
+    
+    api_freeData(&data);
+    remove(BENCH_SYNC_FILE);
+    remove(BENCH_DATA_FILE);
+}
+
+// Count the persons of a cp born before a date and find documents, scanning the population and its columns
+void bench_columns(int size) {
+    tApiData data;
+    tApiError error;
+    tPopulationColumns columns;
+    tPerson* person;
+    tDate limit;
+    char document[16];
+    double start;
+    double seconds;
+    double personSeconds;
+    long memory;
+    int limitDays;
+    int cp;
+    int numFind;
+    int count;
+    int found;
+    int i, j;
+    
+    bench_writePersons(BENCH_DATA_FILE, size);
+    
+    api_initData(&data);
+    error = api_loadData(&data, BENCH_DATA_FILE, false);
+    assert(error == E_SUCCESS);
+    
+    memory = bench_memoryUsage();
+    start = bench_now();
+    api_enableColumns(&data, &columns);
+    seconds = bench_elapsed(start);
+    printf("Build columns of  %d persons in %.3f s (%ld KB)\n", populationColumns_len(&columns), seconds, bench_memoryUsage() - memory);
+    
+    // Scan comparing the fields of each person
+    date_parse(&limit, "01/01/1950");
+    count = 0;
+    start = bench_now();
+    for (i = 0; i < BENCH_SCAN_ROUNDS; i++) {
+        for (j = 0; j < data.population.count; j++) {
+            person = &(data.population.elems[j]);
+            if (strcmp(person->cp, "08010") == 0 && date_cmp(person->birthday, limit) < 0) {
+                count++;
+            }
+        }
+    }
+    personSeconds = bench_elapsed(start);
+    printf("Scan persons      %d rounds, %d matches in %.3f s (%.1f ns/person)\n",
+        BENCH_SCAN_ROUNDS, count / BENCH_SCAN_ROUNDS, personSeconds, 1e9 * personSeconds / ((double) BENCH_SCAN_ROUNDS * size));
+    
+    // Scan comparing the integers of the cp and birthday columns
+    cp = internTable_findId(&(data.strings), "08010");
+    limitDays = date_toDays(limit);
+    found = 0;
+    start = bench_now();
+    for (i = 0; i < BENCH_SCAN_ROUNDS; i++) {
+        for (j = 0; j < columns.count; j++) {
+            if (columns.cps[j] == cp && columns.birthdays[j] < limitDays) {
+                found++;
+            }
+        }
+    }
+    seconds = bench_elapsed(start);
+    assert(found == count);
+    printf("Scan columns      %d rounds, %d matches in %.3f s (%.1f ns/person, %.1fx faster)\n",
+        BENCH_SCAN_ROUNDS, found / BENCH_SCAN_ROUNDS, seconds, 1e9 * seconds / ((double) BENCH_SCAN_ROUNDS * size), personSeconds / seconds);
+    
+    // Linear lookups by document are O(n), so only a sample is measured
+    numFind = size < 100 ? size : 100;
+    found = 0;
+    start = bench_now();
+    for (i = 0; i < numFind; i++) {
+        bench_document(document, (int)(((long long)i * size) / numFind));
+        if (bench_populationFindLinear(&(data.population), document) >= 0) {
+            found++;
+        }
+    }
+    personSeconds = bench_elapsed(start);
+    assert(found == numFind);
+    printf("Find persons      %d lookups in %.3f s (%.1f us/lookup)\n", numFind, personSeconds, 1e6 * personSeconds / numFind);
+    
+    found = 0;
+    start = bench_now();
+    for (i = 0; i < numFind; i++) {
+        bench_document(document, (int)(((long long)i * size) / numFind));
+        if (populationColumns_find(&columns, document) >= 0) {
+            found++;
+        }
+    }
+    seconds = bench_elapsed(start);
+    assert(found == numFind);
+    printf("Find columns      %d lookups in %.3f s (%.1f us/lookup, %.1fx faster)\n", numFind, seconds, 1e6 * seconds / numFind, personSeconds / seconds);
+    
+    populationColumns_free(&columns);
+    api_freeData(&data);
+    remove(BENCH_DATA_FILE);
+}
+
+// Select the persons born before 1960 of the cp 08001 to 08025 without appointments, scanning the persons and with cohort queries
+void bench_cohort(int size) {
+    tApiData data;
+    tApiError error;
+    tPopulationColumns columns;
+    tCohortSelection selection;
+    tCohortSelection booked;
+    tCohortQuery query;
+    tPersonAppointments* appointments;
+    tPerson* person;
+    tDate bornBefore;
+    char cp[16];
+    int cps[50];
+    int* rows;
+    double start;
+    double seconds;
+    double personSeconds;
+    int numPersons;
+    int count;
+    int i;
+    
+    numPersons = size < BENCH_COHORT_PERSONS ? size : BENCH_COHORT_PERSONS;
+    bench_writeData(BENCH_DATA_FILE, numPersons);
+    
+    api_initData(&data);
+    error = api_loadData(&data, BENCH_DATA_FILE, false);
+    assert(error == E_SUCCESS);
+    bench_logBookings(&data, 0, numPersons / 100, false);
+    
+    date_parse(&bornBefore, "01/01/1960");
+    cohortQuery_init(&query);
+    cohortQuery_bornBefore(&query, bornBefore);
+    cohortQuery_addCpRange(&query, &(data.strings), "08001", "08025");
+    query.withoutAppointment = true;
+    
+    // Scan comparing the fields of each person and looking up its appointments
+    count = 0;
+    start = bench_now();
+    for (i = 0; i < data.population.count; i++) {
+        person = &(data.population.elems[i]);
+        if (date_cmp(person->birthday, bornBefore) < 0 && strcmp(person->cp, "08001") >= 0 && strcmp(person->cp, "08025") <= 0) {
+            appointments = appointmentIndex_find(&(data.personAppointments), person->document);
+            if (appointments == NULL || appointments->count == 0) {
+                count++;
+            }
+        }
+    }
+    personSeconds = bench_elapsed(start);
+    printf("Scan persons      %d persons, %d selected in %.3f s (%.1f ns/person)\n", numPersons, count, personSeconds, 1e9 * personSeconds / numPersons);
+    
+    // Without columns, they are built for each query
+    start = bench_now();
+    error = api_selectCohort(&data, &query, &selection);
+    seconds = bench_elapsed(start);
+    assert(error == E_SUCCESS && cohortSelection_len(&selection) == count);
+    cohortSelection_free(&selection);
+    printf("Cohort query      %d persons, building the columns in %.3f s\n", numPersons, seconds);
+    
+    api_enableColumns(&data, &columns);
+    start = bench_now();
+    error = api_selectCohort(&data, &query, &selection);
+    seconds = bench_elapsed(start);
+    assert(error == E_SUCCESS && cohortSelection_len(&selection) == count);
+    cohortSelection_free(&selection);
+    printf("Cohort query      %d persons, with the columns in %.3f s (%.1f ns/person, %.1fx faster)\n", numPersons, seconds, 1e9 * seconds / numPersons, personSeconds / seconds);
+    
+    // Synthetic columns of size persons, with only the cp and birthdays filled, and an appointment for every 10 persons
+    api_disableColumns(&data);
+    populationColumns_free(&columns);
+    populationColumns_reserve(&columns, size);
+    for (i = 0; i < 50; i++) {
+        sprintf(cp, "%05d", 8001 + i);
+        cps[i] = internTable_findId(&(data.strings), cp);
+    }
+    cohortSelection_init(&booked, size);
+    for (i = 0; i < size; i++) {
+        columns.cps[i] = cps[i % 50];
+        columns.birthdays[i] = date_toDays(bornBefore) - 15000 + (i % 30000);
+        if (i % 10 == 0) {
+            cohortSelection_add(&booked, i);
+        }
+    }
+    columns.count = size;
+    
+    start = bench_now();
+    cohortQuery_select(&query, &columns, &booked, &selection);
+    seconds = bench_elapsed(start);
+    count = cohortSelection_len(&selection);
+    printf("Cohort query      %d persons, %d selected in %.3f s (%.2f ns/person)\n", size, count, seconds, 1e9 * seconds / size);
+    
+    rows = (int*) malloc((count + 1) * sizeof(int));
+    assert(rows != NULL);
+    start = bench_now();
+    i = cohortSelection_rows(&selection, rows);
+    seconds = bench_elapsed(start);
+    assert(i == count);
+    printf("Selected rows     %d rows listed in %.3f s\n", count, seconds);
+    
+    free(rows);
+    cohortSelection_free(&selection);
+    cohortSelection_free(&booked);
+    populationColumns_free(&columns);
+    cohortQuery_free(&query);
+    api_freeData(&data);
+    remove(BENCH_DATA_FILE);
+}
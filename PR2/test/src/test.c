@@ -5,6 +5,7 @@
 #include "test_pr1.h"
 #include "test_pr2.h"
 #include "test_pr3.h"
+#include "test_pr4.h"
 
 
 // Write data to file
@@ -72,4 +73,11 @@ void testSuite_run(tTestSuite* test_suite, const char* input, const char* readme
     }
     // Run tests
     run_pr3(test_suite, filename);
+    
+    //////////////////////
+    // Run tests for PR4
+    //////////////////////
+    
+    // PR4 tests use the same default data as PR3
+    run_pr4(test_suite, filename);
 }
@@ -98,7 +98,7 @@ bool run_pr1_ex2(tTestSection* test_section, const char* input) {
     if (fail_all) {
         failed = true;
     } else {
-        nVaccines = api_vaccineCount(data);        
+        nVaccines = api_vaccineCount(&data);        
         if (nVaccines != 1) {
             failed = true;
             passed = false;
@@ -115,7 +115,7 @@ bool run_pr1_ex2(tTestSection* test_section, const char* input) {
     if (fail_all) {
         failed = true;
     } else {        
-        nLots = api_vaccineLotsCount(data);
+        nLots = api_vaccineLotsCount(&data);
         if (nLots != 1) {
             failed = true;
             passed = false;
@@ -171,9 +171,9 @@ bool run_pr1_ex2(tTestSection* test_section, const char* input) {
         failed = true;
     } else {        
         error = api_freeData(&data);
-        nVaccines = api_vaccineCount(data);
-        nLots = api_vaccineLotsCount(data);
-        nPeople = api_populationCount(data);
+        nVaccines = api_vaccineCount(&data);
+        nLots = api_vaccineLotsCount(&data);
+        nPeople = api_populationCount(&data);
         if (error != E_SUCCESS || nVaccines != 0 || nLots != 0 || nPeople != 0) {
             failed = true;
             passed = false;
@@ -193,9 +193,9 @@ bool run_pr1_ex2(tTestSection* test_section, const char* input) {
         failed = true;
     } else {
         error = api_loadData(&data, input, true);
-        nVaccines = api_vaccineCount(data);
-        nLots = api_vaccineLotsCount(data);
-        nPeople = api_populationCount(data);
+        nVaccines = api_vaccineCount(&data);
+        nLots = api_vaccineLotsCount(&data);
+        nPeople = api_populationCount(&data);
         if (error != E_SUCCESS || nVaccines != 2 || nLots != 5 || nPeople != 2) {
             failed = true;
             passed = false;
@@ -236,9 +236,9 @@ bool run_pr1_ex3(tTestSection* test_section, const char* input) {
     
     if (!fail_all) {
         error = api_loadData(&data, input, true);
-        nVaccines = api_vaccineCount(data);
-        nLots = api_vaccineLotsCount(data);
-        nPeople = api_populationCount(data);
+        nVaccines = api_vaccineCount(&data);
+        nLots = api_vaccineLotsCount(&data);
+        nPeople = api_populationCount(&data);
         if (error != E_SUCCESS || nVaccines != 2 || nLots != 5 || nPeople != 2) {            
             passed = false;
             fail_all = true;
@@ -257,7 +257,7 @@ bool run_pr1_ex3(tTestSection* test_section, const char* input) {
         csv_initEntry(&entry);
         csv_initEntry(&refEntry);
         csv_parseEntry(&refEntry, "PFIZER;2;21", "VACCINE");
-        error = api_getVaccine(data, "PFIZER", &entry);
+        error = api_getVaccine(&data, "PFIZER", &entry);
         if (error != E_SUCCESS || !csv_equalsEntry(entry, refEntry)) {
             failed = true;
             passed = false;            
@@ -276,7 +276,7 @@ bool run_pr1_ex3(tTestSection* test_section, const char* input) {
         failed = true;
     } else {
         csv_initEntry(&entry);
-        error = api_getVaccine(data, "NO_VACC", &entry);
+        error = api_getVaccine(&data, "NO_VACC", &entry);
         if (error != E_VACCINE_NOT_FOUND) {
             failed = true;
             passed = false;            
@@ -297,7 +297,7 @@ bool run_pr1_ex3(tTestSection* test_section, const char* input) {
         csv_initEntry(&refEntry);
         csv_parseEntry(&refEntry, "01/01/2022;13:45;08001;PFIZER;2;21;350", "VACCINE_LOT");
         dateTime_parse(&timestamp, "01/01/2022", "13:45");
-        error = api_getVaccineLot(data, "08001", "PFIZER", timestamp, &entry);
+        error = api_getVaccineLot(&data, "08001", "PFIZER", timestamp, &entry);
         if (error != E_SUCCESS || !csv_equalsEntry(entry, refEntry)) {
             failed = true;
             passed = false;            
@@ -317,7 +317,7 @@ bool run_pr1_ex3(tTestSection* test_section, const char* input) {
     } else {
         csv_initEntry(&entry);
         dateTime_parse(&timestamp, "01/01/2022", "13:45");
-        error = api_getVaccineLot(data, "10001", "NO_VACC", timestamp, &entry);
+        error = api_getVaccineLot(&data, "10001", "NO_VACC", timestamp, &entry);
         if (error != E_LOT_NOT_FOUND) {
             failed = true;
             passed = false;            
@@ -338,7 +338,7 @@ bool run_pr1_ex3(tTestSection* test_section, const char* input) {
         csv_init(&refReport);
         csv_addStrEntry(&refReport, "MODERNA;1;0", "VACCINE");
         csv_addStrEntry(&refReport, "PFIZER;2;21", "VACCINE");        
-        error = api_getVaccines(data, &report);
+        error = api_getVaccines(&data, &report);
         if (error != E_SUCCESS || !csv_equals(report, refReport)) {
             failed = true;
             passed = false;            
@@ -363,7 +363,7 @@ bool run_pr1_ex3(tTestSection* test_section, const char* input) {
         csv_addStrEntry(&refReport, "02/01/2022;18:00;08500;MODERNA;1;0;100", "VACCINE_LOT");
         csv_addStrEntry(&refReport, "02/01/2022;15:45;08001;MODERNA;1;0;100", "VACCINE_LOT");
         csv_addStrEntry(&refReport, "03/01/2022;13:45;08500;PFIZER;2;21;70", "VACCINE_LOT");               
-        error = api_getVaccineLots(data, &report);
+        error = api_getVaccineLots(&data, &report);
         if (error != E_SUCCESS || !csv_equals(report, refReport)) {
             failed = true;
             passed = false;            
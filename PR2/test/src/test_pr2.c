@@ -28,7 +28,7 @@ bool run_pr2_ex1(tTestSection* test_section, const char* input) {
     tDate date;
     int i;
     tVaccineStockData stock;
-    tVaccineDailyStock* pDailyStockNode;    
+    tVaccineStock dayStock;
     tVaccine vModerna, vPfizer, vAAAA;
     bool passed = true;
     bool failed = false;
@@ -55,7 +55,7 @@ bool run_pr2_ex1(tTestSection* test_section, const char* input) {
     
     // Initialize the data    
     stockList_init(&stock);
-    if (stock.count != 0 || stock.first != NULL || stock.last != NULL) {
+    if (stock.count != 0 || stock.columns != NULL || stock.numColumns != 0) {
         failed = true;
         passed = false;
         fail_all = true;
@@ -76,16 +76,17 @@ bool run_pr2_ex1(tTestSection* test_section, const char* input) {
         // Check result
         if (stock.count != 1) {
             failed = true;
-        } else if (stock.first->count != 1 || stock.first == NULL || stock.last == NULL) {
+        } else if (stockList_find(&stock, date) != 0) {
             failed = true;
-        } else if (date_cmp(stock.first->day, date) != 0) {
+        } else if (date_cmp(stockList_getDate(&stock, 0), date) != 0) {
             failed = true;
-        } else if (stock.first->count != 1 || stock.first->first == NULL || stock.last->first == NULL) {
-            failed = true;
-        } else if (stock.first->first->elem.vaccine != &vModerna || stock.first->first->elem.doses != 50 || stock.first->first->next != NULL) {
-            failed = true;
-        } else if (stock.last->first->elem.vaccine != &vModerna || stock.last->first->elem.doses != 50 || stock.last->first->next != NULL) {
+        } else if (stockList_dayCount(&stock, 0) != 1) {
             failed = true;
+        } else {
+            dayStock = stockList_dayStock(&stock, 0, 0);
+            if (dayStock.vaccine != &vModerna || dayStock.doses != 50) {
+                failed = true;
+            }
         }
         
         if (failed) {
@@ -112,21 +113,19 @@ bool run_pr2_ex1(tTestSection* test_section, const char* input) {
             failed = true;
         } else {
             date_parse(&date, "02/01/2022");            
-            pDailyStockNode = stock.first;
             for (i=0; i<4 && !failed; i++) {
                 date.day = i + 2;
-                if (pDailyStockNode == NULL) {
+                if (i >= stock.count) {
                     failed = true;
                 } else {
-                    if (date_cmp(pDailyStockNode->day, date) != 0 || pDailyStockNode->count != 1 || pDailyStockNode->first == NULL) {
+                    if (date_cmp(stockList_getDate(&stock, i), date) != 0 || stockList_dayCount(&stock, i) != 1) {
                         failed = true;
-                    } else if (i<3 && pDailyStockNode->first->elem.doses != 50) {
+                    } else if (i<3 && stockList_dayStock(&stock, i, 0).doses != 50) {
                         failed = true;                        
-                    } else if (i==3 && pDailyStockNode->first->elem.doses != 60) {
+                    } else if (i==3 && stockList_dayStock(&stock, i, 0).doses != 60) {
                         failed = true;
                     }
                 }
-                pDailyStockNode = pDailyStockNode->next;
             }
         }
 
@@ -153,23 +152,21 @@ bool run_pr2_ex1(tTestSection* test_section, const char* input) {
             failed = true;
         } else {
             date_parse(&date, "01/01/2022");            
-            pDailyStockNode = stock.first;
             for (i=0; i<5 && !failed; i++) {
                 date.day = i + 1;
-                if (pDailyStockNode == NULL) {
+                if (i >= stock.count) {
                     failed = true;
                 } else {
-                    if (date_cmp(pDailyStockNode->day, date) != 0 || pDailyStockNode->count != 1 || pDailyStockNode->first == NULL) {
+                    if (date_cmp(stockList_getDate(&stock, i), date) != 0 || stockList_dayCount(&stock, i) != 1) {
                         failed = true;
-                    } else if (i<1 && pDailyStockNode->first->elem.doses != 2) {
+                    } else if (i<1 && stockList_dayStock(&stock, i, 0).doses != 2) {
                         failed = true;                        
-                    } else if (i>0 && i<4 && pDailyStockNode->first->elem.doses != 52) {
+                    } else if (i>0 && i<4 && stockList_dayStock(&stock, i, 0).doses != 52) {
                         failed = true;                        
-                    } else if (i==4 && pDailyStockNode->first->elem.doses != 62) {
+                    } else if (i==4 && stockList_dayStock(&stock, i, 0).doses != 62) {
                         failed = true;
                     }
                 }
-                pDailyStockNode = pDailyStockNode->next;
             }
         }
 
@@ -196,27 +193,25 @@ bool run_pr2_ex1(tTestSection* test_section, const char* input) {
             failed = true;
         } else {
             date_parse(&date, "01/01/2022");            
-            pDailyStockNode = stock.first;
             for (i=0; i<5 && !failed; i++) {
                 date.day = i + 1;
-                if (pDailyStockNode == NULL) {
+                if (i >= stock.count) {
                     failed = true;
                 } else {
-                    if (date_cmp(pDailyStockNode->day, date) != 0 || pDailyStockNode->first == NULL) {
+                    if (date_cmp(stockList_getDate(&stock, i), date) != 0 || stockList_dayCount(&stock, i) == 0) {
                         failed = true;
-                    } else if (i<1 && pDailyStockNode->first->elem.doses != 2) {
+                    } else if (i<1 && stockList_dayStock(&stock, i, 0).doses != 2) {
                         failed = true;                        
-                    } else if (i>0 && i<4 && pDailyStockNode->first->elem.doses != 52) {
+                    } else if (i>0 && i<4 && stockList_dayStock(&stock, i, 0).doses != 52) {
                         failed = true;            
-                    } else if (i>=2 && pDailyStockNode->count != 2) {
+                    } else if (i>=2 && stockList_dayCount(&stock, i) != 2) {
                         failed = true;
-                    } else if (i<2 && pDailyStockNode->count != 1) {
+                    } else if (i<2 && stockList_dayCount(&stock, i) != 1) {
                         failed = true;                    
-                    } else if (i==4 && pDailyStockNode->first->elem.doses != 62) {
+                    } else if (i==4 && stockList_dayStock(&stock, i, 0).doses != 62) {
                         failed = true;
                     }
                 }
-                pDailyStockNode = pDailyStockNode->next;
             }
         }
 
@@ -243,23 +238,21 @@ bool run_pr2_ex1(tTestSection* test_section, const char* input) {
             failed = true;
         } else {
             date_parse(&date, "01/01/2022");            
-            pDailyStockNode = stock.first;
             for (i=0; i<5 && !failed; i++) {
                 date.day = i + 1;
-                if (pDailyStockNode == NULL) {
+                if (i >= stock.count) {
                     failed = true;
                 } else {
-                    if (date_cmp(pDailyStockNode->day, date) != 0 || pDailyStockNode->count != 1 || pDailyStockNode->first == NULL) {
+                    if (date_cmp(stockList_getDate(&stock, i), date) != 0 || stockList_dayCount(&stock, i) != 1) {
                         failed = true;
-                    } else if (i<1 && pDailyStockNode->first->elem.doses != 2) {
+                    } else if (i<1 && stockList_dayStock(&stock, i, 0).doses != 2) {
                         failed = true;                        
-                    } else if (i>0 && i<4 && pDailyStockNode->first->elem.doses != 52) {
+                    } else if (i>0 && i<4 && stockList_dayStock(&stock, i, 0).doses != 52) {
                         failed = true;                        
-                    } else if (i==4 && pDailyStockNode->first->elem.doses != 62) {
+                    } else if (i==4 && stockList_dayStock(&stock, i, 0).doses != 62) {
                         failed = true;
                     }
                 }
-                pDailyStockNode = pDailyStockNode->next;
             }
         }
 
@@ -286,27 +279,25 @@ bool run_pr2_ex1(tTestSection* test_section, const char* input) {
             failed = true;
         } else {
             date_parse(&date, "01/01/2022");            
-            pDailyStockNode = stock.first;
             for (i=0; i<5 && !failed; i++) {
                 date.day = i + 1;
-                if (pDailyStockNode == NULL) {
+                if (i >= stock.count) {
                     failed = true;
                 } else {
-                    if (date_cmp(pDailyStockNode->day, date) != 0) {
+                    if (date_cmp(stockList_getDate(&stock, i), date) != 0) {
                         failed = true;
-                    } else if((i<2 || i >3) && (pDailyStockNode->count != 1 || pDailyStockNode->first == NULL)) {
+                    } else if((i<2 || i >3) && stockList_dayCount(&stock, i) != 1) {
                         failed = true;                    
-                    } else if (i<1 && pDailyStockNode->first->elem.doses != 2 ) {
+                    } else if (i<1 && stockList_dayStock(&stock, i, 0).doses != 2 ) {
                         failed = true;                        
-                    } else if (i>0 && i<2 && pDailyStockNode->first->elem.doses != 52) {
+                    } else if (i>0 && i<2 && stockList_dayStock(&stock, i, 0).doses != 52) {
                         failed = true;                        
-                    } else if (i>=2 && i<4 && pDailyStockNode->count != 0) {
+                    } else if (i>=2 && i<4 && stockList_dayCount(&stock, i) != 0) {
                         failed = true;                        
-                    } else if (i==4 && pDailyStockNode->first->elem.doses != 10) {
+                    } else if (i==4 && stockList_dayStock(&stock, i, 0).doses != 10) {
                         failed = true;
                     }
                 }
-                pDailyStockNode = pDailyStockNode->next;
             }
         }
 
@@ -383,11 +374,11 @@ bool run_pr2_ex1(tTestSection* test_section, const char* input) {
         // Check result
         if (stock.count != 5) {
             failed = true;
-        } else if (stock.first->count != 2) {
+        } else if (stockList_dayCount(&stock, 0) != 2) {
             failed = true;
-        } else if (stock.first->first->elem.vaccine != &vAAAA) {
+        } else if (stockList_dayStock(&stock, 0, 0).vaccine != &vAAAA) {
             failed = true;
-        } else if (stock.first->first->next->elem.vaccine != &vModerna) {
+        } else if (stockList_dayStock(&stock, 0, 1).vaccine != &vModerna) {
             failed = true;
         }
 
@@ -454,9 +445,9 @@ bool run_pr2_ex2(tTestSection* test_section, const char* input) {
             failed = true;
         } else if (center.stock.count != 0) {
             failed = true;
-        } else if (center.stock.first != NULL) {
+        } else if (center.stock.columns != NULL) {
             failed = true;
-        } else if (center.stock.last != NULL) {
+        } else if (center.stock.numColumns != 0) {
             failed = true;
         }
 
@@ -479,7 +470,7 @@ bool run_pr2_ex2(tTestSection* test_section, const char* input) {
     
         // Initialize the data    
         centerList_init(&list);
-        if (list.count != 0 || list.first != NULL) {
+        if (list.count != 0 || list.sorted != NULL) {
             failed = true;
             passed = false;
             fail_all = true;
@@ -501,7 +492,7 @@ bool run_pr2_ex2(tTestSection* test_section, const char* input) {
         // Insert a new center
         centerList_insert(&list, "08004");        
         
-        if (list.count != 1 || list.first == NULL || strcmp(list.first->elem.cp, "08004") != 0) {
+        if (list.count != 1 || strcmp(centerList_get(&list, 0)->cp, "08004") != 0) {
             failed = true;
             passed = false;
             fail_all = true;
@@ -519,11 +510,11 @@ bool run_pr2_ex2(tTestSection* test_section, const char* input) {
         // Insert a new center
         centerList_insert(&list, "08005");        
         
-        if (list.count != 2 || list.first == NULL || strcmp(list.first->elem.cp, "08004") != 0) {
+        if (list.count != 2 || strcmp(centerList_get(&list, 0)->cp, "08004") != 0) {
             failed = true;
             passed = false;
             fail_all = true;
-        } else if (list.first->next == NULL || strcmp(list.first->next->elem.cp, "08005") != 0) {
+        } else if (strcmp(centerList_get(&list, 1)->cp, "08005") != 0) {
             failed = true;
             passed = false;
             fail_all = true;
@@ -532,15 +523,15 @@ bool run_pr2_ex2(tTestSection* test_section, const char* input) {
         // Insert a new center
         centerList_insert(&list, "08001");        
         
-        if (list.count != 3 || list.first == NULL || strcmp(list.first->elem.cp, "08001") != 0) {
+        if (list.count != 3 || strcmp(centerList_get(&list, 0)->cp, "08001") != 0) {
             failed = true;
             passed = false;
             fail_all = true;
-        } else if (list.first->next == NULL || strcmp(list.first->next->elem.cp, "08004") != 0) {
+        } else if (strcmp(centerList_get(&list, 1)->cp, "08004") != 0) {
             failed = true;
             passed = false;
             fail_all = true;
-        } else if (list.first->next->next == NULL || strcmp(list.first->next->next->elem.cp, "08005") != 0) {
+        } else if (strcmp(centerList_get(&list, 2)->cp, "08005") != 0) {
             failed = true;
             passed = false;
             fail_all = true;
@@ -594,7 +585,7 @@ bool run_pr2_ex2(tTestSection* test_section, const char* input) {
         
         // Initialize the data    
         centerList_free(&list);
-        if (list.count != 0 || list.first != NULL) {
+        if (list.count != 0 || list.sorted != NULL) {
             failed = true;
             passed = false;
             fail_all = true;
@@ -629,7 +620,7 @@ bool run_pr2_ex3(tTestSection* test_section, const char* input) {
         passed = false; 
         failed = true;
         fail_all = true;
-    } else if (api_centersCount(data) != 0) {
+    } else if (api_centersCount(&data) != 0) {
         passed = false; 
         failed = true;
         fail_all = true;
@@ -645,10 +636,10 @@ bool run_pr2_ex3(tTestSection* test_section, const char* input) {
     start_test(test_section, "PR2_EX3_2", "Load API data");
     if (!fail_all) {
         error = api_loadData(&data, input, true);
-        nVaccines = api_vaccineCount(data);
-        nLots = api_vaccineLotsCount(data);
-        nPeople = api_populationCount(data);
-        nCenters = api_centersCount(data);
+        nVaccines = api_vaccineCount(&data);
+        nLots = api_vaccineLotsCount(&data);
+        nPeople = api_populationCount(&data);
+        nCenters = api_centersCount(&data);
         if (error != E_SUCCESS || nVaccines != 2 || nLots != 5 || nPeople != 2) {            
             passed = false; 
             failed = true;
@@ -171,7 +171,7 @@ bool run_pr3_ex1(tTestSection* test_section, const char* input) {
     failed = fail_all;
     start_test(test_section, "PR3_EX1_8", "Search for an existing appointment");    
     if (!fail_all) {        
-        pos = appointmentData_find(data, &person2, 0);
+        pos = appointmentData_find(&data, &person2, 0);
         if (pos != 0) {
             failed = true;
             fail_all = true;
@@ -186,7 +186,7 @@ bool run_pr3_ex1(tTestSection* test_section, const char* input) {
     failed = fail_all;
     start_test(test_section, "PR3_EX1_9", "Search for a non existing appointment");    
     if (!fail_all) {        
-        pos = appointmentData_find(data, &person1, 0);
+        pos = appointmentData_find(&data, &person1, 0);
         if (pos != -1) {
             failed = true;
             fail_all = true;
@@ -201,7 +201,7 @@ bool run_pr3_ex1(tTestSection* test_section, const char* input) {
     failed = fail_all;
     start_test(test_section, "PR3_EX1_10", "Search for an existing appointment but invalid start position");    
     if (!fail_all) {        
-        pos = appointmentData_find(data, &person2, 1);
+        pos = appointmentData_find(&data, &person2, 1);
         if (pos != -1) {
             failed = true;
             fail_all = true;
@@ -315,7 +315,7 @@ bool run_pr3_ex2(tTestSection* test_section, const char* input) {
     start_test(test_section, "PR3_EX2_4", "Get appointments for a non-existing person");
     if (!fail_all) {        
         csv_init(&csv_report);
-        error = api_getPersonAppointments(data, "67654329J", &csv_report);
+        error = api_getPersonAppointments(&data, "67654329J", &csv_report);
         csv_free(&csv_report);
         if (error != E_PERSON_NOT_FOUND) {
             failed = true;
@@ -332,7 +332,7 @@ bool run_pr3_ex2(tTestSection* test_section, const char* input) {
     start_test(test_section, "PR3_EX2_5", "Get appointments for a valid person without appointments");
     if (!fail_all) {        
         csv_init(&csv_report);
-        error = api_getPersonAppointments(data, "98765432J", &csv_report);        
+        error = api_getPersonAppointments(&data, "98765432J", &csv_report);        
         if (error != E_SUCCESS || csv_report.count !=0) {
             failed = true;
             fail_all = true;
@@ -357,7 +357,7 @@ bool run_pr3_ex2(tTestSection* test_section, const char* input) {
         } else {
             // Check report
             csv_init(&csv_report);
-            error = api_getPersonAppointments(data, "98765432J", &csv_report);
+            error = api_getPersonAppointments(&data, "98765432J", &csv_report);
             if (error != E_SUCCESS || csv_report.count != 1) {
                 failed = true;
                 fail_all = true;
@@ -383,7 +383,7 @@ bool run_pr3_ex2(tTestSection* test_section, const char* input) {
             passed = false;
         } else {
             csv_init(&csv_report);
-            error = api_getPersonAppointments(data, "87654321K", &csv_report);
+            error = api_getPersonAppointments(&data, "87654321K", &csv_report);
             if (error != E_SUCCESS || csv_report.count != 2) {
                 failed = true;
                 fail_all = true;
@@ -434,7 +434,7 @@ bool run_pr3_ex3(tTestSection* test_section, const char* input) {
     start_test(test_section, "PR3_EX3_1", "Check availability for a one-shot vaccine with availability");
     if (!fail_all) {
         date_parse(&date1, "05/04/2022");
-        if (!api_checkAvailability(data, "08001", "MODERNA", date1)) {
+        if (!api_checkAvailability(&data, "08001", "MODERNA", date1)) {
             failed = true;
             fail_all = true;
             passed = false;
@@ -449,7 +449,7 @@ bool run_pr3_ex3(tTestSection* test_section, const char* input) {
     start_test(test_section, "PR3_EX3_2", "Check availability for a two-shots vaccine with availability");
     if (!fail_all) {
         date_parse(&date2, "01/04/2022");
-        if (!api_checkAvailability(data, "08001", "PFIZER", date2)) {
+        if (!api_checkAvailability(&data, "08001", "PFIZER", date2)) {
             failed = true;
             fail_all = true;
             passed = false;
@@ -464,7 +464,7 @@ bool run_pr3_ex3(tTestSection* test_section, const char* input) {
     start_test(test_section, "PR3_EX3_3", "Check availability for a one-shot vaccine without availability");
     if (!fail_all) {
         date_parse(&date1, "01/04/2022");
-        if (api_checkAvailability(data, "08001", "MODERNA", date1)) {
+        if (api_checkAvailability(&data, "08001", "MODERNA", date1)) {
             failed = true;
             fail_all = true;
             passed = false;
@@ -479,7 +479,7 @@ bool run_pr3_ex3(tTestSection* test_section, const char* input) {
     start_test(test_section, "PR3_EX3_4", "Check availability for a two-shots vaccine without availability I");
     if (!fail_all) {
         date_parse(&date2, "30/03/2022");
-        if (api_checkAvailability(data, "08500", "PFIZER", date2)) {
+        if (api_checkAvailability(&data, "08500", "PFIZER", date2)) {
             failed = true;
             fail_all = true;
             passed = false;
@@ -494,7 +494,7 @@ bool run_pr3_ex3(tTestSection* test_section, const char* input) {
     start_test(test_section, "PR3_EX3_5", "Check availability for a two-shots vaccine without availability II");
     if (!fail_all) {
         date_parse(&date2, "02/04/2022");
-        if (api_checkAvailability(data, "08500", "PFIZER", date2)) {
+        if (api_checkAvailability(&data, "08500", "PFIZER", date2)) {
             failed = true;
             fail_all = true;
             passed = false;
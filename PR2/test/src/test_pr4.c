@@ -0,0 +1,2746 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test_pr4.h"
+#include "test.h"
+#include "api.h"
+#include "array.h"
+
+// Number of persons used to test the index of the population
+#define POPULATION_NUM_PERSONS 100
+
+// Length of the address used to test long lines
+#define LONG_ADDRESS_LENGTH 5000
+
+// Number of persons of the file used to test the parallel load
+#define PARALLEL_NUM_PERSONS 2000
+
+// Number of threads used to test the parallel load
+#define PARALLEL_NUM_THREADS 4
+
+// Number of appointments used to test the sorted appointments
+#define APPOINTMENT_NUM_PERSONS 1000
+
+// Number of different timestamps of the appointments
+#define APPOINTMENT_NUM_SLOTS 50
+
+// Number of centers used to test the directory of centers
+#define DIRECTORY_NUM_CENTERS 1000
+
+// Number of vaccines used to test the catalog of vaccines
+#define CATALOG_NUM_VACCINES 100
+
+// Number of lots used to test the index of lots
+#define INDEX_NUM_LOTS 500
+
+// Number of entries added by the writer while the shared data is read
+#define SHARED_NUM_ENTRIES 2000
+
+// Number of threads reading the shared data
+#define SHARED_NUM_READERS 4
+
+// File used to test the snapshots
+#define SNAPSHOT_FILE "test_data_pr4.snap"
+
+// Files used to test the log of changes
+#define LOG_FILE "test_data_pr4.wal"
+#define LOG_SNAPSHOT_FILE "test_data_pr4_wal.snap"
+
+// Number of changes synced at once on the log of changes
+#define LOG_GROUP_SIZE 4
+
+// Files used to test the synchronization with a new version of a feed
+#define SYNC_FILE "test_data_pr4_sync.csv"
+#define SYNC_BAD_FILE "test_data_pr4_sync_bad.csv"
+#define SYNC_LOG_FILE "test_data_pr4_sync.wal"
+#define SYNC_SNAPSHOT_FILE "test_data_pr4_sync.snap"
+
+// File used to test the population stored by columns
+#define COLUMNS_FILE "test_data_pr4_columns.csv"
+
+// Person with a document longer than the rows of the document column
+#define COLUMNS_LONG_PERSON "PERSON;X1234567890123456789Z;Maria;Garcia;maria.garcia@example.com;Long street, 7;08999;01/01/1950"
+
+// Number of times a row is changed to test the heaps of the columns, alternating a short and a long name
+#define COLUMNS_NUM_UPDATES 1000
+#define COLUMNS_LONG_NAME "Maria Dolores Concepcion Garcia"
+
+// File and number of persons used to test the cohort queries
+#define COHORT_FILE "test_data_pr4_cohort.csv"
+#define COHORT_NUM_PERSONS 1000
+
+// Range of cp of the cohort queries
+#define COHORT_FIRST_CP "08002"
+#define COHORT_LAST_CP "08005"
+
+// Person of the cohort added to test the cohort queries with the population stored by columns
+#define COHORT_NEW_PERSON "PERSON;99999999R;Name;Surname;mail@example.com;Street;08004;15/05/1940"
+
+// Run all tests for PR4
+bool run_pr4(tTestSuite* test_suite, const char* input) {
+    bool ok = true;
+    tTestSection* section = NULL;
+
+    assert(test_suite != NULL);
+
+    testSuite_addSection(test_suite, "PR4", "Tests for PR4 exercices");
+
+    section = testSuite_getSection(test_suite, "PR4");
+    assert(section != NULL);
+
+    ok = run_pr4_ex1(section, input);
+    ok = run_pr4_ex2(section, input) && ok;
+    ok = run_pr4_ex3(section, input) && ok;
+    ok = run_pr4_ex4(section, input) && ok;
+    ok = run_pr4_ex5(section, input) && ok;
+    ok = run_pr4_ex6(section, input) && ok;
+    ok = run_pr4_ex7(section, input) && ok;
+    ok = run_pr4_ex8(section, input) && ok;
+    ok = run_pr4_ex9(section, input) && ok;
+    ok = run_pr4_ex10(section, input) && ok;
+    ok = run_pr4_ex11(section, input) && ok;
+    ok = run_pr4_ex12(section, input) && ok;
+    ok = run_pr4_ex13(section, input) && ok;
+    ok = run_pr4_ex14(section, input) && ok;
+    ok = run_pr4_ex15(section, input) && ok;
+    ok = run_pr4_ex16(section, input) && ok;
+    ok = run_pr4_ex17(section, input) && ok;
+    ok = run_pr4_ex18(section, input) && ok;
+    ok = run_pr4_ex19(section, input) && ok;
+    ok = run_pr4_ex20(section, input) && ok;
+    ok = run_pr4_ex21(section, input) && ok;
+
+    return ok;
+}
+
+// Check that each person of the population is found on its position, and the removed document is not found
+static bool test_populationIndex(const tPopulation* population, const char* removed) {
+    int i;
+    
+    for (i = 0; i < population->count; i++) {
+        if (population_find(population, population->elems[i].document) != i) {
+            return false;
+        }
+    }
+    
+    return removed == NULL || population_find(population, removed) < 0;
+}
+
+// Run all tests for Exercice 1 of PR4
+bool run_pr4_ex1(tTestSection* test_section, const char* input) {
+    tPopulation population;
+    tCSVEntry entry;
+    tPerson person;
+    char line[128];
+    char document[16];
+    int i;
+    bool passed = true;
+    bool failed = false;
+    
+    /////////////////////////////
+    /////  PR4 EX1 TEST 1  //////
+    /////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX1_1", "Find the persons added, growing the population");
+    population_init(&population);
+    for (i = 0; i < POPULATION_NUM_PERSONS; i++) {
+        sprintf(line, "%08dP;Name;Surname;mail@example.com;Street;08001;01/01/1980", i);
+        csv_initEntry(&entry);
+        csv_parseEntry(&entry, line, "PERSON");
+        person_init(&person);
+        person_parse(&person, entry);
+        population_add(&population, person);
+        if (population.count != i + 1 || population_find(&population, person.document) != i) {
+            failed = true;
+        }
+        // Persons added before the population grew are still found, and a repeated person is not added
+        population_add(&population, person);
+        if (population.count != i + 1 || population_find(&population, "00000000P") != 0) {
+            failed = true;
+        }
+        person_free(&person);
+        csv_freeEntry(&entry);
+    }
+    if (population.count != POPULATION_NUM_PERSONS || !test_populationIndex(&population, "99999999P")) {
+        failed = true;
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX1_1", !failed);
+    
+    /////////////////////////////
+    /////  PR4 EX1 TEST 2  //////
+    /////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX1_2", "Find the persons after removing them");
+    // Removing a person shifts the next ones
+    population_del(&population, "00000000P");
+    if (population.count != POPULATION_NUM_PERSONS - 1 || !test_populationIndex(&population, "00000000P")) {
+        failed = true;
+    }
+    // Remove a person in the middle and the last one
+    sprintf(document, "%08dP", POPULATION_NUM_PERSONS / 2);
+    population_del(&population, document);
+    if (population.count != POPULATION_NUM_PERSONS - 2 || !test_populationIndex(&population, document)) {
+        failed = true;
+    }
+    sprintf(document, "%08dP", POPULATION_NUM_PERSONS - 1);
+    population_del(&population, document);
+    if (population.count != POPULATION_NUM_PERSONS - 3 || !test_populationIndex(&population, document)) {
+        failed = true;
+    }
+    // Removing a position moves the last person to it
+    sprintf(document, "%08dP", POPULATION_NUM_PERSONS - 2);
+    population_removeAt(&population, 0);
+    if (population.count != POPULATION_NUM_PERSONS - 4 || population_find(&population, document) != 0 || !test_populationIndex(&population, "00000001P")) {
+        failed = true;
+    }
+    population_free(&population);
+    if (population.count != 0 || population_find(&population, "00000002P") >= 0) {
+        failed = true;
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX1_2", !failed);
+    
+    return passed;
+}
+
+// Run all tests for Exercice 2 of PR4
+bool run_pr4_ex2(tTestSection* test_section, const char* input) {
+    tPopulation population;
+    int* elems;
+    int capacity;
+    int i;
+    bool passed = true;
+    bool failed = false;
+    
+    /////////////////////////////
+    /////  PR4 EX2 TEST 1  //////
+    /////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX2_1", "Double the capacity of an array when it is full");
+    elems = NULL;
+    capacity = 0;
+    elems = (int*) array_grow(elems, &capacity, 1, sizeof(int));
+    if (elems == NULL || capacity != ARRAY_MIN_CAPACITY) {
+        failed = true;
+    }
+    for (i = 0; i < ARRAY_MIN_CAPACITY; i++) {
+        elems[i] = i;
+    }
+    // The capacity only changes when the array is full
+    elems = (int*) array_grow(elems, &capacity, ARRAY_MIN_CAPACITY, sizeof(int));
+    if (capacity != ARRAY_MIN_CAPACITY) {
+        failed = true;
+    }
+    elems = (int*) array_grow(elems, &capacity, ARRAY_MIN_CAPACITY + 1, sizeof(int));
+    if (capacity != 2 * ARRAY_MIN_CAPACITY) {
+        failed = true;
+    }
+    // A size beyond the double of the capacity is rounded to the next double
+    elems = (int*) array_grow(elems, &capacity, 4 * ARRAY_MIN_CAPACITY + 1, sizeof(int));
+    if (capacity != 8 * ARRAY_MIN_CAPACITY) {
+        failed = true;
+    }
+    for (i = 0; i < ARRAY_MIN_CAPACITY; i++) {
+        if (elems[i] != i) {
+            failed = true;
+        }
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX2_1", !failed);
+    
+    /////////////////////////////
+    /////  PR4 EX2 TEST 2  //////
+    /////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX2_2", "Reserve the exact capacity of an array");
+    elems = (int*) array_reserve(elems, &capacity, 10 * ARRAY_MIN_CAPACITY + 1, sizeof(int));
+    if (capacity != 10 * ARRAY_MIN_CAPACITY + 1) {
+        failed = true;
+    }
+    // A smaller size keeps the capacity, and growing doubles the reserved capacity
+    elems = (int*) array_reserve(elems, &capacity, ARRAY_MIN_CAPACITY, sizeof(int));
+    if (capacity != 10 * ARRAY_MIN_CAPACITY + 1) {
+        failed = true;
+    }
+    elems = (int*) array_grow(elems, &capacity, 10 * ARRAY_MIN_CAPACITY + 2, sizeof(int));
+    if (capacity != 20 * ARRAY_MIN_CAPACITY + 2) {
+        failed = true;
+    }
+    for (i = 0; i < ARRAY_MIN_CAPACITY; i++) {
+        if (elems[i] != i) {
+            failed = true;
+        }
+    }
+    free(elems);
+    // The population reserves the exact number of persons
+    population_init(&population);
+    population_reserve(&population, POPULATION_NUM_PERSONS);
+    if (population.capacity != POPULATION_NUM_PERSONS || population.count != 0) {
+        failed = true;
+    }
+    population_free(&population);
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX2_2", !failed);
+    
+    return passed;
+}
+
+// Run all tests for Exercice 3 of PR4
+bool run_pr4_ex3(tTestSection* test_section, const char* input) {
+    tApiData data;
+    tApiError error;
+    tCSVView view;
+    char* buffer;
+    const char* line = "PERSON;87654321K;John;Smith;john.smith@example.com;My street, 25;08001;30/12/1980";
+    int pos;
+    bool passed = true;
+    bool failed = false;
+    bool fail_all = false;
+    
+    /////////////////////////////
+    /////  PR4 EX3 TEST 1  //////
+    /////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX3_1", "Parse a CSV line as views");
+    csv_parseView(&view, line, strlen(line), NULL);
+    if (!csv_fieldEquals(view.type, "PERSON") || view.numFields != 7) {
+        failed = true;
+    } else if (!csv_fieldEquals(view.fields[0], "87654321K") || !csv_fieldEquals(view.fields[4], "My street, 25")) {
+        failed = true;
+    } else if (!csv_fieldEquals(view.fields[6], "30/12/1980") || csv_fieldEquals(view.fields[6], "30/12/19")) {
+        failed = true;
+    }
+    if (failed) {
+        passed = false;
+        fail_all = true;
+    }
+    end_test(test_section, "PR4_EX3_1", !failed);
+    
+    /////////////////////////////
+    /////  PR4 EX3 TEST 2  //////
+    /////////////////////////////
+    failed = fail_all;
+    start_test(test_section, "PR4_EX3_2", "Load a file with lines longer than the read buffer");
+    if (!fail_all) {
+        // Create a file with a very long address
+        buffer = (char*) malloc(LONG_ADDRESS_LENGTH + 512);
+        assert(buffer != NULL);
+        strcpy(buffer, "PERSON;98765432J;Jane;Doe;jane.doe@example.com;");
+        pos = strlen(buffer);
+        memset(buffer + pos, 'a', LONG_ADDRESS_LENGTH);
+        strcpy(buffer + pos + LONG_ADDRESS_LENGTH, ";08500;12/01/1995\n");
+        strcat(buffer, "VACCINE_LOT;01/01/2022;13:45;08500;PFIZER;2;21;300\n");
+        save_data("test_data_pr4_long.csv", buffer);
+        free(buffer);
+        
+        api_initData(&data);
+        error = api_loadData(&data, "test_data_pr4_long.csv", true);
+        pos = population_find(&(data.population), "98765432J");
+        if (error != E_SUCCESS || api_populationCount(&data) != 1 || api_vaccineLotsCount(&data) != 1 || pos < 0) {
+            failed = true;
+        } else if (strlen(data.population.elems[pos].address) != LONG_ADDRESS_LENGTH || strcmp(data.population.elems[pos].cp, "08500") != 0) {
+            failed = true;
+        }
+        api_freeData(&data);
+        
+        if (failed) {
+            passed = false;
+        }
+    }
+    end_test(test_section, "PR4_EX3_2", !failed);
+    
+    /////////////////////////////
+    /////  PR4 EX3 TEST 3  //////
+    /////////////////////////////
+    failed = fail_all;
+    start_test(test_section, "PR4_EX3_3", "Load a file with Windows line ends and empty lines");
+    if (!fail_all) {
+        save_data("test_data_pr4_crlf.csv", "PERSON;87654321K;John;Smith;john.smith@example.com;My street, 25;08001;30/12/1980\r\n\r\n" \
+                                            "VACCINE_LOT;01/01/2022;13:45;08001;PFIZER;2;21;300\r\n" \
+                                            "VACCINE_LOT;01/01/2022;13:45;08001;PFIZER;2;21;50");
+        api_initData(&data);
+        error = api_loadData(&data, "test_data_pr4_crlf.csv", true);
+        if (error != E_SUCCESS || api_populationCount(&data) != 1 || api_vaccineLotsCount(&data) != 1) {
+            failed = true;
+        } else if (data.vaccineLots.elems[0].doses != 350 || data.population.elems[0].birthday.year != 1980) {
+            failed = true;
+        }
+        api_freeData(&data);
+        
+        if (failed) {
+            passed = false;
+        }
+    }
+    end_test(test_section, "PR4_EX3_3", !failed);
+    
+    return passed;
+}
+
+// Check that two loads produced the same data, in the same order
+static bool test_sameData(tApiData* data1, tApiData* data2) {
+    int i;
+    
+    if (api_populationCount(data1) != api_populationCount(data2) || api_vaccineLotsCount(data1) != api_vaccineLotsCount(data2)) {
+        return false;
+    }
+    for (i = 0; i < data1->population.count; i++) {
+        if (strcmp(data1->population.elems[i].document, data2->population.elems[i].document) != 0) {
+            return false;
+        }
+    }
+    for (i = 0; i < data1->vaccineLots.count; i++) {
+        if (strcmp(data1->vaccineLots.elems[i].cp, data2->vaccineLots.elems[i].cp) != 0 || data1->vaccineLots.elems[i].doses != data2->vaccineLots.elems[i].doses) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+// Run all tests for Exercice 4 of PR4
+bool run_pr4_ex4(tTestSection* test_section, const char* input) {
+    tApiData data;
+    tApiData reference;
+    tApiError error;
+    tApiError refError;
+    char* buffer;
+    int pos;
+    int i;
+    bool passed = true;
+    bool failed = false;
+    
+    /////////////////////////////
+    /////  PR4 EX4 TEST 1  //////
+    /////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX4_1", "Load a file in parallel");
+    api_initData(&reference);
+    api_initData(&data);
+    refError = api_loadData(&reference, input, true);
+    error = api_loadDataParallel(&data, input, true, PARALLEL_NUM_THREADS);
+    if (refError != E_SUCCESS || error != E_SUCCESS || !test_sameData(&reference, &data)) {
+        failed = true;
+    }
+    api_freeData(&data);
+    api_freeData(&reference);
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX4_1", !failed);
+    
+    /////////////////////////////
+    /////  PR4 EX4 TEST 2  //////
+    /////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX4_2", "Parallel load keeps the file order for duplicated persons and lots");
+    // Lots of the same center and vaccine are merged, and a duplicated person stops the load
+    buffer = (char*) malloc(PARALLEL_NUM_PERSONS * 128);
+    assert(buffer != NULL);
+    pos = 0;
+    for (i = 0; i < PARALLEL_NUM_PERSONS; i++) {
+        pos += sprintf(buffer + pos, "PERSON;%08dA;Name;Surname;mail@example.com;Street;08001;01/01/1980\n", i % (3 * PARALLEL_NUM_PERSONS / 4));
+        if (i % 10 == 0) {
+            pos += sprintf(buffer + pos, "VACCINE_LOT;01/01/2022;13:45;%05d;PFIZER;2;21;%d\n", 8001 + (i % 3), i);
+        }
+    }
+    save_data("test_data_pr4_parallel.csv", buffer);
+    free(buffer);
+    
+    api_initData(&reference);
+    refError = api_loadData(&reference, "test_data_pr4_parallel.csv", true);
+    if (refError != E_DUPLICATED_PERSON) {
+        failed = true;
+    }
+    for (i = 1; i <= PARALLEL_NUM_THREADS && !failed; i++) {
+        api_initData(&data);
+        error = api_loadDataParallel(&data, "test_data_pr4_parallel.csv", true, i);
+        if (error != refError || !test_sameData(&reference, &data)) {
+            failed = true;
+        }
+        api_freeData(&data);
+    }
+    api_freeData(&reference);
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX4_2", !failed);
+    
+    return passed;
+}
+
+// Run all tests for Exercice 5 of PR4
+bool run_pr4_ex5(tTestSection* test_section, const char* input) {
+    tApiData data;
+    tApiError error;
+    tArena arena;
+    tArena other;
+    tArenaBlock* block;
+    char* str;
+    char* big;
+    int count;
+    bool passed = true;
+    bool failed = false;
+    
+    /////////////////////////////
+    /////  PR4 EX5 TEST 1  //////
+    /////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX5_1", "Allocate and merge arenas");
+    arena_init(&arena);
+    arena_init(&other);
+    str = arena_strndup(&arena, "08001;PFIZER", 5);
+    big = (char*) arena_alloc(&other, 2 * ARENA_BLOCK_SIZE);
+    memset(big, 'a', 2 * ARENA_BLOCK_SIZE);
+    arena_merge(&arena, &other);
+    if (strcmp(str, "08001") != 0 || strcmp(arena_strdup(&arena, "MODERNA"), "MODERNA") != 0) {
+        failed = true;
+    } else if (other.first != NULL || arena.size != 3 * ARENA_BLOCK_SIZE || ((size_t) arena_alloc(&arena, 3)) % ARENA_ALIGNMENT != 0) {
+        failed = true;
+    }
+    // The blocks of a merged arena are appended after its last block
+    arena_strdup(&other, "MODERNA");
+    arena_merge(&other, &arena);
+    block = other.first;
+    while (block != NULL && block->next != NULL) {
+        block = block->next;
+    }
+    if (arena.first != NULL || other.size != 4 * ARENA_BLOCK_SIZE || block != other.last) {
+        failed = true;
+    }
+    arena_free(&other);
+    arena_free(&arena);
+    if (arena.first != NULL || arena.size != 0) {
+        failed = true;
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX5_1", !failed);
+    
+    /////////////////////////////
+    /////  PR4 EX5 TEST 2  //////
+    /////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX5_2", "Store the loaded strings on the data arena");
+    api_initData(&data);
+    error = api_loadData(&data, input, true);
+    count = api_populationCount(&data);
+    if (error != E_SUCCESS || count < 2 || data.arena.first == NULL) {
+        failed = true;
+    } else {
+        // Removed persons keep their strings on the arena, the other ones are not affected
+        str = data.population.elems[count - 1].document;
+        population_del(&(data.population), data.population.elems[0].document);
+        if (api_populationCount(&data) != count - 1 || population_find(&(data.population), str) != count - 2) {
+            failed = true;
+        }
+    }
+    api_freeData(&data);
+    if (data.arena.first != NULL || api_populationCount(&data) != 0 || api_vaccineLotsCount(&data) != 0) {
+        failed = true;
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX5_2", !failed);
+    
+    return passed;
+}
+
+// Run all tests for Exercice 6 of PR4
+bool run_pr4_ex6(tTestSection* test_section, const char* input) {
+    tApiData data;
+    tApiError error;
+    tInternTable table;
+    tHealthCenter* center;
+    tVaccine* vaccine;
+    const char* str;
+    char buffer[16];
+    int i;
+    bool passed = true;
+    bool failed = false;
+    
+    /////////////////////////////
+    /////  PR4 EX6 TEST 1  //////
+    /////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX6_1", "Intern strings");
+    internTable_init(&table);
+    str = internTable_add(&table, "08001");
+    if (internTable_find(&table, "08002") != NULL || internTable_addn(&table, "08001;PFIZER", 5) != str) {
+        failed = true;
+    }
+    // Add enough strings to grow the table
+    for (i = 0; i < 1000 && !failed; i++) {
+        sprintf(buffer, "%05d", i);
+        if (internTable_add(&table, buffer) != internTable_find(&table, buffer) || !internTable_isCanonical(&table, internTable_find(&table, buffer))) {
+            failed = true;
+        }
+    }
+    if (internTable_len(&table) != 1001 || internTable_find(&table, "08001") != str || internTable_isCanonical(&table, "08001")) {
+        failed = true;
+    }
+    internTable_free(&table);
+    if (internTable_len(&table) != 0) {
+        failed = true;
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX6_1", !failed);
+    
+    /////////////////////////////
+    /////  PR4 EX6 TEST 2  //////
+    /////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX6_2", "Share the cp and vaccine names of the loaded data");
+    api_initData(&data);
+    error = api_loadData(&data, input, true);
+    str = internTable_find(&(data.strings), "08001");
+    center = centerList_find(&(data.centers), "08001");
+    vaccine = vaccineList_find(&(data.vaccines), "PFIZER");
+    if (error != E_SUCCESS || str == NULL || center == NULL || vaccine == NULL) {
+        failed = true;
+    } else if (center->cp != str || vaccine->name != internTable_find(&(data.strings), "PFIZER")) {
+        failed = true;
+    } else {
+        // Persons and lots with the same cp share the canonical copy
+        for (i = 0; i < data.population.count; i++) {
+            if (strcmp(data.population.elems[i].cp, "08001") == 0 && data.population.elems[i].cp != str) {
+                failed = true;
+            }
+        }
+        for (i = 0; i < data.vaccineLots.count; i++) {
+            if (strcmp(data.vaccineLots.elems[i].cp, "08001") == 0 && data.vaccineLots.elems[i].cp != str) {
+                failed = true;
+            }
+            if (strcmp(data.vaccineLots.elems[i].vaccine->name, "PFIZER") == 0 && data.vaccineLots.elems[i].vaccine != vaccine) {
+                failed = true;
+            }
+        }
+        // Unknown strings are not found nor added
+        if (centerList_find(&(data.centers), "99999") != NULL || vaccineList_find(&(data.vaccines), "UNKNOWN") != NULL || internTable_find(&(data.strings), "99999") != NULL) {
+            failed = true;
+        }
+    }
+    api_freeData(&data);
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX6_2", !failed);
+    
+    return passed;
+}
+
+// Run tests for PR4 exercice 7
+bool run_pr4_ex7(tTestSection* test_section, const char* input) {
+    tVaccineStockData stock;
+    tVaccine vModerna, vPfizer, vPfizerCopy;
+    tDate date;
+    tDate other;
+    tDateTime dateTime;
+    tDateTime otherTime;
+    struct tm tm;
+    int days;
+    int i;
+    bool passed = true;
+    bool failed = false;
+    
+    vPfizer.name = "PFIZER";
+    vPfizer.days = 21;
+    vPfizer.required = 2;
+    vModerna.name = "MODERNA";
+    vModerna.days = 0;
+    vModerna.required = 1;
+    vPfizerCopy = vPfizer;
+    
+    /////////////////////////////
+    /////  PR4 EX7 TEST 1  //////
+    /////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX7_1", "Convert dates to day numbers");
+    date_parse(&date, "01/01/1970");
+    if (date_toDays(date) != 0) {
+        failed = true;
+    }
+    date_parse(&date, "29/02/2024");
+    if (date_toDays(date) != 19782) {
+        failed = true;
+    }
+    // Consecutive days have consecutive numbers, across months and leap years, as computed by mktime
+    date_parse(&date, "25/12/1999");
+    days = date_toDays(date);
+    for (i = 0; i < 2000 && !failed; i++) {
+        memset(&tm, 0, sizeof(struct tm));
+        tm.tm_mday = date.day + i;
+        tm.tm_mon = date.month - 1;
+        tm.tm_year = date.year - 1900;
+        tm.tm_hour = 12;
+        mktime(&tm);
+        date_fromDays(&other, days + i);
+        if (other.day != tm.tm_mday || other.month != tm.tm_mon + 1 || other.year != tm.tm_year + 1900 || date_toDays(other) != days + i) {
+            failed = true;
+        }
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX7_1", !failed);
+    
+    /////////////////////////////
+    /////  PR4 EX7 TEST 2  //////
+    /////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX7_2", "Grow the stock at both ends");
+    stockList_init(&stock);
+    date_parse(&date, "01/06/2022");
+    stockList_update(&stock, date, &vPfizer, 10);
+    // Add a lot every day after and before the first one
+    for (i = 1; i <= 100; i++) {
+        date_parse(&date, "01/06/2022");
+        date_addDay(&date, i);
+        stockList_update(&stock, date, &vModerna, 1);
+        date_parse(&date, "01/06/2022");
+        date_addDay(&date, -i);
+        stockList_update(&stock, date, &vPfizer, 1);
+    }
+    // Alternating growth must not make the allocated days grow exponentially
+    if (stock.count != 201 || stock.numColumns != 2 || stock.capacity > 4 * stock.count) {
+        failed = true;
+    } else {
+        date_parse(&date, "01/06/2022");
+        date_addDay(&date, -100);
+        for (i = 0; i < stock.count && !failed; i++) {
+            // Pfizer doses accumulate from the left, Moderna doses from the first day after 01/06/2022
+            if (stockList_find(&stock, date) != i || date_cmp(stockList_getDate(&stock, i), date) != 0) {
+                failed = true;
+            } else if (stockList_getDoses(&stock, date, &vPfizer) != (i < 100 ? i + 1 : 110)) {
+                failed = true;
+            } else if (stockList_getDoses(&stock, date, &vModerna) != (i > 100 ? i - 100 : 0)) {
+                failed = true;
+            } else if (stockList_dayCount(&stock, i) != (i > 100 ? 2 : 1) || stockList_dayStock(&stock, i, stockList_dayCount(&stock, i) - 1).vaccine != &vPfizer) {
+                failed = true;
+            }
+            date_addDay(&date, 1);
+        }
+        if (stockList_find(&stock, date) != -1 || stockList_getDoses(&stock, date, &vModerna) != 100) {
+            failed = true;
+        }
+    }
+    stockList_free(&stock);
+    
+    // Removing the doses trims the empty days at the end
+    date_parse(&date, "01/06/2022");
+    stockList_update(&stock, date, &vPfizer, 5);
+    date_addDay(&date, 10);
+    stockList_update(&stock, date, &vPfizer, -5);
+    if (stock.count != 10 || stockList_getDoses(&stock, date, &vPfizer) != 5) {
+        failed = true;
+    }
+    date_parse(&date, "01/06/2022");
+    stockList_update(&stock, date, &vPfizer, -5);
+    if (stock.count != 0 || stockList_getDoses(&stock, date, &vPfizer) != 0) {
+        failed = true;
+    }
+    stockList_free(&stock);
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX7_2", !failed);
+    
+    /////////////////////////////
+    /////  PR4 EX7 TEST 3  //////
+    /////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX7_3", "Change the doses of past and single days");
+    stockList_init(&stock);
+    date_parse(&date, "01/06/2022");
+    stockList_update(&stock, date, &vPfizer, 10);
+    date_addDay(&date, 9);
+    stockList_update(&stock, date, &vPfizer, 10);
+    // A lot on a past day changes all the following days
+    date_parse(&date, "05/06/2022");
+    stockList_update(&stock, date, &vModerna, 3);
+    // Booked doses only change their own day, except on the last day
+    stockList_addDoses(&stock, 2, &vPfizer, -1);
+    stockList_addDoses(&stock, 9, &vPfizer, -1);
+    date_parse(&date, "01/06/2022");
+    for (i = 0; i < 12 && !failed; i++) {
+        if (stockList_getDoses(&stock, date, &vPfizer) != (i == 2 ? 9 : (i < 9 ? 10 : 19))) {
+            failed = true;
+        } else if (stockList_getDoses(&stock, date, &vModerna) != (i < 4 ? 0 : 3)) {
+            failed = true;
+        }
+        date_addDay(&date, 1);
+    }
+    if (!failed && stock.count != 10) {
+        failed = true;
+    }
+    // Another vaccine with the same name adds its doses to the same column
+    date_parse(&date, "01/06/2022");
+    stockList_update(&stock, date, &vPfizerCopy, 5);
+    if (stock.numColumns != 2 || stockList_getDoses(&stock, date, &vPfizer) != 15 || stockList_getDoses(&stock, date, &vPfizerCopy) != 15) {
+        failed = true;
+    }
+    stockList_free(&stock);
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX7_3", !failed);
+    
+    /////////////////////////////
+    /////  PR4 EX7 TEST 4  //////
+    /////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX7_4", "Add days and minutes to dates");
+    date_parse(&date, "28/02/2024");
+    date_addDay(&date, 1);
+    date_parse(&other, "29/02/2024");
+    if (date_cmp(date, other) != 0) {
+        failed = true;
+    }
+    date_addDay(&date, -366);
+    date_parse(&other, "28/02/2023");
+    if (date_cmp(date, other) != 0 || date_cmp(date, date) != 0) {
+        failed = true;
+    }
+    date_parse(&other, "01/03/2023");
+    if (date_cmp(date, other) != -1 || date_cmp(other, date) != 1) {
+        failed = true;
+    }
+    // The time does not change when adding days
+    dateTime_parse(&dateTime, "31/12/2021", "23:45");
+    dateTime_addDay(&dateTime, 1);
+    dateTime_parse(&otherTime, "01/01/2022", "23:45");
+    if (!dateTime_equals(dateTime, otherTime)) {
+        failed = true;
+    }
+    dateTime_fromMinutes(&otherTime, dateTime_toMinutes(dateTime) + 15);
+    dateTime_parse(&dateTime, "02/01/2022", "00:00");
+    if (!dateTime_equals(dateTime, otherTime) || dateTime_toMinutes(dateTime) != date_toDays(dateTime.date) * 1440) {
+        failed = true;
+    }
+    dateTime_fromMinutes(&otherTime, -1);
+    dateTime_parse(&dateTime, "31/12/1969", "23:59");
+    if (!dateTime_equals(dateTime, otherTime)) {
+        failed = true;
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX7_4", !failed);
+    
+    return passed;
+}
+
+// Check that appointments are sorted by timestamp and then by document
+static bool test_appointmentsSorted(tAppointmentData* list) {
+    int cmp;
+    int i;
+    
+    for (i = 1; i < list->count; i++) {
+        cmp = dateTime_cmp(list->elems[i - 1].timestamp, list->elems[i].timestamp);
+        if (cmp > 0 || (cmp == 0 && strcmp(list->elems[i - 1].person->document, list->elems[i].person->document) > 0)) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+// Get the timestamp of the test appointment of the person i
+static void test_appointmentTimestamp(tDateTime* timestamp, int i) {
+    tDateTime first;
+    
+    // Appointments every 15 minutes, with many persons on each one
+    dateTime_parse(&first, "01/01/2022", "08:00");
+    dateTime_fromMinutes(timestamp, dateTime_toMinutes(first) + ((i * 37) % APPOINTMENT_NUM_SLOTS) * 15);
+}
+
+// Run tests for PR4 exercice 8
+bool run_pr4_ex8(tTestSection* test_section, const char* input) {
+    tApiData data;
+    tApiError error;
+    tCSVData report;
+    tHealthCenter* center;
+    char buffer[16];
+    tAppointmentData appointments;
+    tPerson persons[APPOINTMENT_NUM_PERSONS];
+    char documents[APPOINTMENT_NUM_PERSONS][16];
+    tVaccine vaccine;
+    tDateTime timestamp;
+    int expected;
+    int i;
+    bool passed = true;
+    bool failed = false;
+    
+    vaccine.name = "PFIZER";
+    vaccine.days = 21;
+    vaccine.required = 2;
+    for (i = 0; i < APPOINTMENT_NUM_PERSONS; i++) {
+        sprintf(documents[i], "%08dX", (i * 7919) % APPOINTMENT_NUM_PERSONS);
+        memset(&(persons[i]), 0, sizeof(tPerson));
+        persons[i].document = documents[i];
+    }
+    
+    /////////////////////////////
+    /////  PR4 EX8 TEST 1  //////
+    /////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX8_1", "Insert and find appointments sorted by timestamp and document");
+    appointmentData_init(&appointments);
+    for (i = 0; i < APPOINTMENT_NUM_PERSONS; i++) {
+        test_appointmentTimestamp(&timestamp, i);
+        appointmentData_insert(&appointments, timestamp, &vaccine, &(persons[i]));
+    }
+    if (appointments.count != APPOINTMENT_NUM_PERSONS || !test_appointmentsSorted(&appointments)) {
+        failed = true;
+    }
+    // Lower bounds match a linear search, also between slots and after the last one
+    for (i = 0; i <= 2 * APPOINTMENT_NUM_SLOTS && !failed; i++) {
+        test_appointmentTimestamp(&timestamp, 0);
+        dateTime_fromMinutes(&timestamp, dateTime_toMinutes(timestamp) + i * 8);
+        expected = 0;
+        while (expected < appointments.count && dateTime_cmp(appointments.elems[expected].timestamp, timestamp) < 0) {
+            expected++;
+        }
+        if (expected == appointments.count) {
+            expected = -1;
+        }
+        if (appointmentData_findTimestamp(&appointments, timestamp, 0) != expected) {
+            failed = true;
+        }
+    }
+    for (i = 0; i < APPOINTMENT_NUM_PERSONS && !failed; i++) {
+        test_appointmentTimestamp(&timestamp, i);
+        expected = appointmentData_findDocument(&appointments, timestamp, persons[i].document, appointmentData_findTimestamp(&appointments, timestamp, 0));
+        if (expected < 0 || appointments.elems[expected].person != &(persons[i]) || appointmentData_find(&appointments, &(persons[i]), 0) != expected) {
+            failed = true;
+        }
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX8_1", !failed);
+    
+    /////////////////////////////
+    /////  PR4 EX8 TEST 2  //////
+    /////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX8_2", "Remove appointments keeping the order");
+    for (i = 0; i < APPOINTMENT_NUM_PERSONS; i += 2) {
+        test_appointmentTimestamp(&timestamp, i);
+        appointmentData_remove(&appointments, timestamp, &(persons[i]));
+    }
+    // Removing an appointment with another timestamp does nothing
+    test_appointmentTimestamp(&timestamp, 2);
+    appointmentData_remove(&appointments, timestamp, &(persons[1]));
+    if (appointments.count != APPOINTMENT_NUM_PERSONS / 2 || !test_appointmentsSorted(&appointments)) {
+        failed = true;
+    }
+    for (i = 0; i < APPOINTMENT_NUM_PERSONS && !failed; i++) {
+        if ((appointmentData_find(&appointments, &(persons[i]), 0) >= 0) != (i % 2 == 1)) {
+            failed = true;
+        }
+    }
+    appointmentData_free(&appointments);
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX8_2", !failed);
+    
+    /////////////////////////////
+    /////  PR4 EX8 TEST 3  //////
+    /////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX8_3", "Find the appointments of a person in any center");
+    api_initData(&data);
+    error = api_loadData(&data, input, true);
+    if (error != E_SUCCESS) {
+        failed = true;
+    } else {
+        // The home center of the person is 08001
+        dateTime_parse(&timestamp, "01/05/2022", "10:00");
+        error = api_addAppointment(&data, "08500", "87654321K", "PFIZER", timestamp);
+        dateTime_parse(&timestamp, "02/04/2022", "09:00");
+        if (error != E_SUCCESS || api_addAppointment(&data, "08001", "87654321K", "MODERNA", timestamp) != E_SUCCESS) {
+            failed = true;
+        }
+        csv_init(&report);
+        if (!failed && (api_getPersonAppointments(&data, "87654321K", &report) != E_SUCCESS || csv_numEntries(report) != 3)) {
+            failed = true;
+        } else if (!failed) {
+            // Appointments are sorted by timestamp
+            csv_getAsString(*csv_getEntry(report, 0), 2, buffer, 16);
+            if (strcmp(buffer, "08001") != 0) {
+                failed = true;
+            }
+            csv_getAsString(*csv_getEntry(report, 2), 0, buffer, 16);
+            if (strcmp(buffer, "22/05/2022") != 0) {
+                failed = true;
+            }
+        }
+        csv_free(&report);
+        // Removed appointments are removed from the index
+        center = centerList_find(&(data.centers), "08500");
+        dateTime_parse(&timestamp, "01/05/2022", "10:00");
+        appointmentData_remove(&(center->appointments), timestamp, &(data.population.elems[population_find(&(data.population), "87654321K")]));
+        csv_init(&report);
+        if (!failed && (api_getPersonAppointments(&data, "87654321K", &report) != E_SUCCESS || csv_numEntries(report) != 2)) {
+            failed = true;
+        }
+        csv_free(&report);
+        // A person with an appointment in a center cannot book another one there
+        dateTime_parse(&timestamp, "01/04/2022", "10:00");
+        if (!failed && api_findAppointmentAvailability(&data, "08500", "87654321K", timestamp) != E_DUPLICATED_PERSON) {
+            failed = true;
+        }
+    }
+    api_freeData(&data);
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX8_3", !failed);
+    
+    return passed;
+}
+
+// Run tests for PR4 exercice 9
+bool run_pr4_ex9(tTestSection* test_section, const char* input) {
+    tHealthCenterList list;
+    tHealthCenter* first;
+    tHealthCenter* center;
+    char cp[16];
+    int i;
+    bool passed = true;
+    bool failed = false;
+    
+    /////////////////////////////
+    /////  PR4 EX9 TEST 1  //////
+    /////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX9_1", "Insert and find health centers in any order");
+    centerList_init(&list);
+    centerList_insert(&list, "08500");
+    first = centerList_find(&list, "08500");
+    // Insert the centers in a scrambled order, twice
+    for (i = 0; i < 2 * DIRECTORY_NUM_CENTERS; i++) {
+        sprintf(cp, "%05d", 8000 + (i * 7919) % DIRECTORY_NUM_CENTERS);
+        centerList_insert(&list, cp);
+    }
+    if (list.count != DIRECTORY_NUM_CENTERS) {
+        failed = true;
+    }
+    // Pointers to the centers remain valid after inserting other centers
+    if (first == NULL || centerList_find(&list, "08500") != first || strcmp(first->cp, "08500") != 0) {
+        failed = true;
+    }
+    for (i = 0; i < list.count && !failed; i++) {
+        center = centerList_get(&list, i);
+        if (i > 0 && strcmp(centerList_get(&list, i - 1)->cp, center->cp) >= 0) {
+            failed = true;
+        } else if (centerList_find(&list, center->cp) != center) {
+            failed = true;
+        }
+    }
+    if (centerList_find(&list, "07999") != NULL || centerList_find(&list, "09000") != NULL || centerList_find(&list, "08500 ") != NULL) {
+        failed = true;
+    }
+    centerList_free(&list);
+    if (list.count != 0) {
+        failed = true;
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX9_1", !failed);
+    
+    return passed;
+}
+
+// Run tests for PR4 exercice 10
+bool run_pr4_ex10(tTestSection* test_section, const char* input) {
+    tVaccineList list;
+    tVaccine vaccine;
+    tVaccine* first;
+    tVaccine* pVaccine;
+    char name[32];
+    int i;
+    bool passed = true;
+    bool failed = false;
+    
+    //////////////////////////////
+    /////  PR4 EX10 TEST 1  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX10_1", "Vaccines have stable ids and are found by name");
+    vaccineList_init(&list);
+    first = NULL;
+    // Insert the vaccines in a scrambled order, twice
+    for (i = 0; i < 2 * CATALOG_NUM_VACCINES; i++) {
+        sprintf(name, "VACCINE%03d", (i * 37) % CATALOG_NUM_VACCINES);
+        vaccine_init(&vaccine, name, 2, 21);
+        vaccineList_insert(&list, vaccine);
+        vaccine_free(&vaccine);
+        if (i == 0) {
+            first = vaccineList_find(&list, name);
+        }
+    }
+    if (vaccineList_len(&list) != CATALOG_NUM_VACCINES) {
+        failed = true;
+    }
+    // Ids are given in insertion order and pointers to the vaccines remain valid
+    if (first == NULL || first->id != 0 || vaccineList_getById(&list, 0) != first || strcmp(first->name, "VACCINE000") != 0) {
+        failed = true;
+    }
+    for (i = 0; i < CATALOG_NUM_VACCINES && !failed; i++) {
+        sprintf(name, "VACCINE%03d", (i * 37) % CATALOG_NUM_VACCINES);
+        pVaccine = vaccineList_find(&list, name);
+        if (pVaccine == NULL || pVaccine->id != i || vaccineList_findId(&list, name) != i || vaccineList_getById(&list, i) != pVaccine) {
+            failed = true;
+        }
+        sprintf(name, "VACCINE%03d", i);
+        if (strcmp(vaccineList_get(&list, i)->name, name) != 0) {
+            failed = true;
+        }
+    }
+    if (vaccineList_find(&list, "UNKNOWN") != NULL || vaccineList_findId(&list, "VACCINE") != -1 || vaccineList_getById(&list, CATALOG_NUM_VACCINES) != NULL) {
+        failed = true;
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX10_1", !failed);
+    
+    //////////////////////////////
+    /////  PR4 EX10 TEST 2  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX10_2", "Removed vaccines keep the ids of the others");
+    vaccineList_del(&list, "VACCINE000");
+    vaccineList_del(&list, "UNKNOWN");
+    if (vaccineList_len(&list) != CATALOG_NUM_VACCINES - 1 || vaccineList_find(&list, "VACCINE000") != NULL || vaccineList_getById(&list, 0) != NULL) {
+        failed = true;
+    }
+    if (strcmp(vaccineList_get(&list, 0)->name, "VACCINE001") != 0) {
+        failed = true;
+    }
+    for (i = 1; i < CATALOG_NUM_VACCINES && !failed; i++) {
+        sprintf(name, "VACCINE%03d", (i * 37) % CATALOG_NUM_VACCINES);
+        if (vaccineList_findId(&list, name) != i) {
+            failed = true;
+        }
+    }
+    // A vaccine added again gets a new id
+    vaccine_init(&vaccine, "VACCINE000", 1, 0);
+    vaccineList_insert(&list, vaccine);
+    vaccine_free(&vaccine);
+    if (vaccineList_findId(&list, "VACCINE000") != CATALOG_NUM_VACCINES || vaccineList_len(&list) != CATALOG_NUM_VACCINES) {
+        failed = true;
+    }
+    vaccineList_free(&list);
+    if (vaccineList_len(&list) != 0 || vaccineList_find(&list, "VACCINE001") != NULL) {
+        failed = true;
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX10_2", !failed);
+    
+    return passed;
+}
+
+// Initialize the i-th lot used to test the index of lots
+static void test_indexLot(tVaccineLot* lot, tVaccine* vaccines, char* cp, int i) {
+    tDateTime timestamp;
+    
+    dateTime_parse(&timestamp, "01/01/2022", "10:00");
+    dateTime_fromMinutes(&timestamp, dateTime_toMinutes(timestamp) + (i / 10) * 30);
+    sprintf(cp, "%05d", 8000 + i % 10);
+    lot->vaccine = &(vaccines[i % 2]);
+    lot->cp = cp;
+    lot->timestamp = timestamp;
+    lot->doses = 10 + i;
+}
+
+// Run tests for PR4 exercice 11
+bool run_pr4_ex11(tTestSection* test_section, const char* input) {
+    tVaccineLotData data;
+    tVaccineLotCenter* center;
+    tVaccine vaccines[2];
+    tVaccineLot lot;
+    tDate from, to;
+    char cp[16];
+    int first, last;
+    int idx;
+    int i, j;
+    bool passed = true;
+    bool failed = false;
+    
+    vaccine_init(&(vaccines[0]), "PFIZER", 2, 21);
+    vaccine_init(&(vaccines[1]), "MODERNA", 2, 28);
+    
+    //////////////////////////////
+    /////  PR4 EX11 TEST 1  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX11_1", "Find and merge lots among many lots");
+    vaccineLotData_init(&data);
+    for (i = 0; i < INDEX_NUM_LOTS; i++) {
+        test_indexLot(&lot, vaccines, cp, i);
+        vaccineLotData_add(&data, lot);
+    }
+    // Lots with the same cp, vaccine and timestamp are merged
+    for (i = 0; i < INDEX_NUM_LOTS; i += 5) {
+        test_indexLot(&lot, vaccines, cp, i);
+        vaccineLotData_add(&data, lot);
+    }
+    if (vaccineLotData_len(&data) != INDEX_NUM_LOTS) {
+        failed = true;
+    }
+    for (i = 0; i < INDEX_NUM_LOTS && !failed; i++) {
+        test_indexLot(&lot, vaccines, cp, i);
+        idx = vaccineLotData_find(&data, cp, lot.vaccine->name, lot.timestamp);
+        if (idx != i || strcmp(data.elems[idx].cp, cp) != 0 || data.elems[idx].doses != (i % 5 == 0 ? 2 : 1) * lot.doses) {
+            failed = true;
+        }
+    }
+    test_indexLot(&lot, vaccines, cp, 0);
+    if (vaccineLotData_find(&data, cp, "MODERNA", lot.timestamp) != -1 || vaccineLotData_find(&data, "99999", "PFIZER", lot.timestamp) != -1) {
+        failed = true;
+    }
+    dateTime_fromMinutes(&(lot.timestamp), dateTime_toMinutes(lot.timestamp) + 1);
+    if (vaccineLotData_find(&data, cp, "PFIZER", lot.timestamp) != -1) {
+        failed = true;
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX11_1", !failed);
+    
+    //////////////////////////////
+    /////  PR4 EX11 TEST 2  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX11_2", "Find lots after removing lots");
+    // Remove all the doses of the even lots and some doses of the odd ones
+    for (i = 0; i < INDEX_NUM_LOTS; i++) {
+        test_indexLot(&lot, vaccines, cp, i);
+        vaccineLotData_del(&data, cp, lot.vaccine->name, lot.timestamp, i % 2 == 0 ? 1000 : 1);
+    }
+    if (vaccineLotData_len(&data) != INDEX_NUM_LOTS / 2) {
+        failed = true;
+    }
+    for (i = 0; i < INDEX_NUM_LOTS && !failed; i++) {
+        test_indexLot(&lot, vaccines, cp, i);
+        idx = vaccineLotData_find(&data, cp, lot.vaccine->name, lot.timestamp);
+        if (i % 2 == 0 && idx != -1) {
+            failed = true;
+        } else if (i % 2 == 1 && (idx < 0 || strcmp(data.elems[idx].cp, cp) != 0 || !dateTime_equals(data.elems[idx].timestamp, lot.timestamp)
+            || data.elems[idx].doses != (i % 5 == 0 ? 2 : 1) * lot.doses - 1)) {
+            failed = true;
+        }
+    }
+    // The lots of each center are still sorted by timestamp. Only the odd cp have lots
+    date_parse(&from, "01/01/2022");
+    date_parse(&to, "31/12/2022");
+    for (i = 0; i < 10 && !failed; i++) {
+        sprintf(cp, "%05d", 8000 + i);
+        center = vaccineLotData_findRange(&data, cp, from, to, &first, &last);
+        if (i % 2 == 0 && center != NULL) {
+            failed = true;
+        } else if (i % 2 == 1 && (center == NULL || last - first != INDEX_NUM_LOTS / 10)) {
+            failed = true;
+        }
+        for (j = first + 1; center != NULL && j < last; j++) {
+            if (dateTime_cmp(data.elems[center->lots[j - 1]].timestamp, data.elems[center->lots[j]].timestamp) > 0) {
+                failed = true;
+            }
+        }
+    }
+    vaccineLotData_free(&data);
+    if (vaccineLotData_len(&data) != 0) {
+        failed = true;
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX11_2", !failed);
+    
+    vaccine_free(&(vaccines[0]));
+    vaccine_free(&(vaccines[1]));
+    
+    return passed;
+}
+
+// Run tests for PR4 exercice 12
+bool run_pr4_ex12(tTestSection* test_section, const char* input) {
+    tApiData data;
+    tCSVEntry entry;
+    tCSVData report;
+    tCSVData refReport;
+    tDate from;
+    tDate to;
+    const char* lots[] = {
+        "01/01/2022;13:45;08001;PFIZER;2;21;300",
+        "03/01/2022;09:00;08001;MODERNA;1;0;100",
+        "05/01/2022;23:59;08001;PFIZER;2;21;50",
+        "02/01/2022;08:00;08001;PFIZER;2;21;20",
+        "02/01/2022;10:00;08002;PFIZER;2;21;10",
+        "06/01/2022;00:00;08001;PFIZER;2;21;5",
+    };
+    int i;
+    bool passed = true;
+    bool failed = false;
+    
+    api_initData(&data);
+    for (i = 0; i < sizeof(lots) / sizeof(lots[0]); i++) {
+        csv_initEntry(&entry);
+        csv_parseEntry(&entry, lots[i], "VACCINE_LOT");
+        api_addVaccineLot(&data, entry);
+        csv_freeEntry(&entry);
+    }
+    
+    //////////////////////////////
+    /////  PR4 EX12 TEST 1  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX12_1", "Get the lots of a center on a date window");
+    date_parse(&from, "02/01/2022");
+    date_parse(&to, "05/01/2022");
+    csv_init(&refReport);
+    csv_addStrEntry(&refReport, "02/01/2022;08:00;08001;PFIZER;2;21;20", "VACCINE_LOT");
+    csv_addStrEntry(&refReport, "03/01/2022;09:00;08001;MODERNA;1;0;100", "VACCINE_LOT");
+    csv_addStrEntry(&refReport, "05/01/2022;23:59;08001;PFIZER;2;21;50", "VACCINE_LOT");
+    if (api_getCenterVaccineLots(&data, "08001", NULL, from, to, &report) != E_SUCCESS || !csv_equals(report, refReport)) {
+        failed = true;
+    }
+    csv_free(&report);
+    csv_free(&refReport);
+    
+    csv_init(&refReport);
+    csv_addStrEntry(&refReport, "02/01/2022;08:00;08001;PFIZER;2;21;20", "VACCINE_LOT");
+    csv_addStrEntry(&refReport, "05/01/2022;23:59;08001;PFIZER;2;21;50", "VACCINE_LOT");
+    if (api_getCenterVaccineLots(&data, "08001", "PFIZER", from, to, &report) != E_SUCCESS || !csv_equals(report, refReport)) {
+        failed = true;
+    }
+    csv_free(&report);
+    csv_free(&refReport);
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX12_1", !failed);
+    
+    //////////////////////////////
+    /////  PR4 EX12 TEST 2  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX12_2", "Get the lots of a center on an empty date window");
+    if (api_getCenterVaccineLots(&data, "08003", NULL, from, to, &report) != E_SUCCESS || csv_numEntries(report) != 0) {
+        failed = true;
+    }
+    csv_free(&report);
+    if (api_getCenterVaccineLots(&data, "08001", NULL, to, from, &report) != E_SUCCESS || csv_numEntries(report) != 0) {
+        failed = true;
+    }
+    csv_free(&report);
+    date_parse(&from, "03/01/2022");
+    if (api_getCenterVaccineLots(&data, "08002", NULL, from, to, &report) != E_SUCCESS || csv_numEntries(report) != 0) {
+        failed = true;
+    }
+    csv_free(&report);
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX12_2", !failed);
+    
+    api_freeData(&data);
+    
+    return passed;
+}
+
+// Run tests for PR4 exercice 13
+bool run_pr4_ex13(tTestSection* test_section, const char* input) {
+    tApiData data;
+    tApiError error;
+    tApiCursor cursor;
+    tVaccine* vaccine;
+    tVaccine* previous;
+    tVaccineLot* lot;
+    tPersonAppointment* appointment;
+    tDateTime timestamp;
+    tDate from;
+    tDate to;
+    int count;
+    bool passed = true;
+    bool failed = false;
+    
+    api_initData(&data);
+    error = api_loadData(&data, input, true);
+    
+    //////////////////////////////
+    /////  PR4 EX13 TEST 1  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX13_1", "Iterate over the vaccines and the lots");
+    if (error != E_SUCCESS) {
+        failed = true;
+    } else {
+        // Vaccines are returned sorted by name
+        count = 0;
+        previous = NULL;
+        api_vaccinesCursor(&data, &cursor);
+        while ((vaccine = api_nextVaccine(&data, &cursor)) != NULL) {
+            if (previous != NULL && strcmp(previous->name, vaccine->name) >= 0) {
+                failed = true;
+            }
+            previous = vaccine;
+            count++;
+        }
+        if (count != api_vaccineCount(&data) || api_nextVaccine(&data, &cursor) != NULL) {
+            failed = true;
+        }
+        // Lots are returned in the order they were added, without copies
+        count = 0;
+        api_vaccineLotsCursor(&data, &cursor);
+        while ((lot = api_nextVaccineLot(&data, &cursor)) != NULL) {
+            if (lot != &(data.vaccineLots.elems[count])) {
+                failed = true;
+            }
+            count++;
+        }
+        if (count != api_vaccineLotsCount(&data)) {
+            failed = true;
+        }
+        // Lots of a center are returned sorted by timestamp
+        count = 0;
+        date_parse(&from, "01/01/2022");
+        date_parse(&to, "31/12/2022");
+        api_centerVaccineLotsCursor(&data, &cursor, "08001", from, to);
+        while ((lot = api_nextVaccineLot(&data, &cursor)) != NULL) {
+            if (strcmp(lot->cp, "08001") != 0 || (count > 0 && dateTime_cmp(timestamp, lot->timestamp) > 0)) {
+                failed = true;
+            }
+            timestamp = lot->timestamp;
+            count++;
+        }
+        if (count == 0) {
+            failed = true;
+        }
+        api_centerVaccineLotsCursor(&data, &cursor, "99999", from, to);
+        if (api_nextVaccineLot(&data, &cursor) != NULL) {
+            failed = true;
+        }
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX13_1", !failed);
+    
+    //////////////////////////////
+    /////  PR4 EX13 TEST 2  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX13_2", "Iterate over the appointments of a person");
+    if (error != E_SUCCESS) {
+        failed = true;
+    } else {
+        dateTime_parse(&timestamp, "01/05/2022", "10:00");
+        if (api_addAppointment(&data, "08500", "87654321K", "PFIZER", timestamp) != E_SUCCESS) {
+            failed = true;
+        }
+        count = 0;
+        if (api_personAppointmentsCursor(&data, &cursor, "87654321K") != E_SUCCESS) {
+            failed = true;
+        }
+        while ((appointment = api_nextPersonAppointment(&data, &cursor)) != NULL) {
+            if (count > 0 && dateTime_cmp(timestamp, appointment->timestamp) > 0) {
+                failed = true;
+            }
+            timestamp = appointment->timestamp;
+            count++;
+        }
+        if (count != 2) {
+            failed = true;
+        }
+        if (api_personAppointmentsCursor(&data, &cursor, "00000000T") != E_PERSON_NOT_FOUND || api_nextPersonAppointment(&data, &cursor) != NULL) {
+            failed = true;
+        }
+        if (api_personAppointmentsCursor(&data, &cursor, "12345678Q") != E_SUCCESS || api_nextPersonAppointment(&data, &cursor) != NULL) {
+            failed = true;
+        }
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX13_2", !failed);
+    
+    api_freeData(&data);
+    
+    return passed;
+}
+
+// Run tests for PR4 exercice 14
+bool run_pr4_ex14(tTestSection* test_section, const char* input) {
+    tApiData batchData;
+    tApiData data;
+    tApiError results[6];
+    tApiError error;
+    tCSVData batchReport;
+    tCSVData report;
+    tDateTime timestamp;
+    const char* documents[] = {"87654321K", "00000000T", "98765432J", "87654321K", "76543210P", "12345678Q"};
+    int count;
+    int i;
+    bool passed = true;
+    bool failed = false;
+    
+    count = sizeof(documents) / sizeof(documents[0]);
+    api_initData(&batchData);
+    api_initData(&data);
+    error = api_loadData(&batchData, input, true);
+    if (error == E_SUCCESS) {
+        error = api_loadData(&data, input, true);
+    }
+    
+    //////////////////////////////
+    /////  PR4 EX14 TEST 1  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX14_1", "Book appointments for a list of persons");
+    if (error != E_SUCCESS) {
+        failed = true;
+    } else {
+        // A batch books the same appointments as booking each person in order
+        dateTime_parse(&timestamp, "02/04/2022", "10:15");
+        if (api_findAppointmentAvailabilityBatch(&batchData, "08001", documents, count, timestamp, results) != E_SUCCESS) {
+            failed = true;
+        }
+        for (i = 0; i < count && !failed; i++) {
+            if (results[i] != api_findAppointmentAvailability(&data, "08001", documents[i], timestamp)) {
+                failed = true;
+            }
+        }
+        if (results[0] != E_SUCCESS || results[1] != E_PERSON_NOT_FOUND || results[3] != E_DUPLICATED_PERSON) {
+            failed = true;
+        }
+        for (i = 0; i < count && !failed; i++) {
+            csv_init(&batchReport);
+            csv_init(&report);
+            if (api_getPersonAppointments(&batchData, documents[i], &batchReport) != api_getPersonAppointments(&data, documents[i], &report) || !csv_equals(batchReport, report)) {
+                failed = true;
+            }
+            csv_free(&batchReport);
+            csv_free(&report);
+        }
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX14_1", !failed);
+    
+    //////////////////////////////
+    /////  PR4 EX14 TEST 2  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX14_2", "Book appointments for a list of persons in a non existing center");
+    if (error != E_SUCCESS) {
+        failed = true;
+    } else {
+        if (api_findAppointmentAvailabilityBatch(&batchData, "08002", documents, count, timestamp, results) != E_HEALTH_CENTER_NOT_FOUND) {
+            failed = true;
+        }
+        if (results[0] != E_HEALTH_CENTER_NOT_FOUND || results[1] != E_PERSON_NOT_FOUND) {
+            failed = true;
+        }
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX14_2", !failed);
+    
+    api_freeData(&batchData);
+    api_freeData(&data);
+    
+    return passed;
+}
+
+// Run all tests for Exercice 15 of PR4
+bool run_pr4_ex15(tTestSection* test_section, const char* input) {
+    tApiData parallelData;
+    tApiData data;
+    tApiError results[8];
+    tApiError error;
+    tCSVData parallelReport;
+    tCSVData report;
+    tDateTime timestamp;
+    tHealthCenter* parallelCenter;
+    tHealthCenter* center;
+    const char* cps[] = {"08001", "08500", "08002", "08001", "08500", "08001", "08500", "08001"};
+    const char* documents[] = {"87654321K", "87654321K", "98765432J", "98765432J", "98765432J", "87654321K", "00000000T", "76543210P"};
+    int count;
+    int i, j;
+    bool passed = true;
+    bool failed = false;
+    
+    count = sizeof(documents) / sizeof(documents[0]);
+    api_initData(&parallelData);
+    api_initData(&data);
+    error = api_loadData(&parallelData, input, true);
+    if (error == E_SUCCESS) {
+        error = api_loadData(&data, input, true);
+    }
+    
+    //////////////////////////////
+    /////  PR4 EX15 TEST 1  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX15_1", "Book appointments of several centers in parallel");
+    if (error != E_SUCCESS) {
+        failed = true;
+    } else {
+        // Booking the centers in parallel gives the same results as booking each request in order
+        dateTime_parse(&timestamp, "02/04/2022", "10:15");
+        if (api_findAppointmentAvailabilityParallel(&parallelData, cps, documents, count, timestamp, results, 3) != E_SUCCESS) {
+            failed = true;
+        }
+        for (i = 0; i < count && !failed; i++) {
+            if (results[i] != api_findAppointmentAvailability(&data, cps[i], documents[i], timestamp)) {
+                failed = true;
+            }
+        }
+        if (results[0] != E_SUCCESS || results[1] != E_SUCCESS || results[2] != E_HEALTH_CENTER_NOT_FOUND || results[5] != E_DUPLICATED_PERSON || results[6] != E_PERSON_NOT_FOUND) {
+            failed = true;
+        }
+        for (i = 0; i < count && !failed; i++) {
+            csv_init(&parallelReport);
+            csv_init(&report);
+            if (api_getPersonAppointments(&parallelData, documents[i], &parallelReport) != api_getPersonAppointments(&data, documents[i], &report) || !csv_equals(parallelReport, report)) {
+                failed = true;
+            }
+            csv_free(&parallelReport);
+            csv_free(&report);
+        }
+        
+        // The calendars of the centers are also the same
+        for (i = 0; i < api_centersCount(&data) && !failed; i++) {
+            parallelCenter = centerList_get(&(parallelData.centers), i);
+            center = centerList_get(&(data.centers), i);
+            if (parallelCenter->appointments.count != center->appointments.count) {
+                failed = true;
+            }
+            for (j = 0; j < center->appointments.count && !failed; j++) {
+                if (parallelCenter->appointments.elems[j].person != &(parallelData.population.elems[center->appointments.elems[j].person - data.population.elems])) {
+                    failed = true;
+                } else if (dateTime_cmp(parallelCenter->appointments.elems[j].timestamp, center->appointments.elems[j].timestamp) != 0) {
+                    failed = true;
+                }
+            }
+        }
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX15_1", !failed);
+    
+    //////////////////////////////
+    /////  PR4 EX15 TEST 2  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX15_2", "Book appointments in parallel with more threads than centers");
+    if (error != E_SUCCESS) {
+        failed = true;
+    } else {
+        if (api_findAppointmentAvailabilityParallel(&parallelData, cps, documents, count, timestamp, results, 16) != E_SUCCESS) {
+            failed = true;
+        }
+        for (i = 0; i < count && !failed; i++) {
+            if (results[i] != api_findAppointmentAvailability(&data, cps[i], documents[i], timestamp)) {
+                failed = true;
+            }
+        }
+        if (results[0] != E_DUPLICATED_PERSON || results[2] != E_HEALTH_CENTER_NOT_FOUND) {
+            failed = true;
+        }
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX15_2", !failed);
+    
+    api_freeData(&parallelData);
+    api_freeData(&data);
+    
+    return passed;
+}
+
+// Reader of the shared data, checking that it only sees the complete entries of the writer
+typedef struct _tTestReader {
+    tApiSharedData* shared;
+    // Set by the writer when it ends, while holding the lock
+    bool* done;
+    // Number of appointments of a person, which are not modified by the writer
+    int numAppointments;
+    // Number of reads and true if the reader found any inconsistency
+    int reads;
+    bool failed;
+} tTestReader;
+
+// Read the shared data until the writer ends. Runs on its own thread
+static void* test_readShared(void* arg) {
+    tTestReader* reader;
+    const tApiData* data;
+    tCSVData appointments;
+    tCSVEntry entry;
+    tDateTime timestamp;
+    tApiError error;
+    int population, lastPopulation;
+    int doses, lastDoses;
+    bool done;
+    
+    reader = (tTestReader*) arg;
+    dateTime_parse(&timestamp, "20/05/2022", "10:00");
+    lastPopulation = 0;
+    lastDoses = 0;
+    done = false;
+    while (!done) {
+        // The writer adds persons and doses, so the counts never decrease
+        data = api_beginRead(reader->shared);
+        population = api_populationCount(data);
+        done = *(reader->done);
+        api_endRead(reader->shared);
+        if (population < lastPopulation) {
+            reader->failed = true;
+        }
+        lastPopulation = population;
+        
+        // Doses are always added 10 at a time
+        error = api_sharedGetVaccineLot(reader->shared, "08001", "PFIZER", timestamp, &entry);
+        if (error == E_SUCCESS) {
+            doses = csv_getAsInteger(entry, 6);
+            if (doses < lastDoses || doses % 10 != 0) {
+                reader->failed = true;
+            }
+            lastDoses = doses;
+            csv_freeEntry(&entry);
+        } else if (error != E_LOT_NOT_FOUND || lastDoses > 0) {
+            reader->failed = true;
+        }
+        if (lastDoses > 0 && !api_sharedCheckAvailability(reader->shared, "08001", "PFIZER", timestamp.date)) {
+            reader->failed = true;
+        }
+        
+        csv_init(&appointments);
+        if (api_sharedGetPersonAppointments(reader->shared, "87654321K", &appointments) != E_SUCCESS || csv_numEntries(appointments) != reader->numAppointments) {
+            reader->failed = true;
+        }
+        csv_free(&appointments);
+        
+        reader->reads++;
+    }
+    
+    return NULL;
+}
+
+// Run all tests for Exercice 16 of PR4
+bool run_pr4_ex16(tTestSection* test_section, const char* input) {
+    tApiSharedData shared;
+    tApiError error;
+    tTestReader readers[SHARED_NUM_READERS];
+    pthread_t threads[SHARED_NUM_READERS];
+    bool threaded[SHARED_NUM_READERS];
+    bool done;
+    tCSVData appointments;
+    tCSVEntry entry;
+    tDateTime timestamp;
+    char buffer[1024];
+    int numAppointments;
+    int i;
+    bool passed = true;
+    bool failed = false;
+    
+    error = api_initSharedData(&shared);
+    if (error == E_SUCCESS) {
+        error = api_loadData(api_beginWrite(&shared), input, true);
+        api_endWrite(&shared);
+    }
+    
+    //////////////////////////////
+    /////  PR4 EX16 TEST 1  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX16_1", "Read the shared data while a writer adds entries");
+    if (error != E_SUCCESS) {
+        failed = true;
+    } else {
+        dateTime_parse(&timestamp, "02/04/2022", "10:15");
+        api_findAppointmentAvailability(api_beginWrite(&shared), "08001", "87654321K", timestamp);
+        api_endWrite(&shared);
+        csv_init(&appointments);
+        api_sharedGetPersonAppointments(&shared, "87654321K", &appointments);
+        numAppointments = csv_numEntries(appointments);
+        csv_free(&appointments);
+        
+        done = false;
+        for (i = 0; i < SHARED_NUM_READERS; i++) {
+            readers[i].shared = &shared;
+            readers[i].done = &done;
+            readers[i].numAppointments = numAppointments;
+            readers[i].reads = 0;
+            readers[i].failed = false;
+            threaded[i] = (pthread_create(&(threads[i]), NULL, test_readShared, &(readers[i])) == 0);
+        }
+        
+        // Add persons and doses of a new lot, one entry at a time
+        for (i = 0; i < SHARED_NUM_ENTRIES; i++) {
+            csv_initEntry(&entry);
+            if (i % 2 == 0) {
+                sprintf(buffer, "%08dS;Name;Surname;name@example.com;Street, 1;08001;01/01/1990", i);
+                csv_parseEntry(&entry, buffer, "PERSON");
+            } else {
+                csv_parseEntry(&entry, "20/05/2022;10:00;08001;PFIZER;2;21;10", "VACCINE_LOT");
+            }
+            if (api_sharedAddDataEntry(&shared, entry) != E_SUCCESS) {
+                failed = true;
+            }
+            csv_freeEntry(&entry);
+        }
+        api_beginWrite(&shared);
+        done = true;
+        api_endWrite(&shared);
+        
+        for (i = 0; i < SHARED_NUM_READERS; i++) {
+            if (threaded[i]) {
+                pthread_join(threads[i], NULL);
+            } else {
+                test_readShared(&(readers[i]));
+            }
+            if (readers[i].failed || readers[i].reads == 0) {
+                failed = true;
+            }
+        }
+        
+        dateTime_parse(&timestamp, "20/05/2022", "10:00");
+        if (api_populationCount(&(shared.data)) != SHARED_NUM_ENTRIES / 2 + 4) {
+            failed = true;
+        }
+        if (api_sharedGetVaccineLot(&shared, "08001", "PFIZER", timestamp, &entry) != E_SUCCESS) {
+            failed = true;
+        } else {
+            if (csv_getAsInteger(entry, 6) != SHARED_NUM_ENTRIES / 2 * 10) {
+                failed = true;
+            }
+            csv_freeEntry(&entry);
+        }
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX16_1", !failed);
+    
+    api_freeSharedData(&shared);
+    
+    return passed;
+}
+
+// Check that the data loaded from a snapshot gives the same results as the saved one
+static bool test_sameSnapshot(tApiData* data1, tApiData* data2) {
+    tCSVData report1;
+    tCSVData report2;
+    tHealthCenter* center1;
+    tHealthCenter* center2;
+    tVaccine* vaccine;
+    tDate date;
+    bool same;
+    int i, j, k;
+    
+    if (api_populationCount(data1) != api_populationCount(data2) || api_vaccineCount(data1) != api_vaccineCount(data2) 
+        || api_vaccineLotsCount(data1) != api_vaccineLotsCount(data2) || api_centersCount(data1) != api_centersCount(data2)) {
+        return false;
+    }
+    
+    csv_init(&report1);
+    csv_init(&report2);
+    api_getVaccines(data1, &report1);
+    api_getVaccines(data2, &report2);
+    same = csv_equals(report1, report2);
+    csv_free(&report1);
+    csv_free(&report2);
+    
+    csv_init(&report1);
+    csv_init(&report2);
+    api_getVaccineLots(data1, &report1);
+    api_getVaccineLots(data2, &report2);
+    same = same && csv_equals(report1, report2);
+    csv_free(&report1);
+    csv_free(&report2);
+    
+    for (i = 0; i < data1->population.count && same; i++) {
+        csv_init(&report1);
+        csv_init(&report2);
+        if (api_getPersonAppointments(data1, data1->population.elems[i].document, &report1) != api_getPersonAppointments(data2, data1->population.elems[i].document, &report2) || !csv_equals(report1, report2)) {
+            same = false;
+        }
+        csv_free(&report1);
+        csv_free(&report2);
+    }
+    
+    // Stock and calendar of each center
+    for (i = 0; i < api_centersCount(data1) && same; i++) {
+        center1 = centerList_get(&(data1->centers), i);
+        center2 = centerList_get(&(data2->centers), i);
+        if (strcmp(center1->cp, center2->cp) != 0 || center1->appointments.count != center2->appointments.count) {
+            same = false;
+        }
+        for (j = 0; j < center1->appointments.count && same; j++) {
+            if (strcmp(center1->appointments.elems[j].person->document, center2->appointments.elems[j].person->document) != 0
+                || strcmp(center1->appointments.elems[j].vaccine->name, center2->appointments.elems[j].vaccine->name) != 0
+                || !dateTime_equals(center1->appointments.elems[j].timestamp, center2->appointments.elems[j].timestamp)) {
+                same = false;
+            }
+        }
+        for (j = 0; j < api_vaccineCount(data1) && same; j++) {
+            vaccine = vaccineList_get(&(data1->vaccines), j);
+            date_parse(&date, "25/03/2022");
+            for (k = 0; k < 60 && same; k++) {
+                if (api_checkAvailability(data1, center1->cp, vaccine->name, date) != api_checkAvailability(data2, center1->cp, vaccine->name, date)) {
+                    same = false;
+                }
+                date_addDay(&date, 1);
+            }
+        }
+    }
+    
+    return same;
+}
+
+// Copy the first size bytes of a file, changing the byte at position corrupt if it is not negative
+static void test_copyFile(const char* from, const char* to, long size, long corrupt) {
+    FILE* fin;
+    FILE* fout;
+    char* buffer;
+    long len;
+    
+    buffer = (char*) malloc(size);
+    assert(buffer != NULL);
+    fin = fopen(from, "rb");
+    assert(fin != NULL);
+    len = (long) fread(buffer, 1, size, fin);
+    fclose(fin);
+    
+    if (corrupt >= 0 && corrupt < len) {
+        buffer[corrupt] = ~buffer[corrupt];
+    }
+    fout = fopen(to, "wb");
+    assert(fout != NULL);
+    fwrite(buffer, 1, len, fout);
+    fclose(fout);
+    free(buffer);
+}
+
+// Run all tests for Exercice 17 of PR4
+bool run_pr4_ex17(tTestSection* test_section, const char* input) {
+    tApiData loaded;
+    tApiData data;
+    tApiError error;
+    tCSVEntry entry;
+    tDateTime timestamp;
+    tSnapshotHeader header;
+    long size;
+    bool passed = true;
+    bool failed = false;
+    
+    api_initData(&loaded);
+    api_initData(&data);
+    error = api_loadData(&data, input, true);
+    if (error == E_SUCCESS) {
+        dateTime_parse(&timestamp, "02/04/2022", "10:15");
+        api_findAppointmentAvailability(&data, "08001", "87654321K", timestamp);
+        api_findAppointmentAvailability(&data, "08500", "98765432J", timestamp);
+        error = api_saveSnapshot(&data, SNAPSHOT_FILE);
+    }
+    
+    //////////////////////////////
+    /////  PR4 EX17 TEST 1  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX17_1", "Save and load a snapshot");
+    if (error != E_SUCCESS) {
+        failed = true;
+    } else {
+        if (api_loadSnapshot(&loaded, SNAPSHOT_FILE) != E_SUCCESS || !test_sameSnapshot(&data, &loaded)) {
+            failed = true;
+        }
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX17_1", !failed);
+    
+    //////////////////////////////
+    /////  PR4 EX17 TEST 2  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX17_2", "Modify the data loaded from a snapshot");
+    if (error != E_SUCCESS) {
+        failed = true;
+    } else {
+        // New lots and appointments use the loaded strings and indexes
+        csv_initEntry(&entry);
+        csv_parseEntry(&entry, "03/04/2022;09:00;08001;MODERNA;1;0;5", "VACCINE_LOT");
+        if (api_addDataEntry(&data, entry) != E_SUCCESS || api_addDataEntry(&loaded, entry) != E_SUCCESS) {
+            failed = true;
+        }
+        csv_freeEntry(&entry);
+        if (api_findAppointmentAvailability(&data, "08001", "76543210P", timestamp) != api_findAppointmentAvailability(&loaded, "08001", "76543210P", timestamp)
+            || api_findAppointmentAvailability(&loaded, "08001", "87654321K", timestamp) != E_DUPLICATED_PERSON
+            || !test_sameSnapshot(&data, &loaded)) {
+            failed = true;
+        }
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX17_2", !failed);
+    
+    //////////////////////////////
+    /////  PR4 EX17 TEST 3  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX17_3", "Reject missing and corrupted snapshots");
+    if (error != E_SUCCESS) {
+        failed = true;
+    } else {
+        if (api_loadSnapshot(&loaded, "missing_data_pr4.snap") != E_FILE_NOT_FOUND || api_populationCount(&loaded) != 0) {
+            failed = true;
+        }
+        if (api_loadSnapshot(&loaded, input) != E_INVALID_SNAPSHOT) {
+            failed = true;
+        }
+        
+        // Truncated file
+        api_saveSnapshot(&data, SNAPSHOT_FILE);
+        size = sizeof(tSnapshotHeader) * 4;
+        test_copyFile(SNAPSHOT_FILE, "test_data_pr4_bad.snap", size, -1);
+        if (api_loadSnapshot(&loaded, "test_data_pr4_bad.snap") != E_INVALID_SNAPSHOT) {
+            failed = true;
+        }
+        
+        // Wrong magic and wrong number of strings
+        test_copyFile(SNAPSHOT_FILE, "test_data_pr4_bad.snap", 1L << 20, 0);
+        if (api_loadSnapshot(&loaded, "test_data_pr4_bad.snap") != E_INVALID_SNAPSHOT) {
+            failed = true;
+        }
+        test_copyFile(SNAPSHOT_FILE, "test_data_pr4_bad.snap", 1L << 20, sizeof(header) + sizeof(int) - 1);
+        if (api_loadSnapshot(&loaded, "test_data_pr4_bad.snap") != E_INVALID_SNAPSHOT || api_populationCount(&loaded) != 0) {
+            failed = true;
+        }
+        
+        // The data can still be loaded after a failure
+        if (api_loadSnapshot(&loaded, SNAPSHOT_FILE) != E_SUCCESS || !test_sameSnapshot(&data, &loaded)) {
+            failed = true;
+        }
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX17_3", !failed);
+    
+    remove(SNAPSHOT_FILE);
+    remove("test_data_pr4_bad.snap");
+    api_freeData(&loaded);
+    api_freeData(&data);
+    
+    return passed;
+}
+
+// Run all tests for Exercice 18 of PR4
+bool run_pr4_ex18(tTestSection* test_section, const char* input) {
+    tApiData recovered;
+    tApiData data;
+    tApiError error;
+    tWal log;
+    tCSVFile file;
+    tCSVEntry entry;
+    tDateTime timestamp;
+    const char* documents[] = {"98765432J", "12345678Q"};
+    tApiError results[2];
+    long long lsn;
+    long size;
+    bool passed = true;
+    bool failed = false;
+    
+    // Changes of the logged data are also applied to data, which is not logged
+    remove(LOG_FILE);
+    remove(LOG_SNAPSHOT_FILE);
+    api_initData(&recovered);
+    api_initData(&data);
+    dateTime_parse(&timestamp, "02/04/2022", "10:15");
+    error = api_recoverData(&recovered, &log, LOG_SNAPSHOT_FILE, LOG_FILE, LOG_GROUP_SIZE);
+    if (error == E_SUCCESS && api_populationCount(&recovered) != 0) {
+        error = E_INVALID_LOG;
+    }
+    if (error == E_SUCCESS) {
+        api_loadData(&recovered, input, false);
+        api_loadData(&data, input, false);
+    }
+    
+    //////////////////////////////
+    /////  PR4 EX18 TEST 1  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX18_1", "Recover the data from the log of changes");
+    if (error != E_SUCCESS) {
+        failed = true;
+    } else {
+        api_findAppointmentAvailability(&recovered, "08001", "87654321K", timestamp);
+        api_findAppointmentAvailability(&data, "08001", "87654321K", timestamp);
+        api_addAppointment(&recovered, "08001", "76543210P", "MODERNA", timestamp);
+        api_addAppointment(&data, "08001", "76543210P", "MODERNA", timestamp);
+        api_findAppointmentAvailabilityBatch(&recovered, "08500", documents, 2, timestamp, results);
+        api_findAppointmentAvailabilityBatch(&data, "08500", documents, 2, timestamp, results);
+        if (api_removeAppointment(&recovered, "08001", "76543210P", timestamp) != E_SUCCESS || api_removeAppointment(&data, "08001", "76543210P", timestamp) != E_SUCCESS) {
+            failed = true;
+        }
+        lsn = recovered.lsn;
+        if (api_closeLog(&recovered) != E_SUCCESS) {
+            failed = true;
+        }
+        
+        // Without a snapshot, all the changes are on the log
+        if (api_recoverData(&recovered, &log, LOG_SNAPSHOT_FILE, LOG_FILE, LOG_GROUP_SIZE) != E_SUCCESS || recovered.lsn != lsn || !test_sameSnapshot(&data, &recovered)) {
+            failed = true;
+        }
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX18_1", !failed);
+    
+    //////////////////////////////
+    /////  PR4 EX18 TEST 2  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX18_2", "Recover the data from a compacted log");
+    if (error != E_SUCCESS || recovered.log == NULL) {
+        failed = true;
+    } else {
+        if (api_compactLog(&recovered, LOG_SNAPSHOT_FILE, LOG_FILE) != E_SUCCESS) {
+            failed = true;
+        }
+        api_findAppointmentAvailability(&recovered, "08001", "76543210P", timestamp);
+        api_findAppointmentAvailability(&data, "08001", "76543210P", timestamp);
+        lsn = recovered.lsn;
+        if (api_closeLog(&recovered) != E_SUCCESS) {
+            failed = true;
+        }
+        
+        // The log only has the changes after the snapshot
+        if (!csv_openFile(&file, LOG_FILE)) {
+            failed = true;
+        } else {
+            if (file.size >= 256) {
+                failed = true;
+            }
+            csv_closeFile(&file);
+        }
+        if (api_recoverData(&recovered, &log, LOG_SNAPSHOT_FILE, LOG_FILE, LOG_GROUP_SIZE) != E_SUCCESS || recovered.lsn != lsn || !test_sameSnapshot(&data, &recovered)) {
+            failed = true;
+        }
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX18_2", !failed);
+    
+    //////////////////////////////
+    /////  PR4 EX18 TEST 3  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX18_3", "Ignore the last change if it is not completely written");
+    if (error != E_SUCCESS || recovered.log == NULL) {
+        failed = true;
+    } else {
+        // A change is only on the disk once it is synced
+        lsn = recovered.lsn;
+        csv_initEntry(&entry);
+        csv_parseEntry(&entry, "10/04/2022;09:00;08500;MODERNA;1;0;3", "VACCINE_LOT");
+        api_addDataEntry(&recovered, entry);
+        csv_freeEntry(&entry);
+        size = 0;
+        if (csv_openFile(&file, LOG_FILE)) {
+            size = file.size;
+            csv_closeFile(&file);
+        }
+        if (api_syncLog(&recovered) != E_SUCCESS || !csv_openFile(&file, LOG_FILE)) {
+            failed = true;
+        } else {
+            if (file.size <= size) {
+                failed = true;
+            }
+            size = file.size;
+            csv_closeFile(&file);
+        }
+        api_closeLog(&recovered);
+        
+        // The last change was cut while it was written
+        test_copyFile(LOG_FILE, "test_data_pr4_bad.wal", size - 3, -1);
+        if (api_recoverData(&recovered, &log, LOG_SNAPSHOT_FILE, "test_data_pr4_bad.wal", LOG_GROUP_SIZE) != E_SUCCESS || recovered.lsn != lsn || !test_sameSnapshot(&data, &recovered)) {
+            failed = true;
+        }
+        
+        // New changes replace the incomplete one
+        csv_initEntry(&entry);
+        csv_parseEntry(&entry, "11/04/2022;09:00;08500;MODERNA;1;0;2", "VACCINE_LOT");
+        api_addDataEntry(&data, entry);
+        if (recovered.log != NULL) {
+            api_addDataEntry(&recovered, entry);
+            api_closeLog(&recovered);
+        }
+        csv_freeEntry(&entry);
+        if (api_recoverData(&recovered, &log, LOG_SNAPSHOT_FILE, "test_data_pr4_bad.wal", LOG_GROUP_SIZE) != E_SUCCESS || recovered.lsn != lsn + 1 || !test_sameSnapshot(&data, &recovered)) {
+            failed = true;
+        }
+        if (recovered.log != NULL) {
+            api_closeLog(&recovered);
+        }
+        
+        // A file that is not a log is not valid
+        test_copyFile(LOG_FILE, "test_data_pr4_bad.wal", 1L << 20, 0);
+        if (api_recoverData(&recovered, &log, LOG_SNAPSHOT_FILE, "test_data_pr4_bad.wal", LOG_GROUP_SIZE) != E_INVALID_LOG || api_populationCount(&recovered) != 0) {
+            failed = true;
+        }
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX18_3", !failed);
+    
+    //////////////////////////////
+    /////  PR4 EX18 TEST 4  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX18_4", "Keep the log and log the reset when the data is reloaded");
+    remove(LOG_FILE);
+    remove(LOG_SNAPSHOT_FILE);
+    if (error != E_SUCCESS || api_recoverData(&recovered, &log, LOG_SNAPSHOT_FILE, LOG_FILE, LOG_GROUP_SIZE) != E_SUCCESS) {
+        failed = true;
+    } else {
+        // Changes before the reset are removed, and the ones after it are kept
+        api_loadData(&recovered, input, false);
+        api_addAppointment(&recovered, "08001", "87654321K", "PFIZER", timestamp);
+        lsn = recovered.lsn;
+        if (api_loadData(&recovered, input, true) != E_SUCCESS || recovered.log != &log || recovered.lsn <= lsn) {
+            failed = true;
+        }
+        api_addAppointment(&recovered, "08001", "76543210P", "MODERNA", timestamp);
+        api_loadData(&data, input, true);
+        api_addAppointment(&data, "08001", "76543210P", "MODERNA", timestamp);
+        
+        // A snapshot can not replace the data of a log
+        if (api_loadSnapshot(&recovered, LOG_SNAPSHOT_FILE) != E_INVALID_LOG || !test_sameSnapshot(&data, &recovered)) {
+            failed = true;
+        }
+        lsn = recovered.lsn;
+        if (api_syncLog(&recovered) != E_SUCCESS || api_closeLog(&recovered) != E_SUCCESS) {
+            failed = true;
+        }
+        if (api_recoverData(&recovered, &log, LOG_SNAPSHOT_FILE, LOG_FILE, LOG_GROUP_SIZE) != E_SUCCESS || recovered.lsn != lsn || !test_sameSnapshot(&data, &recovered)) {
+            failed = true;
+        }
+        if (recovered.log != NULL) {
+            api_closeLog(&recovered);
+        }
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX18_4", !failed);
+    
+    remove(LOG_FILE);
+    remove(LOG_SNAPSHOT_FILE);
+    remove("test_data_pr4_bad.wal");
+    api_freeData(&recovered);
+    api_freeData(&data);
+    
+    return passed;
+}
+
+// Add the same appointments to the data before and after the synchronization. The appointments of 98765432J are only added before it
+static void test_syncAppointments(tApiData* data, bool synced) {
+    tDateTime timestamp;
+    
+    dateTime_parse(&timestamp, "02/04/2022", "10:15");
+    api_addAppointment(data, "08001", "87654321K", "PFIZER", timestamp);
+    api_addAppointment(data, "08500", "12345678Q", "PFIZER", timestamp);
+    if (!synced) {
+        api_addAppointment(data, "08500", "98765432J", "MODERNA", timestamp);
+    }
+}
+
+// Run all tests for Exercice 19 of PR4
+bool run_pr4_ex19(tTestSection* test_section, const char* input) {
+    tApiData expected;
+    tApiData recovered;
+    tApiData data;
+    tApiError error;
+    tApiSyncStats stats;
+    tWal log;
+    bool passed = true;
+    bool failed = false;
+    
+    // New version of the feed: a person and a lot changed, removed and inserted. Inserted rows take the position of the removed ones
+    save_data(SYNC_FILE, "PERSON;87654321K;John;Smith;john.smith@example.org;My street, 25;08001;30/12/1980\n" \
+                         "PERSON;11111111H;Anna;Lopez;anna.lopez@example.com;Main street, 3;08003;21/07/1988\n" \
+                         "PERSON;76543210P;Donna;Comer;donna.comer@example.com;Another street, 61;08001;12/06/1973\n" \
+                         "PERSON;12345678Q;Brian;Davis;brian.davis@example.com;Yet another street, 1;08003;30/01/1999\n" \
+                         "VACCINE_LOT;01/04/2022;13:45;08001;PFIZER;2;21;5\n" \
+                         "VACCINE_LOT;10/04/2022;09:00;08003;MODERNA;1;0;4\n" \
+                         "VACCINE_LOT;15/04/2022;13:45;08001;PFIZER;2;21;2\n" \
+                         "VACCINE_LOT;05/04/2022;18:00;08500;MODERNA;1;0;1\n" \
+                         "VACCINE_LOT;05/04/2022;15:45;08001;MODERNA;1;0;1\n" \
+                         "VACCINE_LOT;30/05/2022;13:45;08500;PFIZER;2;21;2\n");
+    save_data(SYNC_BAD_FILE, "PERSON;87654321K;John;Smith;john.smith@example.org;My street, 25;08001;30/12/1980\n" \
+                             "PERSON;98765432J\n" \
+                             "VACCINE_LOT;01/04/2022;13:45;08001;PFIZER;2;21;5\n");
+    
+    // The expected data is loaded from the new version of the feed
+    api_initData(&expected);
+    api_initData(&data);
+    error = api_loadData(&expected, SYNC_FILE, false);
+    if (error == E_SUCCESS) {
+        error = api_loadData(&data, input, false);
+    }
+    test_syncAppointments(&expected, true);
+    test_syncAppointments(&data, false);
+    
+    //////////////////////////////
+    /////  PR4 EX19 TEST 1  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX19_1", "Apply the rows inserted, changed and removed on a new version of a feed");
+    if (error != E_SUCCESS || api_syncData(&data, SYNC_FILE, &stats) != E_SUCCESS) {
+        failed = true;
+    } else {
+        if (stats.inserted != 2 || stats.changed != 2 || stats.removed != 2 || stats.unchanged != 6) {
+            failed = true;
+        }
+        // Appointments of the removed person are cancelled, and the others are kept
+        if (!test_sameSnapshot(&expected, &data) || appointmentIndex_find(&(data.personAppointments), "98765432J")->count != 0) {
+            failed = true;
+        }
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX19_1", !failed);
+    
+    //////////////////////////////
+    /////  PR4 EX19 TEST 2  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX19_2", "Do not apply the rows without changes, nor remove rows of a feed with invalid rows");
+    if (error != E_SUCCESS || api_syncData(&data, SYNC_FILE, &stats) != E_SUCCESS) {
+        failed = true;
+    } else {
+        if (stats.inserted != 0 || stats.changed != 0 || stats.removed != 0 || stats.unchanged != 10 || !test_sameSnapshot(&expected, &data)) {
+            failed = true;
+        }
+        if (api_syncData(&data, SYNC_BAD_FILE, &stats) != E_INVALID_ENTRY_FORMAT || stats.removed != 0 || !test_sameSnapshot(&expected, &data)) {
+            failed = true;
+        }
+        if (api_syncData(&data, "missing_file.csv", NULL) != E_FILE_NOT_FOUND) {
+            failed = true;
+        }
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX19_2", !failed);
+    
+    //////////////////////////////
+    /////  PR4 EX19 TEST 3  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX19_3", "Recover a synchronized data from the log of changes");
+    remove(SYNC_LOG_FILE);
+    remove(SYNC_SNAPSHOT_FILE);
+    api_initData(&recovered);
+    if (error != E_SUCCESS || api_recoverData(&recovered, &log, SYNC_SNAPSHOT_FILE, SYNC_LOG_FILE, LOG_GROUP_SIZE) != E_SUCCESS) {
+        failed = true;
+    } else {
+        api_loadData(&recovered, input, false);
+        test_syncAppointments(&recovered, false);
+        if (api_syncData(&recovered, SYNC_FILE, NULL) != E_SUCCESS || api_closeLog(&recovered) != E_SUCCESS) {
+            failed = true;
+        }
+        if (api_recoverData(&recovered, &log, SYNC_SNAPSHOT_FILE, SYNC_LOG_FILE, LOG_GROUP_SIZE) != E_SUCCESS || !test_sameSnapshot(&expected, &recovered)) {
+            failed = true;
+        }
+        if (recovered.log != NULL) {
+            api_closeLog(&recovered);
+        }
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX19_3", !failed);
+    
+    remove(SYNC_LOG_FILE);
+    remove(SYNC_SNAPSHOT_FILE);
+    remove(SYNC_BAD_FILE);
+    remove(SYNC_FILE);
+    api_freeData(&recovered);
+    api_freeData(&expected);
+    api_freeData(&data);
+    
+    return passed;
+}
+
+// Check that each row of the columns of the data has the person on the same position of the population
+static bool test_sameColumns(tApiData* data) {
+    tPerson* person;
+    tPerson row;
+    int i;
+    
+    if (populationColumns_len(data->columns) != data->population.count) {
+        return false;
+    }
+    for (i = 0; i < data->population.count; i++) {
+        person = &(data->population.elems[i]);
+        populationColumns_get(data->columns, i, &row);
+        if (strcmp(row.document, person->document) != 0 || strcmp(row.name, person->name) != 0 || strcmp(row.surname, person->surname) != 0) {
+            return false;
+        }
+        if (strcmp(row.email, person->email) != 0 || strcmp(row.address, person->address) != 0 || strcmp(row.cp, person->cp) != 0) {
+            return false;
+        }
+        if (date_cmp(row.birthday, person->birthday) != 0 || populationColumns_find(data->columns, person->document) != i) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+// Run all tests for Exercice 20 of PR4
+bool run_pr4_ex20(tTestSection* test_section, const char* input) {
+    tPopulationColumns columns;
+    tApiData data;
+    tApiError error;
+    tCSVView view;
+    tPerson person;
+    char name[64];
+    int count;
+    int i;
+    bool passed = true;
+    bool failed = false;
+    
+    // New version of the feed: a person changed, a person removed and a person inserted
+    save_data(COLUMNS_FILE, "PERSON;87654321K;John;Smith;john.smith@example.org;My street, 25;08001;30/12/1980\n" \
+                            "PERSON;11111111H;Anna;Lopez;anna.lopez@example.com;Main street, 3;08003;21/07/1988\n" \
+                            "PERSON;76543210P;Donna;Comer;donna.comer@example.com;Another street, 61;08001;12/06/1973\n" \
+                            "PERSON;12345678Q;Brian;Davis;brian.davis@example.com;Yet another street, 1;08003;30/01/1999\n");
+    
+    api_initData(&data);
+    error = api_loadData(&data, input, false);
+    
+    //////////////////////////////
+    /////  PR4 EX20 TEST 1  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX20_1", "Store the population by columns on the same order");
+    if (error != E_SUCCESS || api_enableColumns(&data, &columns) != E_SUCCESS) {
+        failed = true;
+    } else {
+        if (!test_sameColumns(&data) || populationColumns_len(&columns) == 0) {
+            failed = true;
+        }
+        if (populationColumns_find(&columns, "00000000T") != -1 || populationColumns_find(&columns, "87654321") != -1) {
+            failed = true;
+        }
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX20_1", !failed);
+    
+    //////////////////////////////
+    /////  PR4 EX20 TEST 2  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX20_2", "Update the columns with the persons added, changed and removed");
+    if (error != E_SUCCESS) {
+        failed = true;
+    } else {
+        // The long document widens the document column, keeping the previous rows
+        csv_parseView(&view, COLUMNS_LONG_PERSON, strlen(COLUMNS_LONG_PERSON), NULL);
+        if (api_addDataView(&data, &view) != E_SUCCESS || !test_sameColumns(&data) || columns.documentWidth <= COLUMNS_DOCUMENT_WIDTH) {
+            failed = true;
+        }
+        if (api_syncData(&data, COLUMNS_FILE, NULL) != E_SUCCESS || !test_sameColumns(&data)) {
+            failed = true;
+        }
+        if (populationColumns_find(&columns, "X1234567890123456789Z") != -1 || populationColumns_find(&columns, "11111111H") < 0) {
+            failed = true;
+        }
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX20_2", !failed);
+    
+    //////////////////////////////
+    /////  PR4 EX20 TEST 3  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX20_3", "Keep the columns of the data when it is reset, and stop updating them when disabled");
+    if (error != E_SUCCESS || api_loadData(&data, input, true) != E_SUCCESS) {
+        failed = true;
+    } else {
+        // The cp of the columns are from the new table of strings
+        if (data.columns != &columns || !test_sameColumns(&data)) {
+            failed = true;
+        }
+        if (api_saveSnapshot(&data, SNAPSHOT_FILE) != E_SUCCESS || api_loadSnapshot(&data, SNAPSHOT_FILE) != E_SUCCESS || data.columns != &columns || !test_sameColumns(&data)) {
+            failed = true;
+        }
+        remove(SNAPSHOT_FILE);
+        count = populationColumns_len(&columns);
+        if (api_disableColumns(&data) != E_SUCCESS || api_loadData(&data, input, true) != E_SUCCESS || data.columns != NULL || populationColumns_len(&columns) != count) {
+            failed = true;
+        }
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX20_3", !failed);
+    
+    //////////////////////////////
+    /////  PR4 EX20 TEST 4  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX20_4", "Reuse the heaps of the columns when the rows are changed and removed");
+    if (error != E_SUCCESS || populationColumns_len(&columns) < 2) {
+        failed = true;
+    } else {
+        // Changing a row many times keeps the heap small, and the other rows are not affected
+        populationColumns_get(&columns, 1, &person);
+        strcpy(name, person.name);
+        populationColumns_get(&columns, 0, &person);
+        for (i = 0; i < COLUMNS_NUM_UPDATES; i++) {
+            person.name = (i % 2 == 0) ? COLUMNS_LONG_NAME : "Ann";
+            populationColumns_set(&columns, 0, &person);
+            populationColumns_get(&columns, 0, &person);
+            if (strcmp(person.name, (i % 2 == 0) ? COLUMNS_LONG_NAME : "Ann") != 0) {
+                failed = true;
+            }
+        }
+        populationColumns_get(&columns, 1, &person);
+        if (strcmp(person.name, name) != 0 || columns.names.size > 4 * (int) sizeof(name)) {
+            failed = true;
+        }
+        // Removing the rows compacts the heaps
+        while (populationColumns_len(&columns) > 1) {
+            populationColumns_removeAt(&columns, 0);
+        }
+        populationColumns_get(&columns, 0, &person);
+        if (columns.names.size > 2 * ((int) strlen(person.name) + 1) || columns.addresses.size > 2 * ((int) strlen(person.address) + 1)) {
+            failed = true;
+        }
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX20_4", !failed);
+    
+    remove(COLUMNS_FILE);
+    if (error == E_SUCCESS) {
+        populationColumns_free(&columns);
+    }
+    api_freeData(&data);
+    
+    return passed;
+}
+
+// Check that a selection has the persons born before a date on the cp range of the cohort queries without appointments, checking each person
+static bool test_sameCohort(tApiData* data, tDate bornBefore, const tCohortSelection* selection) {
+    tPersonAppointments* appointments;
+    tPerson* person;
+    int* rows;
+    int numRows;
+    bool selected;
+    bool same;
+    int i;
+    
+    if (selection->count != data->population.count) {
+        return false;
+    }
+    
+    same = true;
+    for (i = 0; i < data->population.count && same; i++) {
+        person = &(data->population.elems[i]);
+        appointments = appointmentIndex_find(&(data->personAppointments), person->document);
+        selected = date_cmp(person->birthday, bornBefore) < 0 && strcmp(person->cp, COHORT_FIRST_CP) >= 0 && strcmp(person->cp, COHORT_LAST_CP) <= 0
+            && (appointments == NULL || appointments->count == 0);
+        same = (cohortSelection_contains(selection, i) == selected);
+    }
+    
+    // The list of rows has the same persons, in increasing order
+    rows = (int*) malloc((data->population.count + 1) * sizeof(int));
+    assert(rows != NULL);
+    numRows = cohortSelection_rows(selection, rows);
+    if (numRows != cohortSelection_len(selection)) {
+        same = false;
+    }
+    for (i = 0; i < numRows && same; i++) {
+        same = cohortSelection_contains(selection, rows[i]) && (i == 0 || rows[i] > rows[i - 1]);
+    }
+    free(rows);
+    
+    return same;
+}
+
+// Run all tests for Exercice 21 of PR4
+bool run_pr4_ex21(tTestSection* test_section, const char* input) {
+    tPopulationColumns columns;
+    tCohortSelection selection;
+    tCohortQuery query;
+    tPersonAppointments* appointments;
+    tApiData data;
+    tApiError error;
+    tDateTime timestamp;
+    tDate bornBefore;
+    tCSVView view;
+    char document[16];
+    char* buffer;
+    int count;
+    int pos;
+    int i;
+    bool passed = true;
+    bool failed = false;
+    
+    // Persons of several cp and birthdays, with the lots of the centers of two of them
+    buffer = (char*) malloc(COHORT_NUM_PERSONS * 128);
+    assert(buffer != NULL);
+    pos = 0;
+    for (i = 0; i < COHORT_NUM_PERSONS; i++) {
+        pos += sprintf(buffer + pos, "PERSON;%08dC;Name;Surname;mail@example.com;Street;%05d;%02d/%02d/%04d\n",
+            i, 8001 + (i % 7), 1 + (i % 28), 1 + (i % 12), 1930 + (i % 70));
+    }
+    pos += sprintf(buffer + pos, "VACCINE_LOT;01/04/2022;13:45;08001;PFIZER;2;21;100\n");
+    pos += sprintf(buffer + pos, "VACCINE_LOT;01/04/2022;13:45;08003;PFIZER;2;21;100\n");
+    save_data(COHORT_FILE, buffer);
+    free(buffer);
+    
+    // Every 5 persons have an appointment
+    api_initData(&data);
+    error = api_loadData(&data, COHORT_FILE, false);
+    dateTime_parse(&timestamp, "02/04/2022", "10:15");
+    for (i = 0; i < COHORT_NUM_PERSONS && error == E_SUCCESS; i += 5) {
+        sprintf(document, "%08dC", i);
+        error = api_addAppointment(&data, (i % 2) ? "08001" : "08003", document, "PFIZER", timestamp);
+    }
+    
+    date_parse(&bornBefore, "01/01/1960");
+    cohortQuery_init(&query);
+    cohortQuery_bornBefore(&query, bornBefore);
+    cohortQuery_addCpRange(&query, &(data.strings), COHORT_FIRST_CP, COHORT_LAST_CP);
+    query.withoutAppointment = true;
+    
+    //////////////////////////////
+    /////  PR4 EX21 TEST 1  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX21_1", "Select the persons of a cohort without appointments");
+    if (error != E_SUCCESS || api_selectCohort(&data, &query, &selection) != E_SUCCESS) {
+        failed = true;
+    } else {
+        if (!test_sameCohort(&data, bornBefore, &selection) || cohortSelection_len(&selection) == 0) {
+            failed = true;
+        }
+        cohortSelection_free(&selection);
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX21_1", !failed);
+    
+    //////////////////////////////
+    /////  PR4 EX21 TEST 2  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX21_2", "Select a cohort with the population stored by columns");
+    if (error != E_SUCCESS || api_enableColumns(&data, &columns) != E_SUCCESS) {
+        failed = true;
+    } else {
+        // A new person of the cohort and a person with the appointments of both doses cancelled are selected
+        csv_parseView(&view, COHORT_NEW_PERSON, strlen(COHORT_NEW_PERSON), NULL);
+        sprintf(document, "%08dC", 15);
+        appointments = appointmentIndex_find(&(data.personAppointments), document);
+        if (api_addDataView(&data, &view) != E_SUCCESS || appointments == NULL) {
+            failed = true;
+        }
+        while (!failed && appointments->count > 0) {
+            count = appointments->count;
+            if (api_removeAppointment(&data, "08001", document, appointments->elems[count - 1].timestamp) != E_SUCCESS || appointments->count == count) {
+                failed = true;
+            }
+        }
+        if (api_selectCohort(&data, &query, &selection) != E_SUCCESS) {
+            failed = true;
+        } else {
+            if (!test_sameCohort(&data, bornBefore, &selection) || !cohortSelection_contains(&selection, data.population.count - 1)
+                || !cohortSelection_contains(&selection, population_find(&(data.population), document))) {
+                failed = true;
+            }
+            cohortSelection_free(&selection);
+        }
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX21_2", !failed);
+    
+    //////////////////////////////
+    /////  PR4 EX21 TEST 3  //////
+    //////////////////////////////
+    failed = false;
+    start_test(test_section, "PR4_EX21_3", "Select all the persons with an empty query, and none with an unknown cp");
+    cohortQuery_free(&query);
+    if (error != E_SUCCESS || api_selectCohort(&data, &query, &selection) != E_SUCCESS) {
+        failed = true;
+    } else {
+        if (cohortSelection_len(&selection) != data.population.count) {
+            failed = true;
+        }
+        cohortSelection_free(&selection);
+        cohortQuery_addCp(&query, &(data.strings), "09999");
+        if (api_selectCohort(&data, &query, &selection) != E_SUCCESS || cohortSelection_len(&selection) != 0) {
+            failed = true;
+        }
+        cohortSelection_free(&selection);
+    }
+    if (failed) {
+        passed = false;
+    }
+    end_test(test_section, "PR4_EX21_3", !failed);
+    
+    remove(COHORT_FILE);
+    if (error == E_SUCCESS) {
+        populationColumns_free(&columns);
+    }
+    cohortQuery_free(&query);
+    api_freeData(&data);
+    
+    return passed;
+}
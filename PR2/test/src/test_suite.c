@@ -14,13 +14,15 @@ void waitKey(tAppArguments parameters) {
 
 // Display help text
 void help(const char* app_name) {
-    printf("%s [--help] [--in <input_test_file>] [--out <output_file>] [--progress <progress_file>] [--readme <readme_file>]\n", app_name);    
+    printf("%s [--help] [--in <input_test_file>] [--out <output_file>] [--progress <progress_file>] [--readme <readme_file>] [--bench <name>] [--bench-size <n>]\n", app_name);    
     printf("\t[%s] %s\n", "--help", "Show this help information.");
     printf("\t[%s] %s\n", "--no-wait", "Do not wait user key press on exit.");
     printf("\t[%s] %s\n", "--in", "Provide file with input test data in CSV format.");
     printf("\t[%s] %s\n", "--out", "Write the result of tests in a file in JSON format.");    
     printf("\t[%s] %s\n", "--progress", "Write test progress in an output file.");    
     printf("\t[%s] %s\n", "--readme", "Path to README.txt file.");
+    printf("\t[%s] %s\n", "--bench", "Run the given benchmark (or 'all') instead of the tests.");
+    printf("\t[%s] %s\n", "--bench-size", "Number of elements used by the benchmarks.");
 }
 
 // Parse application arguments
@@ -33,6 +35,8 @@ bool parseArguments(tAppArguments* arguments, int argc, char **argv) {
     arguments->in_file = NULL;
     arguments->readme_file = NULL;
     arguments->progress_file = NULL;
+    arguments->bench = NULL;
+    arguments->bench_size = 0;
     arguments->wait_on_exit = true;
     
     // Parse input arguments
@@ -76,6 +80,22 @@ bool parseArguments(tAppArguments* arguments, int argc, char **argv) {
             arguments->readme_file = argv[i+1];
             i++;
         }
+        if (strcmp(argv[i], "--bench") == 0) {
+            if (argc < i + 1) {
+                help(argv[0]);
+                return false;
+            }
+            arguments->bench = argv[i+1];
+            i++;
+        }
+        if (strcmp(argv[i], "--bench-size") == 0) {
+            if (argc < i + 1) {
+                help(argv[0]);
+                return false;
+            }
+            arguments->bench_size = atoi(argv[i+1]);
+            i++;
+        }
     }
     
     return true;